@@ -3,22 +3,59 @@
 in vec3 FragPos;
 in vec3 Normal;
 in vec2 TexCoords;
+in float ViewDepth;
 
 out vec4 FragColor;
 
-uniform vec3 lightPos = vec3(5.0, 10.0, 5.0);
+uniform vec3 sunDirection = vec3(0.0, -1.0, 0.0);
 uniform vec3 lightColor = vec3(1.0, 1.0, 1.0);
 uniform vec3 objectColor = vec3(0.8, 0.4, 0.2);
 uniform float ambientStrength = 0.3;
 
+uniform sampler2DArrayShadow shadowMap;
+uniform mat4 lightSpaceMatrices[4];
+uniform float cascadeSplits[4];
+uniform int cascadeCount = 0;
+uniform int receiveShadows = 1;
+
+float computeShadow(vec3 norm, vec3 lightDir) {
+    if (receiveShadows == 0 || cascadeCount == 0 || ViewDepth > cascadeSplits[cascadeCount - 1]) {
+        return 0.0;
+    }
+    
+    int cascade = cascadeCount - 1;
+    for (int i = 0; i < cascadeCount; ++i) {
+        if (ViewDepth < cascadeSplits[i]) {
+            cascade = i;
+            break;
+        }
+    }
+    
+    float normalBias = 0.02 * (1.0 - dot(norm, lightDir)) * float(cascade + 1);
+    vec4 lightSpace = lightSpaceMatrices[cascade] * vec4(FragPos + norm * normalBias, 1.0);
+    vec3 coords = lightSpace.xyz / lightSpace.w * 0.5 + 0.5;
+    if (coords.z > 1.0) {
+        return 0.0;
+    }
+    
+    vec2 texelSize = 1.0 / vec2(textureSize(shadowMap, 0).xy);
+    float lit = 0.0;
+    for (int x = -1; x <= 1; ++x) {
+        for (int y = -1; y <= 1; ++y) {
+            lit += texture(shadowMap, vec4(coords.xy + vec2(x, y) * texelSize, float(cascade), coords.z));
+        }
+    }
+    return 1.0 - lit / 9.0;
+}
+
 void main() {
     vec3 norm = normalize(Normal);
-    vec3 lightDir = normalize(lightPos - FragPos);
+    vec3 lightDir = normalize(-sunDirection);
     
     vec3 ambient = ambientStrength * lightColor;
     
     float diff = max(dot(norm, lightDir), 0.0);
-    vec3 diffuse = diff * lightColor;
+    vec3 diffuse = diff * lightColor * (1.0 - computeShadow(norm, lightDir));
     
     vec3 result = (ambient + diffuse) * objectColor;
     FragColor = vec4(result, 1.0);
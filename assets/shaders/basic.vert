@@ -11,10 +11,13 @@ uniform mat4 projection;
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoords;
+out float ViewDepth;
 
 void main() {
     FragPos = vec3(model * vec4(aPosition, 1.0));
     Normal = mat3(transpose(inverse(model))) * aNormal;
     TexCoords = aTexCoords;
-    gl_Position = projection * view * vec4(FragPos, 1.0);
+    vec4 viewPos = view * vec4(FragPos, 1.0);
+    ViewDepth = -viewPos.z;
+    gl_Position = projection * viewPos;
 }
@@ -0,0 +1,27 @@
+#version 450 core
+
+in vec2 TexCoords;
+
+out vec4 FragColor;
+
+uniform sampler2D sceneColor;
+uniform vec2 uvScale = vec2(1.0);
+uniform vec2 texelSize;
+uniform float sharpness = 0.4;
+
+void main() {
+    vec2 uvMax = uvScale - texelSize * 0.5;
+    vec2 uv = min(TexCoords * uvScale, uvMax);
+    
+    vec3 center = texture(sceneColor, uv).rgb;
+    vec3 north = texture(sceneColor, min(uv + vec2(0.0, texelSize.y), uvMax)).rgb;
+    vec3 south = texture(sceneColor, max(uv - vec2(0.0, texelSize.y), vec2(0.0))).rgb;
+    vec3 east = texture(sceneColor, min(uv + vec2(texelSize.x, 0.0), uvMax)).rgb;
+    vec3 west = texture(sceneColor, max(uv - vec2(texelSize.x, 0.0), vec2(0.0))).rgb;
+    
+    vec3 minColor = min(center, min(min(north, south), min(east, west)));
+    vec3 maxColor = max(center, max(max(north, south), max(east, west)));
+    
+    vec3 sharpened = center + (4.0 * center - north - south - east - west) * sharpness * 0.25;
+    FragColor = vec4(clamp(sharpened, minColor, maxColor), 1.0);
+}
@@ -0,0 +1,46 @@
+#include "AllocationCounter.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// The size sits in a header in front of each block so frees can be counted
+// too. Array and nothrow forms forward to these by default.
+std::atomic<size_t> s_allocations{0};
+std::atomic<size_t> s_liveBytes{0};
+constexpr size_t HeaderSize = alignof(std::max_align_t);
+
+}
+
+namespace roblox_clone::benchmarks {
+
+size_t AllocationCounter::getAllocations() {
+    return s_allocations.load(std::memory_order_relaxed);
+}
+
+size_t AllocationCounter::getLiveBytes() {
+    return s_liveBytes.load(std::memory_order_relaxed);
+}
+
+}
+
+void* operator new(size_t size) {
+    auto* block = static_cast<char*>(std::malloc(size + HeaderSize));
+    if (!block) throw std::bad_alloc();
+    *reinterpret_cast<size_t*>(block) = size;
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    s_liveBytes.fetch_add(size, std::memory_order_relaxed);
+    return block + HeaderSize;
+}
+
+void operator delete(void* pointer) noexcept {
+    if (!pointer) return;
+    char* block = static_cast<char*>(pointer) - HeaderSize;
+    s_liveBytes.fetch_sub(*reinterpret_cast<size_t*>(block), std::memory_order_relaxed);
+    std::free(block);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    operator delete(pointer);
+}
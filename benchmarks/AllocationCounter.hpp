@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+
+namespace roblox_clone::benchmarks {
+
+// The benchmark binary replaces global operator new and delete once, in
+// AllocationCounter.cpp, so every benchmark reads the same counters.
+struct AllocationCounter {
+    // Calls to operator new since startup.
+    static size_t getAllocations();
+    // Bytes handed out by operator new and not yet deleted.
+    static size_t getLiveBytes();
+};
+
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace roblox_clone::benchmarks {
+
+using BenchmarkFunction = void (*)();
+
+struct BenchmarkEntry {
+    const char* name;
+    BenchmarkFunction function;
+};
+
+inline std::vector<BenchmarkEntry>& getBenchmarks() {
+    static std::vector<BenchmarkEntry> benchmarks;
+    return benchmarks;
+}
+
+struct BenchmarkRegistration {
+    BenchmarkRegistration(const char* name, BenchmarkFunction function) {
+        getBenchmarks().push_back({ name, function });
+    }
+};
+
+// Runs func once to warm up, then returns the best of `repeats` timings in
+// milliseconds.
+template<typename Func>
+double measureMs(Func&& func, int repeats = 5) {
+    func();
+    double best = 1.0e30;
+    for (int i = 0; i < repeats; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        func();
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    return best;
+}
+
+// Keeps the optimizer from discarding a computed value.
+template<typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+}
+
+#define RC_BENCHMARK(name) \
+    static void name(); \
+    static ::roblox_clone::benchmarks::BenchmarkRegistration name##Registration(#name, name); \
+    static void name()
@@ -0,0 +1,101 @@
+#include "Benchmark.hpp"
+#include "scene/Entity.hpp"
+#include "scene/Scene.hpp"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace roblox_clone;
+using namespace roblox_clone::benchmarks;
+
+namespace {
+
+constexpr size_t EntityCount = 1000000;
+constexpr int WritesPerProperty = 4;
+constexpr int Ticks = 5;
+
+// A single timed run; warming up as measureMs() does would consume the tick's
+// changes.
+template<typename Func>
+double timeOnceMs(Func&& func) {
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+// Finding a tick's changes with change events against polling every transform
+// for differences from a copy, which is what listeners had to do before.
+RC_BENCHMARK(ChangeDispatch) {
+    scene::Scene scene;
+    auto& registry = scene.registry();
+    std::vector<entt::entity> entities(EntityCount);
+    registry.create(entities.begin(), entities.end());
+    for (entt::entity entity : entities) {
+        registry.emplace<scene::TransformComponent>(entity);
+    }
+    
+    size_t received = 0;
+    scene.getChangeTracker().addListener(scene::TrackedComponent::Transform,
+        [&received](const scene::ChangeBatch& batch) { received += batch.count; });
+    
+    const auto& transforms = registry.storage<scene::TransformComponent>();
+    std::vector<scene::TransformComponent> shadow(transforms.size());
+    auto poll = [&]() {
+        size_t changed = 0;
+        const entt::entity* packed = transforms.data();
+        for (size_t i = 0; i < transforms.size(); ++i) {
+            const auto& transform = transforms.get(packed[i]);
+            scene::TransformComponent& copy = shadow[i];
+            if (transform.position != copy.position || transform.rotation != copy.rotation ||
+                transform.scale != copy.scale) {
+                copy = transform;
+                ++changed;
+            }
+        }
+        return changed;
+    };
+    poll();
+    scene.dispatchChanges();
+    
+    std::mt19937 random(7);
+    std::printf("%zu entities, each changed property written %d times per tick\n\n", EntityCount,
+                WritesPerProperty);
+    std::printf("%10s %14s %14s %14s %12s\n", "changed", "writes us", "dispatch us", "polling us", "events");
+    for (size_t changedCount : { size_t(10), size_t(1000), size_t(100000) }) {
+        std::vector<entt::entity> changed(changedCount);
+        for (entt::entity& entity : changed) {
+            entity = entities[random() % EntityCount];
+        }
+        
+        float value = 0.0f;
+        auto write = [&]() {
+            for (int i = 0; i < WritesPerProperty; ++i) {
+                value += 1.0f;
+                for (entt::entity entity : changed) {
+                    scene::Entity(entity, &scene).setPosition(glm::vec3(value));
+                }
+            }
+        };
+        
+        double writeMs = 0.0;
+        double dispatchMs = 0.0;
+        double pollMs = 0.0;
+        size_t events = 0;
+        // An untimed tick first, so growing the dirty arrays is not counted.
+        write();
+        scene.dispatchChanges();
+        poll();
+        for (int tick = 0; tick < Ticks; ++tick) {
+            writeMs += timeOnceMs(write);
+            received = 0;
+            dispatchMs += timeOnceMs([&scene]() { scene.dispatchChanges(); });
+            events = received;
+            pollMs += timeOnceMs([&]() { doNotOptimize(poll()); });
+        }
+        std::printf("%10zu %14.1f %14.1f %14.1f %12zu\n", changedCount, writeMs * 1000.0 / Ticks,
+                    dispatchMs * 1000.0 / Ticks, pollMs * 1000.0 / Ticks, events);
+    }
+}
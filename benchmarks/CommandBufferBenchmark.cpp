@@ -0,0 +1,64 @@
+#include "Benchmark.hpp"
+#include "core/JobSystem.hpp"
+#include "scene/Scene.hpp"
+#include <cstdio>
+
+using namespace roblox_clone;
+using namespace roblox_clone::benchmarks;
+
+namespace {
+
+constexpr int PartCount = 10000;
+
+scene::TransformComponent partTransform(int i) {
+    return scene::TransformComponent(glm::vec3(static_cast<float>(i % 100), 1.0f, static_cast<float>(i / 100)));
+}
+
+}
+
+RC_BENCHMARK(CommandBufferSpawnParts) {
+    core::JobSystem::get().initialize();
+    
+    double immediateMs = measureMs([]() {
+        scene::Scene scene;
+        for (int i = 0; i < PartCount; ++i) {
+            auto entity = scene.createEntity("Part");
+            entity.getComponent<scene::TransformComponent>() = partTransform(i);
+            entity.addComponent<scene::MeshRendererComponent>();
+        }
+    });
+    
+    double bufferedMs = measureMs([]() {
+        scene::Scene scene;
+        auto& commands = scene.commands();
+        for (int i = 0; i < PartCount; ++i) {
+            auto entity = commands.create();
+            commands.emplace<scene::TransformComponent>(entity, partTransform(i));
+            commands.emplace<scene::NameComponent>(entity, "Part");
+            commands.emplace<scene::MeshRendererComponent>(entity);
+        }
+        scene.flushCommands();
+    });
+    
+    double parallelMs = measureMs([]() {
+        scene::Scene scene;
+        core::JobSystem::get().parallelFor(PartCount, [&scene](size_t begin, size_t end) {
+            auto& commands = scene.commands();
+            for (size_t i = begin; i < end; ++i) {
+                auto entity = commands.create();
+                commands.emplace<scene::TransformComponent>(entity, partTransform(static_cast<int>(i)));
+                commands.emplace<scene::NameComponent>(entity, "Part");
+                commands.emplace<scene::MeshRendererComponent>(entity);
+            }
+        });
+        scene.flushCommands();
+    });
+    
+    std::printf("%-28s %12s\n", "spawn 10k parts", "time (ms)");
+    std::printf("%-28s %12.3f\n", "immediate registry calls", immediateMs);
+    std::printf("%-28s %12.3f\n", "command buffer + playback", bufferedMs);
+    std::printf("%-28s %12.3f (%d threads)\n", "parallel record + playback", parallelMs,
+                core::JobSystem::get().getThreadCount());
+    
+    core::JobSystem::get().shutdown();
+}
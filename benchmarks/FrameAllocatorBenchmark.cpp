@@ -0,0 +1,73 @@
+#include "AllocationCounter.hpp"
+#include "Benchmark.hpp"
+#include "core/FrameAllocator.hpp"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace roblox_clone;
+using namespace roblox_clone::benchmarks;
+
+namespace {
+
+constexpr int Frames = 600;
+constexpr int PacketsPerFrame = 64;
+constexpr int PrintsPerFrame = 32;
+
+// Mirrors Client::sendInput (header + payload copy) and the Lua print
+// concatenation, once with the global heap and once with frame containers.
+template<typename ByteVector, typename String>
+size_t simulateFrame(const uint8_t* payload, size_t payloadSize) {
+    size_t checksum = 0;
+    for (int i = 0; i < PacketsPerFrame; ++i) {
+        ByteVector packet(1 + payloadSize);
+        packet[0] = 0x10;
+        std::memcpy(packet.data() + 1, payload, payloadSize);
+        checksum += packet[payloadSize / 2];
+    }
+    
+    const char* parts[] = { "player", "jumped", "at", "position", "12.5", "3.0", "-7.25" };
+    for (int i = 0; i < PrintsPerFrame; ++i) {
+        String output;
+        for (const char* part : parts) {
+            output += part;
+            output += " ";
+        }
+        checksum += output.size();
+    }
+    return checksum;
+}
+
+template<typename ByteVector, typename String>
+void runCase(const char* name, bool frameArena) {
+    uint8_t payload[48] = {};
+    size_t checksum = 0;
+    
+    size_t allocationsBefore = AllocationCounter::getAllocations();
+    double ms = measureMs([&]() {
+        for (int frame = 0; frame < Frames; ++frame) {
+            checksum += simulateFrame<ByteVector, String>(payload, sizeof(payload));
+            if (frameArena) core::FrameAllocator::endFrame();
+        }
+    }, 3);
+    size_t allocations = AllocationCounter::getAllocations() - allocationsBefore;
+    doNotOptimize(checksum);
+    
+    // measureMs runs one warm-up plus three timed passes.
+    double perFrame = static_cast<double>(allocations) / (Frames * 4.0);
+    std::printf("%-14s %12.3f %18.2f %14.1f\n", name, ms / Frames * 1000.0, perFrame,
+                static_cast<double>(allocations));
+}
+
+}
+
+RC_BENCHMARK(FrameAllocatorHeapAllocations) {
+    std::printf("%-14s %12s %18s %14s\n", "allocator", "us/frame", "heap allocs/frame", "heap allocs");
+    runCase<std::vector<uint8_t>, std::string>("std heap", false);
+    runCase<core::FrameVector<uint8_t>, core::FrameString>("frame arena", true);
+    
+    const auto& stats = core::FrameAllocator::getStats();
+    std::printf("arena peak %zu bytes/frame, %zu bytes reserved across %u arenas\n", stats.peakFrameBytes,
+                stats.capacityBytes, stats.arenaCount);
+}
@@ -0,0 +1,106 @@
+#include "Benchmark.hpp"
+#include "core/JobSystem.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace roblox_clone;
+using namespace roblox_clone::benchmarks;
+
+namespace {
+
+int maxThreads() {
+    return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+}
+
+RC_BENCHMARK(JobSystemParallelForScaling) {
+    constexpr size_t Count = 1 << 22;
+    std::vector<float> values(Count);
+    
+    std::printf("%-8s %12s %10s %10s\n", "threads", "time (ms)", "speedup", "stolen");
+    double baseline = 0.0;
+    for (int threads = 1; threads <= maxThreads(); ++threads) {
+        auto& jobs = core::JobSystem::get();
+        jobs.initialize(threads - 1);
+        
+        double ms = measureMs([&]() {
+            jobs.parallelFor(Count, [&values](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    float x = static_cast<float>(i) * 0.001f;
+                    values[i] = std::sqrt(x) * std::sin(x) + std::cos(x * 0.5f);
+                }
+            });
+        });
+        doNotOptimize(values[Count / 2]);
+        
+        if (threads == 1) baseline = ms;
+        std::printf("%-8d %12.3f %9.2fx %10llu\n", threads, ms, baseline / ms,
+                    static_cast<unsigned long long>(jobs.getStolenCount()));
+        jobs.shutdown();
+    }
+}
+
+RC_BENCHMARK(JobSystemFineGrainedJobs) {
+    constexpr int JobCount = 2000;
+    
+    std::printf("%-8s %12s %14s\n", "threads", "time (ms)", "jobs/ms");
+    for (int threads = 1; threads <= maxThreads(); ++threads) {
+        auto& jobs = core::JobSystem::get();
+        jobs.initialize(threads - 1);
+        
+        std::atomic<uint64_t> sink{0};
+        double ms = measureMs([&]() {
+            core::JobCounter counter;
+            for (int i = 0; i < JobCount; ++i) {
+                jobs.run([&sink, i]() {
+                    uint64_t value = static_cast<uint64_t>(i);
+                    for (int k = 0; k < 256; ++k) value = value * 6364136223846793005ull + 1442695040888963407ull;
+                    sink.fetch_add(value, std::memory_order_relaxed);
+                }, &counter);
+            }
+            jobs.wait(counter);
+        });
+        
+        std::printf("%-8d %12.3f %14.1f\n", threads, ms, JobCount / ms);
+        jobs.shutdown();
+    }
+}
+
+RC_BENCHMARK(JobSystemDependencyFanOut) {
+    constexpr int Stages = 64;
+    constexpr int Width = 32;
+    
+    std::printf("%-8s %12s\n", "threads", "time (ms)");
+    for (int threads = 1; threads <= maxThreads(); ++threads) {
+        auto& jobs = core::JobSystem::get();
+        jobs.initialize(threads - 1);
+        
+        std::atomic<uint64_t> sink{0};
+        double ms = measureMs([&]() {
+            std::vector<core::JobCounter> counters(Stages);
+            for (int stage = 0; stage < Stages; ++stage) {
+                for (int i = 0; i < Width; ++i) {
+                    auto work = [&sink]() {
+                        uint64_t value = 1;
+                        for (int k = 0; k < 2048; ++k) value = value * 2862933555777941757ull + 3037000493ull;
+                        sink.fetch_add(value, std::memory_order_relaxed);
+                    };
+                    if (stage == 0) {
+                        jobs.run(work, &counters[stage]);
+                    } else {
+                        jobs.runAfter(counters[stage - 1], work, &counters[stage]);
+                    }
+                }
+            }
+            jobs.wait(counters.back());
+        });
+        
+        std::printf("%-8d %12.3f\n", threads, ms);
+        jobs.shutdown();
+    }
+}
@@ -0,0 +1,233 @@
+#include "Benchmark.hpp"
+#include "core/JobSystem.hpp"
+#include "physics/BoxBatch.hpp"
+#include "physics/PhysicsWorld.hpp"
+#include <glm/gtc/quaternion.hpp>
+#include "scene/Scene.hpp"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace roblox_clone;
+using namespace roblox_clone::benchmarks;
+
+namespace {
+
+constexpr int PileWidth = 50;
+constexpr int PileLayers = 4;
+constexpr int SettleSteps = 120;
+constexpr int SleepSettleSteps = 480;
+constexpr int MeasuredSteps = 60;
+constexpr int DroppedBodies = 25;
+constexpr int VolleyWidth = 16;
+constexpr float ProjectileSpeed = 600.0f;
+constexpr float StepTime = 1.0f / 60.0f;
+constexpr int NarrowphasePairs = 4096;
+constexpr int NarrowphaseRounds = 50;
+
+// PileWidth x PileWidth x PileLayers boxes and spheres, slightly rotated and
+// dropped from just above each other so they land in a heap.
+void buildPile(scene::Scene& scene) {
+    auto& registry = scene.registry();
+    const entt::entity ground = registry.create();
+    registry.emplace<scene::TransformComponent>(ground);
+    registry.emplace<physics::RigidBodyComponent>(ground, physics::BodyType::Static, physics::ShapeType::Plane);
+    
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> tilt(-10.0f, 10.0f);
+    std::uniform_real_distribution<float> size(0.8f, 1.2f);
+    for (int layer = 0; layer < PileLayers; ++layer) {
+        for (int x = 0; x < PileWidth; ++x) {
+            for (int z = 0; z < PileWidth; ++z) {
+                const entt::entity entity = registry.create();
+                scene::TransformComponent transform(glm::vec3(x * 1.5f, 1.0f + layer * 1.5f, z * 1.5f));
+                transform.rotation = glm::vec3(tilt(random), tilt(random), tilt(random));
+                transform.scale = glm::vec3(size(random), size(random), size(random));
+                const bool sphere = (x + z + layer) % 8 == 0;
+                if (sphere) transform.scale = glm::vec3(transform.scale.x);
+                registry.emplace<scene::TransformComponent>(entity, transform);
+                registry.emplace<physics::RigidBodyComponent>(
+                    entity, physics::BodyType::Dynamic, sphere ? physics::ShapeType::Sphere : physics::ShapeType::Box);
+            }
+        }
+    }
+}
+
+void dropBodies(scene::Scene& scene) {
+    auto& registry = scene.registry();
+    for (int i = 0; i < DroppedBodies; ++i) {
+        const entt::entity entity = registry.create();
+        registry.emplace<scene::TransformComponent>(entity, glm::vec3((i % 5) * 15.0f, 12.0f, (i / 5) * 15.0f));
+        registry.emplace<physics::RigidBodyComponent>(entity);
+    }
+}
+
+// Randomly rotated boxes overlapping by up to a tenth of their size, the kind
+// of pairs a settling pile hands the narrowphase.
+std::vector<physics::BoxPairBatch> buildBoxBatches() {
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> size(0.4f, 0.6f);
+    std::vector<physics::BoxPairBatch> batches(NarrowphasePairs / physics::BoxPairBatch::MaxPairs);
+    for (auto& batch : batches) {
+        while (!batch.isFull()) {
+            const glm::vec3 halfA(size(random), size(random), size(random));
+            const glm::vec3 halfB(size(random), size(random), size(random));
+            physics::Pose poseA;
+            physics::Pose poseB;
+            poseA.rotation = glm::mat3_cast(glm::normalize(glm::quat(1.0f, unit(random), unit(random), unit(random))));
+            poseB.rotation = glm::mat3_cast(glm::normalize(glm::quat(1.0f, unit(random), unit(random), unit(random))));
+            poseB.position = glm::normalize(glm::vec3(unit(random), unit(random), unit(random))) * (0.9f + 0.3f * unit(random));
+            batch.add(halfA, poseA, halfB, poseB);
+        }
+    }
+    return batches;
+}
+
+// A thin wall and a volley of continuous projectiles fast enough to cross it
+// in a fraction of one step.
+void buildVolley(scene::Scene& scene) {
+    auto& registry = scene.registry();
+    const entt::entity ground = registry.create();
+    registry.emplace<scene::TransformComponent>(ground);
+    registry.emplace<physics::RigidBodyComponent>(ground, physics::BodyType::Static, physics::ShapeType::Plane);
+    const entt::entity wall = registry.create();
+    scene::TransformComponent wallTransform(glm::vec3(0.0f, VolleyWidth * 0.5f, 0.0f));
+    wallTransform.scale = glm::vec3(VolleyWidth * 2.0f, VolleyWidth * 2.0f, 0.1f);
+    registry.emplace<scene::TransformComponent>(wall, wallTransform);
+    registry.emplace<physics::RigidBodyComponent>(wall, physics::BodyType::Static, physics::ShapeType::Box);
+    
+    for (int x = 0; x < VolleyWidth; ++x) {
+        for (int y = 0; y < VolleyWidth; ++y) {
+            const entt::entity entity = registry.create();
+            scene::TransformComponent transform(glm::vec3(x - VolleyWidth * 0.5f, y + 0.5f, -40.0f - (x + y) % 4));
+            transform.scale = glm::vec3(0.3f);
+            registry.emplace<scene::TransformComponent>(entity, transform);
+            auto& rigidBody = registry.emplace<physics::RigidBodyComponent>(
+                entity, physics::BodyType::Dynamic, (x + y) % 2 ? physics::ShapeType::Sphere : physics::ShapeType::Box);
+            rigidBody.linearVelocity = glm::vec3(0.0f, 0.0f, ProjectileSpeed);
+            rigidBody.continuous = true;
+        }
+    }
+}
+
+void measure(physics::PhysicsWorld& world) {
+    physics::PhysicsStats total;
+    double worstMs = 0.0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int step = 0; step < MeasuredSteps; ++step) {
+        world.step(StepTime);
+        const auto& stats = world.getStats();
+        total.broadphaseMs += stats.broadphaseMs;
+        total.narrowphaseMs += stats.narrowphaseMs;
+        total.solverMs += stats.solverMs;
+        total.continuousMs += stats.continuousMs;
+        total.continuousPairCount += stats.continuousPairCount;
+        worstMs = std::max(worstMs, static_cast<double>(stats.stepMs));
+    }
+    const double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    
+    const auto& stats = world.getStats();
+    std::printf("%zu bodies, %zu awake in %zu islands, %zu pairs, %zu touching, %zu contact points\n",
+                stats.bodyCount, stats.awakeBodyCount, stats.islandCount, stats.pairCount, stats.contactCount,
+                stats.contactPointCount);
+    std::printf("%-12s %12s\n", "phase", "ms/step");
+    std::printf("%-12s %12.3f\n", "broadphase", total.broadphaseMs / MeasuredSteps);
+    std::printf("%-12s %12.3f\n", "narrowphase", total.narrowphaseMs / MeasuredSteps);
+    std::printf("%-12s %12.3f\n", "solver", total.solverMs / MeasuredSteps);
+    std::printf("%-12s %12.3f (%.1f pair tests/step)\n", "continuous", total.continuousMs / MeasuredSteps,
+                static_cast<double>(total.continuousPairCount) / MeasuredSteps);
+    std::printf("%-12s %12.3f (worst %.3f)\n", "step", elapsedMs / MeasuredSteps, worstMs);
+}
+
+}
+
+// Every body awake: the cost of solving the whole heap each step.
+RC_BENCHMARK(PhysicsPile) {
+    core::JobSystem::get().initialize();
+    scene::Scene scene;
+    buildPile(scene);
+    physics::PhysicsSettings settings;
+    settings.allowSleep = false;
+    physics::PhysicsWorld world(settings);
+    world.attach(scene);
+    
+    for (int step = 0; step < SettleSteps; ++step) {
+        world.step(StepTime);
+    }
+    measure(world);
+    core::JobSystem::get().shutdown();
+}
+
+// The same heap once it has gone to sleep, with a few boxes dropped on it:
+// step time should follow the bodies they wake rather than the heap's size.
+RC_BENCHMARK(PhysicsSleepingPile) {
+    core::JobSystem::get().initialize();
+    scene::Scene scene;
+    buildPile(scene);
+    physics::PhysicsWorld world;
+    world.attach(scene);
+    
+    for (int step = 0; step < SleepSettleSteps; ++step) {
+        world.step(StepTime);
+    }
+    std::printf("after settling: %zu of %zu bodies awake\n", world.getStats().awakeBodyCount,
+                world.getStats().bodyCount);
+    
+    // With nothing awake a step should cost next to nothing, whatever the
+    // size of the heap.
+    const auto settledStart = std::chrono::steady_clock::now();
+    for (int step = 0; step < MeasuredSteps; ++step) {
+        world.step(StepTime);
+    }
+    const double settledMs =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - settledStart).count();
+    std::printf("settled, nothing dropped: %.3f ms/step\n", settledMs / MeasuredSteps);
+    
+    dropBodies(scene);
+    measure(world);
+    core::JobSystem::get().shutdown();
+}
+
+// Continuous projectiles hitting a wall: the continuous line is what they
+// add to a step while they fly, and none of them should end up behind it.
+RC_BENCHMARK(PhysicsProjectiles) {
+    scene::Scene scene;
+    buildVolley(scene);
+    physics::PhysicsWorld world;
+    world.attach(scene);
+    measure(world);
+    
+    size_t tunnelled = 0;
+    for (auto [entity, transform] : scene.registry().view<scene::TransformComponent>().each()) {
+        (void)entity;
+        if (transform.position.z > 0.0f) ++tunnelled;
+    }
+    std::printf("%zu of %d projectiles tunnelled\n", tunnelled, VolleyWidth * VolleyWidth);
+}
+
+// Box-box SAT and clipping alone, through each kernel this CPU supports.
+RC_BENCHMARK(BoxNarrowphase) {
+    const std::vector<physics::BoxPairBatch> batches = buildBoxBatches();
+    physics::ContactManifold manifolds[physics::BoxPairBatch::MaxPairs];
+    std::printf("%-8s %14s %16s %10s\n", "kernel", "pairs/s", "contacts/s", "ns/pair");
+    for (physics::SimdKernel kernel : { physics::SimdKernel::Scalar, physics::SimdKernel::Sse, physics::SimdKernel::Avx2 }) {
+        if (!physics::isKernelSupported(kernel)) continue;
+        
+        size_t contacts = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < NarrowphaseRounds; ++round) {
+            for (const auto& batch : batches) {
+                physics::collideBoxBatch(batch, 0.05f, manifolds, kernel);
+                for (int pair = 0; pair < batch.count; ++pair) {
+                    contacts += manifolds[pair].pointCount;
+                }
+            }
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const double pairs = static_cast<double>(NarrowphasePairs) * NarrowphaseRounds;
+        std::printf("%-8s %14.0f %16.0f %10.1f\n", physics::getKernelName(kernel), pairs / seconds, contacts / seconds,
+                    seconds * 1.0e9 / pairs);
+    }
+}
@@ -0,0 +1,120 @@
+#include "AllocationCounter.hpp"
+#include "Benchmark.hpp"
+#include "scene/Prefab.hpp"
+#include "scene/Scene.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace roblox_clone;
+using namespace roblox_clone::benchmarks;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int PartCount = 200;
+constexpr int InstanceCount = 1000;
+
+struct SpawnResult {
+    double ms = 1.0e30;
+    size_t allocations = 0;
+    size_t bytes = 0;
+};
+
+// A 200-part vehicle: every part named, meshed with one of 20 meshes and a
+// few materials, a handful scripted.
+scene::Prefab buildModel() {
+    scene::Scene source;
+    auto& registry = source.registry();
+    std::vector<entt::entity> parts;
+    for (int i = 0; i < PartCount; ++i) {
+        const entt::entity entity = registry.create();
+        registry.emplace<scene::TransformComponent>(entity, glm::vec3(i % 10, i / 50, (i / 10) % 5));
+        registry.emplace<scene::NameComponent>(entity, "Chassis_Component_" + std::to_string(i));
+        auto& mesh = registry.emplace<scene::MeshRendererComponent>(entity);
+        mesh.meshPath = "assets/vehicles/truck/meshes/part_" + std::to_string(i % 20) + ".obj";
+        mesh.materialPath = "assets/vehicles/truck/materials/paint_" + std::to_string(i % 4) + ".mat";
+        if (i % 50 == 0) registry.emplace<scene::ScriptComponent>(entity, "assets/vehicles/truck/scripts/wheel.lua");
+        parts.push_back(entity);
+    }
+    return scene::Prefab::capture(source, parts);
+}
+
+std::vector<glm::vec3> spawnPoints() {
+    std::vector<glm::vec3> positions;
+    for (int i = 0; i < InstanceCount; ++i) {
+        positions.push_back(glm::vec3((i % 40) * 20.0f, 0.0f, (i / 40) * 20.0f));
+    }
+    return positions;
+}
+
+// Runs spawn into a fresh scene a few times, keeping the best time and the
+// allocations and bytes still held once it returns.
+template<typename Func>
+SpawnResult measureSpawn(Func&& spawn) {
+    SpawnResult result;
+    for (int run = 0; run < 3; ++run) {
+        scene::Scene scene;
+        const size_t allocations = AllocationCounter::getAllocations();
+        const size_t bytes = AllocationCounter::getLiveBytes();
+        const auto start = Clock::now();
+        spawn(scene);
+        result.ms = std::min(result.ms, std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        result.allocations = AllocationCounter::getAllocations() - allocations;
+        result.bytes = AllocationCounter::getLiveBytes() - bytes;
+    }
+    return result;
+}
+
+void printResult(const char* method, const SpawnResult& result) {
+    std::printf("%-18s %10.1f %12.2f %14.1f %14.1f\n", method, result.ms,
+                PartCount * InstanceCount / result.ms / 1000.0, static_cast<double>(result.allocations) / InstanceCount,
+                result.bytes / 1024.0 / InstanceCount);
+}
+
+}
+
+RC_BENCHMARK(PrefabSpawn) {
+    const scene::Prefab prefab = buildModel();
+    const std::vector<glm::vec3> positions = spawnPoints();
+    
+    // What spawning looked like before prefabs: each part created on its own,
+    // every string looked up again by its text.
+    scene::Scene source;
+    std::vector<entt::entity> parts;
+    prefab.instantiate(source, glm::vec3(0.0f)).swap(parts);
+    const auto& sourceRegistry = source.registry();
+    const SpawnResult copied = measureSpawn([&](scene::Scene& scene) {
+        auto& registry = scene.registry();
+        for (const glm::vec3& position : positions) {
+            for (const entt::entity part : parts) {
+                const entt::entity entity = registry.create();
+                const auto& transform = sourceRegistry.get<scene::TransformComponent>(part);
+                registry.emplace<scene::TransformComponent>(entity, transform.position + position);
+                const auto& name = sourceRegistry.get<scene::NameComponent>(part);
+                registry.emplace<scene::NameComponent>(entity, name.name.str());
+                const auto& sourceMesh = sourceRegistry.get<scene::MeshRendererComponent>(part);
+                auto& mesh = registry.emplace<scene::MeshRendererComponent>(entity);
+                mesh.meshPath = sourceMesh.meshPath.str();
+                mesh.materialPath = sourceMesh.materialPath.str();
+                if (const auto* script = sourceRegistry.try_get<scene::ScriptComponent>(part)) {
+                    registry.emplace<scene::ScriptComponent>(entity, script->scriptPath.str());
+                }
+            }
+        }
+    });
+    
+    std::vector<entt::entity> created;
+    const SpawnResult instanced = measureSpawn([&](scene::Scene& scene) {
+        prefab.instantiate(scene, positions, &created);
+        created = {};
+    });
+    
+    std::printf("%d instances of a %d-part model\n", InstanceCount, PartCount);
+    std::printf("%-18s %10s %12s %14s %14s\n", "method", "ms", "Mparts/s", "allocs/inst", "KB/inst");
+    printResult("copy per part", copied);
+    printResult("Prefab bulk", instanced);
+}
@@ -0,0 +1,103 @@
+#include "Benchmark.hpp"
+#include "core/JobSystem.hpp"
+#include "scene/Scene.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace roblox_clone;
+using namespace roblox_clone::benchmarks;
+
+namespace {
+
+constexpr size_t PartCount = 100000;
+constexpr size_t RayCount = 200000;
+constexpr float WorldSize = 2000.0f;
+
+void buildCity(scene::Scene& scene) {
+    auto& registry = scene.registry();
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> coordinate(0.0f, WorldSize);
+    std::uniform_real_distribution<float> size(1.0f, 12.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 360.0f);
+    
+    std::vector<entt::entity> parts(PartCount);
+    registry.create(parts.begin(), parts.end());
+    for (entt::entity entity : parts) {
+        scene::TransformComponent transform(glm::vec3(coordinate(random), size(random), coordinate(random)));
+        transform.rotation = glm::vec3(0.0f, angle(random), 0.0f);
+        transform.scale = glm::vec3(size(random), size(random) * 2.0f, size(random));
+        registry.emplace<scene::TransformComponent>(entity, transform);
+        registry.emplace<scene::MeshRendererComponent>(entity);
+    }
+}
+
+}
+
+RC_BENCHMARK(RaycastScene) {
+    scene::Scene scene;
+    buildCity(scene);
+    auto& raycaster = scene.getRaycaster();
+    
+    double buildMs = measureMs([&scene]() {
+        scene.getRaycaster().clear();
+        scene.updateRaycaster();
+    }, 3);
+    // Moving any part refits; never fall back to a rebuild here.
+    raycaster.setSettings({ ~0u });
+    const entt::entity mover = *scene.renderables().begin();
+    double refitMs = measureMs([&scene, mover]() {
+        scene.transformChanged(mover);
+        scene.updateRaycaster();
+    }, 3);
+    std::printf("%zu parts, %zu nodes, build %.2f ms, refit %.2f ms\n", raycaster.getStats().partCount,
+                raycaster.getStats().nodeCount, buildMs, refitMs);
+    
+    // Mostly grazing rays from eye height, like weapons and camera probes.
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> coordinate(0.0f, WorldSize);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<scene::RaycastRay> rays(RayCount);
+    for (auto& ray : rays) {
+        ray.origin = glm::vec3(coordinate(random), 5.0f, coordinate(random));
+        ray.direction = glm::vec3(unit(random), unit(random) * 0.2f, unit(random));
+        ray.maxDistance = 500.0f;
+    }
+    std::vector<scene::RaycastResult> results(RayCount);
+    
+    double singleMs = measureMs([&]() {
+        for (size_t i = 0; i < RayCount; ++i) {
+            results[i] = raycaster.raycast(rays[i].origin, rays[i].direction, rays[i].maxDistance);
+        }
+    }, 3);
+    size_t hits = static_cast<size_t>(std::count_if(results.begin(), results.end(),
+                                                    [](const scene::RaycastResult& hit) { return bool(hit); }));
+    
+    double sphereMs = measureMs([&]() {
+        for (size_t i = 0; i < RayCount / 10; ++i) {
+            results[i] = raycaster.spherecast(rays[i].origin, 1.0f, rays[i].direction, rays[i].maxDistance);
+        }
+    }, 3);
+    
+    std::printf("%zu rays, %.1f%% hit\n", RayCount, 100.0 * hits / RayCount);
+    std::printf("%-8s %-12s %12s %16s %16s\n", "threads", "cast", "time (ms)", "rays/s", "rays/s/core");
+    std::printf("%-8d %-12s %12.3f %16.0f %16.0f\n", 1, "ray", singleMs, RayCount / (singleMs * 1.0e-3),
+                RayCount / (singleMs * 1.0e-3));
+    std::printf("%-8d %-12s %12.3f %16.0f %16.0f\n", 1, "sphere r=1", sphereMs, RayCount / 10 / (sphereMs * 1.0e-3),
+                RayCount / 10 / (sphereMs * 1.0e-3));
+    
+    const int maxThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        auto& jobs = core::JobSystem::get();
+        jobs.initialize(threads - 1);
+        double batchMs = measureMs([&]() {
+            raycaster.raycastBatch(rays.data(), results.data(), RayCount);
+        }, 3);
+        const double raysPerSecond = RayCount / (batchMs * 1.0e-3);
+        std::printf("%-8d %-12s %12.3f %16.0f %16.0f\n", threads, "ray batch", batchMs, raysPerSecond,
+                    raysPerSecond / threads);
+        jobs.shutdown();
+    }
+}
@@ -0,0 +1,63 @@
+#include "Benchmark.hpp"
+#include "scene/Scene.hpp"
+#include "scene/SceneFile.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+using namespace roblox_clone;
+using namespace roblox_clone::benchmarks;
+
+namespace {
+
+// Named parts, half of them rendered with one of a few meshes.
+std::unique_ptr<scene::Scene> buildScene(size_t count) {
+    auto scene = std::make_unique<scene::Scene>();
+    auto& registry = scene->registry();
+    const char* meshes[] = { "meshes/cube.obj", "meshes/sphere.obj", "meshes/wedge.obj" };
+    for (size_t i = 0; i < count; ++i) {
+        entt::entity entity = registry.create();
+        registry.emplace<scene::TransformComponent>(entity, glm::vec3(static_cast<float>(i % 1000), 1.0f,
+                                                                      static_cast<float>(i / 1000)));
+        registry.emplace<scene::NameComponent>(entity, "Part");
+        if (i % 2 == 0) {
+            auto& mesh = registry.emplace<scene::MeshRendererComponent>(entity);
+            mesh.meshPath = meshes[i % 3];
+            mesh.materialPath = "materials/plastic.mat";
+        }
+        if (i % 10 == 0) {
+            registry.emplace<scene::NetworkComponent>(entity).networkId = static_cast<uint32_t>(i);
+        }
+    }
+    return scene;
+}
+
+}
+
+RC_BENCHMARK(SceneFile) {
+    const size_t counts[] = { 10000, 100000, 1000000 };
+    const std::string path = (std::filesystem::temp_directory_path() / "rc_bench.rcscene").string();
+    
+    std::printf("%-10s %10s %10s %10s %9s %9s %9s %9s\n", "entities", "MB", "save (ms)", "load (ms)", "map",
+                "reserve", "decode", "insert");
+    for (size_t count : counts) {
+        auto source = buildScene(count);
+        const double saveMs = measureMs([&]() { scene::saveScene(*source, path); }, 2);
+        source.reset();
+        
+        // Timed inside loadScene, so tearing the scene down is not counted.
+        scene::SceneLoadStats stats;
+        float loadMs = 1.0e30f;
+        for (int i = 0; i < 3; ++i) {
+            scene::Scene target;
+            scene::loadScene(target, path, &stats);
+            loadMs = std::min(loadMs, stats.totalMs);
+        }
+        
+        std::printf("%-10zu %10.1f %10.1f %10.1f %9.1f %9.1f %9.1f %9.1f\n", count, stats.fileBytes / 1.0e6, saveMs,
+                    loadMs, stats.mapMs, stats.reserveMs, stats.decodeMs, stats.insertMs);
+    }
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,94 @@
+#include "Benchmark.hpp"
+#include "core/JobSystem.hpp"
+#include "scene/Scene.hpp"
+#include <cstdio>
+#include <memory>
+
+using namespace roblox_clone;
+using namespace roblox_clone::benchmarks;
+
+namespace {
+
+// Every entity gets a transform, half are renderable and one in eight is a
+// bare entity with no components, like service or folder objects.
+std::unique_ptr<scene::Scene> buildScene(size_t count) {
+    auto scene = std::make_unique<scene::Scene>();
+    auto& registry = scene->registry();
+    for (size_t i = 0; i < count; ++i) {
+        if (i % 8 == 7) {
+            (void)registry.create();
+            continue;
+        }
+        entt::entity entity = registry.create();
+        registry.emplace<scene::TransformComponent>(entity, glm::vec3(static_cast<float>(i), 0.0f, 0.0f));
+        registry.emplace<scene::NameComponent>(entity, "Part");
+        if (i % 2 == 0) {
+            registry.emplace<scene::MeshRendererComponent>(entity);
+        }
+    }
+    return scene;
+}
+
+void nudge(scene::TransformComponent& transform) {
+    transform.position.y += 0.001f;
+}
+
+}
+
+RC_BENCHMARK(SceneIteration) {
+    core::JobSystem::get().initialize();
+    const size_t counts[] = { 10000, 100000, 1000000 };
+    
+    std::printf("%-10s %-32s %12s %14s\n", "entities", "method", "time (ms)", "ns/entity");
+    for (size_t count : counts) {
+        auto scene = buildScene(count);
+        auto& registry = scene->registry();
+        const double transforms = static_cast<double>(registry.storage<scene::TransformComponent>().size());
+        const double renderables = static_cast<double>(scene->renderables().size());
+        
+        auto report = [count](const char* method, double ms, double visited) {
+            std::printf("%-10zu %-32s %12.3f %14.2f\n", count, method, ms, ms * 1.0e6 / visited);
+        };
+        
+        // The old Scene::each: every entity, then a sparse all_of + get.
+        report("registry all_of + get", measureMs([&registry]() {
+            for (auto entity : registry.view<entt::entity>()) {
+                if (registry.all_of<scene::TransformComponent>(entity)) {
+                    nudge(registry.get<scene::TransformComponent>(entity));
+                }
+            }
+        }), transforms);
+        
+        report("each<Transform>", measureMs([&scene]() {
+            scene->each([](entt::entity, scene::TransformComponent& transform) { nudge(transform); });
+        }), transforms);
+        
+        report("parallelEach<Transform>", measureMs([&scene]() {
+            scene->parallelEach([](entt::entity, scene::TransformComponent& transform) { nudge(transform); });
+        }), transforms);
+        
+        report("view<Transform, MeshRenderer>", measureMs([&registry]() {
+            auto view = registry.view<scene::TransformComponent, scene::MeshRendererComponent>();
+            for (auto entity : view) {
+                auto [transform, meshRenderer] = view.get(entity);
+                if (meshRenderer.visible) nudge(transform);
+            }
+        }), renderables);
+        
+        report("eachRenderable (owning group)", measureMs([&scene]() {
+            scene->eachRenderable([](entt::entity, scene::TransformComponent& transform,
+                                     scene::MeshRendererComponent& meshRenderer) {
+                if (meshRenderer.visible) nudge(transform);
+            });
+        }), renderables);
+        
+        report("parallelEachRenderable", measureMs([&scene]() {
+            scene->parallelEachRenderable([](entt::entity, scene::TransformComponent& transform,
+                                             scene::MeshRendererComponent& meshRenderer) {
+                if (meshRenderer.visible) nudge(transform);
+            });
+        }), renderables);
+    }
+    
+    core::JobSystem::get().shutdown();
+}
@@ -0,0 +1,109 @@
+#include "Benchmark.hpp"
+#include "core/JobSystem.hpp"
+#include "scene/Scene.hpp"
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace roblox_clone;
+using namespace roblox_clone::benchmarks;
+
+namespace {
+
+constexpr size_t PartCount = 100000;
+constexpr size_t QueryCount = 10000;
+constexpr float WorldSize = 2000.0f;
+
+}
+
+RC_BENCHMARK(SpatialHashQueries) {
+    core::JobSystem::get().initialize();
+    
+    scene::Scene scene;
+    auto& registry = scene.registry();
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> coordinate(0.0f, WorldSize);
+    std::uniform_real_distribution<float> size(1.0f, 8.0f);
+    
+    std::vector<entt::entity> parts(PartCount);
+    registry.create(parts.begin(), parts.end());
+    for (entt::entity entity : parts) {
+        scene::TransformComponent transform(glm::vec3(coordinate(random), coordinate(random) * 0.05f, coordinate(random)));
+        transform.scale = glm::vec3(size(random), size(random), size(random));
+        registry.emplace<scene::TransformComponent>(entity, transform);
+        registry.emplace<scene::MeshRendererComponent>(entity);
+    }
+    
+    double buildMs = measureMs([&scene]() {
+        scene.getSpatialHash().markAllDirty();
+        scene.updateSpatialHash();
+    }, 1);
+    
+    std::vector<glm::vec3> points(QueryCount);
+    for (auto& point : points) {
+        point = glm::vec3(coordinate(random), 10.0f, coordinate(random));
+    }
+    
+    const auto& hash = scene.getSpatialHash();
+    size_t hits = 0;
+    auto runSerial = [&](auto&& query) {
+        return measureMs([&]() {
+            std::vector<entt::entity> results;
+            hits = 0;
+            for (const auto& point : points) {
+                results.clear();
+                query(point, results);
+                hits += results.size();
+            }
+        });
+    };
+    auto runParallel = [&](auto&& query) {
+        return measureMs([&]() {
+            core::JobSystem::get().parallelFor(points.size(), [&](size_t begin, size_t end) {
+                std::vector<entt::entity> results;
+                for (size_t i = begin; i < end; ++i) {
+                    results.clear();
+                    query(points[i], results);
+                }
+                doNotOptimize(results.size());
+            }, 64);
+        });
+    };
+    
+    auto radiusQuery = [&hash](const glm::vec3& point, std::vector<entt::entity>& results) {
+        hash.queryRadius(point, 20.0f, results);
+    };
+    auto boxQuery = [&hash](const glm::vec3& point, std::vector<entt::entity>& results) {
+        hash.queryBox(scene::Aabb::fromCenter(point, glm::vec3(20.0f)), results);
+    };
+    auto nearestQuery = [&hash](const glm::vec3& point, std::vector<entt::entity>& results) {
+        hash.queryNearest(point, 8, results);
+    };
+    
+    std::printf("%zu parts in %zu cells, full build %.3f ms\n", hash.size(), hash.getCellCount(), buildMs);
+    std::printf("%-20s %12s %12s %12s %14s\n", "10k queries", "serial (ms)", "us/query", "hits/query", "parallel (ms)");
+    
+    auto report = [&](const char* name, auto&& query) {
+        double serialMs = runSerial(query);
+        double parallelMs = runParallel(query);
+        std::printf("%-20s %12.3f %12.3f %12.1f %14.3f\n", name, serialMs, serialMs * 1000.0 / QueryCount,
+                    static_cast<double>(hits) / QueryCount, parallelMs);
+    };
+    report("radius 20", radiusQuery);
+    report("box 40x40x40", boxQuery);
+    report("nearest 8", nearestQuery);
+    
+    // Incremental upkeep: 1% of the parts move a little every frame.
+    double moveMs = measureMs([&]() {
+        for (size_t i = 0; i < PartCount; i += 100) {
+            auto& transform = registry.get<scene::TransformComponent>(parts[i]);
+            transform.position.x += 0.5f;
+            scene.transformChanged(parts[i]);
+        }
+        scene.updateSpatialHash();
+    });
+    std::printf("%-20s %12.3f ms for %zu moved parts, threads %d\n", "incremental sync", moveMs, PartCount / 100,
+                core::JobSystem::get().getThreadCount());
+    
+    core::JobSystem::get().shutdown();
+}
@@ -0,0 +1,88 @@
+#include "Benchmark.hpp"
+#include "scene/Scene.hpp"
+#include "scene/StreamingManager.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace roblox_clone;
+using namespace roblox_clone::benchmarks;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// A million parts on a 2 km square.
+void partitionWorld(const std::string& directory) {
+    scene::Scene world;
+    auto& registry = world.registry();
+    const char* meshes[] = { "meshes/cube.obj", "meshes/sphere.obj", "meshes/wedge.obj" };
+    for (int x = 0; x < 1000; ++x) {
+        for (int z = 0; z < 1000; ++z) {
+            const entt::entity entity = registry.create();
+            registry.emplace<scene::TransformComponent>(entity, glm::vec3(x * 2.0f, 1.0f, z * 2.0f));
+            registry.emplace<scene::NameComponent>(entity, "Part");
+            registry.emplace<scene::MeshRendererComponent>(entity).meshPath = meshes[(x + z) % 3];
+        }
+    }
+    scene::partitionScene(world, directory, 128.0f);
+}
+
+}
+
+RC_BENCHMARK(WorldStreaming) {
+    const std::string directory = (std::filesystem::temp_directory_path() / "rc_bench_world").string();
+    std::filesystem::remove_all(directory);
+    auto start = Clock::now();
+    partitionWorld(directory);
+    std::printf("partitioned 1000000 parts in %.0f ms\n\n", elapsedMs(start));
+    
+    std::printf("%-8s %10s %12s %10s %12s %14s %14s\n", "radius", "cells", "entities", "MB", "settle (ms)",
+                "update (us)", "worst add (ms)");
+    for (float radius : { 128.0f, 256.0f, 512.0f }) {
+        scene::Scene scene;
+        scene::StreamingSettings settings;
+        settings.loadRadius = radius;
+        settings.unloadRadius = radius * 1.25f;
+        settings.maxPendingLoads = 8;
+        scene::StreamingManager streaming(scene, settings);
+        streaming.open(directory);
+        
+        // Time until everything around a camera in the middle is resident.
+        const std::vector<glm::vec3> center = { glm::vec3(1000.0f, 0.0f, 1000.0f) };
+        start = Clock::now();
+        do {
+            streaming.update(center);
+            std::this_thread::yield();
+        } while (!streaming.isIdle());
+        const double settleMs = elapsedMs(start);
+        const auto settled = streaming.getStats();
+        
+        // Then fly across the world, one update per step, and keep the
+        // average update and the slowest batch of cells added to the scene.
+        double updateMs = 0.0;
+        float worstAddMs = 0.0f;
+        const int steps = 400;
+        for (int i = 0; i < steps; ++i) {
+            const std::vector<glm::vec3> camera = { glm::vec3(1000.0f + i * 2.0f, 0.0f, 1000.0f + i) };
+            const auto updateStart = Clock::now();
+            streaming.update(camera);
+            updateMs += elapsedMs(updateStart);
+            worstAddMs = std::max(worstAddMs, streaming.getStats().instantiateMs);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        
+        std::printf("%-8.0f %4zu/%-5zu %12zu %10.1f %12.1f %14.1f %14.2f\n", radius, settled.loadedCells,
+                    settled.cellCount, settled.residentEntities, settled.residentBytes / 1.0e6, settleMs,
+                    updateMs * 1000.0 / steps, worstAddMs);
+    }
+    std::filesystem::remove_all(directory);
+}
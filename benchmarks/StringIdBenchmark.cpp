@@ -0,0 +1,118 @@
+#include "Benchmark.hpp"
+#include "core/StringInterner.hpp"
+#include "scene/Scene.hpp"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace roblox_clone;
+using namespace roblox_clone::benchmarks;
+
+namespace {
+
+constexpr size_t PartCount = 1000000;
+
+// The components as they were with std::string fields.
+struct StringName {
+    std::string name;
+};
+
+struct StringMeshRenderer {
+    std::string meshPath;
+    std::string materialPath;
+    bool visible = true;
+    bool castShadows = true;
+    bool receiveShadows = true;
+    bool isStatic = false;
+};
+
+struct StringScript {
+    std::string scriptPath;
+    bool enabled = true;
+};
+
+std::string partName(size_t i) {
+    return "Workspace_Model_Part_" + std::to_string(i % 5000);
+}
+
+std::string meshPath(size_t i) {
+    return "assets/models/buildings/meshes/wall_" + std::to_string(i % 64) + ".obj";
+}
+
+// Heap bytes a std::string holds beyond its own size.
+size_t heapBytes(const std::string& value) {
+    return value.capacity() > 15 ? value.capacity() + 1 : 0;
+}
+
+}
+
+RC_BENCHMARK(StringIdFootprint) {
+    std::vector<StringName> stringNames(PartCount);
+    std::vector<StringMeshRenderer> stringMeshes(PartCount);
+    std::vector<scene::NameComponent> names(PartCount);
+    std::vector<scene::MeshRendererComponent> meshes(PartCount);
+    size_t heap = 0;
+    for (size_t i = 0; i < PartCount; ++i) {
+        stringNames[i].name = partName(i);
+        stringMeshes[i].meshPath = meshPath(i);
+        stringMeshes[i].materialPath = "assets/materials/concrete.mat";
+        heap += heapBytes(stringNames[i].name) + heapBytes(stringMeshes[i].meshPath) +
+                heapBytes(stringMeshes[i].materialPath);
+        names[i].name = stringNames[i].name;
+        meshes[i].meshPath = stringMeshes[i].meshPath;
+        meshes[i].materialPath = stringMeshes[i].materialPath;
+    }
+    
+    std::printf("%-16s %12s %12s\n", "component", "string (B)", "id (B)");
+    std::printf("%-16s %12zu %12zu\n", "Name", sizeof(StringName), sizeof(scene::NameComponent));
+    std::printf("%-16s %12zu %12zu\n", "MeshRenderer", sizeof(StringMeshRenderer),
+                sizeof(scene::MeshRendererComponent));
+    std::printf("%-16s %12zu %12zu\n", "Script", sizeof(StringScript), sizeof(scene::ScriptComponent));
+    
+    const size_t stringBytes = PartCount * (sizeof(StringName) + sizeof(StringMeshRenderer)) + heap;
+    const size_t idBytes = PartCount * (sizeof(scene::NameComponent) + sizeof(scene::MeshRendererComponent));
+    std::printf("\n%zu named meshes: strings %.1f MB (%.1f MB on the heap), ids %.1f MB + %.2f MB interned\n",
+                PartCount, stringBytes / 1.0e6, heap / 1.0e6, idBytes / 1.0e6,
+                core::StringInterner::get().getMemoryBytes() / 1.0e6);
+}
+
+RC_BENCHMARK(StringIdCompare) {
+    std::vector<std::string> strings(PartCount);
+    std::vector<core::StringId> ids(PartCount);
+    for (size_t i = 0; i < PartCount; ++i) {
+        strings[i] = partName(i);
+        ids[i] = strings[i];
+    }
+    
+    // Names share a long prefix, as they do in real models.
+    const std::string target = partName(4321);
+    size_t matches = 0;
+    const double stringMs = measureMs([&]() {
+        matches = 0;
+        for (const std::string& value : strings) {
+            matches += value == target;
+        }
+        doNotOptimize(matches);
+    });
+    const core::StringId targetId = core::StringId::find(target);
+    const double idMs = measureMs([&]() {
+        matches = 0;
+        for (const core::StringId value : ids) {
+            matches += value == targetId;
+        }
+        doNotOptimize(matches);
+    });
+    
+    // Views walk the newest entities first, so the match is the oldest.
+    scene::Scene scene;
+    scene.createEntity("SpawnLocation");
+    for (size_t i = 0; i < PartCount; ++i) {
+        scene.registry().emplace<scene::NameComponent>(scene.registry().create(), strings[i]);
+    }
+    const double lookupMs = measureMs([&]() { doNotOptimize(scene.getEntityByName("SpawnLocation")); });
+    
+    std::printf("%-16s %12s %14s\n", "compare", "ms", "Mcompares/s");
+    std::printf("%-16s %12.2f %14.0f\n", "std::string", stringMs, PartCount / stringMs / 1000.0);
+    std::printf("%-16s %12.2f %14.0f\n", "StringId", idMs, PartCount / idMs / 1000.0);
+    std::printf("\ngetEntityByName over %zu names: %.2f ms\n", PartCount, lookupMs);
+}
@@ -0,0 +1,167 @@
+#include "Benchmark.hpp"
+#include "scene/Scene.hpp"
+#include "scene/TransformBatch.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace roblox_clone;
+using namespace roblox_clone::benchmarks;
+
+namespace {
+
+constexpr size_t TransformCount = 1000000;
+// One part in this many moves per step in the resident frame.
+constexpr size_t MovingStride = 100;
+
+double perMicrosecond(double ms) {
+    return TransformCount / (ms * 1000.0);
+}
+
+// What Renderer::computeModelMatrix(previous, current, alpha) does for one
+// entity.
+glm::mat4 interpolatedMatrix(const scene::TransformComponent& previous, const scene::TransformComponent& current,
+                             float alpha) {
+    auto toQuat = [](const glm::vec3& degrees) {
+        const glm::vec3 radians = glm::radians(degrees);
+        return glm::angleAxis(radians.x, glm::vec3(1, 0, 0)) *
+               glm::angleAxis(radians.y, glm::vec3(0, 1, 0)) *
+               glm::angleAxis(radians.z, glm::vec3(0, 0, 1));
+    };
+    
+    glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::mix(previous.position, current.position, alpha));
+    model *= glm::mat4_cast(glm::slerp(toQuat(previous.rotation), toQuat(current.rotation), alpha));
+    return glm::scale(model, glm::mix(previous.scale, current.scale, alpha));
+}
+
+}
+
+RC_BENCHMARK(TransformBatch) {
+    scene::Scene scene;
+    auto& registry = scene.registry();
+    std::mt19937 random(3);
+    std::uniform_real_distribution<float> unit(-100.0f, 100.0f);
+    for (size_t i = 0; i < TransformCount; ++i) {
+        const entt::entity entity = registry.create();
+        auto& transform = registry.emplace<scene::TransformComponent>(entity, glm::vec3(unit(random), unit(random),
+                                                                                        unit(random)));
+        transform.rotation = glm::vec3(unit(random), unit(random), unit(random));
+        registry.emplace<scene::PreviousTransformComponent>(entity).transform = transform;
+    }
+    const auto& storage = registry.storage<scene::TransformComponent>();
+    const entt::entity* entities = storage.data();
+    std::vector<glm::mat4> matrices(TransformCount);
+    
+    // What the renderer did per entity: three axis rotations from degrees.
+    const double eulerMs = measureMs([&]() {
+        for (size_t i = 0; i < TransformCount; ++i) {
+            const auto& transform = storage.get(entities[i]);
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), transform.position);
+            model = glm::rotate(model, glm::radians(transform.rotation.x), glm::vec3(1, 0, 0));
+            model = glm::rotate(model, glm::radians(transform.rotation.y), glm::vec3(0, 1, 0));
+            model = glm::rotate(model, glm::radians(transform.rotation.z), glm::vec3(0, 0, 1));
+            matrices[i] = glm::scale(model, transform.scale);
+        }
+        doNotOptimize(matrices.data());
+    }, 3);
+    
+    scene::TransformBatch current;
+    scene::TransformBatch previous;
+    scene::TransformBatch blended;
+    const double gatherMs = measureMs([&]() { current.gather(registry, entities, TransformCount); }, 3);
+    previous.gatherPrevious(registry, entities, TransformCount);
+    std::printf("%zu transforms: per-entity Euler matrices %.2f /us, gather into SoA %.2f /us\n\n", TransformCount,
+                perMicrosecond(eulerMs), perMicrosecond(gatherMs));
+    
+    const glm::mat4 viewProjection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f) *
+                                     glm::lookAt(glm::vec3(0.0f, 10.0f, 150.0f), glm::vec3(0.0f), glm::vec3(0, 1, 0));
+    std::vector<uint8_t> visible(TransformCount);
+    std::printf("%-8s %16s %18s %14s\n", "kernel", "matrices/us", "interpolated/us", "culled/us");
+    for (core::SimdKernel kernel : { core::SimdKernel::Scalar, core::SimdKernel::Sse, core::SimdKernel::Avx2 }) {
+        if (!scene::isTransformKernelSupported(kernel)) continue;
+        const double composeMs = measureMs([&]() {
+            scene::composeMatrices(current, matrices.data(), kernel);
+            doNotOptimize(matrices.data());
+        });
+        const double interpolateMs = measureMs([&]() {
+            scene::interpolateTransforms(previous, current, 0.5f, blended, kernel);
+            doNotOptimize(blended.data(scene::TransformBatch::PositionX));
+        });
+        const double cullMs = measureMs([&]() {
+            scene::cullTransforms(current, viewProjection, visible.data(), kernel);
+            doNotOptimize(visible.data());
+        });
+        std::printf("%-8s %16.1f %18.1f %14.1f\n", core::getKernelName(kernel), perMicrosecond(composeMs),
+                    perMicrosecond(interpolateMs), perMicrosecond(cullMs));
+    }
+    
+    // A whole interpolated frame as Renderer::prepareTransforms runs it,
+    // against the per-entity path it replaced. Transforms stay in the
+    // registry as components, so the batch is filled from them every frame;
+    // the gather share is the most that keeping them in SoA form inside the
+    // registry could save.
+    const double perEntityMs = measureMs([&]() {
+        for (size_t i = 0; i < TransformCount; ++i) {
+            const auto& transform = storage.get(entities[i]);
+            const auto* previousTransform = registry.try_get<scene::PreviousTransformComponent>(entities[i]);
+            matrices[i] = interpolatedMatrix(previousTransform->transform, transform, 0.5f);
+        }
+        doNotOptimize(matrices.data());
+    }, 3);
+    const double bothGathersMs = measureMs([&]() {
+        current.gather(registry, entities, TransformCount);
+        previous.gatherPrevious(registry, entities, TransformCount);
+    }, 3);
+    const double batchedMs = measureMs([&]() {
+        current.gather(registry, entities, TransformCount);
+        previous.gatherPrevious(registry, entities, TransformCount);
+        scene::interpolateTransforms(previous, current, 0.5f, current);
+        scene::composeMatrices(current, matrices.data());
+        doNotOptimize(matrices.data());
+    }, 3);
+    std::printf("\ninterpolated frame: per-entity %.2f ms, batched %.2f ms (%.1fx), of which gathering %.2f ms "
+                "(%.0f%%)\n", perEntityMs, batchedMs, perEntityMs / batchedMs, bothGathersMs,
+                100.0 * bothGathersMs / batchedMs);
+    
+    // The frame as the renderer runs it now: the scene's batch stays resident
+    // and reloads the blocks of the parts the step moved, which are also the
+    // only ones blended.
+    std::vector<entt::entity> moving;
+    for (size_t i = 0; i < TransformCount; i += MovingStride) {
+        moving.push_back(entities[i]);
+    }
+    scene.updateTransformBatch();
+    scene.beginSimulationStep();
+    for (entt::entity entity : moving) {
+        registry.patch<scene::TransformComponent>(entity, [](scene::TransformComponent& transform) {
+            transform.position.y += 0.1f;
+        });
+    }
+    scene.endSimulationStep();
+    auto moveParts = [&]() {
+        for (entt::entity entity : moving) {
+            registry.patch<scene::TransformComponent>(entity);
+        }
+    };
+    const double syncMs = measureMs([&]() {
+        moveParts();
+        scene.updateTransformBatch();
+    }, 3);
+    const std::vector<entt::entity>& stepped = scene.getSteppedParts();
+    std::vector<glm::mat4> blendedMatrices(stepped.size());
+    const double residentMs = measureMs([&]() {
+        moveParts();
+        scene::composeMatrices(scene.updateTransformBatch(), matrices.data());
+        current.gather(registry, stepped.data(), stepped.size());
+        previous.gatherPrevious(registry, stepped.data(), stepped.size());
+        scene::interpolateTransforms(previous, current, 0.5f, current);
+        scene::composeMatrices(current, blendedMatrices.data());
+        for (size_t i = 0; i < stepped.size(); ++i) {
+            matrices[storage.index(stepped[i])] = blendedMatrices[i];
+        }
+        doNotOptimize(matrices.data());
+    }, 3);
+    std::printf("resident frame, %zu parts moved: %.2f ms (%.1fx the batched frame), of which syncing %.2f ms\n",
+                stepped.size(), residentMs, batchedMs / residentMs, syncMs);
+}
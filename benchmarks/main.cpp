@@ -0,0 +1,34 @@
+#include "Benchmark.hpp"
+#include "core/Logger.hpp"
+#include <cstdio>
+#include <cstring>
+
+using namespace roblox_clone;
+
+int main(int argc, char* argv[]) {
+    core::Logger::init();
+    core::Logger::setLevel(spdlog::level::warn);
+    
+    int ran = 0;
+    for (const auto& benchmark : benchmarks::getBenchmarks()) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; ++i) {
+            if (std::strstr(benchmark.name, argv[i])) selected = true;
+        }
+        if (!selected) continue;
+        
+        std::printf("== %s ==\n", benchmark.name);
+        benchmark.function();
+        std::printf("\n");
+        ++ran;
+    }
+    
+    if (ran == 0) {
+        std::printf("No benchmarks matched. Available:\n");
+        for (const auto& benchmark : benchmarks::getBenchmarks()) {
+            std::printf("  %s\n", benchmark.name);
+        }
+        return 1;
+    }
+    return 0;
+}
@@ -1,12 +1,53 @@
 #include "Application.hpp"
 #include "Logger.hpp"
+#include "FrameAllocator.hpp"
+#include "JobSystem.hpp"
+#include "Profiler.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <csignal>
+#include <limits>
+#include <stdexcept>
+#include <thread>
 
 namespace roblox_clone::core {
 
 Application* Application::s_instance = nullptr;
 
+namespace {
+
+volatile std::sig_atomic_t s_stopSignal = 0;
+
+void handleStopSignal(int) {
+    s_stopSignal = 1;
+}
+
+// Parses all of text as an integer within [min, max]. Logs and returns false
+// otherwise, including for trailing characters such as "60abc".
+bool parseOption(const std::string& option, const char* text, long long min, long long max, long long& value) {
+    size_t end = 0;
+    try {
+        value = std::stoll(text, &end);
+    } catch (const std::invalid_argument&) {
+        end = 0;
+    } catch (const std::out_of_range&) {
+        RC_ERROR("Invalid value for {}: '{}' is out of range", option, text);
+        return false;
+    }
+    if (end == 0 || text[end] != '\0') {
+        RC_ERROR("Invalid value for {}: '{}' is not a number", option, text);
+        return false;
+    }
+    if (value < min || value > max) {
+        RC_ERROR("Invalid value for {}: {} is not between {} and {}", option, text, min, max);
+        return false;
+    }
+    return true;
+}
+
+}
+
 Application::~Application() {
     close();
 }
@@ -14,33 +55,120 @@ Application::~Application() {
 bool Application::initialize(int argc, char* argv[]) {
     s_instance = this;
     
-    processCommandLine(argc, argv);
     loadConfig("config.json");
+    if (!processCommandLine(argc, argv)) {
+        return false;
+    }
     
     RC_INFO("Initializing Roblox Clone Engine v0.1.0");
     
-    m_window = std::make_unique<renderer::Window>();
-    if (!m_window->initialize(m_config.title, m_config.width, m_config.height, m_config.fullscreen)) {
-        RC_ERROR("Failed to initialize window");
-        return false;
+    Profiler::get().setEnabled(m_config.profiling || !m_config.traceFile.empty());
+    Profiler::get().setThreadName("Main");
+    JobSystem::get().initialize(m_config.workerThreads);
+    JobSystem::get().setDeterministic(m_config.deterministic);
+    
+    if (m_config.headless) {
+        RC_INFO("Running headless at {} Hz", m_config.tickRate);
+        m_config.editorMode = false;
+    }
+    if (m_config.deterministic) {
+        RC_INFO("Deterministic simulation (random seed {})", m_config.randomSeed);
     }
     
-    m_renderer = std::make_unique<renderer::Renderer>();
-    if (!m_renderer->initialize(m_window.get())) {
-        RC_ERROR("Failed to initialize renderer");
-        return false;
+#ifndef ROBLOX_CLONE_DEDICATED_SERVER
+    if (m_config.headless) {
+        if (m_config.nullRenderer) {
+            m_renderer = std::make_unique<renderer::Renderer>();
+            if (!m_renderer->initializeHeadless(m_config.width, m_config.height)) {
+                RC_ERROR("Failed to initialize headless renderer");
+                return false;
+            }
+        }
+    } else {
+        m_window = std::make_unique<renderer::Window>();
+        if (!m_window->initialize(m_config.title, m_config.width, m_config.height, m_config.fullscreen)) {
+            RC_ERROR("Failed to initialize window");
+            return false;
+        }
+        
+        m_window->setVSync(m_config.vsync);
+        
+        m_renderer = std::make_unique<renderer::Renderer>();
+        if (!m_renderer->initialize(m_window.get())) {
+            RC_ERROR("Failed to initialize renderer");
+            return false;
+        }
+        
+        if (auto* dynamicResolution = m_renderer->getBackend()->getDynamicResolution()) {
+            renderer::DynamicResolutionSettings settings;
+            settings.enabled = m_config.dynamicResolution;
+            settings.targetFrameTimeMs = 1000.0f / m_config.targetFrameRate;
+            dynamicResolution->setSettings(settings);
+        }
     }
+#endif
+    
+    FixedTimestepSettings timestepSettings;
+    timestepSettings.stepRate = m_config.tickRate > 0 ? m_config.tickRate : timestepSettings.stepRate;
+    timestepSettings.maxStepsPerFrame = m_config.maxSimulationSteps;
+    m_timestep.setSettings(timestepSettings);
     
     m_scene = std::make_unique<scene::Scene>();
+    m_physics = std::make_unique<physics::PhysicsWorld>();
+    m_physics->attach(*m_scene);
+    
+    if (m_config.rollbackFrames > 0) {
+        m_snapshots = std::make_unique<scene::SnapshotHistory>(static_cast<size_t>(m_config.rollbackFrames));
+        m_snapshots->track<scene::TransformComponent, scene::PreviousTransformComponent, scene::NetworkComponent,
+                           physics::RigidBodyComponent>();
+        m_physicsStates.resize(static_cast<size_t>(m_config.rollbackFrames));
+    }
+    
+    if (!m_config.streamingPath.empty()) {
+        scene::StreamingSettings streamingSettings;
+        streamingSettings.loadRadius = m_config.streamingRadius;
+        streamingSettings.unloadRadius = m_config.streamingRadius * 1.25f;
+        streamingSettings.memoryBudget = static_cast<size_t>(std::max(m_config.streamingBudgetMB, 1)) << 20;
+        m_streaming = std::make_unique<scene::StreamingManager>(*m_scene, streamingSettings);
+        if (!m_streaming->open(m_config.streamingPath)) {
+            RC_ERROR("Failed to open streamed world: {}", m_config.streamingPath);
+            return false;
+        }
+    }
     
     m_scriptEngine = std::make_unique<scripting::ScriptEngine>();
     if (!m_scriptEngine->initialize()) {
         RC_ERROR("Failed to initialize script engine");
         return false;
     }
+    m_scriptEngine->registerSceneAPI(m_scene.get());
+    if (m_config.deterministic) {
+        m_scriptEngine->seedRandom(m_config.randomSeed);
+    }
     
     m_networkManager = std::make_unique<network::NetworkManager>();
     
+    if (m_config.server) {
+        network::ServerConfig serverConfig;
+        serverConfig.port = m_config.port;
+        serverConfig.maxClients = m_config.maxClients;
+        serverConfig.tickRate = m_config.tickRate > 0 ? m_config.tickRate : serverConfig.tickRate;
+        
+        m_server = std::make_unique<network::Server>();
+        if (!m_server->initialize(serverConfig)) {
+            RC_ERROR("Failed to start server on port {}", m_config.port);
+            return false;
+        }
+        m_server->setScene(m_scene.get());
+    } else if (!m_config.connectHost.empty()) {
+        m_client = std::make_unique<network::Client>();
+        m_client->setScene(m_scene.get());
+        if (!m_client->initialize() || !m_client->connect(m_config.connectHost, m_config.port)) {
+            RC_ERROR("Failed to join server {}:{}", m_config.connectHost, m_config.port);
+            return false;
+        }
+    }
+    
 #ifdef ROBLOX_CLONE_BUILD_EDITOR
     if (m_config.editorMode) {
         m_editor = std::make_unique<editor::Editor>();
@@ -57,6 +185,14 @@ bool Application::initialize(int argc, char* argv[]) {
 }
 
 int Application::run() {
+    if (m_config.headless) {
+        return runHeadless();
+    }
+    
+#ifdef ROBLOX_CLONE_DEDICATED_SERVER
+    return 0;
+#else
+    
     auto lastTime = std::chrono::high_resolution_clock::now();
     
     while (m_running && !m_window->shouldClose()) {
@@ -64,49 +200,238 @@ int Application::run() {
         float deltaTime = std::chrono::duration<float>(currentTime - lastTime).count();
         lastTime = currentTime;
         
-        m_window->pollEvents();
-        
-        m_scene->update(deltaTime);
-        
+        {
+            RC_PROFILE_SCOPE("Frame");
+            
+            m_window->pollEvents();
+            
+            int steps = m_timestep.advance(deltaTime);
+            for (int step = 0; step < steps; ++step) {
+                tick(m_timestep.getStepSeconds());
+            }
+            
 #ifdef ROBLOX_CLONE_BUILD_EDITOR
-        if (m_editor) {
-            m_editor->beginFrame();
-            m_editor->render(m_scene.get(), deltaTime);
-            m_editor->endFrame();
-        }
+            if (m_editor) {
+                RC_PROFILE_SCOPE("Editor");
+                m_editor->beginFrame();
+                m_editor->render(m_scene.get(), deltaTime);
+                m_editor->renderViewport();
+            }
 #endif
-        
-        m_renderer->beginFrame();
-        m_renderer->render(m_scene.get());
-        
+            
+            {
+                RC_PROFILE_SCOPE("Render");
+                m_renderer->beginFrame();
+                m_renderer->render(m_scene.get(), m_timestep.getAlpha());
+                m_renderer->endFrame();
+            }
+            
 #ifdef ROBLOX_CLONE_BUILD_EDITOR
-        if (m_editor) {
-            m_renderer->renderEditorOverlay(m_editor.get());
+            if (m_editor) {
+                RC_PROFILE_SCOPE("Editor::endFrame");
+                m_editor->endFrame();
+            }
+#endif
+            
+            RC_PROFILE_SCOPE("SwapBuffers");
+            m_window->swapBuffers();
         }
+        
+        FrameAllocator::endFrame();
+        Profiler::get().endFrame();
+    }
+    
+    return 0;
+#endif
+}
+
+int Application::runHeadless() {
+    using Clock = std::chrono::steady_clock;
+    
+    std::signal(SIGINT, handleStopSignal);
+    std::signal(SIGTERM, handleStopSignal);
+    
+    const bool throttled = m_config.tickRate > 0;
+    const float fixedDelta = m_timestep.getStepSeconds();
+    const auto tickInterval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(fixedDelta));
+    
+    auto startTime = Clock::now();
+    auto nextTick = startTime;
+    uint64_t ticks = 0;
+    
+    while (m_running && !s_stopSignal) {
+        {
+            RC_PROFILE_SCOPE("Frame");
+            tick(fixedDelta);
+            
+#ifndef ROBLOX_CLONE_DEDICATED_SERVER
+            if (m_renderer) {
+                RC_PROFILE_SCOPE("Render");
+                m_renderer->beginFrame();
+                m_renderer->render(m_scene.get());
+                m_renderer->endFrame();
+            }
 #endif
+        }
+        FrameAllocator::endFrame();
+        Profiler::get().endFrame();
+        
+        ++ticks;
+        if (m_config.maxTicks > 0 && ticks >= m_config.maxTicks) {
+            break;
+        }
         
-        m_renderer->endFrame();
-        m_window->swapBuffers();
+        if (throttled) {
+            nextTick += tickInterval;
+            auto now = Clock::now();
+            if (nextTick > now) {
+                std::this_thread::sleep_until(nextTick);
+            } else if (now - nextTick > tickInterval * 5) {
+                nextTick = now;
+            }
+        }
+    }
+    
+    float elapsed = std::chrono::duration<float>(Clock::now() - startTime).count();
+    RC_INFO("Headless run finished: {} ticks in {:.2f}s ({:.1f} ticks/s)", ticks, elapsed,
+            elapsed > 0.0f ? static_cast<float>(ticks) / elapsed : 0.0f);
+    RC_INFO("Frame arenas: peak {} bytes per frame, {} bytes reserved", FrameAllocator::getStats().peakFrameBytes,
+            FrameAllocator::getStats().capacityBytes);
+    if (m_config.deterministic) {
+        RC_INFO("State hash after tick {}: {:016x}", m_simulationTick, m_stateHash);
+    }
+    if (m_snapshots) {
+        const auto& stats = m_snapshots->getStats();
+        RC_INFO("Rollback snapshots: {} bytes per tick, {} bytes reserved, last save {:.1f} us, last restore {:.1f} us",
+                stats.frameBytes, stats.reservedBytes, stats.saveUs, stats.restoreUs);
     }
+    if (m_streaming) {
+        const auto stats = m_streaming->getStats();
+        RC_INFO("Streaming: {}/{} cells resident, {} entities, {} bytes, {} loads, {} unloads", stats.loadedCells,
+                stats.cellCount, stats.residentEntities, stats.residentBytes, stats.loads, stats.unloads);
+    }
+    
+#ifndef ROBLOX_CLONE_DEDICATED_SERVER
+    if (m_renderer) {
+        const auto& stats = m_renderer->getBackend()->getStats();
+        RC_INFO("Render submission: {} frames, {} draw packets, {} shadow casters", stats.frameCount,
+                stats.packetCount, stats.shadowCasterCount);
+    }
+#endif
     
     return 0;
 }
 
+void Application::tick(float deltaTime) {
+    RC_PROFILE_SCOPE("Tick");
+    if (m_server) {
+        m_server->tick();
+    }
+    if (m_client) {
+        m_client->update();
+    }
+    
+    updateStreaming();
+    simulate(deltaTime);
+    
+    if (m_config.deterministic && m_server) {
+        m_server->broadcastStateHash(m_simulationTick, m_stateHash);
+    }
+    if (m_config.deterministic && m_client) {
+        m_client->recordStateHash(m_simulationTick, m_stateHash);
+    }
+    
+    // Everything written through Entity since the last tick, including the
+    // editor's edits between ticks, goes out once to scripts, the replicator
+    // and the editor.
+    m_scene->dispatchChanges();
+}
+
+void Application::updateStreaming() {
+    if (!m_streaming) return;
+    
+    std::vector<glm::vec3> focusPoints;
+#ifndef ROBLOX_CLONE_DEDICATED_SERVER
+    if (m_renderer && !m_server) {
+        focusPoints.push_back(m_renderer->getCamera().position);
+    }
+#endif
+    // Snapshots from before the world changed would destroy what streamed in,
+    // so rollback cannot reach past a streaming update that added or removed
+    // entities.
+    if (m_streaming->update(focusPoints) && m_snapshots) {
+        m_snapshots->clear();
+    }
+}
+
+// One tick of everything rollback replays. The snapshot is taken first, so
+// the frame for tick t holds the state tick t started from.
+void Application::simulate(float deltaTime) {
+    if (m_snapshots) {
+        m_snapshots->save(m_scene->registry(), m_simulationTick);
+        m_physics->saveState(m_physicsStates[m_simulationTick % m_physicsStates.size()]);
+    }
+    
+    m_scene->beginSimulationStep();
+    m_scriptEngine->update(deltaTime);
+    m_physics->step(deltaTime);
+    m_scene->update(deltaTime);
+    m_scene->endSimulationStep();
+    ++m_simulationTick;
+    
+    if (m_config.deterministic) {
+        m_stateHash = m_scene->computeStateHash();
+    }
+}
+
+bool Application::resimulate(uint32_t ticks, const std::function<void(uint64_t)>& beforeTick) {
+    RC_PROFILE_SCOPE("Resimulate");
+    if (!m_snapshots || ticks > m_simulationTick) return false;
+    
+    const uint64_t targetTick = m_simulationTick;
+    m_simulationTick -= ticks;
+    if (!m_snapshots->restore(*m_scene, m_simulationTick)) {
+        m_simulationTick = targetTick;
+        return false;
+    }
+    m_physics->restoreState(m_physicsStates[m_simulationTick % m_physicsStates.size()]);
+    
+    while (m_simulationTick < targetTick) {
+        if (beforeTick) {
+            beforeTick(m_simulationTick);
+        }
+        simulate(m_timestep.getStepSeconds());
+    }
+    return true;
+}
+
 void Application::close() {
     if (!m_running) return;
     
     RC_INFO("Shutting down engine...");
     m_running = false;
     
+    if (!m_config.traceFile.empty()) {
+        Profiler::get().exportChromeTrace(m_config.traceFile);
+    }
+    
 #ifdef ROBLOX_CLONE_BUILD_EDITOR
     m_editor.reset();
 #endif
     
+    m_server.reset();
+    m_client.reset();
     m_networkManager.reset();
     m_scriptEngine.reset();
+    m_streaming.reset();
+    m_physics.reset();
     m_scene.reset();
+#ifndef ROBLOX_CLONE_DEDICATED_SERVER
     m_renderer.reset();
     m_window.reset();
+#endif
+    
+    JobSystem::get().shutdown();
     
     s_instance = nullptr;
     RC_INFO("Engine shutdown complete");
@@ -120,20 +445,88 @@ bool Application::loadConfig(const std::string& filepath) {
         m_config.height = config.get<int>("height", m_config.height);
         m_config.fullscreen = config.get<bool>("fullscreen", m_config.fullscreen);
         m_config.vsync = config.get<bool>("vsync", m_config.vsync);
+        m_config.dynamicResolution = config.get<bool>("dynamicResolution", m_config.dynamicResolution);
+        m_config.targetFrameRate = config.get<float>("targetFrameRate", m_config.targetFrameRate);
         m_config.editorMode = config.get<bool>("editorMode", m_config.editorMode);
+        m_config.tickRate = config.get<int>("tickRate", m_config.tickRate);
+        m_config.maxSimulationSteps = config.get<int>("maxSimulationSteps", m_config.maxSimulationSteps);
+        m_config.connectHost = config.get<std::string>("connectHost", m_config.connectHost);
+        m_config.port = config.get<uint16_t>("port", m_config.port);
+        m_config.maxClients = config.get<int>("maxClients", m_config.maxClients);
+        m_config.profiling = config.get<bool>("profiling", m_config.profiling);
+        m_config.workerThreads = config.get<int>("workerThreads", m_config.workerThreads);
+        m_config.deterministic = config.get<bool>("deterministic", m_config.deterministic);
+        m_config.randomSeed = config.get<int64_t>("randomSeed", m_config.randomSeed);
+        m_config.rollbackFrames = config.get<int>("rollbackFrames", m_config.rollbackFrames);
+        m_config.streamingPath = config.get<std::string>("streamingPath", m_config.streamingPath);
+        m_config.streamingRadius = config.get<float>("streamingRadius", m_config.streamingRadius);
+        m_config.streamingBudgetMB = config.get<int>("streamingBudgetMB", m_config.streamingBudgetMB);
     }
     return true;
 }
 
-void Application::processCommandLine(int argc, char* argv[]) {
+bool Application::processCommandLine(int argc, char* argv[]) {
+#ifdef ROBLOX_CLONE_DEDICATED_SERVER
+    m_config.headless = true;
+    m_config.server = true;
+#endif
+    
+    constexpr long long IntMax = std::numeric_limits<int>::max();
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
+        long long value = 0;
         if (arg == "--no-editor") {
             m_config.editorMode = false;
         } else if (arg == "--fullscreen") {
             m_config.fullscreen = true;
+        } else if (arg == "--headless") {
+            m_config.headless = true;
+        } else if (arg == "--null-renderer") {
+            m_config.headless = true;
+            m_config.nullRenderer = true;
+        } else if (arg == "--tick-rate" && i + 1 < argc) {
+            if (!parseOption(arg, argv[++i], 0, IntMax, value)) return false;
+            m_config.tickRate = static_cast<int>(value);
+        } else if (arg == "--ticks" && i + 1 < argc) {
+            if (!parseOption(arg, argv[++i], 0, std::numeric_limits<long long>::max(), value)) return false;
+            m_config.maxTicks = static_cast<uint64_t>(value);
+        } else if (arg == "--server") {
+            m_config.server = true;
+        } else if (arg == "--connect" && i + 1 < argc) {
+            m_config.connectHost = argv[++i];
+        } else if (arg == "--port" && i + 1 < argc) {
+            if (!parseOption(arg, argv[++i], 1, std::numeric_limits<uint16_t>::max(), value)) return false;
+            m_config.port = static_cast<uint16_t>(value);
+        } else if (arg == "--workers" && i + 1 < argc) {
+            // -1 picks a count from the hardware and 0 runs jobs on the main
+            // thread; nothing lower means anything.
+            if (!parseOption(arg, argv[++i], -1, IntMax, value)) return false;
+            m_config.workerThreads = static_cast<int>(value);
+        } else if (arg == "--trace" && i + 1 < argc) {
+            m_config.traceFile = argv[++i];
+        } else if (arg == "--deterministic") {
+            m_config.deterministic = true;
+        } else if (arg == "--seed" && i + 1 < argc) {
+            if (!parseOption(arg, argv[++i], std::numeric_limits<long long>::min(),
+                             std::numeric_limits<long long>::max(), value)) {
+                return false;
+            }
+            m_config.deterministic = true;
+            m_config.randomSeed = static_cast<int64_t>(value);
+        } else if (arg == "--rollback" && i + 1 < argc) {
+            if (!parseOption(arg, argv[++i], 0, IntMax, value)) return false;
+            m_config.rollbackFrames = static_cast<int>(value);
+        } else if (arg == "--stream" && i + 1 < argc) {
+            m_config.streamingPath = argv[++i];
         }
     }
+    
+    // An unthrottled tick only makes sense without a window to present to.
+    if (m_config.tickRate == 0 && !m_config.headless) {
+        RC_ERROR("Invalid value for --tick-rate: 0 is only allowed with --headless");
+        return false;
+    }
+    return true;
 }
 
 }
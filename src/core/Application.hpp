@@ -1,18 +1,31 @@
 #pragma once
 
 #include "Config.hpp"
-#include "renderer/Window.hpp"
-#include "renderer/Renderer.hpp"
+#include "FixedTimestep.hpp"
 #include "scene/Scene.hpp"
+#include "scene/SnapshotHistory.hpp"
+#include "scene/StreamingManager.hpp"
+#include "physics/PhysicsWorld.hpp"
 #include "scripting/ScriptEngine.hpp"
 #include "network/NetworkManager.hpp"
+#include "network/Server.hpp"
+#include "network/Client.hpp"
+
+#ifndef ROBLOX_CLONE_DEDICATED_SERVER
+#include "renderer/Window.hpp"
+#include "renderer/Renderer.hpp"
+#include "renderer/DynamicResolution.hpp"
+#endif
 
 #ifdef ROBLOX_CLONE_BUILD_EDITOR
 #include "editor/Editor.hpp"
 #endif
 
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace roblox_clone::core {
 
@@ -22,7 +35,34 @@ struct AppConfig {
     int height = 720;
     bool fullscreen = false;
     bool vsync = true;
+    bool dynamicResolution = true;
+    float targetFrameRate = 60.0f;
     bool editorMode = true;
+    bool headless = false;
+    bool nullRenderer = false;
+    int tickRate = 60;
+    int maxSimulationSteps = 5;
+    uint64_t maxTicks = 0;
+    bool server = false;
+    // Server to join as a client; port is shared with the server setting.
+    std::string connectHost;
+    uint16_t port = 7777;
+    int maxClients = 32;
+    bool profiling = true;
+    int workerThreads = -1;
+    std::string traceFile;
+    // Lockstep and replay: fixed job partitioning, a fixed Lua random seed and
+    // a per-tick state hash that the server sends to clients, which compare it
+    // with their own.
+    bool deterministic = false;
+    int64_t randomSeed = 0;
+    // Ticks of registry snapshots kept for rollback; 0 turns snapshots off.
+    int rollbackFrames = 0;
+    // Directory of a partitioned world to stream around the camera, or on a
+    // server around every StreamingFocusComponent. Empty loads nothing.
+    std::string streamingPath;
+    float streamingRadius = 256.0f;
+    int streamingBudgetMB = 256;
 };
 
 class Application {
@@ -36,33 +76,72 @@ public:
     bool initialize(int argc, char* argv[]);
     int run();
     void close();
+    void requestStop() { m_running = false; }
+    
+    bool isHeadless() const { return m_config.headless; }
+    
+    // Ticks simulated so far and, in deterministic mode, the state hash after
+    // the latest one.
+    uint64_t getSimulationTick() const { return m_simulationTick; }
+    uint64_t getStateHash() const { return m_stateHash; }
+    
+    // Rolls the replicated state and the physics world back by ticks and
+    // simulates them again, for rollback netcode after a server correction. beforeTick runs ahead of
+    // each replayed tick so the caller can apply that tick's inputs. Fails if
+    // snapshots are off or the tick has left the ring.
+    bool resimulate(uint32_t ticks, const std::function<void(uint64_t)>& beforeTick = nullptr);
+    const scene::SnapshotHistory* getSnapshots() const { return m_snapshots.get(); }
+    scene::StreamingManager* getStreaming() const { return m_streaming.get(); }
     
     static Application* getInstance() { return s_instance; }
     
+#ifndef ROBLOX_CLONE_DEDICATED_SERVER
     renderer::Window* getWindow() const { return m_window.get(); }
     renderer::Renderer* getRenderer() const { return m_renderer.get(); }
+#endif
     scene::Scene* getScene() const { return m_scene.get(); }
+    physics::PhysicsWorld* getPhysics() const { return m_physics.get(); }
     scripting::ScriptEngine* getScriptEngine() const { return m_scriptEngine.get(); }
     network::NetworkManager* getNetworkManager() const { return m_networkManager.get(); }
+    network::Server* getServer() const { return m_server.get(); }
+    network::Client* getClient() const { return m_client.get(); }
 
 private:
     bool loadConfig(const std::string& filepath);
-    void processCommandLine(int argc, char* argv[]);
+    // Returns false, after logging it, if an option's value is not a whole
+    // number in the option's range.
+    bool processCommandLine(int argc, char* argv[]);
     void mainLoop();
+    int runHeadless();
+    void tick(float deltaTime);
+    void simulate(float deltaTime);
+    void updateStreaming();
     
     static Application* s_instance;
     
     AppConfig m_config;
+#ifndef ROBLOX_CLONE_DEDICATED_SERVER
     std::unique_ptr<renderer::Window> m_window;
     std::unique_ptr<renderer::Renderer> m_renderer;
+#endif
     std::unique_ptr<scene::Scene> m_scene;
+    std::unique_ptr<physics::PhysicsWorld> m_physics;
     std::unique_ptr<scripting::ScriptEngine> m_scriptEngine;
     std::unique_ptr<network::NetworkManager> m_networkManager;
+    std::unique_ptr<network::Server> m_server;
+    std::unique_ptr<network::Client> m_client;
+    std::unique_ptr<scene::SnapshotHistory> m_snapshots;
+    // Physics state saved with each snapshot, at the same tick % size slot.
+    std::vector<physics::PhysicsWorld::State> m_physicsStates;
+    std::unique_ptr<scene::StreamingManager> m_streaming;
     
 #ifdef ROBLOX_CLONE_BUILD_EDITOR
     std::unique_ptr<editor::Editor> m_editor;
 #endif
     
+    FixedTimestep m_timestep;
+    uint64_t m_simulationTick = 0;
+    uint64_t m_stateHash = 0;
     bool m_running = false;
 };
 
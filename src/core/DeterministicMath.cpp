@@ -0,0 +1,101 @@
+#include "DeterministicMath.hpp"
+#include <cmath>
+
+namespace roblox_clone::core {
+
+namespace {
+
+constexpr double HalfPi = 1.57079632679489661923;
+constexpr double QuarterPi = 0.78539816339744830962;
+constexpr double Pi = 3.14159265358979323846;
+
+// Minimax polynomials on [-pi/4, pi/4], after Cephes' sinf and cosf.
+double sinKernel(double r) {
+    const double z = r * r;
+    return r + r * z * ((-1.9515295891e-4 * z + 8.3321608736e-3) * z - 1.6666654611e-1);
+}
+
+double cosKernel(double r) {
+    const double z = r * r;
+    return 1.0 - 0.5 * z + z * z * ((2.443315711809948e-5 * z - 1.388731625493765e-3) * z + 4.166664568298827e-2);
+}
+
+// Reduces to r in [-pi/4, pi/4] plus the quarter turns taken off.
+double reduce(double radians, int& quadrant) {
+    const double turns = std::floor(radians / HalfPi + 0.5);
+    quadrant = static_cast<int>(std::fmod(turns, 4.0));
+    if (quadrant < 0) quadrant += 4;
+    return radians - turns * HalfPi;
+}
+
+double atanKernel(double value) {
+    double x = std::fabs(value);
+    double base = 0.0;
+    if (x > 2.414213562373095) {
+        base = HalfPi;
+        x = -1.0 / x;
+    } else if (x > 0.4142135623730950) {
+        base = QuarterPi;
+        x = (x - 1.0) / (x + 1.0);
+    }
+    const double z = x * x;
+    const double result =
+        base + (((8.05374449538e-2 * z - 1.38776856032e-1) * z + 1.99777106478e-1) * z - 3.33329491539e-1) * z * x + x;
+    return value < 0.0 ? -result : result;
+}
+
+}
+
+float deterministicSin(float radians) {
+    int quadrant;
+    const double r = reduce(radians, quadrant);
+    switch (quadrant) {
+        case 0: return static_cast<float>(sinKernel(r));
+        case 1: return static_cast<float>(cosKernel(r));
+        case 2: return static_cast<float>(-sinKernel(r));
+        default: return static_cast<float>(-cosKernel(r));
+    }
+}
+
+float deterministicCos(float radians) {
+    int quadrant;
+    const double r = reduce(radians, quadrant);
+    switch (quadrant) {
+        case 0: return static_cast<float>(cosKernel(r));
+        case 1: return static_cast<float>(-sinKernel(r));
+        case 2: return static_cast<float>(-cosKernel(r));
+        default: return static_cast<float>(sinKernel(r));
+    }
+}
+
+float deterministicAsin(float value) {
+    double x = std::fabs(static_cast<double>(value));
+    if (x > 1.0) x = 1.0;
+    
+    // Near +-1 the series converges slowly, so use asin(x) = pi/2 - 2 asin(sqrt((1 - x) / 2)).
+    const bool folded = x > 0.5;
+    double z;
+    if (folded) {
+        z = 0.5 * (1.0 - x);
+        x = std::sqrt(z);
+    } else {
+        z = x * x;
+    }
+    double result = ((((4.2163199048e-2 * z + 2.4181311049e-2) * z + 4.5470025998e-2) * z + 7.4953002686e-2) * z +
+                     1.6666752422e-1) * z * x + x;
+    if (folded) result = HalfPi - 2.0 * result;
+    return static_cast<float>(value < 0.0f ? -result : result);
+}
+
+float deterministicAtan2(float y, float x) {
+    if (x == 0.0f) {
+        if (y > 0.0f) return static_cast<float>(HalfPi);
+        if (y < 0.0f) return static_cast<float>(-HalfPi);
+        return 0.0f;
+    }
+    double result = atanKernel(static_cast<double>(y) / static_cast<double>(x));
+    if (x < 0.0f) result += y < 0.0f ? -Pi : Pi;
+    return static_cast<float>(result);
+}
+
+}
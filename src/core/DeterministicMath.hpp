@@ -0,0 +1,15 @@
+#pragma once
+
+namespace roblox_clone::core {
+
+// Trigonometry built from IEEE-exact operations only (add, multiply, divide,
+// sqrt, floor), so every platform gets the same bits. libm's sin and atan2
+// are free to differ in the last place, which is enough for lockstep peers
+// to drift apart. Accurate to about one float ulp over the simulation's
+// range of angles.
+float deterministicSin(float radians);
+float deterministicCos(float radians);
+float deterministicAsin(float value);
+float deterministicAtan2(float y, float x);
+
+}
@@ -0,0 +1,36 @@
+#include "FixedTimestep.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace roblox_clone::core {
+
+void FixedTimestep::setSettings(const FixedTimestepSettings& settings) {
+    m_settings = settings;
+    m_settings.stepRate = std::max(1, m_settings.stepRate);
+    m_settings.maxStepsPerFrame = std::max(1, m_settings.maxStepsPerFrame);
+    m_stepSeconds = 1.0 / static_cast<double>(m_settings.stepRate);
+    m_accumulator = std::min(m_accumulator, m_stepSeconds);
+}
+
+int FixedTimestep::advance(double frameSeconds) {
+    frameSeconds = std::clamp(frameSeconds, 0.0, m_settings.maxFrameSeconds);
+    m_accumulator += frameSeconds;
+    
+    int steps = 0;
+    while (m_accumulator >= m_stepSeconds && steps < m_settings.maxStepsPerFrame) {
+        m_accumulator -= m_stepSeconds;
+        ++steps;
+    }
+    
+    if (m_accumulator >= m_stepSeconds) {
+        double remainder = std::fmod(m_accumulator, m_stepSeconds);
+        m_droppedSeconds += m_accumulator - remainder;
+        m_accumulator = remainder;
+    }
+    
+    m_stepCount += static_cast<uint64_t>(steps);
+    m_lastSteps = steps;
+    return steps;
+}
+
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+
+namespace roblox_clone::core {
+
+struct FixedTimestepSettings {
+    int stepRate = 60;
+    // Spiral-of-death guard: at most this many steps run per frame and the
+    // rest of the backlog is dropped instead of being carried forward.
+    int maxStepsPerFrame = 5;
+    double maxFrameSeconds = 0.25;
+};
+
+class FixedTimestep {
+public:
+    FixedTimestep() = default;
+    explicit FixedTimestep(const FixedTimestepSettings& settings) { setSettings(settings); }
+    
+    void setSettings(const FixedTimestepSettings& settings);
+    const FixedTimestepSettings& getSettings() const { return m_settings; }
+    
+    // Adds a frame's wall-clock time and returns how many fixed steps to run.
+    int advance(double frameSeconds);
+    
+    float getStepSeconds() const { return static_cast<float>(m_stepSeconds); }
+    // Fraction of a step left in the accumulator, used to blend the last two
+    // simulated states when rendering.
+    float getAlpha() const { return static_cast<float>(m_accumulator / m_stepSeconds); }
+    
+    uint64_t getStepCount() const { return m_stepCount; }
+    int getLastStepCount() const { return m_lastSteps; }
+    double getDroppedSeconds() const { return m_droppedSeconds; }
+
+private:
+    FixedTimestepSettings m_settings;
+    double m_stepSeconds = 1.0 / 60.0;
+    double m_accumulator = 0.0;
+    double m_droppedSeconds = 0.0;
+    uint64_t m_stepCount = 0;
+    int m_lastSteps = 0;
+};
+
+}
@@ -0,0 +1,139 @@
+#include "FrameAllocator.hpp"
+#include <algorithm>
+#include <mutex>
+
+namespace roblox_clone::core {
+
+std::atomic<uint64_t> FrameAllocator::s_frame{0};
+FrameAllocatorStats FrameAllocator::s_stats;
+
+namespace {
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+struct ThreadArena {
+    LinearArena arena;
+    std::atomic<uint64_t> frame{~uint64_t(0)};
+    std::atomic<size_t> frameBytes{0};
+    std::atomic<size_t> capacity{0};
+};
+
+struct ThreadArenas {
+    ThreadArena single;
+    // Indexed by frame parity, so the previous frame's arena stays intact.
+    ThreadArena doubled[2];
+    
+    template<typename Func>
+    void forEach(Func&& func) {
+        func(single);
+        func(doubled[0]);
+        func(doubled[1]);
+    }
+};
+
+std::mutex s_registryMutex;
+std::vector<std::shared_ptr<ThreadArenas>> s_registry;
+
+ThreadArenas& getThreadArenas() {
+    thread_local std::shared_ptr<ThreadArenas> arenas = []() {
+        auto created = std::make_shared<ThreadArenas>();
+        std::lock_guard<std::mutex> lock(s_registryMutex);
+        s_registry.push_back(created);
+        return created;
+    }();
+    return *arenas;
+}
+
+}
+
+LinearArena::LinearArena(size_t blockSize) : m_blockSize(blockSize) {}
+
+void LinearArena::addBlock(size_t minSize) {
+    Block block;
+    block.size = std::max(m_blockSize, minSize);
+    block.data = std::make_unique<std::byte[]>(block.size);
+    m_capacity += block.size;
+    m_blocks.push_back(std::move(block));
+}
+
+void* LinearArena::allocate(size_t size, size_t alignment) {
+    if (m_blocks.empty()) {
+        addBlock(size + alignment);
+    }
+    
+    while (true) {
+        Block& block = m_blocks[m_blockIndex];
+        auto base = reinterpret_cast<uintptr_t>(block.data.get());
+        size_t start = alignUp(base + m_offset, alignment) - base;
+        if (start + size <= block.size) {
+            m_offset = start + size;
+            m_used += size;
+            return block.data.get() + start;
+        }
+        
+        if (m_blockIndex + 1 >= m_blocks.size()) {
+            addBlock(size + alignment);
+        }
+        ++m_blockIndex;
+        m_offset = 0;
+    }
+}
+
+void LinearArena::reset() {
+    m_peak = std::max(m_peak, m_used);
+    
+    if (m_blocks.size() > 1) {
+        size_t merged = alignUp(m_capacity, m_blockSize);
+        m_blocks.clear();
+        m_capacity = 0;
+        addBlock(merged);
+    }
+    
+    m_blockIndex = 0;
+    m_offset = 0;
+    m_used = 0;
+}
+
+void* FrameAllocator::allocate(size_t size, size_t alignment, FrameLifetime lifetime) {
+    uint64_t frame = getFrame();
+    ThreadArenas& arenas = getThreadArenas();
+    ThreadArena& slot = lifetime == FrameLifetime::Double ? arenas.doubled[frame & 1] : arenas.single;
+    
+    if (slot.frame.load(std::memory_order_relaxed) != frame) {
+        slot.arena.reset();
+        slot.frame.store(frame, std::memory_order_relaxed);
+    }
+    
+    void* memory = slot.arena.allocate(size, alignment);
+    slot.frameBytes.store(slot.arena.getUsed(), std::memory_order_relaxed);
+    slot.capacity.store(slot.arena.getCapacity(), std::memory_order_relaxed);
+    return memory;
+}
+
+void FrameAllocator::endFrame() {
+    uint64_t frame = getFrame();
+    FrameAllocatorStats stats;
+    stats.frame = frame;
+    
+    {
+        std::lock_guard<std::mutex> lock(s_registryMutex);
+        for (const auto& arenas : s_registry) {
+            arenas->forEach([&stats, frame](const ThreadArena& slot) {
+                if (slot.frame.load(std::memory_order_relaxed) == frame) {
+                    stats.lastFrameBytes += slot.frameBytes.load(std::memory_order_relaxed);
+                }
+                stats.capacityBytes += slot.capacity.load(std::memory_order_relaxed);
+                ++stats.arenaCount;
+            });
+        }
+    }
+    
+    stats.peakFrameBytes = std::max(s_stats.peakFrameBytes, stats.lastFrameBytes);
+    s_stats = stats;
+    
+    s_frame.fetch_add(1, std::memory_order_acq_rel);
+}
+
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace roblox_clone::core {
+
+class LinearArena {
+public:
+    static constexpr size_t DefaultBlockSize = 256 * 1024;
+    
+    explicit LinearArena(size_t blockSize = DefaultBlockSize);
+    
+    LinearArena(const LinearArena&) = delete;
+    LinearArena& operator=(const LinearArena&) = delete;
+    
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+    
+    // Rewinds to the start. If the previous frame spilled into extra blocks
+    // they are merged into one block big enough for that frame's peak.
+    void reset();
+    
+    size_t getUsed() const { return m_used; }
+    size_t getCapacity() const { return m_capacity; }
+    size_t getPeak() const { return m_peak; }
+
+private:
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        size_t size = 0;
+    };
+    
+    void addBlock(size_t minSize);
+    
+    std::vector<Block> m_blocks;
+    size_t m_blockSize;
+    size_t m_blockIndex = 0;
+    size_t m_offset = 0;
+    size_t m_capacity = 0;
+    size_t m_peak = 0;
+    size_t m_used = 0;
+};
+
+enum class FrameLifetime {
+    // Valid until the end of the current Application::run iteration.
+    Single,
+    // Valid until the end of the following iteration.
+    Double
+};
+
+struct FrameAllocatorStats {
+    uint64_t frame = 0;
+    size_t lastFrameBytes = 0;
+    size_t peakFrameBytes = 0;
+    size_t capacityBytes = 0;
+    uint32_t arenaCount = 0;
+};
+
+// Thread-local linear arenas that are recycled every frame. Each thread owns
+// two arenas per lifetime and picks one by frame parity; an arena is rewound
+// lazily the first time its thread allocates in a new frame, so endFrame()
+// never touches another thread's memory. Memory handed out for a frame must
+// not be used by jobs that outlive it.
+class FrameAllocator {
+public:
+    static void* allocate(size_t size, size_t alignment = alignof(std::max_align_t),
+                          FrameLifetime lifetime = FrameLifetime::Single);
+    
+    template<typename T, typename... Args>
+    static T* create(Args&&... args) {
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+    
+    static void endFrame();
+    
+    static uint64_t getFrame() { return s_frame.load(std::memory_order_acquire); }
+    // Totals for the last completed frame; call from the thread driving endFrame.
+    static const FrameAllocatorStats& getStats() { return s_stats; }
+
+private:
+    static std::atomic<uint64_t> s_frame;
+    static FrameAllocatorStats s_stats;
+};
+
+template<typename T, FrameLifetime Lifetime = FrameLifetime::Single>
+class FrameStlAllocator {
+public:
+    using value_type = T;
+    
+    template<typename U>
+    struct rebind {
+        using other = FrameStlAllocator<U, Lifetime>;
+    };
+    
+    FrameStlAllocator() noexcept = default;
+    
+    template<typename U>
+    FrameStlAllocator(const FrameStlAllocator<U, Lifetime>&) noexcept {}
+    
+    T* allocate(size_t count) {
+        return static_cast<T*>(FrameAllocator::allocate(count * sizeof(T), alignof(T), Lifetime));
+    }
+    
+    void deallocate(T*, size_t) noexcept {}
+    
+    template<typename U>
+    bool operator==(const FrameStlAllocator<U, Lifetime>&) const noexcept { return true; }
+    
+    template<typename U>
+    bool operator!=(const FrameStlAllocator<U, Lifetime>&) const noexcept { return false; }
+};
+
+template<typename T>
+using FrameVector = std::vector<T, FrameStlAllocator<T>>;
+
+template<typename T>
+using DoubleFrameVector = std::vector<T, FrameStlAllocator<T, FrameLifetime::Double>>;
+
+using FrameString = std::basic_string<char, std::char_traits<char>, FrameStlAllocator<char>>;
+
+}
@@ -0,0 +1,329 @@
+#include "JobSystem.hpp"
+#include "Logger.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+namespace roblox_clone::core {
+
+struct Job {
+    JobFunction function;
+    JobCounter* counter = nullptr;
+    // Set by the owning thread when it hands the slot out, cleared by
+    // whichever thread starts the job.
+    std::atomic<bool> busy{false};
+};
+
+namespace {
+
+// Index into m_participants for the current thread, or -1 for threads that
+// are not part of the job system (they run submitted jobs inline).
+thread_local int t_participant = -1;
+
+}
+
+bool WorkStealingQueue::push(Job* job) {
+    int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+    int64_t top = m_top.load(std::memory_order_acquire);
+    if (bottom - top >= Capacity) {
+        return false;
+    }
+    
+    m_buffer[bottom & (Capacity - 1)].store(job, std::memory_order_relaxed);
+    m_bottom.store(bottom + 1, std::memory_order_release);
+    return true;
+}
+
+Job* WorkStealingQueue::pop() {
+    int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+    m_bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = m_top.load(std::memory_order_relaxed);
+    
+    if (top > bottom) {
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    
+    Job* job = m_buffer[bottom & (Capacity - 1)].load(std::memory_order_relaxed);
+    if (top == bottom) {
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            job = nullptr;
+        }
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return job;
+}
+
+Job* WorkStealingQueue::steal() {
+    int64_t top = m_top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t bottom = m_bottom.load(std::memory_order_acquire);
+    
+    if (top >= bottom) {
+        return nullptr;
+    }
+    
+    Job* job = m_buffer[top & (Capacity - 1)].load(std::memory_order_relaxed);
+    if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    return job;
+}
+
+JobSystem& JobSystem::get() {
+    static JobSystem jobSystem;
+    return jobSystem;
+}
+
+JobSystem::~JobSystem() {
+    shutdown();
+}
+
+void JobSystem::initialize(int workerCount) {
+    shutdown();
+    
+    if (workerCount < 0) {
+        workerCount = std::max(0, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+    }
+    
+    m_participants.clear();
+    for (int i = 0; i <= workerCount; ++i) {
+        auto participant = std::make_unique<Participant>();
+        participant->jobs = std::make_unique<Job[]>(JobPoolSize);
+        participant->stealSeed = 0x9E3779B9u * static_cast<uint32_t>(i + 1);
+        m_participants.push_back(std::move(participant));
+    }
+    
+    t_participant = 0;
+    m_running = true;
+    
+    m_workers.reserve(workerCount);
+    for (int i = 1; i <= workerCount; ++i) {
+        m_workers.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+    
+    RC_INFO("Job system started with {} worker threads", workerCount);
+}
+
+void JobSystem::shutdown() {
+    if (!m_running) return;
+    
+    // Let the workers help empty the queues first, so a caller outside the
+    // job system does not leave jobs behind.
+    while (m_queuedJobs.load(std::memory_order_acquire) > 0) {
+        if (t_participant < 0 || !tryExecuteOne()) {
+            std::this_thread::yield();
+        }
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_running = false;
+    }
+    m_wakeCondition.notify_all();
+    
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+    m_workers.clear();
+    
+    if (t_participant >= 0) {
+        while (tryExecuteOne()) {
+        }
+    }
+    
+    m_participants.clear();
+    t_participant = -1;
+}
+
+bool JobSystem::isWorkerThread() const {
+    return t_participant >= 0 && m_running;
+}
+
+// Takes function only when a slot is free; otherwise returns null and the
+// caller runs it inline.
+Job* JobSystem::allocateJob(JobFunction& function, JobCounter* counter) {
+    Participant& participant = *m_participants[t_participant];
+    for (uint32_t attempt = 0; attempt < JobPoolSize; ++attempt) {
+        Job& job = participant.jobs[participant.nextJob++ & (JobPoolSize - 1)];
+        if (job.busy.load(std::memory_order_acquire)) continue;
+        
+        job.busy.store(true, std::memory_order_relaxed);
+        job.function = std::move(function);
+        job.counter = counter;
+        return &job;
+    }
+    return nullptr;
+}
+
+void JobSystem::run(JobFunction function, JobCounter* counter) {
+    if (counter) {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    if (isWorkerThread()) {
+        if (Job* job = allocateJob(function, counter)) {
+            submit(job);
+            return;
+        }
+    }
+    
+    function();
+    finish(counter);
+}
+
+void JobSystem::runAfter(JobCounter& dependency, JobFunction function, JobCounter* counter) {
+    if (counter) {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    if (isWorkerThread()) {
+        if (Job* job = allocateJob(function, counter)) {
+            {
+                std::lock_guard<std::mutex> lock(dependency.m_continuationMutex);
+                if (dependency.m_pending.load(std::memory_order_seq_cst) > 0) {
+                    dependency.m_continuations.push_back(job);
+                    return;
+                }
+            }
+            submit(job);
+            return;
+        }
+        // No slot to park the continuation in, so help the dependency along
+        // and run it here.
+        wait(dependency);
+    } else {
+        wait(dependency, false);
+    }
+    
+    function();
+    finish(counter);
+}
+
+void JobSystem::submit(Job* job) {
+    if (!m_participants[t_participant]->queue.push(job)) {
+        execute(job);
+        return;
+    }
+    
+    m_queuedJobs.fetch_add(1, std::memory_order_release);
+    m_wakeCondition.notify_one();
+}
+
+size_t JobSystem::computeGrainSize(size_t count, size_t minGrain) const {
+    size_t targetRanges = m_deterministic ? FixedRangeCount : static_cast<size_t>(getThreadCount()) * 4;
+    size_t grain = (count + targetRanges - 1) / targetRanges;
+    return std::max<size_t>({ grain, minGrain, 1 });
+}
+
+void JobSystem::parallelFor(size_t count, const RangeFunction& function, size_t minGrain) {
+    if (count == 0) return;
+    
+    size_t grain = computeGrainSize(count, minGrain);
+    if (grain >= count || !isWorkerThread() || m_workers.empty()) {
+        function(0, count);
+        return;
+    }
+    
+    JobCounter counter;
+    for (size_t begin = grain; begin < count; begin += grain) {
+        size_t end = std::min(begin + grain, count);
+        run([&function, begin, end]() { function(begin, end); }, &counter);
+    }
+    
+    function(0, grain);
+    wait(counter);
+}
+
+void JobSystem::wait(JobCounter& counter, bool help) {
+    while (!counter.isDone()) {
+        if (!help || !isWorkerThread() || !tryExecuteOne()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+Job* JobSystem::findJob() {
+    Participant& self = *m_participants[t_participant];
+    if (Job* job = self.queue.pop()) {
+        return job;
+    }
+    
+    const uint32_t count = static_cast<uint32_t>(m_participants.size());
+    if (count <= 1) return nullptr;
+    
+    self.stealSeed ^= self.stealSeed << 13;
+    self.stealSeed ^= self.stealSeed >> 17;
+    self.stealSeed ^= self.stealSeed << 5;
+    uint32_t start = self.stealSeed % count;
+    
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t victim = (start + i) % count;
+        if (static_cast<int>(victim) == t_participant) continue;
+        if (Job* job = m_participants[victim]->queue.steal()) {
+            m_stolen.fetch_add(1, std::memory_order_relaxed);
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+bool JobSystem::tryExecuteOne() {
+    Job* job = findJob();
+    if (!job) return false;
+    
+    m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+    execute(job);
+    return true;
+}
+
+void JobSystem::execute(Job* job) {
+    JobFunction function = std::move(job->function);
+    JobCounter* counter = job->counter;
+    job->function = nullptr;
+    job->busy.store(false, std::memory_order_release);
+    
+    function();
+    m_executed.fetch_add(1, std::memory_order_relaxed);
+    finish(counter);
+}
+
+void JobSystem::finish(JobCounter* counter) {
+    if (!counter) return;
+    
+    counter->m_finishing.fetch_add(1, std::memory_order_seq_cst);
+    std::vector<Job*> continuations;
+    if (counter->m_pending.fetch_sub(1, std::memory_order_seq_cst) == 1) {
+        std::lock_guard<std::mutex> lock(counter->m_continuationMutex);
+        continuations.swap(counter->m_continuations);
+    }
+    counter->m_finishing.fetch_sub(1, std::memory_order_seq_cst);
+    
+    for (Job* job : continuations) {
+        if (isWorkerThread()) {
+            submit(job);
+        } else {
+            execute(job);
+        }
+    }
+}
+
+void JobSystem::workerLoop(int index) {
+    t_participant = index;
+    Profiler::get().setThreadName("Worker " + std::to_string(index));
+    
+    while (m_running.load(std::memory_order_acquire)) {
+        if (tryExecuteOne()) continue;
+        
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_wakeCondition.wait_for(lock, std::chrono::milliseconds(1), [this]() {
+            return !m_running || m_queuedJobs.load(std::memory_order_acquire) > 0;
+        });
+    }
+    
+    t_participant = -1;
+}
+
+}
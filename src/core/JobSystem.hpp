@@ -0,0 +1,173 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace roblox_clone::core {
+
+struct Job;
+
+class JobCounter {
+public:
+    JobCounter() = default;
+    
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+    
+    bool isDone() const {
+        return m_pending.load(std::memory_order_seq_cst) == 0 && m_finishing.load(std::memory_order_seq_cst) == 0;
+    }
+    uint32_t getPending() const { return m_pending.load(std::memory_order_acquire); }
+
+private:
+    friend class JobSystem;
+    
+    std::atomic<uint32_t> m_pending{0};
+    // Held by a thread between its decrement and its last access, so a waiter
+    // never destroys the counter while continuations are being collected.
+    std::atomic<uint32_t> m_finishing{0};
+    std::mutex m_continuationMutex;
+    std::vector<Job*> m_continuations;
+};
+
+// Chase-Lev work-stealing deque. The owning thread pushes and pops at the
+// bottom, any other thread steals from the top.
+class WorkStealingQueue {
+public:
+    static constexpr int64_t Capacity = 4096;
+    
+    WorkStealingQueue() = default;
+    
+    WorkStealingQueue(const WorkStealingQueue&) = delete;
+    WorkStealingQueue& operator=(const WorkStealingQueue&) = delete;
+    
+    bool push(Job* job);
+    Job* pop();
+    Job* steal();
+    
+    bool isEmpty() const {
+        return m_bottom.load(std::memory_order_relaxed) <= m_top.load(std::memory_order_relaxed);
+    }
+
+private:
+    alignas(64) std::atomic<int64_t> m_top{0};
+    alignas(64) std::atomic<int64_t> m_bottom{0};
+    std::atomic<Job*> m_buffer[Capacity] = {};
+};
+
+using JobFunction = std::function<void()>;
+using RangeFunction = std::function<void(size_t begin, size_t end)>;
+
+class JobSystem {
+public:
+    // Each participating thread owns a pool of this many job slots. A slot is
+    // reused only once its job has started; with every slot taken, further
+    // jobs run inline on the submitting thread.
+    static constexpr uint32_t JobPoolSize = 4096;
+    // Ranges per parallelFor in deterministic mode and per parallelReduce,
+    // whatever the thread count.
+    static constexpr size_t FixedRangeCount = 64;
+    
+    static JobSystem& get();
+    
+    ~JobSystem();
+    
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+    
+    // Starts workerCount threads; the thread calling initialize becomes
+    // participant 0 and can execute jobs while it waits. A negative count
+    // uses one worker per remaining hardware thread.
+    void initialize(int workerCount = -1);
+    // Runs every queued job, and any continuation they release, before the
+    // workers stop.
+    void shutdown();
+    
+    void run(JobFunction function, JobCounter* counter = nullptr);
+    void runAfter(JobCounter& dependency, JobFunction function, JobCounter* counter = nullptr);
+    
+    // Splits [0, count) into ranges of at least minGrain items, sized so every
+    // thread gets a few ranges to balance uneven work, and waits for them.
+    void parallelFor(size_t count, const RangeFunction& function, size_t minGrain = 1);
+    size_t computeGrainSize(size_t count, size_t minGrain = 1) const;
+    
+    // Reduces [0, count) by calling map(begin, end) on ranges that depend only
+    // on count and minGrain, then folding the results with combine in range
+    // order. The result is the same for any thread count or schedule.
+    template<typename T, typename Map, typename Combine>
+    T parallelReduce(size_t count, T identity, const Map& map, const Combine& combine, size_t minGrain = 1);
+    
+    // Deterministic mode splits parallelFor into FixedRangeCount ranges instead
+    // of a few per thread, so work that keeps per-range state partitions the
+    // same on every machine.
+    void setDeterministic(bool deterministic) { m_deterministic = deterministic; }
+    bool isDeterministic() const { return m_deterministic; }
+    
+    void wait(JobCounter& counter, bool help = true);
+    
+    int getThreadCount() const { return static_cast<int>(m_workers.size()) + 1; }
+    int getWorkerCount() const { return static_cast<int>(m_workers.size()); }
+    bool isWorkerThread() const;
+    
+    uint64_t getExecutedCount() const { return m_executed.load(std::memory_order_relaxed); }
+    uint64_t getStolenCount() const { return m_stolen.load(std::memory_order_relaxed); }
+
+private:
+    struct Participant {
+        WorkStealingQueue queue;
+        std::unique_ptr<Job[]> jobs;
+        uint32_t nextJob = 0;
+        uint32_t stealSeed = 0;
+    };
+    
+    JobSystem() = default;
+    
+    Job* allocateJob(JobFunction& function, JobCounter* counter);
+    void submit(Job* job);
+    bool tryExecuteOne();
+    Job* findJob();
+    void execute(Job* job);
+    void finish(JobCounter* counter);
+    void workerLoop(int index);
+    
+    std::vector<std::unique_ptr<Participant>> m_participants;
+    std::vector<std::thread> m_workers;
+    
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCondition;
+    std::atomic<int32_t> m_queuedJobs{0};
+    std::atomic<bool> m_running{false};
+    bool m_deterministic = false;
+    
+    std::atomic<uint64_t> m_executed{0};
+    std::atomic<uint64_t> m_stolen{0};
+};
+
+template<typename T, typename Map, typename Combine>
+T JobSystem::parallelReduce(size_t count, T identity, const Map& map, const Combine& combine, size_t minGrain) {
+    if (count == 0) return identity;
+    
+    const size_t grain = std::max<size_t>({ (count + FixedRangeCount - 1) / FixedRangeCount, minGrain, 1 });
+    const size_t rangeCount = (count + grain - 1) / grain;
+    std::vector<T> partials(rangeCount, identity);
+    parallelFor(rangeCount, [&](size_t begin, size_t end) {
+        for (size_t range = begin; range < end; ++range) {
+            partials[range] = map(range * grain, std::min(range * grain + grain, count));
+        }
+    });
+    
+    T result = identity;
+    for (const T& partial : partials) {
+        result = combine(result, partial);
+    }
+    return result;
+}
+
+}
@@ -0,0 +1,107 @@
+#include "MappedFile.hpp"
+#include "Logger.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace roblox_clone::core {
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& filepath) {
+    close();
+    
+    m_file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                         FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        m_file = nullptr;
+        RC_ERROR("Failed to open file: {}", filepath);
+        return false;
+    }
+    
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0) {
+        RC_ERROR("Failed to map empty file: {}", filepath);
+        close();
+        return false;
+    }
+    
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* view = m_mapping ? MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        RC_ERROR("Failed to map file: {}", filepath);
+        close();
+        return false;
+    }
+    
+    m_data = static_cast<const uint8_t*>(view);
+    m_size = static_cast<size_t>(size.QuadPart);
+    return true;
+}
+
+void MappedFile::close() {
+    if (m_data) UnmapViewOfFile(m_data);
+    if (m_mapping) CloseHandle(m_mapping);
+    if (m_file) CloseHandle(m_file);
+    m_data = nullptr;
+    m_size = 0;
+    m_mapping = nullptr;
+    m_file = nullptr;
+}
+
+#else
+
+bool MappedFile::open(const std::string& filepath) {
+    close();
+    
+    const int descriptor = ::open(filepath.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        RC_ERROR("Failed to open file: {}", filepath);
+        return false;
+    }
+    
+    struct stat status;
+    if (fstat(descriptor, &status) != 0 || status.st_size == 0) {
+        RC_ERROR("Failed to map empty file: {}", filepath);
+        ::close(descriptor);
+        return false;
+    }
+    
+    const size_t size = static_cast<size_t>(status.st_size);
+    void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    // The mapping keeps the file alive on its own.
+    ::close(descriptor);
+    if (view == MAP_FAILED) {
+        RC_ERROR("Failed to map file: {}", filepath);
+        return false;
+    }
+    
+    madvise(view, size, MADV_WILLNEED);
+    m_data = static_cast<const uint8_t*>(view);
+    m_size = size;
+    return true;
+}
+
+void MappedFile::close() {
+    if (m_data) {
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+    m_data = nullptr;
+    m_size = 0;
+}
+
+#endif
+
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace roblox_clone::core {
+
+// Read-only mapping of a whole file. Pages are faulted in as they are read,
+// so a loader can hand disjoint ranges of it to several threads.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    bool open(const std::string& filepath);
+    void close();
+    
+    const uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool isOpen() const { return m_data != nullptr; }
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#endif
+};
+
+}
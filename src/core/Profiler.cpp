@@ -0,0 +1,147 @@
+#include "Profiler.hpp"
+#include "Logger.hpp"
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+
+namespace roblox_clone::core {
+
+namespace {
+
+thread_local ProfileTrack* t_track = nullptr;
+
+void writeJsonString(std::ofstream& file, const std::string& text) {
+    file << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') file << '\\';
+        file << c;
+    }
+    file << '"';
+}
+
+}
+
+Profiler& Profiler::get() {
+    static Profiler profiler;
+    return profiler;
+}
+
+uint64_t Profiler::now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+ProfileTrack* Profiler::createTrack(const std::string& name) {
+    std::lock_guard<std::mutex> lock(m_trackMutex);
+    auto index = static_cast<uint16_t>(m_tracks.size());
+    m_tracks.push_back(std::make_unique<ProfileTrack>(name, index));
+    return m_tracks.back().get();
+}
+
+ProfileTrack* Profiler::getThreadTrack() {
+    if (!t_track) {
+        std::string name;
+        {
+            std::lock_guard<std::mutex> lock(m_trackMutex);
+            name = "Thread " + std::to_string(m_tracks.size());
+        }
+        t_track = createTrack(name);
+    }
+    return t_track;
+}
+
+void Profiler::setThreadName(const std::string& name) {
+    if (t_track) {
+        RC_WARN("Profiler track already created for thread, ignoring name {}", name);
+        return;
+    }
+    t_track = createTrack(name);
+}
+
+void Profiler::endFrame() {
+    uint64_t frameEnd = now();
+    if (m_frameStartNs == 0) {
+        m_frameStartNs = frameEnd;
+    }
+    
+    ProfileFrame* frame = nullptr;
+    if (!m_paused) {
+        frame = &m_history[m_frameCount % HistorySize];
+        frame->startNs = m_frameStartNs;
+        frame->endNs = frameEnd;
+        frame->events.clear();
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(m_trackMutex);
+        for (auto& track : m_tracks) {
+            track->drain([frame](const ProfileEvent& event) {
+                if (frame) frame->events.push_back(event);
+            });
+        }
+    }
+    
+    if (frame) {
+        ++m_frameCount;
+    }
+    m_frameStartNs = frameEnd;
+}
+
+const ProfileFrame* Profiler::getFrame(size_t framesAgo) const {
+    if (framesAgo >= getFrameCount()) return nullptr;
+    return &m_history[(m_frameCount - 1 - framesAgo) % HistorySize];
+}
+
+std::vector<std::string> Profiler::getTrackNames() const {
+    std::lock_guard<std::mutex> lock(m_trackMutex);
+    std::vector<std::string> names;
+    names.reserve(m_tracks.size());
+    for (const auto& track : m_tracks) {
+        names.push_back(track->getName());
+    }
+    return names;
+}
+
+bool Profiler::exportChromeTrace(const std::string& filepath) const {
+    std::ofstream file(filepath);
+    if (!file.is_open()) {
+        RC_ERROR("Failed to create trace file: {}", filepath);
+        return false;
+    }
+    
+    auto trackNames = getTrackNames();
+    size_t frameCount = getFrameCount();
+    uint64_t origin = frameCount > 0 ? getFrame(frameCount - 1)->startNs : 0;
+    
+    file << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+    bool first = true;
+    
+    for (size_t i = 0; i < trackNames.size(); ++i) {
+        file << (first ? "" : ",") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << i
+             << ",\"args\":{\"name\":";
+        writeJsonString(file, trackNames[i]);
+        file << "}}";
+        first = false;
+    }
+    
+    size_t eventCount = 0;
+    for (size_t framesAgo = frameCount; framesAgo-- > 0;) {
+        const ProfileFrame* frame = getFrame(framesAgo);
+        for (const auto& event : frame->events) {
+            uint64_t start = event.startNs > origin ? event.startNs - origin : 0;
+            file << (first ? "" : ",") << "{\"name\":";
+            writeJsonString(file, event.name ? event.name : "?");
+            file << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.track
+                 << ",\"ts\":" << static_cast<double>(start) / 1000.0
+                 << ",\"dur\":" << static_cast<double>(event.endNs - event.startNs) / 1000.0 << "}";
+            first = false;
+            ++eventCount;
+        }
+    }
+    
+    file << "],\"displayTimeUnit\":\"ms\"}\n";
+    RC_INFO("Exported {} profiler events from {} frames to {}", eventCount, frameCount, filepath);
+    return true;
+}
+
+}
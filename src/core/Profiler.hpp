@@ -0,0 +1,156 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifndef ROBLOX_CLONE_PROFILING
+#define ROBLOX_CLONE_PROFILING 1
+#endif
+
+namespace roblox_clone::core {
+
+struct ProfileEvent {
+    const char* name = nullptr;
+    uint64_t startNs = 0;
+    uint64_t endNs = 0;
+    uint16_t depth = 0;
+    uint16_t track = 0;
+};
+
+// Single-producer/single-consumer ring. The owning thread pushes, the main
+// thread drains once per frame in Profiler::endFrame.
+class ProfileTrack {
+public:
+    static constexpr uint32_t Capacity = 1 << 14;
+    
+    explicit ProfileTrack(std::string name, uint16_t index) : m_name(std::move(name)), m_index(index) {}
+    
+    void push(const ProfileEvent& event) {
+        uint32_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) >= Capacity) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        m_events[head & (Capacity - 1)] = event;
+        m_head.store(head + 1, std::memory_order_release);
+    }
+    
+    template<typename Func>
+    void drain(Func&& func) {
+        uint32_t tail = m_tail.load(std::memory_order_relaxed);
+        uint32_t head = m_head.load(std::memory_order_acquire);
+        for (; tail != head; ++tail) {
+            func(m_events[tail & (Capacity - 1)]);
+        }
+        m_tail.store(tail, std::memory_order_release);
+    }
+    
+    const std::string& getName() const { return m_name; }
+    uint16_t getIndex() const { return m_index; }
+    uint64_t getDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+    
+    uint16_t depth = 0;
+
+private:
+    std::string m_name;
+    uint16_t m_index;
+    std::array<ProfileEvent, Capacity> m_events;
+    alignas(64) std::atomic<uint32_t> m_head{0};
+    alignas(64) std::atomic<uint32_t> m_tail{0};
+    std::atomic<uint64_t> m_dropped{0};
+};
+
+struct ProfileFrame {
+    uint64_t startNs = 0;
+    uint64_t endNs = 0;
+    std::vector<ProfileEvent> events;
+};
+
+class Profiler {
+public:
+    static constexpr size_t HistorySize = 240;
+    
+    static Profiler& get();
+    static uint64_t now();
+    
+    void setEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+    
+    void setPaused(bool paused) { m_paused = paused; }
+    bool isPaused() const { return m_paused; }
+    
+    void setThreadName(const std::string& name);
+    ProfileTrack* createTrack(const std::string& name);
+    ProfileTrack* getThreadTrack();
+    
+    void endFrame();
+    
+    const ProfileFrame* getFrame(size_t framesAgo) const;
+    size_t getFrameCount() const { return m_frameCount < HistorySize ? m_frameCount : HistorySize; }
+    std::vector<std::string> getTrackNames() const;
+    
+    bool exportChromeTrace(const std::string& filepath) const;
+
+private:
+    Profiler() = default;
+    
+    mutable std::mutex m_trackMutex;
+    std::vector<std::unique_ptr<ProfileTrack>> m_tracks;
+    
+    std::array<ProfileFrame, HistorySize> m_history;
+    size_t m_frameCount = 0;
+    uint64_t m_frameStartNs = 0;
+    
+    std::atomic<bool> m_enabled{true};
+    bool m_paused = false;
+};
+
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) {
+        if (!Profiler::get().isEnabled()) return;
+        m_track = Profiler::get().getThreadTrack();
+        m_name = name;
+        m_depth = m_track->depth++;
+        m_startNs = Profiler::now();
+    }
+    
+    ~ProfileScope() {
+        if (!m_track) return;
+        ProfileEvent event;
+        event.name = m_name;
+        event.startNs = m_startNs;
+        event.endNs = Profiler::now();
+        event.depth = m_depth;
+        event.track = m_track->getIndex();
+        m_track->depth--;
+        m_track->push(event);
+    }
+    
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    ProfileTrack* m_track = nullptr;
+    const char* m_name = nullptr;
+    uint64_t m_startNs = 0;
+    uint16_t m_depth = 0;
+};
+
+}
+
+#define RC_PROFILE_CONCAT_IMPL(a, b) a##b
+#define RC_PROFILE_CONCAT(a, b) RC_PROFILE_CONCAT_IMPL(a, b)
+
+#if ROBLOX_CLONE_PROFILING
+#define RC_PROFILE_SCOPE(name) ::roblox_clone::core::ProfileScope RC_PROFILE_CONCAT(rcProfileScope, __LINE__)(name)
+#define RC_PROFILE_FUNCTION() RC_PROFILE_SCOPE(__func__)
+#else
+#define RC_PROFILE_SCOPE(name)
+#define RC_PROFILE_FUNCTION()
+#endif
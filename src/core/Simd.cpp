@@ -0,0 +1,48 @@
+#include "Simd.hpp"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace roblox_clone::core {
+
+namespace {
+
+bool detectAvx2() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    const bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6;
+    if (!osSavesYmm) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#elif defined(__x86_64__) || defined(__i386__)
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+}
+
+const char* getKernelName(SimdKernel kernel) {
+    switch (kernel) {
+        case SimdKernel::Scalar:
+            return "scalar";
+        case SimdKernel::Sse:
+            return "sse";
+        case SimdKernel::Avx2:
+            return "avx2";
+    }
+    return "unknown";
+}
+
+bool cpuSupportsAvx2() {
+    static const bool hasAvx2 = detectAvx2();
+    return hasAvx2;
+}
+
+}
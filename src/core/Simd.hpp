@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+namespace roblox_clone::core {
+
+// Instruction sets that batch kernels are built for. Which ones a module can
+// run depends on its build as well as the CPU.
+enum class SimdKernel : uint8_t {
+    Scalar,
+    Sse,
+    Avx2
+};
+
+const char* getKernelName(SimdKernel kernel);
+
+// Checked once. False off x86 and when the OS does not save the YMM registers.
+bool cpuSupportsAvx2();
+
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+// Float lanes for batch kernels that are written once against a lane type and
+// instantiated for plain floats, SSE and AVX2. The lane types only wrap
+// operations that round identically in every instruction set (no FMA, no
+// reciprocal estimates, min and max with the SSE operand order), so every
+// instantiation computes bit for bit the same results.
+//
+// Lanes8 only exists in files built with AVX2 enabled. Everything lives in an
+// anonymous namespace so the linker can never merge an AVX2 compiled copy into
+// a scalar or SSE path.
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ROBLOX_CLONE_SSE 1
+#include <emmintrin.h>
+#else
+#define ROBLOX_CLONE_SSE 0
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace roblox_clone::core {
+
+namespace {
+
+struct Lanes1 {
+    static constexpr int Width = 1;
+    using Mask = bool;
+    
+    float value;
+    
+    Lanes1() = default;
+    explicit Lanes1(float scalar) : value(scalar) {}
+    
+    static Lanes1 load(const float* source) { return Lanes1(*source); }
+    void store(float* target) const { *target = value; }
+};
+
+inline Lanes1 operator+(Lanes1 a, Lanes1 b) { return Lanes1(a.value + b.value); }
+inline Lanes1 operator-(Lanes1 a, Lanes1 b) { return Lanes1(a.value - b.value); }
+inline Lanes1 operator*(Lanes1 a, Lanes1 b) { return Lanes1(a.value * b.value); }
+inline Lanes1 operator/(Lanes1 a, Lanes1 b) { return Lanes1(a.value / b.value); }
+inline Lanes1 operator-(Lanes1 a) { return Lanes1(-a.value); }
+inline bool operator<(Lanes1 a, Lanes1 b) { return a.value < b.value; }
+inline bool operator>(Lanes1 a, Lanes1 b) { return a.value > b.value; }
+inline bool operator<=(Lanes1 a, Lanes1 b) { return a.value <= b.value; }
+inline bool operator>=(Lanes1 a, Lanes1 b) { return a.value >= b.value; }
+inline bool operator==(Lanes1 a, Lanes1 b) { return a.value == b.value; }
+inline Lanes1 min(Lanes1 a, Lanes1 b) { return a.value < b.value ? a : b; }
+inline Lanes1 max(Lanes1 a, Lanes1 b) { return a.value > b.value ? a : b; }
+inline Lanes1 abs(Lanes1 a) { return Lanes1(std::fabs(a.value)); }
+inline Lanes1 sqrt(Lanes1 a) { return Lanes1(std::sqrt(a.value)); }
+// Nearest integer, ties to even. Only exact for |a| < 2^31.
+inline Lanes1 nearest(Lanes1 a) { return Lanes1(std::nearbyint(a.value)); }
+inline Lanes1 select(bool mask, Lanes1 a, Lanes1 b) { return mask ? a : b; }
+inline bool any(bool mask) { return mask; }
+
+#if ROBLOX_CLONE_SSE
+struct Mask4 {
+    __m128 value;
+};
+
+inline Mask4 operator&(Mask4 a, Mask4 b) { return { _mm_and_ps(a.value, b.value) }; }
+inline Mask4 operator|(Mask4 a, Mask4 b) { return { _mm_or_ps(a.value, b.value) }; }
+inline Mask4 operator!(Mask4 a) { return { _mm_xor_ps(a.value, _mm_castsi128_ps(_mm_set1_epi32(-1))) }; }
+inline bool any(Mask4 mask) { return _mm_movemask_ps(mask.value) != 0; }
+
+struct Lanes4 {
+    static constexpr int Width = 4;
+    using Mask = Mask4;
+    
+    __m128 value;
+    
+    Lanes4() = default;
+    explicit Lanes4(float scalar) : value(_mm_set1_ps(scalar)) {}
+    explicit Lanes4(__m128 vector) : value(vector) {}
+    
+    static Lanes4 load(const float* source) { return Lanes4(_mm_load_ps(source)); }
+    void store(float* target) const { _mm_store_ps(target, value); }
+};
+
+inline Lanes4 operator+(Lanes4 a, Lanes4 b) { return Lanes4(_mm_add_ps(a.value, b.value)); }
+inline Lanes4 operator-(Lanes4 a, Lanes4 b) { return Lanes4(_mm_sub_ps(a.value, b.value)); }
+inline Lanes4 operator*(Lanes4 a, Lanes4 b) { return Lanes4(_mm_mul_ps(a.value, b.value)); }
+inline Lanes4 operator/(Lanes4 a, Lanes4 b) { return Lanes4(_mm_div_ps(a.value, b.value)); }
+inline Lanes4 operator-(Lanes4 a) { return Lanes4(_mm_xor_ps(a.value, _mm_set1_ps(-0.0f))); }
+inline Mask4 operator<(Lanes4 a, Lanes4 b) { return { _mm_cmplt_ps(a.value, b.value) }; }
+inline Mask4 operator>(Lanes4 a, Lanes4 b) { return { _mm_cmpgt_ps(a.value, b.value) }; }
+inline Mask4 operator<=(Lanes4 a, Lanes4 b) { return { _mm_cmple_ps(a.value, b.value) }; }
+inline Mask4 operator>=(Lanes4 a, Lanes4 b) { return { _mm_cmpge_ps(a.value, b.value) }; }
+inline Mask4 operator==(Lanes4 a, Lanes4 b) { return { _mm_cmpeq_ps(a.value, b.value) }; }
+inline Lanes4 min(Lanes4 a, Lanes4 b) { return Lanes4(_mm_min_ps(a.value, b.value)); }
+inline Lanes4 max(Lanes4 a, Lanes4 b) { return Lanes4(_mm_max_ps(a.value, b.value)); }
+inline Lanes4 abs(Lanes4 a) { return Lanes4(_mm_andnot_ps(_mm_set1_ps(-0.0f), a.value)); }
+inline Lanes4 sqrt(Lanes4 a) { return Lanes4(_mm_sqrt_ps(a.value)); }
+inline Lanes4 nearest(Lanes4 a) { return Lanes4(_mm_cvtepi32_ps(_mm_cvtps_epi32(a.value))); }
+inline Lanes4 select(Mask4 mask, Lanes4 a, Lanes4 b) {
+    return Lanes4(_mm_or_ps(_mm_and_ps(mask.value, a.value), _mm_andnot_ps(mask.value, b.value)));
+}
+#endif
+
+#if defined(__AVX2__)
+struct Mask8 {
+    __m256 value;
+};
+
+inline Mask8 operator&(Mask8 a, Mask8 b) { return { _mm256_and_ps(a.value, b.value) }; }
+inline Mask8 operator|(Mask8 a, Mask8 b) { return { _mm256_or_ps(a.value, b.value) }; }
+inline Mask8 operator!(Mask8 a) { return { _mm256_xor_ps(a.value, _mm256_castsi256_ps(_mm256_set1_epi32(-1))) }; }
+inline bool any(Mask8 mask) { return _mm256_movemask_ps(mask.value) != 0; }
+
+struct Lanes8 {
+    static constexpr int Width = 8;
+    using Mask = Mask8;
+    
+    __m256 value;
+    
+    Lanes8() = default;
+    explicit Lanes8(float scalar) : value(_mm256_set1_ps(scalar)) {}
+    explicit Lanes8(__m256 vector) : value(vector) {}
+    
+    static Lanes8 load(const float* source) { return Lanes8(_mm256_load_ps(source)); }
+    void store(float* target) const { _mm256_store_ps(target, value); }
+};
+
+inline Lanes8 operator+(Lanes8 a, Lanes8 b) { return Lanes8(_mm256_add_ps(a.value, b.value)); }
+inline Lanes8 operator-(Lanes8 a, Lanes8 b) { return Lanes8(_mm256_sub_ps(a.value, b.value)); }
+inline Lanes8 operator*(Lanes8 a, Lanes8 b) { return Lanes8(_mm256_mul_ps(a.value, b.value)); }
+inline Lanes8 operator/(Lanes8 a, Lanes8 b) { return Lanes8(_mm256_div_ps(a.value, b.value)); }
+inline Lanes8 operator-(Lanes8 a) { return Lanes8(_mm256_xor_ps(a.value, _mm256_set1_ps(-0.0f))); }
+inline Mask8 operator<(Lanes8 a, Lanes8 b) { return { _mm256_cmp_ps(a.value, b.value, _CMP_LT_OQ) }; }
+inline Mask8 operator>(Lanes8 a, Lanes8 b) { return { _mm256_cmp_ps(a.value, b.value, _CMP_GT_OQ) }; }
+inline Mask8 operator<=(Lanes8 a, Lanes8 b) { return { _mm256_cmp_ps(a.value, b.value, _CMP_LE_OQ) }; }
+inline Mask8 operator>=(Lanes8 a, Lanes8 b) { return { _mm256_cmp_ps(a.value, b.value, _CMP_GE_OQ) }; }
+inline Mask8 operator==(Lanes8 a, Lanes8 b) { return { _mm256_cmp_ps(a.value, b.value, _CMP_EQ_OQ) }; }
+inline Lanes8 min(Lanes8 a, Lanes8 b) { return Lanes8(_mm256_min_ps(a.value, b.value)); }
+inline Lanes8 max(Lanes8 a, Lanes8 b) { return Lanes8(_mm256_max_ps(a.value, b.value)); }
+inline Lanes8 abs(Lanes8 a) { return Lanes8(_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.value)); }
+inline Lanes8 sqrt(Lanes8 a) { return Lanes8(_mm256_sqrt_ps(a.value)); }
+inline Lanes8 nearest(Lanes8 a) { return Lanes8(_mm256_cvtepi32_ps(_mm256_cvtps_epi32(a.value))); }
+inline Lanes8 select(Mask8 mask, Lanes8 a, Lanes8 b) { return Lanes8(_mm256_blendv_ps(b.value, a.value, mask.value)); }
+#endif
+
+}
+
+}
@@ -0,0 +1,117 @@
+#include "StringInterner.hpp"
+#include "Logger.hpp"
+#include <mutex>
+
+namespace roblox_clone::core {
+
+StringId::StringId(std::string_view text) : m_value(StringInterner::get().intern(text).m_value) {}
+
+StringId StringId::find(std::string_view text) {
+    return StringInterner::get().find(text);
+}
+
+const std::string& StringId::str() const {
+    return StringInterner::get().resolve(*this);
+}
+
+StringInterner& StringInterner::get() {
+    static StringInterner interner;
+    return interner;
+}
+
+StringInterner::StringInterner() : m_slots(1024, 0), m_pages(new std::atomic<Entry*>[MaxPages]) {
+    for (uint32_t i = 0; i < MaxPages; ++i) {
+        m_pages[i].store(nullptr, std::memory_order_relaxed);
+    }
+    m_pages[0].store(new Entry[PageSize], std::memory_order_release);
+    m_count.store(1, std::memory_order_release);
+}
+
+StringInterner::~StringInterner() {
+    for (uint32_t i = 0; i < MaxPages; ++i) {
+        delete[] m_pages[i].load(std::memory_order_relaxed);
+    }
+}
+
+const StringInterner::Entry& StringInterner::entry(uint32_t id) const {
+    return m_pages[id >> PageBits].load(std::memory_order_acquire)[id & (PageSize - 1)];
+}
+
+uint32_t StringInterner::lookup(std::string_view text, uint32_t hash) const {
+    const size_t mask = m_slots.size() - 1;
+    for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+        const uint32_t id = m_slots[slot];
+        if (id == 0) return 0;
+        const Entry& candidate = entry(id);
+        if (candidate.hash == hash && candidate.text == text) return id;
+    }
+}
+
+void StringInterner::insertSlot(uint32_t id, uint32_t hash) {
+    const size_t mask = m_slots.size() - 1;
+    size_t slot = hash & mask;
+    while (m_slots[slot] != 0) {
+        slot = (slot + 1) & mask;
+    }
+    m_slots[slot] = id;
+}
+
+StringId StringInterner::intern(std::string_view text, uint32_t hash) {
+    if (text.empty()) return {};
+    {
+        std::shared_lock lock(m_mutex);
+        if (const uint32_t id = lookup(text, hash)) return StringId(id);
+    }
+    
+    std::unique_lock lock(m_mutex);
+    if (const uint32_t id = lookup(text, hash)) return StringId(id);
+    
+    const uint32_t id = m_count.load(std::memory_order_relaxed);
+    if ((id >> PageBits) >= MaxPages) {
+        RC_ERROR("String interner is full, dropping \"{}\"", text);
+        return {};
+    }
+    Entry* page = m_pages[id >> PageBits].load(std::memory_order_relaxed);
+    if (!page) {
+        page = new Entry[PageSize];
+        m_pages[id >> PageBits].store(page, std::memory_order_release);
+    }
+    Entry& added = page[id & (PageSize - 1)];
+    added.text = text;
+    added.hash = hash;
+    m_textBytes += text.size();
+    
+    // Keep the table at most half full.
+    if ((id + 1) * 2 > m_slots.size()) {
+        m_slots.assign(m_slots.size() * 2, 0);
+        for (uint32_t existing = 1; existing < id; ++existing) {
+            insertSlot(existing, entry(existing).hash);
+        }
+    }
+    insertSlot(id, hash);
+    m_count.store(id + 1, std::memory_order_release);
+    return StringId(id);
+}
+
+StringId StringInterner::find(std::string_view text, uint32_t hash) const {
+    if (text.empty()) return {};
+    std::shared_lock lock(m_mutex);
+    return StringId(lookup(text, hash));
+}
+
+const std::string& StringInterner::resolve(StringId id) const {
+    if (id.value() >= m_count.load(std::memory_order_acquire)) return entry(0).text;
+    return entry(id.value()).text;
+}
+
+size_t StringInterner::getMemoryBytes() const {
+    std::shared_lock lock(m_mutex);
+    size_t pages = 0;
+    for (uint32_t i = 0; i < MaxPages && m_pages[i].load(std::memory_order_relaxed); ++i) {
+        ++pages;
+    }
+    return m_textBytes + pages * PageSize * sizeof(Entry) + m_slots.size() * sizeof(uint32_t) +
+           MaxPages * sizeof(std::atomic<Entry*>);
+}
+
+}
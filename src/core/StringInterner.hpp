@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace roblox_clone::core {
+
+// 32-bit FNV-1a, constexpr so literals hash at compile time.
+constexpr uint32_t hashString(std::string_view text) {
+    uint32_t hash = 2166136261u;
+    for (char c : text) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+    }
+    return hash;
+}
+
+// A string in the global interner. Equal text always gets the same id, so
+// copying and comparing are integer operations. Ids are handed out in order
+// and only mean something within one run; files store the text.
+class StringId {
+public:
+    constexpr StringId() = default;
+    StringId(std::string_view text);
+    StringId(const std::string& text) : StringId(std::string_view(text)) {}
+    StringId(const char* text) : StringId(std::string_view(text)) {}
+    
+    // The id of text if it was ever interned, else an empty id. Adds nothing.
+    static StringId find(std::string_view text);
+    
+    const std::string& str() const;
+    const char* c_str() const { return str().c_str(); }
+    constexpr uint32_t value() const { return m_value; }
+    constexpr bool empty() const { return m_value == 0; }
+    
+    friend constexpr bool operator==(StringId a, StringId b) { return a.m_value == b.m_value; }
+    friend constexpr bool operator!=(StringId a, StringId b) { return a.m_value != b.m_value; }
+    friend constexpr bool operator<(StringId a, StringId b) { return a.m_value < b.m_value; }
+
+private:
+    friend class StringInterner;
+    
+    explicit constexpr StringId(uint32_t value) : m_value(value) {}
+    
+    uint32_t m_value = 0;
+};
+
+// The table behind StringId. Interning text that is already known takes a
+// shared lock, adding new text an exclusive one. Resolving an id takes no lock:
+// entries live in pages that never move and are not changed once added.
+// Strings are kept until exit; id 0 is the empty string.
+class StringInterner {
+public:
+    static StringInterner& get();
+    
+    ~StringInterner();
+    
+    StringInterner(const StringInterner&) = delete;
+    StringInterner& operator=(const StringInterner&) = delete;
+    
+    StringId intern(std::string_view text) { return intern(text, hashString(text)); }
+    StringId intern(std::string_view text, uint32_t hash);
+    StringId find(std::string_view text) const { return find(text, hashString(text)); }
+    StringId find(std::string_view text, uint32_t hash) const;
+    const std::string& resolve(StringId id) const;
+    
+    size_t getCount() const { return m_count.load(std::memory_order_acquire); }
+    // Text, entries and the lookup table.
+    size_t getMemoryBytes() const;
+
+private:
+    static constexpr uint32_t PageBits = 12;
+    static constexpr uint32_t PageSize = 1u << PageBits;
+    static constexpr uint32_t MaxPages = 1u << 14;
+    
+    struct Entry {
+        std::string text;
+        uint32_t hash = 0;
+    };
+    
+    StringInterner();
+    
+    const Entry& entry(uint32_t id) const;
+    uint32_t lookup(std::string_view text, uint32_t hash) const;
+    void insertSlot(uint32_t id, uint32_t hash);
+    
+    mutable std::shared_mutex m_mutex;
+    // Open addressing on the hash; holds ids, 0 marks a free slot.
+    std::vector<uint32_t> m_slots;
+    std::unique_ptr<std::atomic<Entry*>[]> m_pages;
+    std::atomic<uint32_t> m_count{0};
+    size_t m_textBytes = 0;
+};
+
+}
+
+// Id of a string literal. The hash is computed at compile time and the table
+// is searched once per call site.
+#define RC_STRING_ID(text) \
+    ([]() -> ::roblox_clone::core::StringId { \
+        static const ::roblox_clone::core::StringId id = ::roblox_clone::core::StringInterner::get().intern( \
+            text, std::integral_constant<uint32_t, ::roblox_clone::core::hashString(text)>::value); \
+        return id; \
+    }())
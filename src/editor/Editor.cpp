@@ -1,10 +1,17 @@
 #include "Editor.hpp"
 #include "Viewport.hpp"
+#include "core/FrameAllocator.hpp"
 #include "core/Logger.hpp"
+#include "core/Profiler.hpp"
+#include "renderer/CascadedShadowMap.hpp"
+#include "renderer/DynamicResolution.hpp"
+#include "scene/SceneFile.hpp"
 #include <imgui.h>
 #include <imgui_impl_sdl2.h>
 #include <imgui_impl_opengl3.h>
 #include <SDL.h>
+#include <algorithm>
+#include <vector>
 
 namespace roblox_clone::editor {
 
@@ -13,6 +20,7 @@ Editor::Editor() {
 }
 
 Editor::~Editor() {
+    listenForChanges(nullptr);
     shutdown();
 }
 
@@ -95,7 +103,10 @@ void Editor::render(scene::Scene* scene, float deltaTime) {
     
     ImGui::DockSpaceOverViewport(ImGui::GetMainViewport());
     
-    renderMenuBar();
+    if (scene != m_changeScene) {
+        listenForChanges(scene);
+    }
+    renderMenuBar(scene);
     
     if (m_showHierarchy) {
         renderSceneHierarchy(scene);
@@ -113,6 +124,14 @@ void Editor::render(scene::Scene* scene, float deltaTime) {
         renderStats(deltaTime);
     }
     
+    if (m_showProfiler) {
+        renderProfiler();
+    }
+    
+    if (m_showSystems) {
+        renderSystems(scene);
+    }
+    
     if (m_showDemo) {
         ImGui::ShowDemoWindow(&m_showDemo);
     }
@@ -150,12 +169,31 @@ void Editor::setupStyle() {
     colors[ImGuiCol_SliderGrabActive] = ImVec4(0.26f, 0.59f, 0.98f, 1.00f);
 }
 
-void Editor::renderMenuBar() {
+void Editor::renderMenuBar(scene::Scene* scene) {
     if (ImGui::BeginMainMenuBar()) {
         if (ImGui::BeginMenu("File")) {
-            if (ImGui::MenuItem("New Scene", "Ctrl+N")) {}
-            if (ImGui::MenuItem("Open Scene", "Ctrl+O")) {}
-            if (ImGui::MenuItem("Save Scene", "Ctrl+S")) {}
+            ImGui::InputText("Path", m_scenePath, sizeof(m_scenePath));
+            if (ImGui::MenuItem("New Scene", "Ctrl+N") && scene) {
+                scene->clear();
+                m_selectedEntity = {};
+            }
+            if (ImGui::MenuItem("Open Scene", "Ctrl+O") && scene) {
+                scene->clear();
+                m_selectedEntity = {};
+                scene::loadScene(*scene, m_scenePath);
+            }
+            if (ImGui::MenuItem("Save Scene", "Ctrl+S") && scene) {
+                scene::saveScene(*scene, m_scenePath);
+            }
+            ImGui::Separator();
+            if (ImGui::MenuItem("Import JSON") && scene) {
+                scene->clear();
+                m_selectedEntity = {};
+                scene::importSceneJson(*scene, std::string(m_scenePath) + ".json");
+            }
+            if (ImGui::MenuItem("Export JSON") && scene) {
+                scene::exportSceneJson(*scene, std::string(m_scenePath) + ".json");
+            }
             ImGui::Separator();
             if (ImGui::MenuItem("Exit")) {}
             ImGui::EndMenu();
@@ -176,6 +214,8 @@ void Editor::renderMenuBar() {
             ImGui::MenuItem("Properties", nullptr, &m_showProperties);
             ImGui::MenuItem("Console", nullptr, &m_showConsole);
             ImGui::MenuItem("Stats", nullptr, &m_showStats);
+            ImGui::MenuItem("Profiler", nullptr, &m_showProfiler);
+            ImGui::MenuItem("Systems", nullptr, &m_showSystems);
             ImGui::Separator();
             ImGui::MenuItem("ImGui Demo", nullptr, &m_showDemo);
             ImGui::EndMenu();
@@ -232,24 +272,69 @@ void Editor::renderPropertiesPanel(scene::Scene* scene) {
     ImGui::Begin("Properties", &m_showProperties);
     
     if (m_selectedEntity && m_selectedEntity.getScene() == scene) {
+        if (!(m_changesEntity == m_selectedEntity)) {
+            m_changesEntity = m_selectedEntity;
+            m_selectedChanges = 0;
+        }
+        
         if (m_selectedEntity.hasComponent<scene::NameComponent>()) {
             auto& name = m_selectedEntity.getComponent<scene::NameComponent>();
             char buffer[256];
             strncpy(buffer, name.name.c_str(), sizeof(buffer));
             if (ImGui::InputText("Name", buffer, sizeof(buffer))) {
-                name.name = buffer;
+                m_selectedEntity.setName(buffer);
             }
         }
         
         if (m_selectedEntity.hasComponent<scene::TransformComponent>()) {
-            auto& transform = m_selectedEntity.getComponent<scene::TransformComponent>();
+            // Edited through copies so the setters see the old values and
+            // raise change events.
+            auto transform = m_selectedEntity.getComponent<scene::TransformComponent>();
             
             ImGui::Separator();
             ImGui::Text("Transform");
             
-            ImGui::DragFloat3("Position", &transform.position.x, 0.1f);
-            ImGui::DragFloat3("Rotation", &transform.rotation.x, 1.0f);
-            ImGui::DragFloat3("Scale", &transform.scale.x, 0.1f);
+            if (ImGui::DragFloat3("Position", &transform.position.x, 0.1f)) {
+                m_selectedEntity.setPosition(transform.position);
+            }
+            if (ImGui::DragFloat3("Rotation", &transform.rotation.x, 1.0f)) {
+                m_selectedEntity.setRotation(transform.rotation);
+            }
+            if (ImGui::DragFloat3("Scale", &transform.scale.x, 0.1f)) {
+                m_selectedEntity.setScale(transform.scale);
+            }
+        }
+        
+        if (m_selectedEntity.hasComponent<scene::MeshRendererComponent>()) {
+            auto meshRenderer = m_selectedEntity.getComponent<scene::MeshRendererComponent>();
+            
+            ImGui::Separator();
+            ImGui::Text("Mesh Renderer");
+            
+            if (ImGui::Checkbox("Visible", &meshRenderer.visible)) {
+                m_selectedEntity.setVisible(meshRenderer.visible);
+            }
+            if (ImGui::Checkbox("Cast Shadows", &meshRenderer.castShadows)) {
+                m_selectedEntity.setCastShadows(meshRenderer.castShadows);
+            }
+            if (ImGui::Checkbox("Receive Shadows", &meshRenderer.receiveShadows)) {
+                m_selectedEntity.setReceiveShadows(meshRenderer.receiveShadows);
+            }
+            if (ImGui::Checkbox("Static", &meshRenderer.isStatic)) {
+                m_selectedEntity.setStatic(meshRenderer.isStatic);
+            }
+        }
+        
+        if (m_selectedChanges != 0) {
+            core::FrameString changes;
+            for (uint8_t bit = 0; bit < static_cast<uint8_t>(scene::Property::Count); ++bit) {
+                const auto property = static_cast<scene::Property>(bit);
+                if ((m_selectedChanges & scene::propertyBit(property)) == 0) continue;
+                changes += changes.empty() ? "" : ", ";
+                changes += scene::getPropertyName(property);
+            }
+            ImGui::Separator();
+            ImGui::TextDisabled("Changed since selected: %s", changes.c_str());
         }
     } else {
         ImGui::Text("No entity selected");
@@ -258,6 +343,37 @@ void Editor::renderPropertiesPanel(scene::Scene* scene) {
     ImGui::End();
 }
 
+void Editor::listenForChanges(scene::Scene* scene) {
+    if (m_changeScene) {
+        for (uint32_t id : m_changeListeners) {
+            m_changeScene->getChangeTracker().removeListener(id);
+        }
+    }
+    m_changeListeners.clear();
+    m_selectedChanges = 0;
+    
+    m_changeScene = scene;
+    if (!scene) return;
+    
+    for (size_t component = 0; component < static_cast<size_t>(scene::TrackedComponent::Count); ++component) {
+        m_changeListeners.push_back(scene->getChangeTracker().addListener(
+            static_cast<scene::TrackedComponent>(component),
+            [this](const scene::ChangeBatch& batch) { onChangeBatch(batch); }));
+    }
+}
+
+void Editor::onChangeBatch(const scene::ChangeBatch& batch) {
+    if (!m_changesEntity) return;
+    
+    const entt::entity selected = m_changesEntity;
+    for (size_t i = 0; i < batch.count; ++i) {
+        if (batch.entities[i] == selected) {
+            m_selectedChanges |= batch.properties[i];
+            return;
+        }
+    }
+}
+
 void Editor::renderConsole() {
     ImGui::Begin("Console", &m_showConsole);
     
@@ -282,11 +398,264 @@ void Editor::renderStats(float deltaTime) {
     ImGui::Text("Frame Time: %.2f ms", m_frameTime);
     ImGui::Text("Delta Time: %.4f s", deltaTime);
     
+    const auto& arenaStats = core::FrameAllocator::getStats();
+    ImGui::Text("Frame Arena: %.1f KiB (peak %.1f KiB, reserved %.1f KiB)", arenaStats.lastFrameBytes / 1024.0,
+                arenaStats.peakFrameBytes / 1024.0, arenaStats.capacityBytes / 1024.0);
+    
+    if (m_changeScene) {
+        const auto& changeStats = m_changeScene->getChangeTracker().getStats();
+        ImGui::Text("Property Changes: %zu on %zu entities (%.1f us)", changeStats.changedProperties,
+                    changeStats.changedEntities, changeStats.dispatchUs);
+    }
+    
     if (m_renderer) {
         auto& camera = m_renderer->getCamera();
         ImGui::Separator();
         ImGui::Text("Camera Position: (%.1f, %.1f, %.1f)", 
                     camera.position.x, camera.position.y, camera.position.z);
+        
+        if (auto* dynamicResolution = m_renderer->getBackend()->getDynamicResolution();
+            dynamicResolution && dynamicResolution->isEnabled() && m_window) {
+            ImGui::Separator();
+            ImGui::Text("Resolution Scale: %.0f%% (%dx%d)", dynamicResolution->getScale() * 100.0f,
+                        dynamicResolution->scaledSize(m_window->getWidth()),
+                        dynamicResolution->scaledSize(m_window->getHeight()));
+            ImGui::Text("GPU Frame Time: %.2f ms (target %.2f ms)", dynamicResolution->getSmoothedGpuTimeMs(),
+                        dynamicResolution->getSettings().targetFrameTimeMs);
+        }
+        
+        if (const auto* shadowMap = m_renderer->getShadowMap(); shadowMap && m_renderer->areShadowsEnabled()) {
+            ImGui::Separator();
+            ImGui::Text("Shadow Cascades");
+            for (int i = 0; i < shadowMap->getCascadeCount(); ++i) {
+                const auto& stats = shadowMap->getCascadeStats(i);
+                ImGui::Text("[%d] %.0fm | casters %u | CPU %.3f ms | GPU %.3f ms%s", i, stats.splitFar,
+                            stats.casterCount, stats.cpuTimeMs, stats.gpuTimeMs,
+                            stats.cached ? (stats.staticRefreshed ? " | static redraw" : " | cached") : "");
+            }
+        }
+    }
+    
+    ImGui::End();
+}
+
+void Editor::renderProfiler() {
+    ImGui::Begin("Profiler", &m_showProfiler);
+    
+    auto& profiler = core::Profiler::get();
+    
+    bool enabled = profiler.isEnabled();
+    if (ImGui::Checkbox("Enabled", &enabled)) {
+        profiler.setEnabled(enabled);
+    }
+    ImGui::SameLine();
+    bool paused = profiler.isPaused();
+    if (ImGui::Checkbox("Paused", &paused)) {
+        profiler.setPaused(paused);
+        m_profilerFrame = 0;
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Export Chrome Trace")) {
+        profiler.exportChromeTrace("profile_trace.json");
+    }
+    
+    int frameCount = static_cast<int>(profiler.getFrameCount());
+    if (frameCount == 0) {
+        ImGui::Text("No frames captured");
+        ImGui::End();
+        return;
+    }
+    
+    if (paused) {
+        ImGui::SliderInt("Frames Ago", &m_profilerFrame, 0, frameCount - 1);
+    } else {
+        m_profilerFrame = 0;
+    }
+    ImGui::SliderFloat("Zoom", &m_profilerZoom, 1.0f, 32.0f, "%.1fx", ImGuiSliderFlags_Logarithmic);
+    
+    const core::ProfileFrame* frame = profiler.getFrame(static_cast<size_t>(m_profilerFrame));
+    const uint64_t frameStart = frame->startNs;
+    const uint64_t frameEnd = frame->endNs;
+    ImGui::Text("Frame: %.3f ms", static_cast<double>(frameEnd - frameStart) / 1.0e6);
+    
+    // GPU results and events from other threads are drained a few frames after
+    // they happened, so neighbouring frames are scanned for anything in range.
+    std::vector<core::ProfileEvent> events;
+    int newest = std::max(0, m_profilerFrame - 6);
+    int oldest = std::min(frameCount - 1, m_profilerFrame + 1);
+    for (int i = newest; i <= oldest; ++i) {
+        for (const auto& event : profiler.getFrame(static_cast<size_t>(i))->events) {
+            if (event.endNs > frameStart && event.startNs < frameEnd) {
+                events.push_back(event);
+            }
+        }
+    }
+    
+    auto trackNames = profiler.getTrackNames();
+    std::vector<int> trackDepth(trackNames.size(), 0);
+    for (const auto& event : events) {
+        if (event.track < trackDepth.size()) {
+            trackDepth[event.track] = std::max(trackDepth[event.track], event.depth + 1);
+        }
+    }
+    
+    const float rowHeight = ImGui::GetTextLineHeight() + 4.0f;
+    const float labelWidth = 80.0f;
+    float contentHeight = 0.0f;
+    for (int depth : trackDepth) {
+        if (depth > 0) contentHeight += (static_cast<float>(depth) + 0.5f) * rowHeight;
+    }
+    
+    ImGui::BeginChild("Timeline", ImVec2(0.0f, std::max(contentHeight, rowHeight) + 16.0f), true,
+                      ImGuiWindowFlags_HorizontalScrollbar);
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    float timelineWidth = (ImGui::GetContentRegionAvail().x - labelWidth) * m_profilerZoom;
+    double nsToPixels = timelineWidth / static_cast<double>(std::max<uint64_t>(frameEnd - frameStart, 1));
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    ImVec2 mouse = ImGui::GetMousePos();
+    
+    float trackTop = origin.y;
+    for (size_t track = 0; track < trackNames.size(); ++track) {
+        if (trackDepth[track] == 0) continue;
+        drawList->AddText(ImVec2(origin.x, trackTop), IM_COL32(200, 200, 200, 255), trackNames[track].c_str());
+        
+        for (const auto& event : events) {
+            if (event.track != track) continue;
+            
+            uint64_t start = std::max(event.startNs, frameStart);
+            uint64_t end = std::min(event.endNs, frameEnd);
+            ImVec2 min(origin.x + labelWidth + static_cast<float>((start - frameStart) * nsToPixels),
+                       trackTop + static_cast<float>(event.depth) * rowHeight);
+            ImVec2 max(std::max(min.x + 1.0f, origin.x + labelWidth + static_cast<float>((end - frameStart) * nsToPixels)),
+                       min.y + rowHeight - 1.0f);
+            
+            uint32_t hash = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(event.name) * 2654435761u);
+            ImU32 color = IM_COL32(80 + (hash & 0x7F), 80 + ((hash >> 8) & 0x7F), 80 + ((hash >> 16) & 0x7F), 255);
+            drawList->AddRectFilled(min, max, color);
+            
+            const char* name = event.name ? event.name : "?";
+            if (max.x - min.x > ImGui::CalcTextSize(name).x + 4.0f) {
+                drawList->PushClipRect(min, max, true);
+                drawList->AddText(ImVec2(min.x + 2.0f, min.y + 2.0f), IM_COL32(0, 0, 0, 255), name);
+                drawList->PopClipRect();
+            }
+            
+            if (ImGui::IsWindowHovered() && mouse.x >= min.x && mouse.x < max.x && mouse.y >= min.y && mouse.y < max.y) {
+                ImGui::SetTooltip("%s\n%.3f ms", name, static_cast<double>(event.endNs - event.startNs) / 1.0e6);
+            }
+        }
+        
+        trackTop += (static_cast<float>(trackDepth[track]) + 0.5f) * rowHeight;
+    }
+    
+    ImGui::Dummy(ImVec2(labelWidth + timelineWidth, trackTop - origin.y));
+    ImGui::EndChild();
+    
+    struct ZoneTotal {
+        const char* name;
+        uint16_t track;
+        uint64_t totalNs;
+        uint32_t count;
+    };
+    std::vector<ZoneTotal> totals;
+    for (const auto& event : events) {
+        auto it = std::find_if(totals.begin(), totals.end(), [&event](const ZoneTotal& total) {
+            return total.name == event.name && total.track == event.track;
+        });
+        if (it == totals.end()) {
+            totals.push_back({ event.name, event.track, 0, 0 });
+            it = totals.end() - 1;
+        }
+        it->totalNs += event.endNs - event.startNs;
+        it->count++;
+    }
+    std::sort(totals.begin(), totals.end(), [](const ZoneTotal& a, const ZoneTotal& b) {
+        return a.track != b.track ? a.track < b.track : a.totalNs > b.totalNs;
+    });
+    
+    if (ImGui::BeginTable("Zones", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_ScrollY)) {
+        ImGui::TableSetupColumn("Track");
+        ImGui::TableSetupColumn("Zone");
+        ImGui::TableSetupColumn("Time (ms)");
+        ImGui::TableSetupColumn("Calls");
+        ImGui::TableHeadersRow();
+        for (const auto& total : totals) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(total.track < trackNames.size() ? trackNames[total.track].c_str() : "?");
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(total.name ? total.name : "?");
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", static_cast<double>(total.totalNs) / 1.0e6);
+            ImGui::TableNextColumn();
+            ImGui::Text("%u", total.count);
+        }
+        ImGui::EndTable();
+    }
+    
+    ImGui::End();
+}
+
+void Editor::renderSystems(scene::Scene* scene) {
+    ImGui::Begin("Systems", &m_showSystems);
+    
+    if (!scene) {
+        ImGui::Text("No scene loaded");
+        ImGui::End();
+        return;
+    }
+    
+    auto& scheduler = scene->getScheduler();
+    ImGui::Text("%zu systems in %u levels", scheduler.getSystemCount(), scheduler.getLevelCount());
+    if (scheduler.getConflictCount() > 0) {
+        ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%llu access conflicts detected",
+                           static_cast<unsigned long long>(scheduler.getConflictCount()));
+    }
+    
+    if (ImGui::BeginTable("SystemTable", 6, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders)) {
+        ImGui::TableSetupColumn("System");
+        ImGui::TableSetupColumn("On");
+        ImGui::TableSetupColumn("Level");
+        ImGui::TableSetupColumn("Deps");
+        ImGui::TableSetupColumn("Last (ms)");
+        ImGui::TableSetupColumn("Avg (ms)");
+        ImGui::TableHeadersRow();
+        
+        for (size_t i = 0; i < scheduler.getSystemCount(); ++i) {
+            const auto& system = scheduler.getSystem(i);
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(system.name.c_str());
+            if (ImGui::IsItemHovered()) {
+                ImGui::BeginTooltip();
+                if (system.access.exclusive) {
+                    ImGui::TextUnformatted("exclusive");
+                }
+                for (const auto& access : system.access.reads) {
+                    ImGui::Text("read  %.*s", static_cast<int>(access.name.size()), access.name.data());
+                }
+                for (const auto& access : system.access.writes) {
+                    ImGui::Text("write %.*s", static_cast<int>(access.name.size()), access.name.data());
+                }
+                ImGui::EndTooltip();
+            }
+            ImGui::TableNextColumn();
+            bool enabled = system.enabled;
+            ImGui::PushID(static_cast<int>(i));
+            if (ImGui::Checkbox("##enabled", &enabled)) {
+                scheduler.setEnabled(system.name, enabled);
+            }
+            ImGui::PopID();
+            ImGui::TableNextColumn();
+            ImGui::Text("%u", system.stats.level);
+            ImGui::TableNextColumn();
+            ImGui::Text("%u", system.stats.dependencyCount);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", system.stats.lastTimeMs);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", system.stats.averageTimeMs);
+        }
+        ImGui::EndTable();
     }
     
     ImGui::End();
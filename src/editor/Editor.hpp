@@ -29,11 +29,15 @@ public:
 
 private:
     void setupStyle();
-    void renderMenuBar();
+    void renderMenuBar(scene::Scene* scene);
     void renderSceneHierarchy(scene::Scene* scene);
     void renderPropertiesPanel(scene::Scene* scene);
     void renderConsole();
     void renderStats(float deltaTime);
+    void renderProfiler();
+    void renderSystems(scene::Scene* scene);
+    void listenForChanges(scene::Scene* scene);
+    void onChangeBatch(const scene::ChangeBatch& batch);
     
     renderer::Window* m_window = nullptr;
     renderer::Renderer* m_renderer = nullptr;
@@ -46,8 +50,21 @@ private:
     bool m_showStats = true;
     bool m_showHierarchy = true;
     bool m_showProperties = true;
+    bool m_showProfiler = false;
+    bool m_showSystems = false;
+    
+    int m_profilerFrame = 0;
+    float m_profilerZoom = 1.0f;
     
     scene::Entity m_selectedEntity;
+    // Properties of the selected entity changed since it was selected, by
+    // scripts, the network or the panels.
+    scene::Entity m_changesEntity;
+    scene::PropertyMask m_selectedChanges = 0;
+    scene::Scene* m_changeScene = nullptr;
+    std::vector<uint32_t> m_changeListeners;
+    // Binary scene file; the JSON export sits next to it with .json appended.
+    char m_scenePath[256] = "scene.rcscene";
     
     float m_fps = 0.0f;
     float m_frameTime = 0.0f;
@@ -1,5 +1,7 @@
 #include "Client.hpp"
+#include "core/FrameAllocator.hpp"
 #include "core/Logger.hpp"
+#include "scene/PropertyReplication.hpp"
 
 namespace roblox_clone::network {
 
@@ -48,11 +50,11 @@ void Client::disconnect() {
 }
 
 void Client::update() {
+    // Packets are handled by the receive callback inside pollEvent, which
+    // frees them before returning, so event.data must not be read here.
     NetworkEvent event;
     while (m_network.pollEvent(event, 0)) {
-        if (event.type == NetworkEvent::Type::Receive) {
-            handlePacket(event.data, event.dataLength);
-        } else if (event.type == NetworkEvent::Type::Disconnect) {
+        if (event.type == NetworkEvent::Type::Disconnect) {
             RC_WARN("Disconnected from server");
         }
     }
@@ -94,12 +96,56 @@ void Client::handlePacket(const void* data, size_t size) {
             }
             break;
         }
+        case StateHashPacket::Type: {
+            if (size >= StateHashPacket::Size) {
+                const StateHashPacket packet = StateHashPacket::read(bytes);
+                m_serverHashes[packet.tick % HashHistory] = { packet.tick, packet.hash };
+                const TickHash& local = m_localHashes[packet.tick % HashHistory];
+                if (local.tick == packet.tick) {
+                    compareStateHash(packet.tick, local.hash, packet.hash);
+                }
+            }
+            break;
+        }
+        case PropertyChangesHeader::Type: {
+            if (size >= PropertyChangesHeader::Size && m_scene) {
+                const PropertyChangesHeader header = PropertyChangesHeader::read(bytes);
+                if (!scene::applyPropertyChanges(*m_scene, bytes + PropertyChangesHeader::Size,
+                                                 size - PropertyChangesHeader::Size, header.count)) {
+                    RC_WARN("Property changes packet is truncated");
+                }
+            }
+            break;
+        }
         default:
             RC_WARN("Unknown packet type: {}", type);
             break;
     }
 }
 
+void Client::recordStateHash(uint64_t tick, uint64_t hash) {
+    m_localHashes[tick % HashHistory] = { tick, hash };
+    const TickHash& server = m_serverHashes[tick % HashHistory];
+    if (server.tick == tick) {
+        compareStateHash(tick, hash, server.hash);
+    }
+}
+
+void Client::compareStateHash(uint64_t tick, uint64_t localHash, uint64_t serverHash) {
+    if (localHash == serverHash) {
+        ++m_verifiedTicks;
+        return;
+    }
+    
+    // Once diverged the states stay apart, so only the first tick is logged.
+    if (m_desyncCount++ == 0) {
+        RC_ERROR("Desync at tick {}: local state hash {:016x}, server {:016x}", tick, localHash, serverHash);
+    }
+    if (m_onDesync) {
+        m_onDesync(tick);
+    }
+}
+
 bool Client::sendInput(const void* data, size_t size) {
     if (!m_network.isConnected()) return false;
     
@@ -107,7 +153,7 @@ bool Client::sendInput(const void* data, size_t size) {
         uint8_t type = 0x10;
     } header;
     
-    std::vector<uint8_t> packet(sizeof(header) + size);
+    core::FrameVector<uint8_t> packet(sizeof(header) + size);
     memcpy(packet.data(), &header, sizeof(header));
     memcpy(packet.data() + sizeof(header), data, size);
     
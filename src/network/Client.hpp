@@ -1,6 +1,7 @@
 #pragma once
 
 #include "NetworkManager.hpp"
+#include <array>
 #include <functional>
 #include <thread>
 #include <atomic>
@@ -32,15 +33,38 @@ public:
     bool sendInput(const void* data, size_t size);
     bool sendChatMessage(const std::string& message);
     
+    // Desync detection for deterministic simulation: record the local state
+    // hash after each tick and it is checked against the server's hash for
+    // the same tick, whichever arrives first. Hashes older than HashHistory
+    // ticks are forgotten unchecked.
+    void recordStateHash(uint64_t tick, uint64_t hash);
+    void setOnDesync(std::function<void(uint64_t)> callback) { m_onDesync = callback; }
+    uint64_t getVerifiedTickCount() const { return m_verifiedTicks; }
+    uint64_t getDesyncCount() const { return m_desyncCount; }
+    
     bool isConnected() const { return m_network.isConnected(); }
     uint32_t getClientId() const { return m_clientId; }
 
 private:
+    static constexpr size_t HashHistory = 256;
+    
+    struct TickHash {
+        uint64_t tick = ~0ull;
+        uint64_t hash = 0;
+    };
+    
     void handlePacket(const void* data, size_t size);
+    void compareStateHash(uint64_t tick, uint64_t localHash, uint64_t serverHash);
     
     NetworkManager m_network;
     roblox_clone::scene::Scene* m_scene = nullptr;
     uint32_t m_clientId = 0;
+    
+    std::array<TickHash, HashHistory> m_localHashes;
+    std::array<TickHash, HashHistory> m_serverHashes;
+    std::function<void(uint64_t)> m_onDesync;
+    uint64_t m_verifiedTicks = 0;
+    uint64_t m_desyncCount = 0;
 };
 
 }
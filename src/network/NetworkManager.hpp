@@ -1,6 +1,8 @@
 #pragma once
 
 #include <enet/enet.h>
+#include <cstdint>
+#include <cstring>
 #include <string>
 #include <functional>
 #include <memory>
@@ -36,6 +38,51 @@ struct NetworkEvent {
     size_t dataLength = 0;
 };
 
+// Sent by the server after every deterministic tick so clients simulating
+// the same inputs can check they still agree. On the wire: the type byte,
+// then tick and hash, with no padding.
+struct StateHashPacket {
+    static constexpr uint8_t Type = 0x04;
+    static constexpr size_t Size = sizeof(uint8_t) + sizeof(uint64_t) * 2;
+    
+    uint64_t tick = 0;
+    uint64_t hash = 0;
+    
+    void write(uint8_t* out) const {
+        out[0] = Type;
+        std::memcpy(out + 1, &tick, sizeof(tick));
+        std::memcpy(out + 1 + sizeof(tick), &hash, sizeof(hash));
+    }
+    
+    static StateHashPacket read(const uint8_t* in) {
+        StateHashPacket packet;
+        std::memcpy(&packet.tick, in + 1, sizeof(packet.tick));
+        std::memcpy(&packet.hash, in + 1 + sizeof(packet.tick), sizeof(packet.hash));
+        return packet;
+    }
+};
+
+// Sent by the server at the end of a tick with the properties that changed
+// during it. The header is followed by count records in the format of
+// scene::writePropertyChanges.
+struct PropertyChangesHeader {
+    static constexpr uint8_t Type = 0x05;
+    static constexpr size_t Size = sizeof(uint8_t) + sizeof(uint32_t);
+    
+    uint32_t count = 0;
+    
+    void write(uint8_t* out) const {
+        out[0] = Type;
+        std::memcpy(out + 1, &count, sizeof(count));
+    }
+    
+    static PropertyChangesHeader read(const uint8_t* in) {
+        PropertyChangesHeader header;
+        std::memcpy(&header.count, in + 1, sizeof(header.count));
+        return header;
+    }
+};
+
 class NetworkManager {
 public:
     NetworkManager();
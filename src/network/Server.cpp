@@ -1,5 +1,8 @@
 #include "Server.hpp"
 #include "core/Logger.hpp"
+#include "core/Profiler.hpp"
+#include "scene/Scene.hpp"
+#include <cstring>
 
 namespace roblox_clone::network {
 
@@ -8,6 +11,7 @@ Server::Server() = default;
 Server::~Server() {
     stop();
     shutdown();
+    setScene(nullptr);
 }
 
 bool Server::initialize(const ServerConfig& config) {
@@ -36,6 +40,22 @@ void Server::shutdown() {
     m_network.shutdown();
 }
 
+void Server::setScene(roblox_clone::scene::Scene* scene) {
+    if (m_scene) {
+        for (uint32_t listener : m_changeListeners) {
+            m_scene->getChangeTracker().removeListener(listener);
+        }
+        m_changeListeners.clear();
+    }
+    m_scene = scene;
+    if (m_scene) {
+        for (auto component : { scene::TrackedComponent::Transform, scene::TrackedComponent::MeshRenderer }) {
+            m_changeListeners.push_back(m_scene->getChangeTracker().addListener(
+                component, [this](const scene::ChangeBatch& batch) { replicateChanges(batch); }));
+        }
+    }
+}
+
 void Server::start() {
     if (m_running) return;
     
@@ -55,25 +75,15 @@ void Server::stop() {
 }
 
 void Server::tick() {
+    RC_PROFILE_SCOPE("Server::tick");
     NetworkEvent event;
     while (m_network.pollEvent(event, 0)) {
-        switch (event.type) {
-            case NetworkEvent::Type::Connect:
-                handleConnect(event.peerId);
-                break;
-            case NetworkEvent::Type::Disconnect:
-                handleDisconnect(event.peerId);
-                break;
-            case NetworkEvent::Type::Receive:
-                handlePacket(event.peerId, event.data, event.dataLength);
-                break;
-            default:
-                break;
-        }
     }
 }
 
 void Server::runThread() {
+    core::Profiler::get().setThreadName("Server");
+    
     while (m_running) {
         tick();
         std::this_thread::sleep_for(std::chrono::milliseconds(1000 / m_config.tickRate));
@@ -100,6 +110,20 @@ void Server::handlePacket(uint32_t peerId, const void* data, size_t size) {
     RC_DEBUG("Received {} bytes from client {}", size, peerId);
 }
 
+void Server::replicateChanges(const roblox_clone::scene::ChangeBatch& batch) {
+    RC_PROFILE_SCOPE("Server::replicateChanges");
+    if (m_clients.empty()) return;
+    
+    PropertyChangesHeader header;
+    m_changePacket.resize(PropertyChangesHeader::Size);
+    header.count = scene::writePropertyChanges(m_scene->registry(), batch, m_changePacket);
+    if (header.count == 0) return;
+    
+    header.write(m_changePacket.data());
+    // Only changes are sent, so a lost packet would never be repaired.
+    m_network.broadcast(m_changePacket.data(), m_changePacket.size(), 1, true);
+}
+
 void Server::broadcastEntitySpawn(uint32_t networkId, const std::string& name) {
     struct {
         uint8_t type = 0x01;
@@ -137,4 +161,13 @@ void Server::broadcastEntityDestroy(uint32_t networkId) {
     m_network.broadcast(&packet, sizeof(packet), 0, true);
 }
 
+void Server::broadcastStateHash(uint64_t tick, uint64_t hash) {
+    StateHashPacket packet;
+    packet.tick = tick;
+    packet.hash = hash;
+    uint8_t bytes[StateHashPacket::Size];
+    packet.write(bytes);
+    m_network.broadcast(bytes, sizeof(bytes), 1, false);
+}
+
 }
@@ -1,11 +1,14 @@
 #pragma once
 
 #include "NetworkManager.hpp"
+#include "scene/ChangeTracker.hpp"
+#include "scene/PropertyReplication.hpp"
 #include <functional>
 #include <thread>
 #include <atomic>
 #include <queue>
 #include <mutex>
+#include <vector>
 
 namespace roblox_clone::scene { class Scene; }
 
@@ -29,11 +32,14 @@ public:
     void stop();
     void tick();
     
-    void setScene(roblox_clone::scene::Scene* scene) { m_scene = scene; }
+    // Replicated entities' transform and mesh renderer changes go out as one
+    // packet per component per tick.
+    void setScene(roblox_clone::scene::Scene* scene);
     
     void broadcastEntitySpawn(uint32_t networkId, const std::string& name);
     void broadcastEntityTransform(uint32_t networkId, const float* transform);
     void broadcastEntityDestroy(uint32_t networkId);
+    void broadcastStateHash(uint64_t tick, uint64_t hash);
     
     size_t getClientCount() const { return m_clients.size(); }
     bool isRunning() const { return m_running; }
@@ -43,10 +49,13 @@ private:
     void handleConnect(uint32_t peerId);
     void handleDisconnect(uint32_t peerId);
     void handlePacket(uint32_t peerId, const void* data, size_t size);
+    void replicateChanges(const roblox_clone::scene::ChangeBatch& batch);
     
     NetworkManager m_network;
     ServerConfig m_config;
     roblox_clone::scene::Scene* m_scene = nullptr;
+    std::vector<uint32_t> m_changeListeners;
+    std::vector<uint8_t> m_changePacket;
     
     std::thread m_thread;
     std::atomic<bool> m_running{false};
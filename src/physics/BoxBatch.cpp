@@ -0,0 +1,114 @@
+#include "BoxBatchKernel.hpp"
+
+#ifndef ROBLOX_CLONE_PHYSICS_AVX2
+#define ROBLOX_CLONE_PHYSICS_AVX2 0
+#endif
+
+namespace roblox_clone::physics {
+
+#if ROBLOX_CLONE_PHYSICS_AVX2
+// Built with AVX2 enabled in BoxBatchAvx2.cpp; only called after the CPU check.
+void collideBoxLanesAvx2(const BoxPairBatch& batch, float margin, BoxBatchResults& results);
+#endif
+
+namespace {
+
+// Candidates closer than this are the same point reached twice, e.g. an
+// incident vertex lying exactly on a reference face corner.
+constexpr float DuplicateDistanceSquared = 1.0e-8f;
+
+bool finishPair(const BoxBatchResults& results, int pair, ContactManifold& manifold) {
+    manifold.pointCount = 0;
+    if (results.touching[pair] == 0.0f) return false;
+    
+    ContactPoint points[MaxCandidates];
+    int count = 0;
+    for (int candidate = 0; candidate < MaxCandidates; ++candidate) {
+        if (results.valid[candidate][pair] == 0.0f) continue;
+        const glm::vec3 position(results.position[candidate][0][pair], results.position[candidate][1][pair],
+                                 results.position[candidate][2][pair]);
+        bool duplicate = false;
+        for (int i = 0; i < count && !duplicate; ++i) {
+            const glm::vec3 delta = points[i].position - position;
+            duplicate = glm::dot(delta, delta) < DuplicateDistanceSquared;
+        }
+        if (duplicate) continue;
+        points[count].position = position;
+        points[count].penetration = results.penetration[candidate][pair];
+        ++count;
+    }
+    if (count == 0) return false;
+    
+    const glm::vec3 normal(results.normal[0][pair], results.normal[1][pair], results.normal[2][pair]);
+    reducePoints(points, count, normal, manifold);
+    manifold.normal = results.flip[pair] != 0.0f ? -normal : normal;
+    return true;
+}
+
+}
+
+void BoxPairBatch::add(const glm::vec3& halfExtentsA, const Pose& poseA, const glm::vec3& halfExtentsB,
+                       const Pose& poseB) {
+    const int lane = count++;
+    for (int axis = 0; axis < 3; ++axis) {
+        halfA[axis][lane] = halfExtentsA[axis];
+        halfB[axis][lane] = halfExtentsB[axis];
+        positionA[axis][lane] = poseA.position[axis];
+        positionB[axis][lane] = poseB.position[axis];
+        for (int row = 0; row < 3; ++row) {
+            rotationA[3 * axis + row][lane] = poseA.rotation[axis][row];
+            rotationB[3 * axis + row][lane] = poseB.rotation[axis][row];
+        }
+    }
+}
+
+bool isKernelSupported(SimdKernel kernel) {
+    switch (kernel) {
+        case SimdKernel::Scalar:
+            return true;
+        case SimdKernel::Sse:
+            return ROBLOX_CLONE_SSE != 0;
+        case SimdKernel::Avx2:
+            return ROBLOX_CLONE_PHYSICS_AVX2 != 0 && core::cpuSupportsAvx2();
+    }
+    return false;
+}
+
+SimdKernel getBestKernel() {
+    if (isKernelSupported(SimdKernel::Avx2)) return SimdKernel::Avx2;
+    if (isKernelSupported(SimdKernel::Sse)) return SimdKernel::Sse;
+    return SimdKernel::Scalar;
+}
+
+uint32_t collideBoxBatch(const BoxPairBatch& batch, float margin, ContactManifold* manifolds, SimdKernel kernel) {
+    if (!isKernelSupported(kernel)) kernel = getBestKernel();
+    
+    BoxBatchResults results;
+    switch (kernel) {
+#if ROBLOX_CLONE_PHYSICS_AVX2
+        case SimdKernel::Avx2:
+            collideBoxLanesAvx2(batch, margin, results);
+            break;
+#endif
+#if ROBLOX_CLONE_SSE
+        case SimdKernel::Sse:
+            for (int lane = 0; lane < batch.count; lane += Lanes4::Width) {
+                collideBoxLanes<Lanes4>(batch, lane, margin, results);
+            }
+            break;
+#endif
+        default:
+            for (int lane = 0; lane < batch.count; ++lane) {
+                collideBoxLanes<Lanes1>(batch, lane, margin, results);
+            }
+            break;
+    }
+    
+    uint32_t touching = 0;
+    for (int pair = 0; pair < batch.count; ++pair) {
+        if (finishPair(results, pair, manifolds[pair])) touching |= 1u << pair;
+    }
+    return touching;
+}
+
+}
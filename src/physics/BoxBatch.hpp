@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Collision.hpp"
+#include "core/Simd.hpp"
+#include <glm/glm.hpp>
+#include <cstdint>
+
+namespace roblox_clone::physics {
+
+using core::getKernelName;
+using core::SimdKernel;
+
+// Box-box pairs in structure of arrays form, so one SIMD register holds the
+// same quantity for four or eight pairs. Rotations are stored column by
+// column: rotationA[3 * column + row].
+struct alignas(32) BoxPairBatch {
+    static constexpr int MaxPairs = 8;
+    
+    float halfA[3][MaxPairs] = {};
+    float halfB[3][MaxPairs] = {};
+    float positionA[3][MaxPairs] = {};
+    float positionB[3][MaxPairs] = {};
+    float rotationA[9][MaxPairs] = {};
+    float rotationB[9][MaxPairs] = {};
+    int count = 0;
+    
+    void add(const glm::vec3& halfExtentsA, const Pose& poseA, const glm::vec3& halfExtentsB, const Pose& poseB);
+    void clear() { count = 0; }
+    bool isFull() const { return count == MaxPairs; }
+};
+
+bool isKernelSupported(SimdKernel kernel);
+// The widest kernel this build and CPU can run.
+SimdKernel getBestKernel();
+
+// Runs the separating axis test and face clipping for every pair in the batch
+// and fills manifolds[0, batch.count). Returns a mask with bit i set when pair
+// i touches. All kernels produce bitwise identical manifolds.
+uint32_t collideBoxBatch(const BoxPairBatch& batch, float margin, ContactManifold* manifolds,
+                         SimdKernel kernel = getBestKernel());
+
+}
@@ -0,0 +1,22 @@
+// Compiled with AVX2 enabled (see src/CMakeLists.txt) and only entered after
+// collideBoxBatch has checked the CPU. FMA stays disabled so products are
+// rounded exactly like the SSE and scalar kernels.
+
+#include "BoxBatchKernel.hpp"
+
+#if ROBLOX_CLONE_PHYSICS_AVX2
+
+namespace roblox_clone::physics {
+
+namespace {
+
+using core::Lanes8;
+
+}
+
+void collideBoxLanesAvx2(const BoxPairBatch& batch, float margin, BoxBatchResults& results) {
+    collideBoxLanes<Lanes8>(batch, 0, margin, results);
+}
+
+}
+#endif
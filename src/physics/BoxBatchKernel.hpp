@@ -0,0 +1,364 @@
+#pragma once
+
+// The box-box kernel behind collideBoxBatch, written once against the lane
+// types of core/SimdLanes.hpp, so every kernel computes bit for bit the same
+// results.
+//
+// BoxBatch.cpp and BoxBatchAvx2.cpp both include this with different target
+// flags. The kernel lives in an anonymous namespace so the linker can never
+// merge an AVX2 compiled copy into the scalar path.
+
+#include "BoxBatch.hpp"
+#include "core/SimdLanes.hpp"
+#include <cmath>
+#include <limits>
+
+namespace roblox_clone::physics {
+
+constexpr int BatchWidth = BoxPairBatch::MaxPairs;
+constexpr float ParallelEpsilon = 1.0e-6f;
+// Edge axes and the second box's faces must beat the first box's faces by this
+// much before they are used, which keeps resting contacts from flickering
+// between features. The relative part scales with the separation's size, so
+// it favours faces for separated speculative pairs as well as overlaps.
+constexpr float RelativeTolerance = 0.05f;
+constexpr float AbsoluteTolerance = 0.01f;
+
+// Candidate contact points per pair: the 4 incident face vertices, the 4
+// reference face corners, 16 crossings of incident edges with the reference
+// face's sides and the edge-edge closest point.
+constexpr int VertexCandidates = 0;
+constexpr int CornerCandidates = 4;
+constexpr int CrossingCandidates = 8;
+constexpr int EdgeCandidate = 24;
+constexpr int MaxCandidates = 25;
+
+// Kernel output, lane by lane. Masks are stored as 0 or 1.
+struct alignas(32) BoxBatchResults {
+    float touching[BatchWidth];
+    float flip[BatchWidth];
+    float normal[3][BatchWidth];
+    float position[MaxCandidates][3][BatchWidth];
+    float penetration[MaxCandidates][BatchWidth];
+    float valid[MaxCandidates][BatchWidth];
+};
+
+namespace {
+
+using core::any;
+using core::Lanes1;
+#if ROBLOX_CLONE_SSE
+using core::Lanes4;
+#endif
+
+template<typename V>
+struct Vec3 {
+    V x;
+    V y;
+    V z;
+};
+
+template<typename V>
+Vec3<V> operator+(const Vec3<V>& a, const Vec3<V>& b) { return { a.x + b.x, a.y + b.y, a.z + b.z }; }
+template<typename V>
+Vec3<V> operator-(const Vec3<V>& a, const Vec3<V>& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+template<typename V>
+Vec3<V> operator*(const Vec3<V>& a, V scale) { return { a.x * scale, a.y * scale, a.z * scale }; }
+template<typename V>
+V dot(const Vec3<V>& a, const Vec3<V>& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+template<typename V>
+Vec3<V> cross(const Vec3<V>& a, const Vec3<V>& b) {
+    return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+}
+template<typename V>
+Vec3<V> select(typename V::Mask mask, const Vec3<V>& a, const Vec3<V>& b) {
+    return { select(mask, a.x, b.x), select(mask, a.y, b.y), select(mask, a.z, b.z) };
+}
+
+template<typename V>
+Vec3<V> loadVec3(const float (*source)[BatchWidth], int lane) {
+    return { V::load(&source[0][lane]), V::load(&source[1][lane]), V::load(&source[2][lane]) };
+}
+
+template<typename V>
+void storeVec3(const Vec3<V>& value, float (*target)[BatchWidth], int lane) {
+    value.x.store(&target[0][lane]);
+    value.y.store(&target[1][lane]);
+    value.z.store(&target[2][lane]);
+}
+
+template<typename V>
+V signOf(V value) {
+    return select(value >= V(0.0f), V(1.0f), V(-1.0f));
+}
+
+template<typename V>
+V clamp(V value, V low, V high) {
+    return min(max(value, low), high);
+}
+
+// Picks items[index] per lane, with index holding 0, 1 or 2.
+template<typename V, typename T>
+T pick(V index, const T* items) {
+    return select(index == V(0.0f), items[0], select(index == V(1.0f), items[1], items[2]));
+}
+
+template<typename V>
+V nextAxis(V index) {
+    return select(index == V(2.0f), V(0.0f), index + V(1.0f));
+}
+
+template<typename V>
+void storeMask(typename V::Mask mask, float* target) {
+    select(mask, V(1.0f), V(0.0f)).store(target);
+}
+
+template<typename V>
+struct BoxLanes {
+    Vec3<V> position;
+    Vec3<V> axes[3];
+    V half[3];
+};
+
+template<typename V>
+BoxLanes<V> loadBox(const float (*half)[BatchWidth], const float (*position)[BatchWidth],
+                    const float (*rotation)[BatchWidth], int lane) {
+    BoxLanes<V> box;
+    box.position = loadVec3<V>(position, lane);
+    for (int axis = 0; axis < 3; ++axis) {
+        box.axes[axis] = loadVec3<V>(rotation + 3 * axis, lane);
+        box.half[axis] = V::load(&half[axis][lane]);
+    }
+    return box;
+}
+
+template<typename V>
+BoxLanes<V> select(typename V::Mask mask, const BoxLanes<V>& a, const BoxLanes<V>& b) {
+    BoxLanes<V> box;
+    box.position = select(mask, a.position, b.position);
+    for (int axis = 0; axis < 3; ++axis) {
+        box.axes[axis] = select(mask, a.axes[axis], b.axes[axis]);
+        box.half[axis] = select(mask, a.half[axis], b.half[axis]);
+    }
+    return box;
+}
+
+// Collides lanes [lane, lane + V::Width) of the batch. Pairs are tested on the
+// same 15 axes with the same feature preferences as a scalar SAT, but every
+// lane runs both the face and the edge path and the clipping produces a fixed
+// set of candidates, so no lane ever branches.
+template<typename V>
+void collideBoxLanes(const BoxPairBatch& batch, int lane, float margin, BoxBatchResults& results) {
+    using Mask = typename V::Mask;
+    const V marginLanes(margin);
+    const V lowest(-std::numeric_limits<float>::max());
+    const BoxLanes<V> boxA = loadBox<V>(batch.halfA, batch.positionA, batch.rotationA, lane);
+    const BoxLanes<V> boxB = loadBox<V>(batch.halfB, batch.positionB, batch.rotationB, lane);
+    const Vec3<V> offset = boxB.position - boxA.position;
+    
+    V absolute[3][3];
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            absolute[i][j] = abs(dot(boxA.axes[i], boxB.axes[j])) + V(ParallelEpsilon);
+        }
+    }
+    
+    Mask separated = V(0.0f) > V(0.0f);
+    V faceSeparationA = lowest;
+    V faceA(0.0f);
+    for (int i = 0; i < 3; ++i) {
+        const V radiusB = boxB.half[0] * absolute[i][0] + boxB.half[1] * absolute[i][1] + boxB.half[2] * absolute[i][2];
+        const V separation = abs(dot(offset, boxA.axes[i])) - boxA.half[i] - radiusB;
+        separated = separated | (separation > marginLanes);
+        const Mask better = separation > faceSeparationA;
+        faceSeparationA = select(better, separation, faceSeparationA);
+        faceA = select(better, V(static_cast<float>(i)), faceA);
+    }
+    
+    V faceSeparationB = lowest;
+    V faceB(0.0f);
+    for (int j = 0; j < 3; ++j) {
+        const V radiusA = boxA.half[0] * absolute[0][j] + boxA.half[1] * absolute[1][j] + boxA.half[2] * absolute[2][j];
+        const V separation = abs(dot(offset, boxB.axes[j])) - boxB.half[j] - radiusA;
+        separated = separated | (separation > marginLanes);
+        const Mask better = separation > faceSeparationB;
+        faceSeparationB = select(better, separation, faceSeparationB);
+        faceB = select(better, V(static_cast<float>(j)), faceB);
+    }
+    
+    V edgeSeparation = lowest;
+    V edgeA(0.0f);
+    V edgeB(0.0f);
+    Vec3<V> edgeNormal = { V(0.0f), V(0.0f), V(0.0f) };
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            Vec3<V> axis = cross(boxA.axes[i], boxB.axes[j]);
+            const V length = sqrt(dot(axis, axis));
+            // Parallel edges give no axis; their lanes divide by one and
+            // never win or separate.
+            const Mask usable = length >= V(ParallelEpsilon);
+            const V divisor = select(usable, length, V(1.0f));
+            axis = { axis.x / divisor, axis.y / divisor, axis.z / divisor };
+            
+            V radiusA(0.0f);
+            V radiusB(0.0f);
+            for (int k = 0; k < 3; ++k) {
+                radiusA = radiusA + boxA.half[k] * abs(dot(boxA.axes[k], axis));
+                radiusB = radiusB + boxB.half[k] * abs(dot(boxB.axes[k], axis));
+            }
+            const V distance = dot(offset, axis);
+            const V separation = select(usable, abs(distance) - radiusA - radiusB, lowest);
+            separated = separated | (separation > marginLanes);
+            const Mask better = separation > edgeSeparation;
+            edgeSeparation = select(better, separation, edgeSeparation);
+            edgeA = select(better, V(static_cast<float>(i)), edgeA);
+            edgeB = select(better, V(static_cast<float>(j)), edgeB);
+            edgeNormal = select(better, axis * signOf(distance), edgeNormal);
+        }
+    }
+    
+    const Mask touching = !separated;
+    storeMask<V>(touching, &results.touching[lane]);
+    if (!any(touching)) return;
+    
+    const V faceSeparation = max(faceSeparationA, faceSeparationB);
+    const Mask useEdge = edgeSeparation > faceSeparation + V(RelativeTolerance) * abs(faceSeparation) +
+                                              V(AbsoluteTolerance);
+    const Mask useB = (!useEdge) & (faceSeparationB > faceSeparationA + V(RelativeTolerance) * abs(faceSeparationA) +
+                                                          V(AbsoluteTolerance));
+    const Mask clipping = touching & !useEdge;
+    
+    // Face contact: clip the incident box's most anti-parallel face against
+    // the reference face. The normal points from reference to incident.
+    const BoxLanes<V> reference = select(useB, boxB, boxA);
+    const BoxLanes<V> incident = select(useB, boxA, boxB);
+    const V face = select(useB, faceB, faceA);
+    const Vec3<V> faceAxis = pick(face, reference.axes);
+    const Vec3<V> normal = faceAxis * signOf(dot(incident.position - reference.position, faceAxis));
+    const V side1 = nextAxis(face);
+    const V side2 = nextAxis(side1);
+    const Vec3<V> sideAxis1 = pick(side1, reference.axes);
+    const Vec3<V> sideAxis2 = pick(side2, reference.axes);
+    const V sideHalf1 = pick(side1, reference.half);
+    const V sideHalf2 = pick(side2, reference.half);
+    const V referenceOffset = dot(normal, reference.position) + pick(face, reference.half);
+    
+    V incidentAxis(0.0f);
+    V alignment(-1.0f);
+    for (int axis = 0; axis < 3; ++axis) {
+        const V value = abs(dot(incident.axes[axis], normal));
+        const Mask better = value > alignment;
+        alignment = select(better, value, alignment);
+        incidentAxis = select(better, V(static_cast<float>(axis)), incidentAxis);
+    }
+    const Vec3<V> incidentNormal = pick(incidentAxis, incident.axes);
+    const V incidentSign = -signOf(dot(incidentNormal, normal));
+    const Vec3<V> faceCenter = incident.position + incidentNormal * (incidentSign * pick(incidentAxis, incident.half));
+    const V uAxis = nextAxis(incidentAxis);
+    const V vAxis = nextAxis(uAxis);
+    const Vec3<V> u = pick(uAxis, incident.axes) * pick(uAxis, incident.half);
+    const Vec3<V> v = pick(vAxis, incident.axes) * pick(vAxis, incident.half);
+    
+    // The incident face in reference face coordinates: x and y along the side
+    // axes, d the separation from the reference face.
+    const Vec3<V> quad[4] = { faceCenter + u + v, faceCenter - u + v, faceCenter - u - v, faceCenter + u - v };
+    V x[4];
+    V y[4];
+    V d[4];
+    for (int k = 0; k < 4; ++k) {
+        const Vec3<V> relative = quad[k] - reference.position;
+        x[k] = dot(relative, sideAxis1);
+        y[k] = dot(relative, sideAxis2);
+        d[k] = dot(normal, quad[k]) - referenceOffset;
+    }
+    
+    auto emit = [&](int candidate, const Vec3<V>& position, V separation, Mask inside) {
+        const Mask keep = clipping & inside & (separation <= marginLanes);
+        storeVec3(position - normal * (V(0.5f) * separation), results.position[candidate], lane);
+        (-separation).store(&results.penetration[candidate][lane]);
+        storeMask<V>(keep, &results.valid[candidate][lane]);
+    };
+    
+    for (int k = 0; k < 4; ++k) {
+        emit(VertexCandidates + k, quad[k], d[k], (abs(x[k]) <= sideHalf1) & (abs(y[k]) <= sideHalf2));
+    }
+    
+    // Reference corners inside the incident quad, projected along the normal
+    // onto the incident face.
+    const V incidentOffset = dot(incidentNormal, faceCenter);
+    const V incidentSlope = dot(incidentNormal, normal);
+    for (int corner = 0; corner < 4; ++corner) {
+        const V cornerX = (corner == 0 || corner == 3) ? sideHalf1 : -sideHalf1;
+        const V cornerY = corner < 2 ? sideHalf2 : -sideHalf2;
+        Mask positive = V(0.0f) >= V(0.0f);
+        Mask negative = positive;
+        for (int k = 0; k < 4; ++k) {
+            const int next = (k + 1) % 4;
+            const V side = (x[next] - x[k]) * (cornerY - y[k]) - (y[next] - y[k]) * (cornerX - x[k]);
+            positive = positive & (side >= V(0.0f));
+            negative = negative & (side <= V(0.0f));
+        }
+        const Vec3<V> base = reference.position + sideAxis1 * cornerX + sideAxis2 * cornerY;
+        const V t = (incidentOffset - dot(incidentNormal, base)) / incidentSlope;
+        const Vec3<V> position = base + normal * t;
+        emit(CornerCandidates + corner, position, dot(normal, position) - referenceOffset, positive | negative);
+    }
+    
+    // Incident edges crossing the reference face's four sides.
+    for (int k = 0; k < 4; ++k) {
+        const int next = (k + 1) % 4;
+        for (int side = 0; side < 4; ++side) {
+            const bool alongX = side < 2;
+            const V limit = alongX ? sideHalf1 : sideHalf2;
+            const V otherLimit = alongX ? sideHalf2 : sideHalf1;
+            const V coordinateA = alongX ? x[k] : y[k];
+            const V coordinateB = alongX ? x[next] : y[next];
+            const V otherA = alongX ? y[k] : x[k];
+            const V otherB = alongX ? y[next] : x[next];
+            const V distanceA = (side % 2 == 0 ? coordinateA : -coordinateA) - limit;
+            const V distanceB = (side % 2 == 0 ? coordinateB : -coordinateB) - limit;
+            const Mask crossing = ((distanceA < V(0.0f)) & (distanceB > V(0.0f))) |
+                                  ((distanceA > V(0.0f)) & (distanceB < V(0.0f)));
+            const V t = distanceA / select(crossing, distanceA - distanceB, V(1.0f));
+            const V other = otherA + (otherB - otherA) * t;
+            const Vec3<V> position = quad[k] + (quad[next] - quad[k]) * t;
+            const V separation = d[k] + (d[next] - d[k]) * t;
+            emit(CrossingCandidates + 4 * k + side, position, separation, crossing & (abs(other) <= otherLimit));
+        }
+    }
+    
+    // Edge contact: the closest points of the two edges, averaged.
+    Vec3<V> pointA = boxA.position;
+    Vec3<V> pointB = boxB.position;
+    const Vec3<V> zero = { V(0.0f), V(0.0f), V(0.0f) };
+    for (int axis = 0; axis < 3; ++axis) {
+        const V index(static_cast<float>(axis));
+        const Vec3<V> towardB = boxA.axes[axis] * (boxA.half[axis] * signOf(dot(boxA.axes[axis], edgeNormal)));
+        const Vec3<V> towardA = boxB.axes[axis] * (boxB.half[axis] * signOf(dot(boxB.axes[axis], edgeNormal)));
+        pointA = pointA + select(edgeA == index, zero, towardB);
+        pointB = pointB - select(edgeB == index, zero, towardA);
+    }
+    const Vec3<V> directionA = pick(edgeA, boxA.axes);
+    const Vec3<V> directionB = pick(edgeB, boxB.axes);
+    const V halfEdgeA = pick(edgeA, boxA.half);
+    const V halfEdgeB = pick(edgeB, boxB.half);
+    const Vec3<V> delta = pointA - pointB;
+    const V b = dot(directionA, directionB);
+    const V c = dot(directionA, delta);
+    const V f = dot(directionB, delta);
+    const V denominator = max(V(1.0f) - b * b, V(ParallelEpsilon));
+    V s = clamp((b * f - c) / denominator, -halfEdgeA, halfEdgeA);
+    const V t = clamp(b * s + f, -halfEdgeB, halfEdgeB);
+    s = clamp(b * t - c, -halfEdgeA, halfEdgeA);
+    const Vec3<V> edgePoint = (pointA + directionA * s + pointB + directionB * t) * V(0.5f);
+    storeVec3(edgePoint, results.position[EdgeCandidate], lane);
+    (-edgeSeparation).store(&results.penetration[EdgeCandidate][lane]);
+    storeMask<V>(touching & useEdge, &results.valid[EdgeCandidate][lane]);
+    
+    storeVec3(select(useEdge, edgeNormal, normal), results.normal, lane);
+    storeMask<V>(useB, &results.flip[lane]);
+}
+
+}
+
+}
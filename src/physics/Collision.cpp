@@ -0,0 +1,231 @@
+#include "Collision.hpp"
+#include "BoxBatch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace roblox_clone::physics {
+
+namespace {
+
+constexpr float ParallelEpsilon = 1.0e-6f;
+constexpr float PlaneExtent = 1.0e6f;
+
+float signOf(float value) {
+    return value >= 0.0f ? 1.0f : -1.0f;
+}
+
+void flip(ContactManifold& manifold) {
+    manifold.normal = -manifold.normal;
+}
+
+void addPoint(ContactManifold& manifold, const glm::vec3& position, float penetration) {
+    ContactPoint& point = manifold.points[manifold.pointCount++];
+    point.position = position;
+    point.penetration = penetration;
+}
+
+bool collideSpheres(float radiusA, const Pose& poseA, float radiusB, const Pose& poseB, float margin,
+                    ContactManifold& manifold) {
+    const glm::vec3 delta = poseB.position - poseA.position;
+    const float distance = glm::length(delta);
+    const float separation = distance - radiusA - radiusB;
+    if (separation > margin) return false;
+    
+    manifold.normal = distance > ParallelEpsilon ? delta / distance : glm::vec3(0.0f, 1.0f, 0.0f);
+    manifold.pointCount = 0;
+    addPoint(manifold, poseA.position + manifold.normal * (radiusA + 0.5f * separation), -separation);
+    return true;
+}
+
+// Normal points from the box to the sphere.
+bool collideBoxSphere(const glm::vec3& half, const Pose& box, float radius, const Pose& sphere, float margin,
+                      ContactManifold& manifold) {
+    const glm::vec3 local = glm::transpose(box.rotation) * (sphere.position - box.position);
+    const glm::vec3 closest = glm::clamp(local, -half, half);
+    glm::vec3 localNormal;
+    glm::vec3 surface = closest;
+    float separation;
+    
+    if (closest != local) {
+        const glm::vec3 delta = local - closest;
+        const float distance = glm::length(delta);
+        separation = distance - radius;
+        if (separation > margin) return false;
+        localNormal = delta / distance;
+    } else {
+        // The center is inside the box: push out through the nearest face.
+        int axis = 0;
+        float depth = std::numeric_limits<float>::max();
+        for (int i = 0; i < 3; ++i) {
+            const float faceDepth = half[i] - std::abs(local[i]);
+            if (faceDepth < depth) {
+                depth = faceDepth;
+                axis = i;
+            }
+        }
+        localNormal = glm::vec3(0.0f);
+        localNormal[axis] = signOf(local[axis]);
+        surface[axis] = half[axis] * localNormal[axis];
+        separation = -depth - radius;
+    }
+    
+    manifold.normal = box.rotation * localNormal;
+    manifold.pointCount = 0;
+    addPoint(manifold, box.position + box.rotation * surface + manifold.normal * (0.5f * separation), -separation);
+    return true;
+}
+
+// Planes are half spaces; the normal points from the plane to the other shape.
+bool collidePlaneSphere(const Pose& plane, float radius, const Pose& sphere, float margin, ContactManifold& manifold) {
+    const glm::vec3 normal = plane.rotation[1];
+    const float separation = glm::dot(normal, sphere.position - plane.position) - radius;
+    if (separation > margin) return false;
+    
+    manifold.normal = normal;
+    manifold.pointCount = 0;
+    addPoint(manifold, sphere.position - normal * (radius + 0.5f * separation), -separation);
+    return true;
+}
+
+bool collidePlaneBox(const Pose& plane, const glm::vec3& half, const Pose& box, float margin,
+                     ContactManifold& manifold) {
+    const glm::vec3 normal = plane.rotation[1];
+    ContactPoint points[8];
+    int count = 0;
+    for (int corner = 0; corner < 8; ++corner) {
+        const glm::vec3 local((corner & 1) ? half.x : -half.x, (corner & 2) ? half.y : -half.y,
+                              (corner & 4) ? half.z : -half.z);
+        const glm::vec3 vertex = box.position + box.rotation * local;
+        const float separation = glm::dot(normal, vertex - plane.position);
+        if (separation > margin) continue;
+        points[count].position = vertex - normal * (0.5f * separation);
+        points[count].penetration = -separation;
+        ++count;
+    }
+    if (count == 0) return false;
+    
+    manifold.normal = normal;
+    reducePoints(points, count, normal, manifold);
+    return true;
+}
+
+}
+
+void reducePoints(const ContactPoint* points, int count, const glm::vec3& normal, ContactManifold& manifold) {
+    manifold.pointCount = 0;
+    if (count <= ContactManifold::MaxPoints) {
+        for (int i = 0; i < count; ++i) {
+            manifold.points[manifold.pointCount++] = points[i];
+        }
+        return;
+    }
+    
+    int first = 0;
+    for (int i = 1; i < count; ++i) {
+        if (points[i].penetration > points[first].penetration) first = i;
+    }
+    
+    int second = first;
+    float farthest = -1.0f;
+    for (int i = 0; i < count; ++i) {
+        const glm::vec3 delta = points[i].position - points[first].position;
+        const float distance = glm::dot(delta, delta);
+        if (distance > farthest) {
+            farthest = distance;
+            second = i;
+        }
+    }
+    
+    int third = -1;
+    int fourth = -1;
+    float largest = 0.0f;
+    float smallest = 0.0f;
+    const glm::vec3 edge = points[second].position - points[first].position;
+    for (int i = 0; i < count; ++i) {
+        const float area = glm::dot(glm::cross(edge, points[i].position - points[first].position), normal);
+        if (area > largest) {
+            largest = area;
+            third = i;
+        } else if (area < smallest) {
+            smallest = area;
+            fourth = i;
+        }
+    }
+    
+    int kept[ContactManifold::MaxPoints] = { first, second, third, fourth };
+    for (int i = 0; i < ContactManifold::MaxPoints; ++i) {
+        if (kept[i] < 0 || (i == 1 && kept[i] == first)) continue;
+        manifold.points[manifold.pointCount++] = points[kept[i]];
+    }
+}
+
+Aabb computeBounds(const Shape& shape, const Pose& pose) {
+    switch (shape.type) {
+        case ShapeType::Box: {
+            glm::vec3 extent(0.0f);
+            for (int axis = 0; axis < 3; ++axis) {
+                extent += glm::abs(pose.rotation[axis]) * shape.halfExtents[axis];
+            }
+            return Aabb::fromCenter(pose.position, extent);
+        }
+        case ShapeType::Sphere:
+            return Aabb::fromCenter(pose.position, glm::vec3(shape.radius));
+        case ShapeType::Plane: {
+            // Axis aligned planes get a half space box, tilted ones cover everything.
+            Aabb bounds(glm::vec3(-PlaneExtent), glm::vec3(PlaneExtent));
+            const glm::vec3& normal = pose.rotation[1];
+            for (int axis = 0; axis < 3; ++axis) {
+                if (std::abs(normal[axis]) < 1.0f - ParallelEpsilon) continue;
+                if (normal[axis] > 0.0f) {
+                    bounds.max[axis] = pose.position[axis];
+                } else {
+                    bounds.min[axis] = pose.position[axis];
+                }
+            }
+            return bounds;
+        }
+    }
+    return Aabb();
+}
+
+bool collide(const Shape& shapeA, const Pose& poseA, const Shape& shapeB, const Pose& poseB, float margin,
+             ContactManifold& manifold) {
+    if (shapeA.type > shapeB.type) {
+        if (!collide(shapeB, poseB, shapeA, poseA, margin, manifold)) return false;
+        flip(manifold);
+        return true;
+    }
+    
+    switch (shapeA.type) {
+        case ShapeType::Box:
+            if (shapeB.type == ShapeType::Box) {
+                return collideBoxes(shapeA.halfExtents, poseA, shapeB.halfExtents, poseB, margin, manifold);
+            }
+            if (shapeB.type == ShapeType::Sphere) {
+                return collideBoxSphere(shapeA.halfExtents, poseA, shapeB.radius, poseB, margin, manifold);
+            }
+            if (!collidePlaneBox(poseB, shapeA.halfExtents, poseA, margin, manifold)) return false;
+            flip(manifold);
+            return true;
+        case ShapeType::Sphere:
+            if (shapeB.type == ShapeType::Sphere) {
+                return collideSpheres(shapeA.radius, poseA, shapeB.radius, poseB, margin, manifold);
+            }
+            if (!collidePlaneSphere(poseB, shapeA.radius, poseA, margin, manifold)) return false;
+            flip(manifold);
+            return true;
+        case ShapeType::Plane:
+            return false;
+    }
+    return false;
+}
+
+bool collideBoxes(const glm::vec3& halfA, const Pose& poseA, const glm::vec3& halfB, const Pose& poseB, float margin,
+                  ContactManifold& manifold) {
+    BoxPairBatch batch;
+    batch.add(halfA, poseA, halfB, poseB);
+    return collideBoxBatch(batch, margin, &manifold, SimdKernel::Scalar) != 0;
+}
+
+}
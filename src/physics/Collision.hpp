@@ -0,0 +1,54 @@
+#pragma once
+
+#include "RigidBody.hpp"
+#include "scene/SpatialHash.hpp"
+#include <glm/glm.hpp>
+#include <cstdint>
+
+namespace roblox_clone::physics {
+
+using scene::Aabb;
+
+struct Shape {
+    ShapeType type = ShapeType::Box;
+    glm::vec3 halfExtents = glm::vec3(0.5f);
+    float radius = 0.5f;
+};
+
+struct Pose {
+    glm::vec3 position = glm::vec3(0.0f);
+    glm::mat3 rotation = glm::mat3(1.0f);
+};
+
+struct ContactPoint {
+    glm::vec3 position = glm::vec3(0.0f);
+    float penetration = 0.0f;
+};
+
+// Up to four contact points sharing one normal, which points from A to B.
+struct ContactManifold {
+    static constexpr int MaxPoints = 4;
+    
+    glm::vec3 normal = glm::vec3(0.0f, 1.0f, 0.0f);
+    ContactPoint points[MaxPoints];
+    int pointCount = 0;
+};
+
+Aabb computeBounds(const Shape& shape, const Pose& pose);
+
+// Returns false when the shapes are more than margin apart. Points closer than
+// margin but not yet touching are reported with a negative penetration.
+bool collide(const Shape& shapeA, const Pose& poseA, const Shape& shapeB, const Pose& poseB, float margin,
+             ContactManifold& manifold);
+
+// Separating axis test over the 15 box axes, with reference face clipping for
+// face contacts and a single closest point for edge contacts. Runs the scalar
+// lane of collideBoxBatch, so single pairs and batches agree exactly.
+bool collideBoxes(const glm::vec3& halfA, const Pose& poseA, const glm::vec3& halfB, const Pose& poseB,
+                  float margin, ContactManifold& manifold);
+
+// Keeps four of the points: the deepest, the one farthest from it and the two
+// spanning the largest area on either side of the line between them.
+void reducePoints(const ContactPoint* points, int count, const glm::vec3& normal, ContactManifold& manifold);
+
+}
@@ -0,0 +1,215 @@
+#include "DynamicTree.hpp"
+#include <algorithm>
+
+namespace roblox_clone::physics {
+
+namespace {
+
+constexpr float DisplacementMultiplier = 2.0f;
+
+Aabb combine(const Aabb& a, const Aabb& b) {
+    return { glm::min(a.min, b.min), glm::max(a.max, b.max) };
+}
+
+float perimeter(const Aabb& bounds) {
+    const glm::vec3 size = bounds.max - bounds.min;
+    return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+bool contains(const Aabb& outer, const Aabb& inner) {
+    return glm::all(glm::lessThanEqual(outer.min, inner.min)) && glm::all(glm::greaterThanEqual(outer.max, inner.max));
+}
+
+}
+
+DynamicTree::DynamicTree(float margin)
+    : m_margin(margin) {
+}
+
+uint32_t DynamicTree::createProxy(const Aabb& bounds, uint32_t userData) {
+    const uint32_t proxy = allocateNode();
+    m_nodes[proxy].bounds = { bounds.min - glm::vec3(m_margin), bounds.max + glm::vec3(m_margin) };
+    m_nodes[proxy].userData = userData;
+    m_nodes[proxy].height = 0;
+    insertLeaf(proxy);
+    ++m_proxyCount;
+    return proxy;
+}
+
+void DynamicTree::destroyProxy(uint32_t proxy) {
+    removeLeaf(proxy);
+    freeNode(proxy);
+    --m_proxyCount;
+}
+
+bool DynamicTree::moveProxy(uint32_t proxy, const Aabb& bounds, const glm::vec3& displacement) {
+    if (contains(m_nodes[proxy].bounds, bounds)) return false;
+    
+    removeLeaf(proxy);
+    
+    Aabb fat = { bounds.min - glm::vec3(m_margin), bounds.max + glm::vec3(m_margin) };
+    const glm::vec3 stretch = displacement * DisplacementMultiplier;
+    fat.min += glm::min(stretch, glm::vec3(0.0f));
+    fat.max += glm::max(stretch, glm::vec3(0.0f));
+    m_nodes[proxy].bounds = fat;
+    
+    insertLeaf(proxy);
+    return true;
+}
+
+uint32_t DynamicTree::allocateNode() {
+    if (m_freeList == Null) {
+        m_nodes.emplace_back();
+        return static_cast<uint32_t>(m_nodes.size() - 1);
+    }
+    
+    const uint32_t index = m_freeList;
+    m_freeList = m_nodes[index].parent;
+    m_nodes[index] = Node();
+    return index;
+}
+
+void DynamicTree::freeNode(uint32_t index) {
+    m_nodes[index].parent = m_freeList;
+    m_nodes[index].height = -1;
+    m_freeList = index;
+}
+
+void DynamicTree::insertLeaf(uint32_t leaf) {
+    if (m_root == Null) {
+        m_root = leaf;
+        m_nodes[leaf].parent = Null;
+        return;
+    }
+    
+    // Walk down towards the sibling that grows the tree's surface area least.
+    const Aabb leafBounds = m_nodes[leaf].bounds;
+    uint32_t index = m_root;
+    while (!m_nodes[index].isLeaf()) {
+        const Node& node = m_nodes[index];
+        const float area = perimeter(node.bounds);
+        const float combinedArea = perimeter(combine(node.bounds, leafBounds));
+        const float cost = 2.0f * combinedArea;
+        const float inheritanceCost = 2.0f * (combinedArea - area);
+        
+        auto descendCost = [&](uint32_t child) {
+            const Aabb bounds = combine(leafBounds, m_nodes[child].bounds);
+            if (m_nodes[child].isLeaf()) return perimeter(bounds) + inheritanceCost;
+            return perimeter(bounds) - perimeter(m_nodes[child].bounds) + inheritanceCost;
+        };
+        const float cost1 = descendCost(node.child1);
+        const float cost2 = descendCost(node.child2);
+        
+        if (cost < cost1 && cost < cost2) break;
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+    
+    const uint32_t sibling = index;
+    const uint32_t oldParent = m_nodes[sibling].parent;
+    const uint32_t newParent = allocateNode();
+    m_nodes[newParent].parent = oldParent;
+    m_nodes[newParent].bounds = combine(leafBounds, m_nodes[sibling].bounds);
+    m_nodes[newParent].height = m_nodes[sibling].height + 1;
+    m_nodes[newParent].child1 = sibling;
+    m_nodes[newParent].child2 = leaf;
+    m_nodes[sibling].parent = newParent;
+    m_nodes[leaf].parent = newParent;
+    
+    if (oldParent == Null) {
+        m_root = newParent;
+    } else if (m_nodes[oldParent].child1 == sibling) {
+        m_nodes[oldParent].child1 = newParent;
+    } else {
+        m_nodes[oldParent].child2 = newParent;
+    }
+    
+    for (index = m_nodes[leaf].parent; index != Null; index = m_nodes[index].parent) {
+        index = balance(index);
+        Node& node = m_nodes[index];
+        node.height = 1 + std::max(m_nodes[node.child1].height, m_nodes[node.child2].height);
+        node.bounds = combine(m_nodes[node.child1].bounds, m_nodes[node.child2].bounds);
+    }
+}
+
+void DynamicTree::removeLeaf(uint32_t leaf) {
+    if (leaf == m_root) {
+        m_root = Null;
+        return;
+    }
+    
+    const uint32_t parent = m_nodes[leaf].parent;
+    const uint32_t grandParent = m_nodes[parent].parent;
+    const uint32_t sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+    
+    if (grandParent == Null) {
+        m_root = sibling;
+        m_nodes[sibling].parent = Null;
+        freeNode(parent);
+        return;
+    }
+    
+    if (m_nodes[grandParent].child1 == parent) {
+        m_nodes[grandParent].child1 = sibling;
+    } else {
+        m_nodes[grandParent].child2 = sibling;
+    }
+    m_nodes[sibling].parent = grandParent;
+    freeNode(parent);
+    
+    for (uint32_t index = grandParent; index != Null; index = m_nodes[index].parent) {
+        index = balance(index);
+        Node& node = m_nodes[index];
+        node.bounds = combine(m_nodes[node.child1].bounds, m_nodes[node.child2].bounds);
+        node.height = 1 + std::max(m_nodes[node.child1].height, m_nodes[node.child2].height);
+    }
+}
+
+// Rotates the taller child of a up when the subtree heights differ by more than
+// one. Returns the index of the subtree's new root.
+uint32_t DynamicTree::balance(uint32_t a) {
+    Node& nodeA = m_nodes[a];
+    if (nodeA.isLeaf() || nodeA.height < 2) return a;
+    
+    const uint32_t b = nodeA.child1;
+    const uint32_t c = nodeA.child2;
+    const int difference = m_nodes[c].height - m_nodes[b].height;
+    if (difference >= -1 && difference <= 1) return a;
+    
+    // up is the taller child, side the shorter one.
+    const uint32_t up = difference > 1 ? c : b;
+    const uint32_t side = difference > 1 ? b : c;
+    Node& nodeUp = m_nodes[up];
+    const uint32_t f = nodeUp.child1;
+    const uint32_t g = nodeUp.child2;
+    
+    nodeUp.child1 = a;
+    nodeUp.parent = nodeA.parent;
+    nodeA.parent = up;
+    if (nodeUp.parent == Null) {
+        m_root = up;
+    } else if (m_nodes[nodeUp.parent].child1 == a) {
+        m_nodes[nodeUp.parent].child1 = up;
+    } else {
+        m_nodes[nodeUp.parent].child2 = up;
+    }
+    
+    // The taller grandchild stays under up, the shorter one replaces up under a.
+    const bool keepF = m_nodes[f].height > m_nodes[g].height;
+    const uint32_t kept = keepF ? f : g;
+    const uint32_t moved = keepF ? g : f;
+    nodeUp.child2 = kept;
+    if (difference > 1) {
+        nodeA.child2 = moved;
+    } else {
+        nodeA.child1 = moved;
+    }
+    m_nodes[moved].parent = a;
+    
+    nodeA.bounds = combine(m_nodes[side].bounds, m_nodes[moved].bounds);
+    nodeUp.bounds = combine(nodeA.bounds, m_nodes[kept].bounds);
+    nodeA.height = 1 + std::max(m_nodes[side].height, m_nodes[moved].height);
+    nodeUp.height = 1 + std::max(nodeA.height, m_nodes[kept].height);
+    return up;
+}
+
+}
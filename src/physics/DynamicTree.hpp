@@ -0,0 +1,97 @@
+#pragma once
+
+#include "scene/SpatialHash.hpp"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace roblox_clone::physics {
+
+using scene::Aabb;
+
+// Incremental broadphase: a binary AABB tree whose leaves hold fattened bounds,
+// so a proxy is only reinserted once it leaves its fat box. Inserts balance
+// the tree with rotations, following Box2D's b2DynamicTree.
+class DynamicTree {
+public:
+    static constexpr uint32_t Null = ~0u;
+    
+    explicit DynamicTree(float margin = 0.1f);
+    
+    // Copied whole, nodes and free list alike, when physics state is saved.
+    DynamicTree(const DynamicTree&) = default;
+    DynamicTree& operator=(const DynamicTree&) = default;
+    
+    uint32_t createProxy(const Aabb& bounds, uint32_t userData);
+    void destroyProxy(uint32_t proxy);
+    // Returns true when the proxy was reinserted; displacement stretches the fat
+    // box in the direction of motion.
+    bool moveProxy(uint32_t proxy, const Aabb& bounds, const glm::vec3& displacement);
+    
+    const Aabb& getFatBounds(uint32_t proxy) const { return m_nodes[proxy].bounds; }
+    uint32_t getUserData(uint32_t proxy) const { return m_nodes[proxy].userData; }
+    size_t getProxyCount() const { return m_proxyCount; }
+    int getHeight() const { return m_root == Null ? 0 : m_nodes[m_root].height; }
+    
+    // Calls func(proxy) for every leaf whose fat bounds overlap bounds; stops
+    // early when func returns false.
+    template<typename Func>
+    void query(const Aabb& bounds, Func&& func) const {
+        if (m_root == Null) return;
+        
+        uint32_t stack[256];
+        std::vector<uint32_t> overflow;
+        uint32_t stackSize = 0;
+        stack[stackSize++] = m_root;
+        while (stackSize > 0 || !overflow.empty()) {
+            uint32_t index;
+            if (!overflow.empty()) {
+                index = overflow.back();
+                overflow.pop_back();
+            } else {
+                index = stack[--stackSize];
+            }
+            
+            const Node& node = m_nodes[index];
+            if (!node.bounds.overlaps(bounds)) continue;
+            
+            if (node.isLeaf()) {
+                if (!func(index)) return;
+            } else {
+                for (uint32_t child : { node.child1, node.child2 }) {
+                    if (stackSize < 256) {
+                        stack[stackSize++] = child;
+                    } else {
+                        overflow.push_back(child);
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    struct Node {
+        Aabb bounds;
+        uint32_t parent = Null;
+        uint32_t child1 = Null;
+        uint32_t child2 = Null;
+        uint32_t userData = 0;
+        int height = -1;
+        
+        bool isLeaf() const { return child1 == Null; }
+    };
+    
+    uint32_t allocateNode();
+    void freeNode(uint32_t index);
+    void insertLeaf(uint32_t leaf);
+    void removeLeaf(uint32_t leaf);
+    uint32_t balance(uint32_t index);
+    
+    std::vector<Node> m_nodes;
+    uint32_t m_root = Null;
+    uint32_t m_freeList = Null;
+    size_t m_proxyCount = 0;
+    float m_margin;
+};
+
+}
@@ -0,0 +1,1143 @@
+#include "PhysicsWorld.hpp"
+#include "BoxBatch.hpp"
+#include "core/DeterministicMath.hpp"
+#include "core/JobSystem.hpp"
+#include "core/Profiler.hpp"
+#include <glm/gtc/constants.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace roblox_clone::physics {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Contact points within this distance of last step's points, measured in body
+// A's frame, inherit their accumulated impulses.
+constexpr float WarmStartDistanceSquared = 0.05f * 0.05f;
+constexpr float MinimumMass = 1.0e-4f;
+
+float elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+}
+
+// The smallest distance across the shape, which a body must move farther than
+// in one step before it can skip over anything.
+float minimumWidth(const Shape& shape) {
+    if (shape.type == ShapeType::Sphere) return 2.0f * shape.radius;
+    return 2.0f * std::min(shape.halfExtents.x, std::min(shape.halfExtents.y, shape.halfExtents.z));
+}
+
+// Same rotation order as the renderer and Obb::fromTransform: X, then Y, then Z.
+// The simulation state and its hash go through these conversions, so they
+// use core's deterministic trig instead of libm.
+glm::mat3 rotationFromEuler(const glm::vec3& degrees) {
+    const glm::vec3 radians = glm::radians(degrees);
+    const float sx = core::deterministicSin(radians.x);
+    const float cx = core::deterministicCos(radians.x);
+    const float sy = core::deterministicSin(radians.y);
+    const float cy = core::deterministicCos(radians.y);
+    const float sz = core::deterministicSin(radians.z);
+    const float cz = core::deterministicCos(radians.z);
+    const glm::mat3 rotateX(1.0f, 0.0f, 0.0f, 0.0f, cx, sx, 0.0f, -sx, cx);
+    const glm::mat3 rotateY(cy, 0.0f, -sy, 0.0f, 1.0f, 0.0f, sy, 0.0f, cy);
+    const glm::mat3 rotateZ(cz, sz, 0.0f, -sz, cz, 0.0f, 0.0f, 0.0f, 1.0f);
+    return rotateX * rotateY * rotateZ;
+}
+
+glm::vec3 eulerFromRotation(const glm::mat3& rotation) {
+    const float sinY = glm::clamp(rotation[2][0], -1.0f, 1.0f);
+    const float y = core::deterministicAsin(sinY);
+    float x;
+    float z;
+    if (std::abs(sinY) < 0.9999f) {
+        x = core::deterministicAtan2(-rotation[2][1], rotation[2][2]);
+        z = core::deterministicAtan2(-rotation[1][0], rotation[0][0]);
+    } else {
+        // Gimbal lock: X and Z turn about the same axis, so fold it all into X.
+        x = core::deterministicAtan2(rotation[0][1] * sinY, rotation[1][1]);
+        z = 0.0f;
+    }
+    return glm::degrees(glm::vec3(x, y, z));
+}
+
+bool sameTransform(const scene::TransformComponent& a, const scene::TransformComponent& b) {
+    return a.position == b.position && a.rotation == b.rotation && a.scale == b.scale;
+}
+
+void updateInertia(glm::mat3& inverseInertia, const glm::mat3& rotation, const glm::vec3& inverseInertiaLocal) {
+    glm::mat3 scaled;
+    for (int axis = 0; axis < 3; ++axis) {
+        scaled[axis] = rotation[axis] * inverseInertiaLocal[axis];
+    }
+    inverseInertia = scaled * glm::transpose(rotation);
+}
+
+void tangentBasis(const glm::vec3& normal, glm::vec3& tangent, glm::vec3& bitangent) {
+    if (std::abs(normal.x) >= 0.57735f) {
+        tangent = glm::normalize(glm::vec3(normal.y, -normal.x, 0.0f));
+    } else {
+        tangent = glm::normalize(glm::vec3(0.0f, normal.z, -normal.y));
+    }
+    bitangent = glm::cross(normal, tangent);
+}
+
+}
+
+PhysicsWorld::PhysicsWorld(const PhysicsSettings& settings)
+    : m_settings(settings), m_tree(settings.proxyMargin) {
+}
+
+PhysicsWorld::~PhysicsWorld() {
+    detach();
+}
+
+void PhysicsWorld::attach(scene::Scene& scene) {
+    detach();
+    m_scene = &scene;
+
+    auto& registry = scene.registry();
+    registry.on_construct<RigidBodyComponent>().connect<&PhysicsWorld::onBodyAdded>(this);
+    registry.on_destroy<RigidBodyComponent>().connect<&PhysicsWorld::onBodyRemoved>(this);
+    registry.on_update<RigidBodyComponent>().connect<&PhysicsWorld::onBodyEdited>(this);
+    scene.onTransformChanged().connect<&PhysicsWorld::onTransformEdited>(this);
+    scene.onAllTransformsChanged().connect<&PhysicsWorld::onAllTransformsEdited>(this);
+    for (auto [entity, rigidBody] : registry.view<RigidBodyComponent>().each()) {
+        rigidBody.body = RigidBodyComponent::NoBody;
+        m_pendingBodies.push_back(entity);
+    }
+}
+
+void PhysicsWorld::detach() {
+    if (!m_scene) return;
+
+    auto& registry = m_scene->registry();
+    registry.on_construct<RigidBodyComponent>().disconnect(this);
+    registry.on_destroy<RigidBodyComponent>().disconnect(this);
+    registry.on_update<RigidBodyComponent>().disconnect(this);
+    m_scene->onTransformChanged().disconnect(this);
+    m_scene->onAllTransformsChanged().disconnect(this);
+    for (auto [entity, rigidBody] : registry.view<RigidBodyComponent>().each()) {
+        (void)entity;
+        rigidBody.body = RigidBodyComponent::NoBody;
+    }
+
+    for (const Body& body : m_bodies) {
+        if (body.alive) m_tree.destroyProxy(body.proxy);
+    }
+    m_bodies.clear();
+    m_freeBodies.clear();
+    m_deadBodies.clear();
+    m_pendingBodies.clear();
+    m_awakeBodies.clear();
+    m_editedBodies.clear();
+    m_moveBuffer.clear();
+    m_contacts.clear();
+    m_freeContacts.clear();
+    m_contactLookup.clear();
+    m_awakeContacts.clear();
+    m_islands.clear();
+    m_sleepingIslands.clear();
+    m_freeSleepingIslands.clear();
+    m_stats = PhysicsStats();
+    m_scene = nullptr;
+}
+
+void PhysicsWorld::saveState(State& state) const {
+    RC_PROFILE_SCOPE("PhysicsWorld::saveState");
+    state.bodies = m_bodies;
+    state.freeBodies = m_freeBodies;
+    state.deadBodies = m_deadBodies;
+    state.pendingBodies = m_pendingBodies;
+    state.awakeBodies = m_awakeBodies;
+    state.editedBodies = m_editedBodies;
+    state.tree = m_tree;
+    state.moveBuffer = m_moveBuffer;
+    state.contacts = m_contacts;
+    state.freeContacts = m_freeContacts;
+    state.contactLookup = m_contactLookup;
+    state.awakeContacts = m_awakeContacts;
+    state.sleepingIslands = m_sleepingIslands;
+    state.freeSleepingIslands = m_freeSleepingIslands;
+    state.stats = m_stats;
+}
+
+void PhysicsWorld::restoreState(const State& state) {
+    RC_PROFILE_SCOPE("PhysicsWorld::restoreState");
+    m_bodies = state.bodies;
+    m_freeBodies = state.freeBodies;
+    m_deadBodies = state.deadBodies;
+    m_pendingBodies = state.pendingBodies;
+    m_awakeBodies = state.awakeBodies;
+    m_editedBodies = state.editedBodies;
+    m_tree = state.tree;
+    m_moveBuffer = state.moveBuffer;
+    m_contacts = state.contacts;
+    m_freeContacts = state.freeContacts;
+    m_contactLookup = state.contactLookup;
+    m_awakeContacts = state.awakeContacts;
+    m_sleepingIslands = state.sleepingIslands;
+    m_freeSleepingIslands = state.freeSleepingIslands;
+    m_stats = state.stats;
+    if (!m_scene) return;
+
+    // Components the restore rebuilt were reset to NoBody as if new, and
+    // their bodies are back in the list above.
+    auto& rigidBodies = m_scene->registry().storage<RigidBodyComponent>();
+    for (uint32_t index = 0; index < m_bodies.size(); ++index) {
+        const Body& body = m_bodies[index];
+        if (body.alive && rigidBodies.contains(body.entity)) rigidBodies.get(body.entity).body = index;
+    }
+}
+
+void PhysicsWorld::step(float deltaTime) {
+    if (!m_scene || deltaTime <= 0.0f) return;
+
+    RC_PROFILE_SCOPE("PhysicsWorld::step");
+    const auto stepStart = Clock::now();
+    removeDeadBodies();
+    addPendingBodies();
+    readComponents();
+    prepareContinuous(deltaTime);
+
+    auto phaseStart = Clock::now();
+    findNewPairs();
+    sortAwakeContacts();
+    m_stats.broadphaseMs = elapsedMs(phaseStart);
+
+    m_stats.narrowphaseMs = 0.0f;
+    m_stats.solverMs = 0.0f;
+    const int substeps = std::max(m_settings.substeps, 1);
+    const float substepTime = deltaTime / static_cast<float>(substeps);
+    for (int substep = 0; substep < substeps; ++substep) {
+        phaseStart = Clock::now();
+        updateContacts();
+        m_stats.narrowphaseMs += elapsedMs(phaseStart);
+
+        phaseStart = Clock::now();
+        buildIslands();
+        solveIslands(substepTime);
+        m_stats.solverMs += elapsedMs(phaseStart);
+    }
+
+    phaseStart = Clock::now();
+    synchronizeProxies(deltaTime);
+    m_stats.broadphaseMs += elapsedMs(phaseStart);
+
+    updateSleep();
+    writeComponents();
+    m_stats.stepMs = elapsedMs(stepStart);
+}
+
+void PhysicsWorld::onBodyAdded(entt::registry& registry, entt::entity entity) {
+    // Copied components must not share the source's body.
+    registry.get<RigidBodyComponent>(entity).body = RigidBodyComponent::NoBody;
+    m_pendingBodies.push_back(entity);
+}
+
+void PhysicsWorld::onBodyRemoved(entt::registry& registry, entt::entity entity) {
+    const uint32_t index = registry.get<RigidBodyComponent>(entity).body;
+    if (index >= m_bodies.size() || !m_bodies[index].alive || m_bodies[index].entity != entity) return;
+
+    // Whatever rested on the body has to wake up and fall. Contacts still
+    // refer to the slot, so it is recycled at the next step.
+    wakeBody(index);
+    Body& body = m_bodies[index];
+    m_tree.destroyProxy(body.proxy);
+    body.proxy = DynamicTree::Null;
+    body.alive = false;
+    m_deadBodies.push_back(index);
+}
+
+void PhysicsWorld::onBodyEdited(entt::registry& registry, entt::entity entity) {
+    markEdited(entity, registry.get<RigidBodyComponent>(entity).body);
+}
+
+void PhysicsWorld::onTransformEdited(entt::entity entity) {
+    if (m_writingComponents) return;
+    if (const auto* rigidBody = m_scene->registry().try_get<RigidBodyComponent>(entity)) {
+        markEdited(entity, rigidBody->body);
+    }
+}
+
+void PhysicsWorld::onAllTransformsEdited() {
+    for (uint32_t index = 0; index < m_bodies.size(); ++index) {
+        markEdited(m_bodies[index].entity, index);
+    }
+}
+
+void PhysicsWorld::markEdited(entt::entity entity, uint32_t index) {
+    if (index >= m_bodies.size()) return;
+    Body& body = m_bodies[index];
+    if (!body.alive || body.entity != entity || body.edited) return;
+    
+    body.edited = true;
+    m_editedBodies.push_back(index);
+}
+
+void PhysicsWorld::addPendingBodies() {
+    auto& registry = m_scene->registry();
+    for (entt::entity entity : m_pendingBodies) {
+        if (!registry.valid(entity)) continue;
+        auto* rigidBody = registry.try_get<RigidBodyComponent>(entity);
+        auto* transform = registry.try_get<scene::TransformComponent>(entity);
+        if (!rigidBody || !transform || rigidBody->body != RigidBodyComponent::NoBody) continue;
+
+        uint32_t index;
+        if (!m_freeBodies.empty()) {
+            index = m_freeBodies.back();
+            m_freeBodies.pop_back();
+        } else {
+            index = static_cast<uint32_t>(m_bodies.size());
+            m_bodies.emplace_back();
+        }
+
+        Body& body = m_bodies[index];
+        body = Body();
+        body.entity = entity;
+        body.alive = true;
+        configureBody(body, *rigidBody, *transform);
+        body.proxy = m_tree.createProxy(computeBounds(body.shape, body.getPose()), index);
+        body.moved = true;
+        m_moveBuffer.push_back(index);
+        m_awakeBodies.push_back(index);
+        rigidBody->body = index;
+        ++m_stats.bodyCount;
+        if (body.type == BodyType::Dynamic) ++m_stats.dynamicBodyCount;
+    }
+    m_pendingBodies.clear();
+}
+
+void PhysicsWorld::removeDeadBodies() {
+    if (m_deadBodies.empty()) return;
+
+    for (uint32_t index : m_deadBodies) {
+        const std::vector<uint32_t>& contacts = m_bodies[index].contacts;
+        while (!contacts.empty()) {
+            const Contact& contact = m_contacts[contacts.back()];
+            wakeBody(contact.bodyA);
+            wakeBody(contact.bodyB);
+            removeContact(contacts.back());
+        }
+    }
+
+    m_awakeBodies.erase(std::remove_if(m_awakeBodies.begin(), m_awakeBodies.end(),
+                                       [this](uint32_t index) { return !m_bodies[index].alive; }),
+                        m_awakeBodies.end());
+    for (uint32_t index : m_deadBodies) {
+        if (m_bodies[index].type == BodyType::Dynamic) --m_stats.dynamicBodyCount;
+        m_bodies[index] = Body();
+        m_freeBodies.push_back(index);
+    }
+    m_stats.bodyCount -= m_deadBodies.size();
+    m_deadBodies.clear();
+}
+
+void PhysicsWorld::readComponents() {
+    auto& registry = m_scene->registry();
+    auto& transforms = registry.storage<scene::TransformComponent>();
+    auto& rigidBodies = registry.storage<RigidBodyComponent>();
+
+    // Awake bodies are read every step, as systems write their components
+    // straight through views. Bodies they wake were read already.
+    const size_t awakeCount = m_awakeBodies.size();
+    for (size_t slot = 0; slot < awakeCount; ++slot) {
+        const entt::entity entity = m_bodies[m_awakeBodies[slot]].entity;
+        readBody(m_awakeBodies[slot], rigidBodies.get(entity), transforms.get(entity));
+    }
+    for (uint32_t index : m_editedBodies) {
+        Body& body = m_bodies[index];
+        body.edited = false;
+        if (body.alive) readBody(index, rigidBodies.get(body.entity), transforms.get(body.entity));
+    }
+    m_editedBodies.clear();
+}
+
+void PhysicsWorld::readBody(uint32_t index, const RigidBodyComponent& rigidBody,
+                            const scene::TransformComponent& transform) {
+    Body& body = m_bodies[index];
+    if (!sameTransform(transform, body.synced) || rigidBody.type != body.type ||
+        rigidBody.shape != body.shape.type || rigidBody.density != body.density) {
+        if (body.type == BodyType::Dynamic) --m_stats.dynamicBodyCount;
+        configureBody(body, rigidBody, transform);
+        if (body.type == BodyType::Dynamic) ++m_stats.dynamicBodyCount;
+        wakeBody(index);
+        if (m_tree.moveProxy(body.proxy, computeBounds(body.shape, body.getPose()), glm::vec3(0.0f)) && !body.moved) {
+            body.moved = true;
+            m_moveBuffer.push_back(index);
+        }
+    }
+
+    body.friction = rigidBody.friction;
+    body.restitution = rigidBody.restitution;
+    body.continuous = rigidBody.continuous;
+    if (body.type == BodyType::Static) {
+        body.linearVelocity = glm::vec3(0.0f);
+        body.angularVelocity = glm::vec3(0.0f);
+    } else {
+        // Sleeping bodies were written with zero velocity, so any other
+        // value came from a script.
+        if (!body.awake && (rigidBody.linearVelocity != body.linearVelocity ||
+                            rigidBody.angularVelocity != body.angularVelocity)) {
+            wakeBody(index);
+        }
+        body.linearVelocity = rigidBody.linearVelocity;
+        body.angularVelocity = rigidBody.angularVelocity;
+    }
+}
+
+void PhysicsWorld::prepareContinuous(float deltaTime) {
+    const auto start = Clock::now();
+    const float substepTime = deltaTime / std::max(m_settings.substeps, 1);
+    size_t fastCount = 0;
+    for (uint32_t index : m_awakeBodies) {
+        Body& body = m_bodies[index];
+        body.speculativeDistance = 0.0f;
+        if (!body.continuous || body.type != BodyType::Dynamic) continue;
+        const float speed = glm::length(body.linearVelocity);
+        if (speed * deltaTime <= minimumWidth(body.shape)) continue;
+
+        // Stretch the proxy over the whole step before the body moves, so the
+        // broadphase pairs it with everything along its path.
+        body.speculativeDistance = speed * substepTime;
+        const glm::vec3 motion = body.linearVelocity * deltaTime;
+        Aabb swept = computeBounds(body.shape, body.getPose());
+        swept.min = glm::min(swept.min, swept.min + motion);
+        swept.max = glm::max(swept.max, swept.max + motion);
+        if (m_tree.moveProxy(body.proxy, swept, motion) && !body.moved) {
+            body.moved = true;
+            m_moveBuffer.push_back(index);
+        }
+        ++fastCount;
+    }
+    m_stats.continuousBodyCount = fastCount;
+    m_stats.continuousPairCount = 0;
+    m_stats.continuousMs = elapsedMs(start);
+}
+
+void PhysicsWorld::findNewPairs() {
+    RC_PROFILE_SCOPE("PhysicsWorld::findNewPairs");
+    for (uint32_t index : m_moveBuffer) {
+        const Body& body = m_bodies[index];
+        if (!body.alive) continue;
+
+        m_tree.query(m_tree.getFatBounds(body.proxy), [&](uint32_t proxy) {
+            const uint32_t other = m_tree.getUserData(proxy);
+            const Body& otherBody = m_bodies[other];
+            // Pairs of moved proxies are added once, from the lower index.
+            if (other == index || (otherBody.moved && other < index)) return true;
+            if (body.type != BodyType::Dynamic && otherBody.type != BodyType::Dynamic) return true;
+            addContact(index, other);
+            return true;
+        });
+    }
+
+    for (uint32_t index : m_moveBuffer) {
+        m_bodies[index].moved = false;
+    }
+    m_moveBuffer.clear();
+}
+
+void PhysicsWorld::updateContacts() {
+    RC_PROFILE_SCOPE("PhysicsWorld::updateContacts");
+    // Drop pairs whose proxies no longer overlap. Pairs where neither body is
+    // awake keep last step's manifold, since neither body moved.
+    m_narrowphaseContacts.clear();
+    m_speculativeContacts.clear();
+    for (size_t slot = 0; slot < m_awakeContacts.size();) {
+        const uint32_t index = m_awakeContacts[slot];
+        const Contact& contact = m_contacts[index];
+        const Body& bodyA = m_bodies[contact.bodyA];
+        const Body& bodyB = m_bodies[contact.bodyB];
+        if (!m_tree.getFatBounds(bodyA.proxy).overlaps(m_tree.getFatBounds(bodyB.proxy))) {
+            // A sleeping body may have rested on the one that moved away, as
+            // when a script drags the ground out from under it. Removal moves
+            // the last awake contact into this slot.
+            const uint32_t indexA = contact.bodyA;
+            const uint32_t indexB = contact.bodyB;
+            removeContact(index);
+            if (m_bodies[indexA].type == BodyType::Dynamic) wakeBody(indexA);
+            if (m_bodies[indexB].type == BodyType::Dynamic) wakeBody(indexB);
+            continue;
+        }
+        m_narrowphaseContacts.push_back(index);
+        ++slot;
+    }
+
+    // Box pairs are collided a SIMD batch at a time, everything else one by one.
+    m_manifolds.resize(m_narrowphaseContacts.size());
+    BoxPairBatch batch;
+    uint32_t batchSlots[BoxPairBatch::MaxPairs];
+    ContactManifold batchManifolds[BoxPairBatch::MaxPairs];
+    const auto flushBatch = [&]() {
+        collideBoxBatch(batch, m_settings.contactMargin, batchManifolds);
+        for (int lane = 0; lane < batch.count; ++lane) {
+            m_manifolds[batchSlots[lane]] = batchManifolds[lane];
+        }
+        batch.clear();
+    };
+    for (size_t slot = 0; slot < m_narrowphaseContacts.size(); ++slot) {
+        const Contact& contact = m_contacts[m_narrowphaseContacts[slot]];
+        const Body& bodyA = m_bodies[contact.bodyA];
+        const Body& bodyB = m_bodies[contact.bodyB];
+        if (bodyA.speculativeDistance + bodyB.speculativeDistance > 0.0f) {
+            m_speculativeContacts.push_back(static_cast<uint32_t>(slot));
+            continue;
+        }
+        if (bodyA.shape.type == ShapeType::Box && bodyB.shape.type == ShapeType::Box) {
+            batchSlots[batch.count] = static_cast<uint32_t>(slot);
+            batch.add(bodyA.shape.halfExtents, bodyA.getPose(), bodyB.shape.halfExtents, bodyB.getPose());
+            if (batch.isFull()) flushBatch();
+            continue;
+        }
+
+        ContactManifold& manifold = m_manifolds[slot];
+        if (!collide(bodyA.shape, bodyA.getPose(), bodyB.shape, bodyB.getPose(), m_settings.contactMargin, manifold)) {
+            manifold.pointCount = 0;
+        }
+    }
+    if (batch.count > 0) flushBatch();
+
+    // Pairs with a fast continuous body reach as far as it can move this
+    // substep. The solver lets separated points close their gap and no more,
+    // which stops the body at the surface instead of past it.
+    if (!m_speculativeContacts.empty()) {
+        const auto start = Clock::now();
+        for (uint32_t slot : m_speculativeContacts) {
+            const Contact& contact = m_contacts[m_narrowphaseContacts[slot]];
+            const Body& bodyA = m_bodies[contact.bodyA];
+            const Body& bodyB = m_bodies[contact.bodyB];
+            const float margin = m_settings.contactMargin + bodyA.speculativeDistance + bodyB.speculativeDistance;
+            ContactManifold& manifold = m_manifolds[slot];
+            if (!collide(bodyA.shape, bodyA.getPose(), bodyB.shape, bodyB.getPose(), margin, manifold)) {
+                manifold.pointCount = 0;
+            }
+        }
+        m_stats.continuousPairCount += m_speculativeContacts.size();
+        m_stats.continuousMs += elapsedMs(start);
+    }
+
+    for (size_t slot = 0; slot < m_narrowphaseContacts.size(); ++slot) {
+        Contact& contact = m_contacts[m_narrowphaseContacts[slot]];
+        const Body& bodyA = m_bodies[contact.bodyA];
+        const Body& bodyB = m_bodies[contact.bodyB];
+        const ContactManifold& manifold = m_manifolds[slot];
+
+        CachedPoint previous[ContactManifold::MaxPoints];
+        const int previousCount = contact.pointCount;
+        std::copy(contact.points, contact.points + previousCount, previous);
+
+        if (previousCount > 0) --m_stats.contactCount;
+        if (manifold.pointCount > 0) ++m_stats.contactCount;
+        m_stats.contactPointCount -= static_cast<size_t>(previousCount);
+        m_stats.contactPointCount += static_cast<size_t>(manifold.pointCount);
+        contact.normal = manifold.normal;
+        contact.pointCount = manifold.pointCount;
+        const glm::mat3 inverseRotationA = glm::transpose(bodyA.rotation);
+        for (int k = 0; k < manifold.pointCount; ++k) {
+            const ContactPoint& source = manifold.points[k];
+            CachedPoint& point = contact.points[k];
+            point = CachedPoint();
+            point.localA = inverseRotationA * (source.position - bodyA.position);
+            point.armA = source.position - bodyA.position;
+            point.armB = source.position - bodyB.position;
+            point.penetration = source.penetration;
+
+            for (int j = 0; j < previousCount; ++j) {
+                const glm::vec3 delta = previous[j].localA - point.localA;
+                if (glm::dot(delta, delta) > WarmStartDistanceSquared) continue;
+                std::copy(previous[j].impulse, previous[j].impulse + 3, point.impulse);
+                break;
+            }
+        }
+    }
+
+    m_stats.pairCount = m_contactLookup.size();
+}
+
+void PhysicsWorld::buildIslands() {
+    RC_PROFILE_SCOPE("PhysicsWorld::buildIslands");
+    // An awake body touching a sleeping one wakes its whole island. Waking
+    // appends the island's contacts to m_awakeContacts, so this one pass also
+    // reaches the islands those touch.
+    for (size_t slot = 0; slot < m_awakeContacts.size(); ++slot) {
+        const Contact& contact = m_contacts[m_awakeContacts[slot]];
+        if (contact.pointCount == 0) continue;
+
+        const Body& bodyA = m_bodies[contact.bodyA];
+        const Body& bodyB = m_bodies[contact.bodyB];
+        if (bodyA.awake == bodyB.awake) continue;
+        const uint32_t sleeping = bodyA.awake ? contact.bodyB : contact.bodyA;
+        if (m_bodies[sleeping].type == BodyType::Static) continue;
+        wakeBody(sleeping);
+    }
+
+    const uint32_t awakeCount = static_cast<uint32_t>(m_awakeBodies.size());
+    for (uint32_t slot = 0; slot < awakeCount; ++slot) {
+        m_bodies[m_awakeBodies[slot]].solverIndex = slot;
+    }
+    m_islandParents.resize(awakeCount);
+    std::iota(m_islandParents.begin(), m_islandParents.end(), 0u);
+    auto findRoot = [this](uint32_t slot) {
+        while (m_islandParents[slot] != slot) {
+            m_islandParents[slot] = m_islandParents[m_islandParents[slot]];
+            slot = m_islandParents[slot];
+        }
+        return slot;
+    };
+
+    // Static and kinematic bodies do not join islands: they are not pushed
+    // back, so islands resting on the same ground stay independent.
+    m_islandContacts.clear();
+    for (uint32_t index : m_awakeContacts) {
+        const Contact& contact = m_contacts[index];
+        if (contact.pointCount == 0) continue;
+
+        const Body& bodyA = m_bodies[contact.bodyA];
+        const Body& bodyB = m_bodies[contact.bodyB];
+        if (bodyA.type != BodyType::Dynamic && bodyB.type != BodyType::Dynamic) continue;
+        m_islandContacts.push_back(index);
+        if (bodyA.type == BodyType::Dynamic && bodyB.type == BodyType::Dynamic) {
+            const uint32_t rootA = findRoot(bodyA.solverIndex);
+            const uint32_t rootB = findRoot(bodyB.solverIndex);
+            if (rootA != rootB) m_islandParents[std::max(rootA, rootB)] = std::min(rootA, rootB);
+        }
+    }
+
+    m_islands.clear();
+    m_islandIds.assign(awakeCount, NoIsland);
+    for (uint32_t slot = 0; slot < awakeCount; ++slot) {
+        if (m_bodies[m_awakeBodies[slot]].type != BodyType::Dynamic) continue;
+
+        const uint32_t root = findRoot(slot);
+        if (m_islandIds[root] == NoIsland) {
+            m_islandIds[root] = static_cast<uint32_t>(m_islands.size());
+            m_islands.emplace_back();
+        }
+        m_islandIds[slot] = m_islandIds[root];
+        ++m_islands[m_islandIds[slot]].bodyCount;
+    }
+
+    auto islandOf = [this](const Contact& contact) {
+        const Body& bodyA = m_bodies[contact.bodyA];
+        const Body& dynamic = bodyA.type == BodyType::Dynamic ? bodyA : m_bodies[contact.bodyB];
+        return m_islandIds[dynamic.solverIndex];
+    };
+    for (uint32_t index : m_islandContacts) {
+        ++m_islands[islandOf(m_contacts[index])].contactCount;
+    }
+
+    uint32_t bodyOffset = 0;
+    uint32_t contactOffset = 0;
+    for (Island& island : m_islands) {
+        island.firstBody = bodyOffset;
+        island.firstContact = contactOffset;
+        bodyOffset += island.bodyCount;
+        contactOffset += island.contactCount;
+        island.bodyCount = 0;
+        island.contactCount = 0;
+    }
+
+    m_islandBodies.resize(bodyOffset);
+    for (uint32_t slot = 0; slot < awakeCount; ++slot) {
+        if (m_islandIds[slot] == NoIsland) continue;
+
+        Island& island = m_islands[m_islandIds[slot]];
+        m_islandBodies[island.firstBody + island.bodyCount++] = m_awakeBodies[slot];
+    }
+
+    // Sleeping static and kinematic bodies all share the still slot past the
+    // awake bodies.
+    auto solverSlot = [this, awakeCount](uint32_t index) {
+        const Body& body = m_bodies[index];
+        return body.awake ? body.solverIndex : awakeCount;
+    };
+    m_solverContacts.resize(contactOffset);
+    for (uint32_t index : m_islandContacts) {
+        const Contact& contact = m_contacts[index];
+        Island& island = m_islands[islandOf(contact)];
+        SolverContact& solverContact = m_solverContacts[island.firstContact + island.contactCount++];
+        solverContact.bodyA = solverSlot(contact.bodyA);
+        solverContact.bodyB = solverSlot(contact.bodyB);
+        solverContact.contact = index;
+        solverContact.pointCount = contact.pointCount;
+    }
+
+    uint32_t pointOffset = 0;
+    uint32_t rollingCount = 0;
+    const bool rolling = m_settings.rollingResistance > 0.0f;
+    for (SolverContact& solverContact : m_solverContacts) {
+        solverContact.firstPoint = pointOffset;
+        pointOffset += static_cast<uint32_t>(solverContact.pointCount);
+
+        const Contact& contact = m_contacts[solverContact.contact];
+        const bool ball = m_bodies[contact.bodyA].shape.type == ShapeType::Sphere ||
+                          m_bodies[contact.bodyB].shape.type == ShapeType::Sphere;
+        solverContact.rolling = rolling && ball ? rollingCount++ : NoRolling;
+    }
+    m_solverPoints.resize(pointOffset);
+    m_solverRolling.resize(rollingCount);
+    m_stats.islandCount = m_islands.size();
+}
+
+void PhysicsWorld::solveIslands(float deltaTime) {
+    RC_PROFILE_SCOPE("PhysicsWorld::solveIslands");
+    const size_t awakeCount = m_awakeBodies.size();
+    m_solverBodies.resize(awakeCount + 1);
+    for (size_t slot = 0; slot < awakeCount; ++slot) {
+        Body& body = m_bodies[m_awakeBodies[slot]];
+        SolverBody& solverBody = m_solverBodies[slot];
+        if (body.type == BodyType::Dynamic) body.linearVelocity += m_settings.gravity * deltaTime;
+        solverBody = SolverBody();
+        solverBody.linearVelocity = body.linearVelocity;
+        solverBody.angularVelocity = body.angularVelocity;
+        solverBody.inverseMass = body.inverseMass;
+    }
+    m_solverBodies[awakeCount] = SolverBody();
+
+    core::JobSystem::get().parallelFor(m_islands.size(), [this, deltaTime](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            solveIsland(m_islands[i], deltaTime);
+        }
+    });
+
+    // Kinematic bodies follow their velocity and are never pushed back.
+    for (size_t slot = 0; slot < awakeCount; ++slot) {
+        Body& body = m_bodies[m_awakeBodies[slot]];
+        if (body.type == BodyType::Kinematic) integrateBody(body, m_solverBodies[slot], deltaTime);
+    }
+}
+
+// Touches only the island's own bodies, contacts and solver slots. Slots of
+// static and kinematic bodies are shared between islands and only read.
+void PhysicsWorld::solveIsland(const Island& island, float deltaTime) {
+    const SolverContact* contactsBegin = m_solverContacts.data() + island.firstContact;
+    const SolverContact* contactsEnd = contactsBegin + island.contactCount;
+    const float inverseDeltaTime = 1.0f / deltaTime;
+
+    for (const SolverContact* solverContact = contactsBegin; solverContact != contactsEnd; ++solverContact) {
+        const Contact& contact = m_contacts[solverContact->contact];
+        const Body& bodyA = m_bodies[contact.bodyA];
+        const Body& bodyB = m_bodies[contact.bodyB];
+        SolverBody& solverA = m_solverBodies[solverContact->bodyA];
+        SolverBody& solverB = m_solverBodies[solverContact->bodyB];
+        SolverContact& prepared = m_solverContacts[solverContact - m_solverContacts.data()];
+        prepared.friction = std::sqrt(bodyA.friction * bodyB.friction);
+        prepared.directions[0] = contact.normal;
+        tangentBasis(contact.normal, prepared.directions[1], prepared.directions[2]);
+        const float restitution = std::max(bodyA.restitution, bodyB.restitution);
+
+        for (int k = 0; k < contact.pointCount; ++k) {
+            const CachedPoint& cached = contact.points[k];
+            SolverPoint& point = m_solverPoints[prepared.firstPoint + k];
+            point = SolverPoint();
+            for (int row = 0; row < 3; ++row) {
+                const glm::vec3& direction = prepared.directions[row];
+                point.angularA[row] = glm::cross(cached.armA, direction);
+                point.angularB[row] = glm::cross(cached.armB, direction);
+                point.responseA[row] = bodyA.inverseInertia * point.angularA[row];
+                point.responseB[row] = bodyB.inverseInertia * point.angularB[row];
+                const float mass = bodyA.inverseMass + bodyB.inverseMass +
+                                   glm::dot(point.angularA[row], point.responseA[row]) +
+                                   glm::dot(point.angularB[row], point.responseB[row]);
+                point.mass[row] = mass > 0.0f ? 1.0f / mass : 0.0f;
+                point.impulse[row] = cached.impulse[row];
+            }
+
+            // Separated points let the bodies close the gap this step and no
+            // more; penetrating points are pushed apart a fraction at a time.
+            point.velocityBias = std::min(cached.penetration, 0.0f) * inverseDeltaTime;
+            point.positionBias = m_settings.baumgarte * inverseDeltaTime *
+                                 std::max(cached.penetration - m_settings.linearSlop, 0.0f);
+
+            const float approach = glm::dot(contact.normal, solverB.linearVelocity - solverA.linearVelocity) +
+                                   glm::dot(point.angularB[0], solverB.angularVelocity) -
+                                   glm::dot(point.angularA[0], solverA.angularVelocity);
+            if (approach < -m_settings.restitutionThreshold && restitution > 0.0f) {
+                point.velocityBias = std::max(point.velocityBias, -restitution * approach);
+            }
+
+            for (int row = 0; row < 3; ++row) {
+                const glm::vec3 impulse = prepared.directions[row] * point.impulse[row];
+                if (solverA.inverseMass > 0.0f) {
+                    solverA.linearVelocity -= impulse * solverA.inverseMass;
+                    solverA.angularVelocity -= point.responseA[row] * point.impulse[row];
+                }
+                if (solverB.inverseMass > 0.0f) {
+                    solverB.linearVelocity += impulse * solverB.inverseMass;
+                    solverB.angularVelocity += point.responseB[row] * point.impulse[row];
+                }
+            }
+        }
+
+        if (prepared.rolling != NoRolling) {
+            SolverRolling& rolling = m_solverRolling[prepared.rolling];
+            const float radiusA = bodyA.shape.type == ShapeType::Sphere ? bodyA.shape.radius : 0.0f;
+            const float radiusB = bodyB.shape.type == ShapeType::Sphere ? bodyB.shape.radius : 0.0f;
+            rolling.inverseInertiaA = bodyA.inverseInertia;
+            rolling.inverseInertiaB = bodyB.inverseInertia;
+            const glm::mat3 inverseMass = bodyA.inverseInertia + bodyB.inverseInertia;
+            rolling.mass = glm::determinant(inverseMass) > 0.0f ? glm::inverse(inverseMass) : glm::mat3(0.0f);
+            rolling.limit = m_settings.rollingResistance * std::max(radiusA, radiusB);
+            rolling.impulse = contact.rollingImpulse;
+            if (solverA.inverseMass > 0.0f) solverA.angularVelocity -= rolling.inverseInertiaA * rolling.impulse;
+            if (solverB.inverseMass > 0.0f) solverB.angularVelocity += rolling.inverseInertiaB * rolling.impulse;
+        }
+    }
+
+    for (int iteration = 0; iteration < m_settings.velocityIterations; ++iteration) {
+        for (const SolverContact* contact = contactsBegin; contact != contactsEnd; ++contact) {
+            SolverBody& bodyA = m_solverBodies[contact->bodyA];
+            SolverBody& bodyB = m_solverBodies[contact->bodyB];
+            SolverPoint* points = m_solverPoints.data() + contact->firstPoint;
+            glm::vec3 linearA = bodyA.linearVelocity;
+            glm::vec3 angularA = bodyA.angularVelocity;
+            glm::vec3 linearB = bodyB.linearVelocity;
+            glm::vec3 angularB = bodyB.angularVelocity;
+
+            auto speed = [&](const SolverPoint& point, int row) {
+                return glm::dot(contact->directions[row], linearB - linearA) + glm::dot(point.angularB[row], angularB) -
+                       glm::dot(point.angularA[row], angularA);
+            };
+            auto apply = [&](const SolverPoint& point, int row, float lambda) {
+                linearA -= contact->directions[row] * (lambda * bodyA.inverseMass);
+                angularA -= point.responseA[row] * lambda;
+                linearB += contact->directions[row] * (lambda * bodyB.inverseMass);
+                angularB += point.responseB[row] * lambda;
+            };
+            auto store = [&](glm::vec3& linearVelocityA, glm::vec3& angularVelocityA, glm::vec3& linearVelocityB,
+                             glm::vec3& angularVelocityB) {
+                if (bodyA.inverseMass > 0.0f) {
+                    linearVelocityA = linearA;
+                    angularVelocityA = angularA;
+                }
+                if (bodyB.inverseMass > 0.0f) {
+                    linearVelocityB = linearB;
+                    angularVelocityB = angularB;
+                }
+            };
+
+            // Rolling and sliding friction first, bounded by the normal impulse
+            // from the last pass.
+            if (contact->rolling != NoRolling) {
+                SolverRolling& rolling = m_solverRolling[contact->rolling];
+                float normalImpulse = 0.0f;
+                for (int k = 0; k < contact->pointCount; ++k) {
+                    normalImpulse += points[k].impulse[0];
+                }
+                const float maxImpulse = rolling.limit * normalImpulse;
+                glm::vec3 accumulated = rolling.impulse - rolling.mass * (angularB - angularA);
+                const float length = glm::length(accumulated);
+                if (length > maxImpulse) accumulated *= maxImpulse / length;
+                const glm::vec3 lambda = accumulated - rolling.impulse;
+                rolling.impulse = accumulated;
+                angularA -= rolling.inverseInertiaA * lambda;
+                angularB += rolling.inverseInertiaB * lambda;
+            }
+            for (int k = 0; k < contact->pointCount; ++k) {
+                SolverPoint& point = points[k];
+                const float maxFriction = contact->friction * point.impulse[0];
+                for (int row = 1; row < 3; ++row) {
+                    const float accumulated = glm::clamp(point.impulse[row] - speed(point, row) * point.mass[row],
+                                                         -maxFriction, maxFriction);
+                    apply(point, row, accumulated - point.impulse[row]);
+                    point.impulse[row] = accumulated;
+                }
+            }
+
+            for (int k = 0; k < contact->pointCount; ++k) {
+                SolverPoint& point = points[k];
+                const float accumulated =
+                    std::max(point.impulse[0] + (point.velocityBias - speed(point, 0)) * point.mass[0], 0.0f);
+                apply(point, 0, accumulated - point.impulse[0]);
+                point.impulse[0] = accumulated;
+            }
+            store(bodyA.linearVelocity, bodyA.angularVelocity, bodyB.linearVelocity, bodyB.angularVelocity);
+
+            // Split impulses, applied to the bias velocities only.
+            linearA = bodyA.biasLinearVelocity;
+            angularA = bodyA.biasAngularVelocity;
+            linearB = bodyB.biasLinearVelocity;
+            angularB = bodyB.biasAngularVelocity;
+            for (int k = 0; k < contact->pointCount; ++k) {
+                SolverPoint& point = points[k];
+                if (point.positionBias <= 0.0f) continue;
+
+                const float accumulated =
+                    std::max(point.biasImpulse + (point.positionBias - speed(point, 0)) * point.mass[0], 0.0f);
+                apply(point, 0, accumulated - point.biasImpulse);
+                point.biasImpulse = accumulated;
+            }
+            store(bodyA.biasLinearVelocity, bodyA.biasAngularVelocity, bodyB.biasLinearVelocity,
+                  bodyB.biasAngularVelocity);
+        }
+    }
+
+    for (const SolverContact* solverContact = contactsBegin; solverContact != contactsEnd; ++solverContact) {
+        Contact& contact = m_contacts[solverContact->contact];
+        for (int k = 0; k < solverContact->pointCount; ++k) {
+            const SolverPoint& point = m_solverPoints[solverContact->firstPoint + k];
+            std::copy(point.impulse, point.impulse + 3, contact.points[k].impulse);
+        }
+        if (solverContact->rolling != NoRolling) contact.rollingImpulse = m_solverRolling[solverContact->rolling].impulse;
+    }
+
+    for (uint32_t i = 0; i < island.bodyCount; ++i) {
+        Body& body = m_bodies[m_islandBodies[island.firstBody + i]];
+        integrateBody(body, m_solverBodies[body.solverIndex], deltaTime);
+    }
+}
+
+void PhysicsWorld::integrateBody(Body& body, const SolverBody& solverBody, float deltaTime) {
+    body.linearVelocity = solverBody.linearVelocity;
+    body.angularVelocity = solverBody.angularVelocity;
+    body.position += (solverBody.linearVelocity + solverBody.biasLinearVelocity) * deltaTime;
+    const glm::vec3 angular = solverBody.angularVelocity + solverBody.biasAngularVelocity;
+    const glm::quat spin(0.0f, angular.x, angular.y, angular.z);
+    body.orientation = glm::normalize(body.orientation + spin * body.orientation * (0.5f * deltaTime));
+    body.rotation = glm::mat3_cast(body.orientation);
+    updateInertia(body.inverseInertia, body.rotation, body.inverseInertiaLocal);
+}
+
+void PhysicsWorld::updateSleep() {
+    if (m_settings.allowSleep) {
+        const float linearLimit = m_settings.sleepLinearVelocity * m_settings.sleepLinearVelocity;
+        const float angularLimit = m_settings.sleepAngularVelocity * m_settings.sleepAngularVelocity;
+        for (const Island& island : m_islands) {
+            int restingFrames = std::numeric_limits<int>::max();
+            for (uint32_t i = 0; i < island.bodyCount; ++i) {
+                Body& body = m_bodies[m_islandBodies[island.firstBody + i]];
+                if (glm::dot(body.linearVelocity, body.linearVelocity) > linearLimit ||
+                    glm::dot(body.angularVelocity, body.angularVelocity) > angularLimit) {
+                    body.restingFrames = 0;
+                } else {
+                    ++body.restingFrames;
+                }
+                restingFrames = std::min(restingFrames, body.restingFrames);
+            }
+            if (restingFrames < m_settings.sleepFrames) continue;
+
+            uint32_t sleepingIsland;
+            if (!m_freeSleepingIslands.empty()) {
+                sleepingIsland = m_freeSleepingIslands.back();
+                m_freeSleepingIslands.pop_back();
+            } else {
+                sleepingIsland = static_cast<uint32_t>(m_sleepingIslands.size());
+                m_sleepingIslands.emplace_back();
+            }
+            for (uint32_t i = 0; i < island.bodyCount; ++i) {
+                const uint32_t index = m_islandBodies[island.firstBody + i];
+                Body& body = m_bodies[index];
+                body.awake = false;
+                body.sleepingIsland = sleepingIsland;
+                body.linearVelocity = glm::vec3(0.0f);
+                body.angularVelocity = glm::vec3(0.0f);
+                m_sleepingIslands[sleepingIsland].push_back(index);
+                dropSleepingContacts(body);
+            }
+        }
+    }
+
+    // Static bodies only stay awake for the step after an edit, so their
+    // contacts get rechecked; kinematic bodies until they stop.
+    for (uint32_t index : m_awakeBodies) {
+        Body& body = m_bodies[index];
+        if (body.type == BodyType::Static ||
+            (body.type == BodyType::Kinematic && body.linearVelocity == glm::vec3(0.0f) &&
+             body.angularVelocity == glm::vec3(0.0f))) {
+            body.awake = false;
+            dropSleepingContacts(body);
+        }
+    }
+}
+
+void PhysicsWorld::wakeBody(uint32_t index) {
+    Body& body = m_bodies[index];
+    if (!body.alive || body.awake) return;
+
+    const uint32_t island = body.sleepingIsland;
+    if (island == NoIsland) {
+        body.awake = true;
+        body.restingFrames = 0;
+        m_awakeBodies.push_back(index);
+        for (uint32_t contact : body.contacts) {
+            addAwakeContact(contact);
+        }
+        return;
+    }
+
+    for (uint32_t member : m_sleepingIslands[island]) {
+        Body& other = m_bodies[member];
+        if (!other.alive || other.sleepingIsland != island) continue;
+
+        other.awake = true;
+        other.restingFrames = 0;
+        other.sleepingIsland = NoIsland;
+        m_awakeBodies.push_back(member);
+        for (uint32_t contact : other.contacts) {
+            addAwakeContact(contact);
+        }
+    }
+    m_sleepingIslands[island].clear();
+    m_freeSleepingIslands.push_back(island);
+}
+
+void PhysicsWorld::synchronizeProxies(float deltaTime) {
+    RC_PROFILE_SCOPE("PhysicsWorld::synchronizeProxies");
+    for (uint32_t index : m_awakeBodies) {
+        Body& body = m_bodies[index];
+        if (body.type == BodyType::Static) continue;
+
+        const Aabb bounds = computeBounds(body.shape, body.getPose());
+        if (m_tree.moveProxy(body.proxy, bounds, body.linearVelocity * deltaTime) && !body.moved) {
+            body.moved = true;
+            m_moveBuffer.push_back(index);
+        }
+    }
+}
+
+void PhysicsWorld::writeComponents() {
+    auto& registry = m_scene->registry();
+    auto& transforms = registry.storage<scene::TransformComponent>();
+    auto& rigidBodies = registry.storage<RigidBodyComponent>();
+    m_writingComponents = true;
+    for (uint32_t index : m_awakeBodies) {
+        Body& body = m_bodies[index];
+        if (body.type == BodyType::Static) continue;
+
+        scene::TransformComponent& transform = transforms.get(body.entity);
+        transform.position = body.position;
+        transform.rotation = eulerFromRotation(body.rotation);
+        body.synced = transform;
+
+        RigidBodyComponent& rigidBody = rigidBodies.get(body.entity);
+        rigidBody.linearVelocity = body.linearVelocity;
+        rigidBody.angularVelocity = body.angularVelocity;
+        m_scene->transformChanged(body.entity);
+    }
+    m_writingComponents = false;
+
+    // Bodies that fell asleep this step were written once more above.
+    m_awakeBodies.erase(std::remove_if(m_awakeBodies.begin(), m_awakeBodies.end(),
+                                       [this](uint32_t index) { return !m_bodies[index].awake; }),
+                        m_awakeBodies.end());
+    m_stats.awakeBodyCount = m_awakeBodies.size();
+}
+
+void PhysicsWorld::configureBody(Body& body, const RigidBodyComponent& rigidBody,
+                                 const scene::TransformComponent& transform) {
+    body.type = rigidBody.type;
+    body.density = rigidBody.density;
+    body.shape.type = rigidBody.shape;
+    const glm::vec3 size = glm::abs(transform.scale);
+    body.shape.halfExtents = size * 0.5f;
+    body.shape.radius = 0.5f * std::max(size.x, std::max(size.y, size.z));
+    // Infinite planes cannot move.
+    if (body.shape.type == ShapeType::Plane) body.type = BodyType::Static;
+
+    body.position = transform.position;
+    body.rotation = rotationFromEuler(transform.rotation);
+    body.orientation = glm::normalize(glm::quat_cast(body.rotation));
+    body.synced = transform;
+
+    body.inverseMass = 0.0f;
+    body.inverseInertiaLocal = glm::vec3(0.0f);
+    if (body.type == BodyType::Dynamic) {
+        const glm::vec3 half = body.shape.halfExtents;
+        const float radius = body.shape.radius;
+        float mass;
+        glm::vec3 inertia;
+        if (body.shape.type == ShapeType::Sphere) {
+            mass = std::max(body.density * (4.0f / 3.0f) * glm::pi<float>() * radius * radius * radius, MinimumMass);
+            inertia = glm::vec3(0.4f * mass * radius * radius);
+        } else {
+            mass = std::max(body.density * 8.0f * half.x * half.y * half.z, MinimumMass);
+            inertia = (mass / 3.0f) * glm::vec3(half.y * half.y + half.z * half.z, half.x * half.x + half.z * half.z,
+                                                half.x * half.x + half.y * half.y);
+        }
+        body.inverseMass = 1.0f / mass;
+        body.inverseInertiaLocal = 1.0f / glm::max(inertia, glm::vec3(MinimumMass));
+    }
+    updateInertia(body.inverseInertia, body.rotation, body.inverseInertiaLocal);
+}
+
+void PhysicsWorld::addContact(uint32_t bodyA, uint32_t bodyB) {
+    if (bodyA > bodyB) std::swap(bodyA, bodyB);
+    const uint64_t key = pairKey(bodyA, bodyB);
+    if (m_contactLookup.count(key)) return;
+
+    uint32_t index;
+    if (!m_freeContacts.empty()) {
+        index = m_freeContacts.back();
+        m_freeContacts.pop_back();
+    } else {
+        index = static_cast<uint32_t>(m_contacts.size());
+        m_contacts.emplace_back();
+    }
+
+    Contact& contact = m_contacts[index];
+    contact = Contact();
+    contact.bodyA = bodyA;
+    contact.bodyB = bodyB;
+    m_contactLookup.emplace(key, index);
+    m_bodies[bodyA].contacts.push_back(index);
+    m_bodies[bodyB].contacts.push_back(index);
+    if (m_bodies[bodyA].awake || m_bodies[bodyB].awake) addAwakeContact(index);
+}
+
+void PhysicsWorld::removeContact(uint32_t index) {
+    Contact& contact = m_contacts[index];
+    m_contactLookup.erase(pairKey(contact.bodyA, contact.bodyB));
+    for (uint32_t body : { contact.bodyA, contact.bodyB }) {
+        std::vector<uint32_t>& contacts = m_bodies[body].contacts;
+        *std::find(contacts.begin(), contacts.end(), index) = contacts.back();
+        contacts.pop_back();
+    }
+
+    if (contact.pointCount > 0) --m_stats.contactCount;
+    m_stats.contactPointCount -= static_cast<size_t>(contact.pointCount);
+    removeAwakeContact(index);
+    contact = Contact();
+    m_freeContacts.push_back(index);
+}
+
+// Waking and removal shuffle the set. Putting it back in index order once a
+// step lets the substeps walk m_contacts front to back.
+void PhysicsWorld::sortAwakeContacts() {
+    std::sort(m_awakeContacts.begin(), m_awakeContacts.end());
+    for (uint32_t slot = 0; slot < m_awakeContacts.size(); ++slot) {
+        m_contacts[m_awakeContacts[slot]].awakeSlot = slot;
+    }
+}
+
+void PhysicsWorld::addAwakeContact(uint32_t index) {
+    Contact& contact = m_contacts[index];
+    if (contact.awakeSlot != NoSlot) return;
+
+    contact.awakeSlot = static_cast<uint32_t>(m_awakeContacts.size());
+    m_awakeContacts.push_back(index);
+}
+
+void PhysicsWorld::dropSleepingContacts(const Body& body) {
+    for (uint32_t index : body.contacts) {
+        const Contact& contact = m_contacts[index];
+        if (!m_bodies[contact.bodyA].awake && !m_bodies[contact.bodyB].awake) removeAwakeContact(index);
+    }
+}
+
+void PhysicsWorld::removeAwakeContact(uint32_t index) {
+    Contact& contact = m_contacts[index];
+    if (contact.awakeSlot == NoSlot) return;
+
+    const uint32_t last = m_awakeContacts.back();
+    m_awakeContacts[contact.awakeSlot] = last;
+    m_contacts[last].awakeSlot = contact.awakeSlot;
+    m_awakeContacts.pop_back();
+    contact.awakeSlot = NoSlot;
+}
+
+}
@@ -0,0 +1,339 @@
+#pragma once
+
+#include "Collision.hpp"
+#include "DynamicTree.hpp"
+#include "RigidBody.hpp"
+#include "scene/Scene.hpp"
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace roblox_clone::physics {
+
+struct PhysicsSettings {
+    // Studs per second squared, the same default as Roblox's Workspace.Gravity.
+    glm::vec3 gravity = glm::vec3(0.0f, -196.2f, 0.0f);
+    // Each step is split into substeps that rerun the narrowphase and solver.
+    // Stud sized parts under Roblox gravity need roughly 240 Hz to stack.
+    int substeps = 4;
+    int velocityIterations = 8;
+    // Fraction of the penetration beyond linearSlop removed per step.
+    float baumgarte = 0.2f;
+    float linearSlop = 0.01f;
+    // Shapes closer than this get speculative contacts.
+    float contactMargin = 0.05f;
+    float proxyMargin = 0.1f;
+    // Impacts slower than this do not bounce.
+    float restitutionThreshold = 2.0f;
+    // Caps the torque resisting a ball's roll at this times its radius times
+    // the contact force. Without it balls never stop and keep piles awake.
+    float rollingResistance = 0.05f;
+    // Islands whose bodies all stay under both speeds for sleepFrames steps
+    // sleep until an awake body touches them or a script edits them.
+    bool allowSleep = true;
+    float sleepLinearVelocity = 0.2f;
+    float sleepAngularVelocity = 0.1f;
+    int sleepFrames = 30;
+};
+
+struct PhysicsStats {
+    size_t bodyCount = 0;
+    size_t dynamicBodyCount = 0;
+    size_t awakeBodyCount = 0;
+    size_t islandCount = 0;
+    size_t pairCount = 0;
+    size_t contactCount = 0;
+    size_t contactPointCount = 0;
+    // Continuous bodies fast enough to need it this step, the speculative pair
+    // tests they caused over all substeps and the time both took.
+    size_t continuousBodyCount = 0;
+    size_t continuousPairCount = 0;
+    float continuousMs = 0.0f;
+    float broadphaseMs = 0.0f;
+    float narrowphaseMs = 0.0f;
+    float solverMs = 0.0f;
+    float stepMs = 0.0f;
+};
+
+// Rigid body simulation for entities with a RigidBodyComponent and a
+// TransformComponent. Pairs come from an incremental dynamic AABB tree and
+// persist across steps, so the sequential impulse solver can warm start from
+// the previous step's impulses.
+//
+// Awake dynamic bodies are grouped into contact islands every substep, and
+// independent islands are solved in parallel on the JobSystem. Each body
+// keeps a list of its contacts, so the narrowphase, the solver and the write
+// back only visit awake bodies and their contacts, and the cost of a step
+// follows the number of awake bodies.
+//
+// Bodies flagged continuous that would cross more than their own size in a
+// step sweep their proxy along the step and collide with a margin as wide as
+// their substep motion, so speculative contacts catch them at thin parts.
+//
+// Each step reads back the components of awake bodies, and of sleeping ones
+// reported through Scene::onTransformChanged() or a registry.patch() of their
+// RigidBodyComponent (edited transforms teleport the body). It then writes the
+// simulated state to the components and reports moved parts through
+// Scene::transformChanged().
+class PhysicsWorld {
+public:
+    explicit PhysicsWorld(const PhysicsSettings& settings = {});
+    ~PhysicsWorld();
+    
+    PhysicsWorld(const PhysicsWorld&) = delete;
+    PhysicsWorld& operator=(const PhysicsWorld&) = delete;
+    
+    void attach(scene::Scene& scene);
+    void detach();
+    void step(float deltaTime);
+    
+    // Everything one step hands to the next: bodies with their orientations,
+    // velocities and sleep state, the broadphase and the contact cache with
+    // its warm starting impulses. States kept in a ring reuse their buffers.
+    class State;
+    void saveState(State& state) const;
+    // Puts the world back as saveState() found it. Restore the registry to the
+    // same tick first: the spawns and edits that restore reports are dropped,
+    // and every RigidBodyComponent is pointed back at its body's slot, so the
+    // restored transforms are not read as teleports.
+    void restoreState(const State& state);
+    
+    const PhysicsSettings& getSettings() const { return m_settings; }
+    void setSettings(const PhysicsSettings& settings) { m_settings = settings; }
+    const PhysicsStats& getStats() const { return m_stats; }
+    const DynamicTree& getBroadphase() const { return m_tree; }
+
+private:
+    static constexpr uint32_t NoIsland = ~0u;
+    static constexpr uint32_t NoRolling = ~0u;
+    static constexpr uint32_t NoSlot = ~0u;
+    
+    struct Body {
+        entt::entity entity = entt::null;
+        BodyType type = BodyType::Static;
+        Shape shape;
+        float density = 1.0f;
+        float friction = 0.5f;
+        float restitution = 0.0f;
+        
+        glm::vec3 position = glm::vec3(0.0f);
+        glm::quat orientation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+        glm::mat3 rotation = glm::mat3(1.0f);
+        glm::vec3 linearVelocity = glm::vec3(0.0f);
+        glm::vec3 angularVelocity = glm::vec3(0.0f);
+        
+        float inverseMass = 0.0f;
+        glm::vec3 inverseInertiaLocal = glm::vec3(0.0f);
+        glm::mat3 inverseInertia = glm::mat3(0.0f);
+        
+        // Transform as last read or written, to spot edits made between steps.
+        scene::TransformComponent synced;
+        uint32_t proxy = DynamicTree::Null;
+        bool alive = false;
+        bool moved = false;
+        bool awake = true;
+        bool continuous = false;
+        // How far the body can travel in one substep, added to the contact
+        // margin of its pairs. Zero unless it is continuous and fast.
+        float speculativeDistance = 0.0f;
+        int restingFrames = 0;
+        uint32_t sleepingIsland = NoIsland;
+        // Index into m_awakeBodies while awake, rebuilt with the islands.
+        uint32_t solverIndex = 0;
+        // Queued in m_editedBodies for the next readComponents().
+        bool edited = false;
+        // Indices into m_contacts of every pair the body is part of.
+        std::vector<uint32_t> contacts;
+        
+        Pose getPose() const { return { position, rotation }; }
+    };
+    
+    // Contact point as kept between steps for warm starting.
+    struct CachedPoint {
+        glm::vec3 localA = glm::vec3(0.0f);
+        glm::vec3 armA = glm::vec3(0.0f);
+        glm::vec3 armB = glm::vec3(0.0f);
+        float penetration = 0.0f;
+        // Normal, then the two friction impulses.
+        float impulse[3] = { 0.0f, 0.0f, 0.0f };
+    };
+    
+    // Slots are recycled through m_freeContacts, so indices stay put while
+    // other pairs come and go.
+    struct Contact {
+        uint32_t bodyA = 0;
+        uint32_t bodyB = 0;
+        // Points from A to B.
+        glm::vec3 normal = glm::vec3(0.0f, 1.0f, 0.0f);
+        CachedPoint points[ContactManifold::MaxPoints];
+        int pointCount = 0;
+        glm::vec3 rollingImpulse = glm::vec3(0.0f);
+        // Index into m_awakeContacts, or NoSlot while both bodies sleep.
+        uint32_t awakeSlot = NoSlot;
+    };
+    
+    // The velocities the solver iterates on, packed apart from Body so the
+    // iterations only stream through the state they change.
+    struct SolverBody {
+        glm::vec3 linearVelocity = glm::vec3(0.0f);
+        glm::vec3 angularVelocity = glm::vec3(0.0f);
+        // Split impulse velocities that push bodies out of penetration. They
+        // move the body for one substep and are then dropped, so overlap
+        // correction never adds momentum.
+        glm::vec3 biasLinearVelocity = glm::vec3(0.0f);
+        glm::vec3 biasAngularVelocity = glm::vec3(0.0f);
+        float inverseMass = 0.0f;
+    };
+    
+    // Row 0 is the normal, rows 1 and 2 the friction tangents. The angular
+    // Jacobians and their inertia scaled responses are cached when the solver
+    // is prepared, so an iteration is a handful of dot products per row.
+    struct SolverPoint {
+        glm::vec3 angularA[3];
+        glm::vec3 angularB[3];
+        glm::vec3 responseA[3];
+        glm::vec3 responseB[3];
+        float impulse[3] = { 0.0f, 0.0f, 0.0f };
+        float mass[3] = { 0.0f, 0.0f, 0.0f };
+        float velocityBias = 0.0f;
+        float positionBias = 0.0f;
+        float biasImpulse = 0.0f;
+    };
+    
+    // Awake dynamic bodies connected through touching contacts, as ranges of
+    // m_islandBodies and m_solverContacts.
+    struct Island {
+        uint32_t firstBody = 0;
+        uint32_t bodyCount = 0;
+        uint32_t firstContact = 0;
+        uint32_t contactCount = 0;
+    };
+    
+    // Angular friction between a ball and whatever it touches.
+    struct SolverRolling {
+        glm::mat3 inverseInertiaA = glm::mat3(0.0f);
+        glm::mat3 inverseInertiaB = glm::mat3(0.0f);
+        glm::mat3 mass = glm::mat3(0.0f);
+        glm::vec3 impulse = glm::vec3(0.0f);
+        float limit = 0.0f;
+    };
+    
+    // A touching contact, rebuilt every substep. Body indices are solver slots.
+    struct SolverContact {
+        uint32_t bodyA = 0;
+        uint32_t bodyB = 0;
+        uint32_t contact = 0;
+        uint32_t firstPoint = 0;
+        // Index into m_solverRolling, or NoRolling for contacts without a ball.
+        uint32_t rolling = NoRolling;
+        int pointCount = 0;
+        float friction = 0.0f;
+        glm::vec3 directions[3];
+    };
+    
+    void onBodyAdded(entt::registry& registry, entt::entity entity);
+    void onBodyRemoved(entt::registry& registry, entt::entity entity);
+    void onBodyEdited(entt::registry& registry, entt::entity entity);
+    void onTransformEdited(entt::entity entity);
+    void onAllTransformsEdited();
+    void markEdited(entt::entity entity, uint32_t index);
+    
+    void addPendingBodies();
+    void removeDeadBodies();
+    void readComponents();
+    void readBody(uint32_t index, const RigidBodyComponent& rigidBody, const scene::TransformComponent& transform);
+    void prepareContinuous(float deltaTime);
+    void findNewPairs();
+    void updateContacts();
+    void buildIslands();
+    void solveIslands(float deltaTime);
+    void solveIsland(const Island& island, float deltaTime);
+    void synchronizeProxies(float deltaTime);
+    void updateSleep();
+    void writeComponents();
+    
+    void wakeBody(uint32_t index);
+    static void integrateBody(Body& body, const SolverBody& solverBody, float deltaTime);
+    
+    void configureBody(Body& body, const RigidBodyComponent& rigidBody, const scene::TransformComponent& transform);
+    void addContact(uint32_t bodyA, uint32_t bodyB);
+    void removeContact(uint32_t index);
+    void sortAwakeContacts();
+    void addAwakeContact(uint32_t index);
+    void removeAwakeContact(uint32_t index);
+    // Takes the body's contacts with another sleeping body out of the set.
+    void dropSleepingContacts(const Body& body);
+    
+    static uint64_t pairKey(uint32_t bodyA, uint32_t bodyB) {
+        return (static_cast<uint64_t>(bodyA) << 32) | bodyB;
+    }
+    
+    PhysicsSettings m_settings;
+    PhysicsStats m_stats;
+    scene::Scene* m_scene = nullptr;
+    
+    std::vector<Body> m_bodies;
+    std::vector<uint32_t> m_freeBodies;
+    std::vector<uint32_t> m_deadBodies;
+    std::vector<entt::entity> m_pendingBodies;
+    // Awake bodies of every type; static and kinematic ones drop out again at
+    // the end of the step they were edited or stopped moving.
+    std::vector<uint32_t> m_awakeBodies;
+    // Sleeping bodies are only read back once they show up here.
+    std::vector<uint32_t> m_editedBodies;
+    // Set while writeComponents() reports moves, which are not edits.
+    bool m_writingComponents = false;
+    
+    DynamicTree m_tree;
+    std::vector<uint32_t> m_moveBuffer;
+    std::vector<Contact> m_contacts;
+    std::vector<uint32_t> m_freeContacts;
+    std::unordered_map<uint64_t, uint32_t> m_contactLookup;
+    // Contacts with at least one awake body. Kept up to date as bodies wake,
+    // fall asleep and pairs come and go, so the per substep passes never
+    // visit the contacts of sleeping islands.
+    std::vector<uint32_t> m_awakeContacts;
+    // Contacts rerun by the narrowphase this substep, and their new manifolds.
+    std::vector<uint32_t> m_narrowphaseContacts;
+    std::vector<uint32_t> m_speculativeContacts;
+    std::vector<ContactManifold> m_manifolds;
+    
+    std::vector<uint32_t> m_islandParents;
+    std::vector<uint32_t> m_islandIds;
+    std::vector<uint32_t> m_islandBodies;
+    std::vector<uint32_t> m_islandContacts;
+    std::vector<Island> m_islands;
+    std::vector<std::vector<uint32_t>> m_sleepingIslands;
+    std::vector<uint32_t> m_freeSleepingIslands;
+    
+    std::vector<SolverBody> m_solverBodies;
+    std::vector<SolverContact> m_solverContacts;
+    std::vector<SolverPoint> m_solverPoints;
+    std::vector<SolverRolling> m_solverRolling;
+};
+
+class PhysicsWorld::State {
+private:
+    friend class PhysicsWorld;
+    
+    std::vector<Body> bodies;
+    std::vector<uint32_t> freeBodies;
+    std::vector<uint32_t> deadBodies;
+    std::vector<entt::entity> pendingBodies;
+    std::vector<uint32_t> awakeBodies;
+    std::vector<uint32_t> editedBodies;
+    DynamicTree tree;
+    std::vector<uint32_t> moveBuffer;
+    std::vector<Contact> contacts;
+    std::vector<uint32_t> freeContacts;
+    std::unordered_map<uint64_t, uint32_t> contactLookup;
+    std::vector<uint32_t> awakeContacts;
+    std::vector<std::vector<uint32_t>> sleepingIslands;
+    std::vector<uint32_t> freeSleepingIslands;
+    PhysicsStats stats;
+};
+
+}
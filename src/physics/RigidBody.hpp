@@ -0,0 +1,45 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+
+namespace roblox_clone::physics {
+
+enum class BodyType : uint8_t {
+    Static,
+    Dynamic,
+    Kinematic
+};
+
+// Shapes take their size from TransformComponent::scale so they line up with
+// the unit meshes: Mesh::createCube(1), createSphere(0.5) and createPlane(1, 1).
+// Planes are infinite and face the transform's +Y axis.
+enum class ShapeType : uint8_t {
+    Box,
+    Sphere,
+    Plane
+};
+
+struct RigidBodyComponent {
+    static constexpr uint32_t NoBody = ~0u;
+    
+    BodyType type = BodyType::Dynamic;
+    ShapeType shape = ShapeType::Box;
+    float density = 1.0f;
+    float friction = 0.5f;
+    float restitution = 0.0f;
+    glm::vec3 linearVelocity = glm::vec3(0.0f);
+    glm::vec3 angularVelocity = glm::vec3(0.0f);
+    // Continuous collision for projectiles: while the body moves farther than
+    // its own size in one step it gets speculative contacts with everything
+    // it could reach, so it cannot pass through thin parts.
+    bool continuous = false;
+    
+    // Slot in the PhysicsWorld, assigned when the body is created.
+    uint32_t body = NoBody;
+    
+    RigidBodyComponent() = default;
+    RigidBodyComponent(BodyType bodyType, ShapeType shapeType) : type(bodyType), shape(shapeType) {}
+};
+
+}
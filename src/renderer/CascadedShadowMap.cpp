@@ -0,0 +1,382 @@
+#include "CascadedShadowMap.hpp"
+#include "GpuProfiler.hpp"
+#include "core/Logger.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace roblox_clone::renderer {
+
+namespace {
+
+const char* const s_cascadeZoneNames[CascadedShadowMap::MaxCascades] = {
+    "Cascade 0", "Cascade 1", "Cascade 2", "Cascade 3"
+};
+
+}
+
+CascadedShadowMap::~CascadedShadowMap() {
+    shutdown();
+}
+
+bool CascadedShadowMap::initialize(const ShadowSettings& settings) {
+    m_settings = settings;
+    m_settings.cascadeCount = std::clamp(m_settings.cascadeCount, 1, MaxCascades);
+    
+    m_depthShader = std::make_unique<Shader>();
+    if (!m_depthShader->loadFromFiles("assets/shaders/shadow_depth.vert", "assets/shaders/shadow_depth.frag")) {
+        static const char* vertexSource = R"(
+            #version 450 core
+            layout(location = 0) in vec3 aPosition;
+            
+            uniform mat4 model;
+            uniform mat4 lightSpaceMatrix;
+            
+            void main() {
+                gl_Position = lightSpaceMatrix * model * vec4(aPosition, 1.0);
+            }
+        )";
+        
+        static const char* fragmentSource = R"(
+            #version 450 core
+            void main() {
+            }
+        )";
+        
+        if (!m_depthShader->loadFromSource(vertexSource, fragmentSource)) {
+            RC_ERROR("Failed to load shadow depth shader");
+            return false;
+        }
+    }
+    
+    if (!createTargets()) {
+        RC_ERROR("Failed to create shadow map targets");
+        return false;
+    }
+    
+    for (int i = 0; i < m_settings.cascadeCount; ++i) {
+        Cascade& cascade = m_cascades[i];
+        cascade.cached = i >= m_settings.firstCachedCascade;
+        cascade.stats.cached = cascade.cached;
+        glGenQueries(2, cascade.timerQueries);
+    }
+    
+    RC_INFO("Shadow map initialized: {} cascades at {}x{}", m_settings.cascadeCount,
+            m_settings.resolution, m_settings.resolution);
+    return true;
+}
+
+void CascadedShadowMap::shutdown() {
+    for (auto& cascade : m_cascades) {
+        if (cascade.liveFramebuffer) glDeleteFramebuffers(1, &cascade.liveFramebuffer);
+        if (cascade.staticFramebuffer) glDeleteFramebuffers(1, &cascade.staticFramebuffer);
+        if (cascade.timerQueries[0]) glDeleteQueries(2, cascade.timerQueries);
+        cascade = Cascade();
+    }
+    
+    if (m_depthArray) {
+        glDeleteTextures(1, &m_depthArray);
+        m_depthArray = 0;
+    }
+    if (m_staticDepthArray) {
+        glDeleteTextures(1, &m_staticDepthArray);
+        m_staticDepthArray = 0;
+    }
+    
+    m_depthShader.reset();
+}
+
+bool CascadedShadowMap::createTargets() {
+    const int resolution = m_settings.resolution;
+    const int layers = m_settings.cascadeCount;
+    const float border[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    
+    glGenTextures(1, &m_depthArray);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_depthArray);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT32F, resolution, resolution, layers, 0,
+                 GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, border);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+    
+    glGenTextures(1, &m_staticDepthArray);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_staticDepthArray);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT32F, resolution, resolution, layers, 0,
+                 GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    
+    for (int i = 0; i < layers; ++i) {
+        Cascade& cascade = m_cascades[i];
+        
+        glGenFramebuffers(1, &cascade.liveFramebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, cascade.liveFramebuffer);
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_depthArray, 0, i);
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            return false;
+        }
+        
+        glGenFramebuffers(1, &cascade.staticFramebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, cascade.staticFramebuffer);
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_staticDepthArray, 0, i);
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            return false;
+        }
+    }
+    
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    return true;
+}
+
+void CascadedShadowMap::invalidateStaticCache() {
+    for (auto& cascade : m_cascades) {
+        cascade.staticDirty = true;
+    }
+}
+
+void CascadedShadowMap::update(const glm::mat4& cameraView, float fov, float aspectRatio, float nearPlane,
+                               const glm::vec3& lightDirection, uint64_t staticGeometryVersion) {
+    glm::vec3 direction = glm::normalize(lightDirection);
+    if (glm::dot(direction, m_lightDirection) < 0.99999f) {
+        m_lightDirection = direction;
+        invalidateStaticCache();
+    }
+    
+    if (staticGeometryVersion != m_staticGeometryVersion) {
+        m_staticGeometryVersion = staticGeometryVersion;
+        invalidateStaticCache();
+    }
+    
+    const int count = m_settings.cascadeCount;
+    const float farPlane = m_settings.maxDistance;
+    const float range = farPlane - nearPlane;
+    const float ratio = farPlane / nearPlane;
+    
+    glm::mat4 inverseView = glm::inverse(cameraView);
+    float splitNear = nearPlane;
+    
+    for (int i = 0; i < count; ++i) {
+        float p = static_cast<float>(i + 1) / static_cast<float>(count);
+        float logSplit = nearPlane * std::pow(ratio, p);
+        float uniformSplit = nearPlane + range * p;
+        float splitFar = m_settings.splitLambda * logSplit + (1.0f - m_settings.splitLambda) * uniformSplit;
+        
+        Cascade& cascade = m_cascades[i];
+        cascade.splitNear = splitNear;
+        cascade.splitFar = splitFar;
+        cascade.stats.splitFar = splitFar;
+        fitCascade(cascade, inverseView, fov, aspectRatio);
+        
+        splitNear = splitFar;
+    }
+}
+
+void CascadedShadowMap::fitCascade(Cascade& cascade, const glm::mat4& inverseView, float fov, float aspectRatio) {
+    const float tanHalfY = std::tan(glm::radians(fov) * 0.5f);
+    const float tanHalfX = tanHalfY * aspectRatio;
+    
+    glm::vec3 corners[8];
+    int index = 0;
+    for (float depth : { cascade.splitNear, cascade.splitFar }) {
+        for (float sy : { -1.0f, 1.0f }) {
+            for (float sx : { -1.0f, 1.0f }) {
+                glm::vec4 viewCorner(sx * tanHalfX * depth, sy * tanHalfY * depth, -depth, 1.0f);
+                corners[index++] = glm::vec3(inverseView * viewCorner);
+            }
+        }
+    }
+    
+    glm::vec3 center(0.0f);
+    for (const auto& corner : corners) {
+        center += corner;
+    }
+    center /= 8.0f;
+    
+    float radius = 0.0f;
+    for (const auto& corner : corners) {
+        radius = std::max(radius, glm::length(corner - center));
+    }
+    radius = std::ceil(radius * 16.0f) / 16.0f;
+    
+    if (cascade.cached) {
+        bool contained = cascade.radius > 0.0f && glm::length(center - cascade.center) + radius <= cascade.radius;
+        if (contained && !cascade.staticDirty) {
+            return;
+        }
+        if (!contained) {
+            cascade.center = center;
+            cascade.radius = radius * m_settings.cachedRadiusScale;
+            cascade.staticDirty = true;
+        }
+    } else {
+        cascade.center = center;
+        cascade.radius = radius;
+    }
+    
+    buildCascadeMatrix(cascade);
+}
+
+void CascadedShadowMap::buildCascadeMatrix(Cascade& cascade) const {
+    glm::vec3 up = std::abs(m_lightDirection.y) > 0.99f ? glm::vec3(0, 0, 1) : glm::vec3(0, 1, 0);
+    float distance = cascade.radius + m_settings.casterExtent;
+    
+    glm::mat4 lightView = glm::lookAt(cascade.center - m_lightDirection * distance, cascade.center, up);
+    glm::mat4 lightProjection = glm::ortho(-cascade.radius, cascade.radius, -cascade.radius, cascade.radius,
+                                           0.0f, distance + cascade.radius);
+    
+    glm::mat4 shadowMatrix = lightProjection * lightView;
+    float halfResolution = static_cast<float>(m_settings.resolution) * 0.5f;
+    glm::vec4 origin = shadowMatrix * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    origin *= halfResolution;
+    glm::vec2 offset = (glm::round(glm::vec2(origin)) - glm::vec2(origin)) / halfResolution;
+    lightProjection[3][0] += offset.x;
+    lightProjection[3][1] += offset.y;
+    
+    cascade.viewProjection = lightProjection * lightView;
+}
+
+bool CascadedShadowMap::overlapsCascade(const Cascade& cascade, const ShadowCaster& caster) const {
+    glm::vec3 center = (caster.boundsMin + caster.boundsMax) * 0.5f;
+    glm::vec3 extent = (caster.boundsMax - caster.boundsMin) * 0.5f;
+    
+    const glm::mat4& m = cascade.viewProjection;
+    glm::vec3 clipCenter = glm::vec3(m * glm::vec4(center, 1.0f));
+    glm::vec3 clipExtent(
+        std::abs(m[0][0]) * extent.x + std::abs(m[1][0]) * extent.y + std::abs(m[2][0]) * extent.z,
+        std::abs(m[0][1]) * extent.x + std::abs(m[1][1]) * extent.y + std::abs(m[2][1]) * extent.z,
+        std::abs(m[0][2]) * extent.x + std::abs(m[1][2]) * extent.y + std::abs(m[2][2]) * extent.z);
+    
+    glm::vec3 lo = clipCenter - clipExtent;
+    glm::vec3 hi = clipCenter + clipExtent;
+    return hi.x >= -1.0f && lo.x <= 1.0f && hi.y >= -1.0f && lo.y <= 1.0f && hi.z >= -1.0f && lo.z <= 1.0f;
+}
+
+void CascadedShadowMap::drawCasters(const Cascade& cascade, const std::vector<ShadowCaster>& casters,
+                                    const Mesh& mesh, bool drawStatic, bool drawDynamic, uint32_t& drawn) {
+    m_depthShader->setMat4("lightSpaceMatrix", cascade.viewProjection);
+    
+    mesh.bind();
+    for (const auto& caster : casters) {
+        if (caster.isStatic ? !drawStatic : !drawDynamic) continue;
+        if (!overlapsCascade(cascade, caster)) continue;
+        
+        m_depthShader->setMat4("model", caster.model);
+        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(mesh.getIndexCount()), GL_UNSIGNED_INT, 0);
+        ++drawn;
+    }
+    mesh.unbind();
+}
+
+void CascadedShadowMap::readTimerQueries() {
+    const int previous = m_queryFrame ^ 1;
+    for (int i = 0; i < m_settings.cascadeCount; ++i) {
+        Cascade& cascade = m_cascades[i];
+        if (!cascade.queryPending[previous]) continue;
+        
+        GLint available = 0;
+        glGetQueryObjectiv(cascade.timerQueries[previous], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) continue;
+        
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(cascade.timerQueries[previous], GL_QUERY_RESULT, &elapsed);
+        cascade.stats.gpuTimeMs = static_cast<float>(elapsed) / 1.0e6f;
+        cascade.queryPending[previous] = false;
+    }
+}
+
+void CascadedShadowMap::render(const std::vector<ShadowCaster>& casters, const Mesh& mesh) {
+    readTimerQueries();
+    
+    const int resolution = m_settings.resolution;
+    
+    glViewport(0, 0, resolution, resolution);
+    glEnable(GL_POLYGON_OFFSET_FILL);
+    glPolygonOffset(2.0f, 4.0f);
+    glCullFace(GL_FRONT);
+    
+    m_depthShader->bind();
+    
+    for (int i = 0; i < m_settings.cascadeCount; ++i) {
+        Cascade& cascade = m_cascades[i];
+        RC_PROFILE_SCOPE(s_cascadeZoneNames[i]);
+        RC_PROFILE_GPU_SCOPE(s_cascadeZoneNames[i]);
+        auto cpuStart = std::chrono::high_resolution_clock::now();
+        
+        if (!cascade.queryPending[m_queryFrame]) {
+            glBeginQuery(GL_TIME_ELAPSED, cascade.timerQueries[m_queryFrame]);
+        }
+        
+        uint32_t staticDrawn = 0;
+        uint32_t dynamicDrawn = 0;
+        cascade.stats.staticRefreshed = false;
+        
+        if (cascade.cached) {
+            if (cascade.staticDirty) {
+                glBindFramebuffer(GL_FRAMEBUFFER, cascade.staticFramebuffer);
+                glClear(GL_DEPTH_BUFFER_BIT);
+                drawCasters(cascade, casters, mesh, true, false, staticDrawn);
+                cascade.staticDirty = false;
+                cascade.stats.staticRefreshed = true;
+                cascade.stats.staticCasterCount = staticDrawn;
+            }
+            
+            glCopyImageSubData(m_staticDepthArray, GL_TEXTURE_2D_ARRAY, 0, 0, 0, i,
+                               m_depthArray, GL_TEXTURE_2D_ARRAY, 0, 0, 0, i,
+                               resolution, resolution, 1);
+            
+            glBindFramebuffer(GL_FRAMEBUFFER, cascade.liveFramebuffer);
+            drawCasters(cascade, casters, mesh, false, true, dynamicDrawn);
+            cascade.stats.casterCount = cascade.stats.staticCasterCount + dynamicDrawn;
+        } else {
+            glBindFramebuffer(GL_FRAMEBUFFER, cascade.liveFramebuffer);
+            glClear(GL_DEPTH_BUFFER_BIT);
+            drawCasters(cascade, casters, mesh, true, true, dynamicDrawn);
+            cascade.stats.casterCount = dynamicDrawn;
+            cascade.stats.staticCasterCount = 0;
+        }
+        
+        if (!cascade.queryPending[m_queryFrame]) {
+            glEndQuery(GL_TIME_ELAPSED);
+            cascade.queryPending[m_queryFrame] = true;
+        }
+        
+        auto cpuEnd = std::chrono::high_resolution_clock::now();
+        cascade.stats.cpuTimeMs = std::chrono::duration<float, std::milli>(cpuEnd - cpuStart).count();
+    }
+    
+    m_depthShader->unbind();
+    
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glCullFace(GL_BACK);
+    glDisable(GL_POLYGON_OFFSET_FILL);
+    
+    m_queryFrame ^= 1;
+}
+
+void CascadedShadowMap::bind(Shader& shader, GLuint textureUnit) const {
+    glActiveTexture(GL_TEXTURE0 + textureUnit);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_depthArray);
+    glActiveTexture(GL_TEXTURE0);
+    
+    shader.setInt("shadowMap", static_cast<int>(textureUnit));
+    shader.setInt("cascadeCount", m_settings.cascadeCount);
+    for (int i = 0; i < m_settings.cascadeCount; ++i) {
+        const std::string index = "[" + std::to_string(i) + "]";
+        shader.setMat4("lightSpaceMatrices" + index, m_cascades[i].viewProjection);
+        shader.setFloat("cascadeSplits" + index, m_cascades[i].splitFar);
+    }
+}
+
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "RenderBackend.hpp"
+#include "Shader.hpp"
+#include "Mesh.hpp"
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace roblox_clone::renderer {
+
+struct ShadowSettings {
+    int cascadeCount = 4;
+    int resolution = 2048;
+    float maxDistance = 250.0f;
+    float splitLambda = 0.75f;
+    float casterExtent = 200.0f;
+    // Cascades from this index on keep static casters in a cached layer that is
+    // only redrawn when the light, the static geometry or the cascade fit changes.
+    int firstCachedCascade = 2;
+    float cachedRadiusScale = 1.5f;
+};
+
+struct ShadowCascadeStats {
+    float splitFar = 0.0f;
+    uint32_t casterCount = 0;
+    uint32_t staticCasterCount = 0;
+    bool cached = false;
+    bool staticRefreshed = false;
+    float cpuTimeMs = 0.0f;
+    float gpuTimeMs = 0.0f;
+};
+
+class CascadedShadowMap {
+public:
+    static constexpr int MaxCascades = 4;
+    
+    CascadedShadowMap() = default;
+    ~CascadedShadowMap();
+    
+    CascadedShadowMap(const CascadedShadowMap&) = delete;
+    CascadedShadowMap& operator=(const CascadedShadowMap&) = delete;
+    
+    bool initialize(const ShadowSettings& settings);
+    void shutdown();
+    
+    void update(const glm::mat4& cameraView, float fov, float aspectRatio, float nearPlane,
+                const glm::vec3& lightDirection, uint64_t staticGeometryVersion);
+    void render(const std::vector<ShadowCaster>& casters, const Mesh& mesh);
+    void bind(Shader& shader, GLuint textureUnit) const;
+    
+    void invalidateStaticCache();
+    
+    int getCascadeCount() const { return m_settings.cascadeCount; }
+    const ShadowCascadeStats& getCascadeStats(int cascade) const { return m_cascades[cascade].stats; }
+    const ShadowSettings& getSettings() const { return m_settings; }
+
+private:
+    struct Cascade {
+        glm::mat4 viewProjection = glm::mat4(1.0f);
+        glm::vec3 center = glm::vec3(0.0f);
+        float radius = 0.0f;
+        float splitNear = 0.0f;
+        float splitFar = 0.0f;
+        bool cached = false;
+        bool staticDirty = true;
+        GLuint liveFramebuffer = 0;
+        GLuint staticFramebuffer = 0;
+        GLuint timerQueries[2] = { 0, 0 };
+        bool queryPending[2] = { false, false };
+        ShadowCascadeStats stats;
+    };
+    
+    bool createTargets();
+    void fitCascade(Cascade& cascade, const glm::mat4& inverseView, float fov, float aspectRatio);
+    void buildCascadeMatrix(Cascade& cascade) const;
+    bool overlapsCascade(const Cascade& cascade, const ShadowCaster& caster) const;
+    void drawCasters(const Cascade& cascade, const std::vector<ShadowCaster>& casters, const Mesh& mesh,
+                     bool drawStatic, bool drawDynamic, uint32_t& drawn);
+    void readTimerQueries();
+    
+    ShadowSettings m_settings;
+    std::array<Cascade, MaxCascades> m_cascades;
+    std::unique_ptr<Shader> m_depthShader;
+    
+    GLuint m_depthArray = 0;
+    GLuint m_staticDepthArray = 0;
+    
+    glm::vec3 m_lightDirection = glm::vec3(0.0f, -1.0f, 0.0f);
+    uint64_t m_staticGeometryVersion = ~uint64_t(0);
+    int m_queryFrame = 0;
+};
+
+}
@@ -0,0 +1,41 @@
+#include "DynamicResolution.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace roblox_clone::renderer {
+
+void DynamicResolution::setSettings(const DynamicResolutionSettings& settings) {
+    m_settings = settings;
+    m_scale = std::clamp(m_scale, m_settings.minScale, m_settings.maxScale);
+}
+
+void DynamicResolution::reset() {
+    m_scale = m_settings.maxScale;
+    m_smoothedGpuTimeMs = 0.0f;
+}
+
+void DynamicResolution::update(float gpuFrameTimeMs) {
+    if (!m_settings.enabled || gpuFrameTimeMs <= 0.0f) return;
+    
+    if (m_smoothedGpuTimeMs <= 0.0f) {
+        m_smoothedGpuTimeMs = gpuFrameTimeMs;
+    } else {
+        m_smoothedGpuTimeMs += (gpuFrameTimeMs - m_smoothedGpuTimeMs) * m_settings.smoothing;
+    }
+    
+    float budget = m_settings.targetFrameTimeMs * m_settings.headroom;
+    float ratio = budget / m_smoothedGpuTimeMs;
+    if (std::abs(ratio - 1.0f) < m_settings.deadband) return;
+    
+    // GPU cost is roughly proportional to pixel count, so the linear scale
+    // follows the square root of the time ratio.
+    float desired = m_scale * std::sqrt(ratio);
+    float step = std::clamp(desired - m_scale, -m_settings.maxStepPerFrame, m_settings.maxStepPerFrame);
+    m_scale = std::clamp(m_scale + step, m_settings.minScale, m_settings.maxScale);
+}
+
+int DynamicResolution::scaledSize(int nativeSize) const {
+    return std::max(1, static_cast<int>(std::lround(static_cast<float>(nativeSize) * getScale())));
+}
+
+}
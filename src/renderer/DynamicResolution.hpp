@@ -0,0 +1,39 @@
+#pragma once
+
+namespace roblox_clone::renderer {
+
+struct DynamicResolutionSettings {
+    bool enabled = true;
+    float targetFrameTimeMs = 1000.0f / 60.0f;
+    float headroom = 0.9f;
+    float minScale = 0.5f;
+    float maxScale = 1.0f;
+    float maxStepPerFrame = 0.05f;
+    float deadband = 0.05f;
+    float smoothing = 0.2f;
+    float sharpness = 0.4f;
+};
+
+class DynamicResolution {
+public:
+    DynamicResolution() = default;
+    
+    void setSettings(const DynamicResolutionSettings& settings);
+    const DynamicResolutionSettings& getSettings() const { return m_settings; }
+    
+    void update(float gpuFrameTimeMs);
+    void reset();
+    
+    bool isEnabled() const { return m_settings.enabled; }
+    float getScale() const { return m_settings.enabled ? m_scale : 1.0f; }
+    float getSmoothedGpuTimeMs() const { return m_smoothedGpuTimeMs; }
+    
+    int scaledSize(int nativeSize) const;
+
+private:
+    DynamicResolutionSettings m_settings;
+    float m_scale = 1.0f;
+    float m_smoothedGpuTimeMs = 0.0f;
+};
+
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <GL/glew.h>
+
+namespace roblox_clone::renderer {
+
+class Framebuffer {
+public:
+    Framebuffer() = default;
+    ~Framebuffer();
+    
+    Framebuffer(const Framebuffer&) = delete;
+    Framebuffer& operator=(const Framebuffer&) = delete;
+    
+    bool create(int width, int height);
+    void destroy();
+    bool resize(int width, int height);
+    
+    void bind() const;
+    void unbind() const;
+    
+    GLuint getHandle() const { return m_framebuffer; }
+    GLuint getColorTexture() const { return m_colorTexture; }
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+    bool isValid() const { return m_framebuffer != 0; }
+
+private:
+    GLuint m_framebuffer = 0;
+    GLuint m_colorTexture = 0;
+    GLuint m_depthRenderbuffer = 0;
+    int m_width = 0;
+    int m_height = 0;
+};
+
+}
@@ -0,0 +1,328 @@
+#include "GLRenderBackend.hpp"
+#include "core/Logger.hpp"
+
+namespace roblox_clone::renderer {
+
+GLRenderBackend::~GLRenderBackend() {
+    shutdown();
+}
+
+bool GLRenderBackend::initialize(int width, int height) {
+    m_width = width;
+    m_height = height;
+    
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_CULL_FACE);
+    glCullFace(GL_BACK);
+    glClearColor(0.1f, 0.1f, 0.2f, 1.0f);
+    
+    if (!loadDefaultShaders()) {
+        RC_ERROR("Failed to load default shaders");
+        return false;
+    }
+    
+    m_testCube = std::make_unique<Mesh>();
+    m_testCube->createCube(1.0f);
+    
+    m_shadowMap = std::make_unique<CascadedShadowMap>();
+    if (!m_shadowMap->initialize(ShadowSettings())) {
+        RC_WARN("Failed to initialize shadow map, shadows disabled");
+        m_shadowMap.reset();
+    }
+    
+    m_sceneTarget = std::make_unique<Framebuffer>();
+    if (!loadUpscaleShader() || !m_sceneTarget->create(width, height)) {
+        RC_WARN("Failed to create scene target, dynamic resolution disabled");
+        m_sceneTarget.reset();
+    }
+    glGenVertexArrays(1, &m_fullscreenVao);
+    
+    m_frameTimer = std::make_unique<GpuTimer>();
+    m_gpuProfiler = std::make_unique<GpuProfiler>();
+    
+    return true;
+}
+
+void GLRenderBackend::shutdown() {
+    if (m_fullscreenVao) {
+        glDeleteVertexArrays(1, &m_fullscreenVao);
+        m_fullscreenVao = 0;
+    }
+    m_gpuProfiler.reset();
+    m_frameTimer.reset();
+    m_sceneTarget.reset();
+    m_shadowMap.reset();
+    m_testCube.reset();
+    m_upscaleShader.reset();
+    m_basicShader.reset();
+}
+
+void GLRenderBackend::beginFrame() {
+    if (m_gpuProfiler) {
+        m_gpuProfiler->beginFrame();
+    }
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+void GLRenderBackend::endFrame() {
+    if (m_gpuProfiler) {
+        m_gpuProfiler->endFrame();
+    }
+}
+
+void GLRenderBackend::submit(const RenderFrame& frame) {
+    RC_PROFILE_SCOPE("GLRenderBackend::submit");
+    recordFrameStats(frame);
+    
+    float gpuFrameTimeMs = 0.0f;
+    if (m_frameTimer->poll(gpuFrameTimeMs)) {
+        m_dynamicResolution.update(gpuFrameTimeMs);
+    }
+    m_frameTimer->begin();
+    
+    bool shadowsActive = frame.shadowsEnabled && m_shadowMap && frame.shadowCasters;
+    if (shadowsActive) {
+        RC_PROFILE_SCOPE("Shadows");
+        RC_PROFILE_GPU_SCOPE("Shadows");
+        m_shadowMap->update(frame.view, frame.fov, frame.aspectRatio, frame.nearPlane,
+                            frame.sun.direction, frame.staticGeometryVersion);
+        m_shadowMap->render(*frame.shadowCasters, *m_testCube);
+    }
+    
+    drawScene(frame, shadowsActive);
+    
+    if (m_sceneTarget && m_dynamicResolution.isEnabled()) {
+        RC_PROFILE_SCOPE("Composite");
+        RC_PROFILE_GPU_SCOPE("Composite");
+        compositeScene();
+    }
+    
+    m_frameTimer->end();
+}
+
+void GLRenderBackend::drawScene(const RenderFrame& frame, bool shadowsActive) {
+    RC_PROFILE_SCOPE("Scene");
+    RC_PROFILE_GPU_SCOPE("Scene");
+    
+    bool scaled = m_sceneTarget && m_dynamicResolution.isEnabled();
+    if (scaled) {
+        m_sceneWidth = m_dynamicResolution.scaledSize(m_width);
+        m_sceneHeight = m_dynamicResolution.scaledSize(m_height);
+        m_sceneTarget->bind();
+        glViewport(0, 0, m_sceneWidth, m_sceneHeight);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    } else {
+        m_sceneWidth = m_width;
+        m_sceneHeight = m_height;
+        glViewport(0, 0, m_width, m_height);
+    }
+    
+    m_basicShader->bind();
+    m_basicShader->setMat4("projection", frame.projection);
+    m_basicShader->setMat4("view", frame.view);
+    m_basicShader->setVec3("sunDirection", glm::normalize(frame.sun.direction));
+    m_basicShader->setVec3("lightColor", frame.sun.color);
+    m_basicShader->setFloat("ambientStrength", frame.sun.ambientStrength);
+    
+    if (shadowsActive) {
+        m_shadowMap->bind(*m_basicShader, 1);
+    } else {
+        m_basicShader->setInt("cascadeCount", 0);
+    }
+    
+    if (frame.packets) {
+        for (const auto& packet : *frame.packets) {
+            m_basicShader->setInt("receiveShadows", packet.receiveShadows ? 1 : 0);
+            m_basicShader->setMat4("model", packet.model);
+            m_testCube->draw();
+        }
+    }
+    
+    m_basicShader->unbind();
+}
+
+void GLRenderBackend::compositeScene() {
+    m_sceneTarget->unbind();
+    glViewport(0, 0, m_width, m_height);
+    glDisable(GL_DEPTH_TEST);
+    
+    m_upscaleShader->bind();
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, m_sceneTarget->getColorTexture());
+    m_upscaleShader->setInt("sceneColor", 0);
+    m_upscaleShader->setVec2("uvScale", glm::vec2(
+        static_cast<float>(m_sceneWidth) / static_cast<float>(m_sceneTarget->getWidth()),
+        static_cast<float>(m_sceneHeight) / static_cast<float>(m_sceneTarget->getHeight())));
+    m_upscaleShader->setVec2("texelSize", glm::vec2(
+        1.0f / static_cast<float>(m_sceneTarget->getWidth()),
+        1.0f / static_cast<float>(m_sceneTarget->getHeight())));
+    m_upscaleShader->setFloat("sharpness",
+                              m_dynamicResolution.getScale() < 1.0f ? m_dynamicResolution.getSettings().sharpness : 0.0f);
+    
+    glBindVertexArray(m_fullscreenVao);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+    
+    glBindTexture(GL_TEXTURE_2D, 0);
+    m_upscaleShader->unbind();
+    glEnable(GL_DEPTH_TEST);
+}
+
+void GLRenderBackend::resize(int width, int height) {
+    m_width = width;
+    m_height = height;
+    glViewport(0, 0, width, height);
+    
+    if (m_sceneTarget && !m_sceneTarget->resize(width, height)) {
+        RC_WARN("Failed to resize scene target, dynamic resolution disabled");
+        m_sceneTarget.reset();
+    }
+}
+
+bool GLRenderBackend::loadUpscaleShader() {
+    m_upscaleShader = std::make_unique<Shader>();
+    
+    if (!m_upscaleShader->loadFromFiles("assets/shaders/upscale.vert", "assets/shaders/upscale.frag")) {
+        static const char* vertexSource = R"(
+            #version 450 core
+            out vec2 TexCoords;
+            
+            void main() {
+                vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+                TexCoords = position;
+                gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+            }
+        )";
+        
+        static const char* fragmentSource = R"(
+            #version 450 core
+            in vec2 TexCoords;
+            
+            out vec4 FragColor;
+            
+            uniform sampler2D sceneColor;
+            uniform vec2 uvScale = vec2(1.0);
+            uniform vec2 texelSize;
+            uniform float sharpness = 0.4;
+            
+            void main() {
+                vec2 uvMax = uvScale - texelSize * 0.5;
+                vec2 uv = min(TexCoords * uvScale, uvMax);
+                
+                vec3 center = texture(sceneColor, uv).rgb;
+                vec3 north = texture(sceneColor, min(uv + vec2(0.0, texelSize.y), uvMax)).rgb;
+                vec3 south = texture(sceneColor, max(uv - vec2(0.0, texelSize.y), vec2(0.0))).rgb;
+                vec3 east = texture(sceneColor, min(uv + vec2(texelSize.x, 0.0), uvMax)).rgb;
+                vec3 west = texture(sceneColor, max(uv - vec2(texelSize.x, 0.0), vec2(0.0))).rgb;
+                
+                vec3 minColor = min(center, min(min(north, south), min(east, west)));
+                vec3 maxColor = max(center, max(max(north, south), max(east, west)));
+                
+                vec3 sharpened = center + (4.0 * center - north - south - east - west) * sharpness * 0.25;
+                FragColor = vec4(clamp(sharpened, minColor, maxColor), 1.0);
+            }
+        )";
+        
+        return m_upscaleShader->loadFromSource(vertexSource, fragmentSource);
+    }
+    
+    return true;
+}
+
+bool GLRenderBackend::loadDefaultShaders() {
+    m_basicShader = std::make_unique<Shader>();
+    
+    if (!m_basicShader->loadFromFiles("assets/shaders/basic.vert", "assets/shaders/basic.frag")) {
+        static const char* vertexSource = R"(
+            #version 450 core
+            layout(location = 0) in vec3 aPosition;
+            layout(location = 1) in vec3 aNormal;
+            layout(location = 2) in vec2 aTexCoords;
+            
+            uniform mat4 model;
+            uniform mat4 view;
+            uniform mat4 projection;
+            
+            out vec3 FragPos;
+            out vec3 Normal;
+            out float ViewDepth;
+            
+            void main() {
+                FragPos = vec3(model * vec4(aPosition, 1.0));
+                Normal = mat3(transpose(inverse(model))) * aNormal;
+                vec4 viewPos = view * vec4(FragPos, 1.0);
+                ViewDepth = -viewPos.z;
+                gl_Position = projection * viewPos;
+            }
+        )";
+        
+        static const char* fragmentSource = R"(
+            #version 450 core
+            in vec3 FragPos;
+            in vec3 Normal;
+            in float ViewDepth;
+            
+            out vec4 FragColor;
+            
+            uniform vec3 sunDirection = vec3(0.0, -1.0, 0.0);
+            uniform vec3 lightColor = vec3(1.0, 1.0, 1.0);
+            uniform vec3 objectColor = vec3(0.8, 0.4, 0.2);
+            uniform float ambientStrength = 0.3;
+            
+            uniform sampler2DArrayShadow shadowMap;
+            uniform mat4 lightSpaceMatrices[4];
+            uniform float cascadeSplits[4];
+            uniform int cascadeCount = 0;
+            uniform int receiveShadows = 1;
+            
+            float computeShadow(vec3 norm, vec3 lightDir) {
+                if (receiveShadows == 0 || cascadeCount == 0 || ViewDepth > cascadeSplits[cascadeCount - 1]) {
+                    return 0.0;
+                }
+                
+                int cascade = cascadeCount - 1;
+                for (int i = 0; i < cascadeCount; ++i) {
+                    if (ViewDepth < cascadeSplits[i]) {
+                        cascade = i;
+                        break;
+                    }
+                }
+                
+                float normalBias = 0.02 * (1.0 - dot(norm, lightDir)) * float(cascade + 1);
+                vec4 lightSpace = lightSpaceMatrices[cascade] * vec4(FragPos + norm * normalBias, 1.0);
+                vec3 coords = lightSpace.xyz / lightSpace.w * 0.5 + 0.5;
+                if (coords.z > 1.0) {
+                    return 0.0;
+                }
+                
+                vec2 texelSize = 1.0 / vec2(textureSize(shadowMap, 0).xy);
+                float lit = 0.0;
+                for (int x = -1; x <= 1; ++x) {
+                    for (int y = -1; y <= 1; ++y) {
+                        lit += texture(shadowMap, vec4(coords.xy + vec2(x, y) * texelSize, float(cascade), coords.z));
+                    }
+                }
+                return 1.0 - lit / 9.0;
+            }
+            
+            void main() {
+                vec3 norm = normalize(Normal);
+                vec3 lightDir = normalize(-sunDirection);
+                
+                vec3 ambient = ambientStrength * lightColor;
+                
+                float diff = max(dot(norm, lightDir), 0.0);
+                vec3 diffuse = diff * lightColor * (1.0 - computeShadow(norm, lightDir));
+                
+                vec3 result = (ambient + diffuse) * objectColor;
+                FragColor = vec4(result, 1.0);
+            }
+        )";
+        
+        return m_basicShader->loadFromSource(vertexSource, fragmentSource);
+    }
+    
+    return true;
+}
+
+}
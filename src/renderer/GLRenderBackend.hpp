@@ -0,0 +1,60 @@
+#pragma once
+
+#include "RenderBackend.hpp"
+#include "Shader.hpp"
+#include "Mesh.hpp"
+#include "CascadedShadowMap.hpp"
+#include "DynamicResolution.hpp"
+#include "Framebuffer.hpp"
+#include "GpuTimer.hpp"
+#include "GpuProfiler.hpp"
+#include <memory>
+
+namespace roblox_clone::renderer {
+
+class GLRenderBackend : public RenderBackend {
+public:
+    GLRenderBackend() = default;
+    ~GLRenderBackend() override;
+    
+    bool initialize(int width, int height) override;
+    void shutdown() override;
+    
+    void beginFrame() override;
+    void submit(const RenderFrame& frame) override;
+    void endFrame() override;
+    
+    void resize(int width, int height) override;
+    
+    bool isHeadless() const override { return false; }
+    const CascadedShadowMap* getShadowMap() const override { return m_shadowMap.get(); }
+    DynamicResolution* getDynamicResolution() override { return &m_dynamicResolution; }
+    
+    float getGpuFrameTimeMs() const { return m_frameTimer ? m_frameTimer->getLastElapsedMs() : 0.0f; }
+    int getSceneWidth() const { return m_sceneWidth; }
+    int getSceneHeight() const { return m_sceneHeight; }
+
+private:
+    bool loadDefaultShaders();
+    bool loadUpscaleShader();
+    void drawScene(const RenderFrame& frame, bool shadowsActive);
+    void compositeScene();
+    
+    std::unique_ptr<Shader> m_basicShader;
+    std::unique_ptr<Shader> m_upscaleShader;
+    std::unique_ptr<Mesh> m_testCube;
+    std::unique_ptr<CascadedShadowMap> m_shadowMap;
+    
+    DynamicResolution m_dynamicResolution;
+    std::unique_ptr<Framebuffer> m_sceneTarget;
+    std::unique_ptr<GpuTimer> m_frameTimer;
+    std::unique_ptr<GpuProfiler> m_gpuProfiler;
+    GLuint m_fullscreenVao = 0;
+    int m_sceneWidth = 0;
+    int m_sceneHeight = 0;
+    
+    int m_width = 1280;
+    int m_height = 720;
+};
+
+}
@@ -0,0 +1,110 @@
+#include "GpuProfiler.hpp"
+
+namespace roblox_clone::renderer {
+
+GpuProfiler* GpuProfiler::s_active = nullptr;
+
+GpuProfiler::GpuProfiler() {
+    for (auto& frame : m_frames) {
+        glGenQueries(MaxZones * 2, frame.queries.data());
+    }
+    m_track = core::Profiler::get().createTrack("GPU");
+    s_active = this;
+}
+
+GpuProfiler::~GpuProfiler() {
+    if (s_active == this) {
+        s_active = nullptr;
+    }
+    for (auto& frame : m_frames) {
+        glDeleteQueries(MaxZones * 2, frame.queries.data());
+    }
+}
+
+void GpuProfiler::beginFrame() {
+    for (int i = 1; i < Latency; ++i) {
+        Frame& frame = m_frames[(m_frameIndex + i) % Latency];
+        if (frame.pending) {
+            collect(frame);
+        }
+    }
+    
+    Frame& current = m_frames[m_frameIndex];
+    if (current.pending && !collect(current)) {
+        current.pending = false;
+        ++m_droppedFrames;
+    }
+    
+    current.zoneCount = 0;
+    m_depth = 0;
+    m_recording = core::Profiler::get().isEnabled();
+    if (m_recording) {
+        calibrate();
+    }
+}
+
+void GpuProfiler::endFrame() {
+    if (!m_recording) return;
+    
+    Frame& frame = m_frames[m_frameIndex];
+    frame.pending = frame.zoneCount > 0;
+    m_frameIndex = (m_frameIndex + 1) % Latency;
+    m_recording = false;
+}
+
+int GpuProfiler::beginZone(const char* name) {
+    if (!m_recording) return -1;
+    
+    Frame& frame = m_frames[m_frameIndex];
+    if (frame.zoneCount >= MaxZones) return -1;
+    
+    int zone = frame.zoneCount++;
+    frame.zones[zone].name = name;
+    frame.zones[zone].depth = m_depth++;
+    glQueryCounter(frame.queries[zone * 2], GL_TIMESTAMP);
+    return zone;
+}
+
+void GpuProfiler::endZone(int zone) {
+    if (!m_recording || zone < 0) return;
+    
+    glQueryCounter(m_frames[m_frameIndex].queries[zone * 2 + 1], GL_TIMESTAMP);
+    --m_depth;
+}
+
+bool GpuProfiler::collect(Frame& frame) {
+    // The last zone's end is not the last query issued once zones nest, and
+    // results need not arrive in issue order, so a frame is read only once
+    // every one of its queries is available.
+    for (int i = 0; i < frame.zoneCount * 2; ++i) {
+        GLint available = 0;
+        glGetQueryObjectiv(frame.queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) return false;
+    }
+    
+    for (int i = 0; i < frame.zoneCount; ++i) {
+        GLuint64 start = 0;
+        GLuint64 end = 0;
+        glGetQueryObjectui64v(frame.queries[i * 2], GL_QUERY_RESULT, &start);
+        glGetQueryObjectui64v(frame.queries[i * 2 + 1], GL_QUERY_RESULT, &end);
+        
+        core::ProfileEvent event;
+        event.name = frame.zones[i].name;
+        event.startNs = static_cast<uint64_t>(static_cast<int64_t>(start) + m_clockOffsetNs);
+        event.endNs = static_cast<uint64_t>(static_cast<int64_t>(end) + m_clockOffsetNs);
+        event.depth = frame.zones[i].depth;
+        event.track = m_track->getIndex();
+        m_track->push(event);
+    }
+    
+    frame.pending = false;
+    return true;
+}
+
+void GpuProfiler::calibrate() {
+    GLint64 gpuNow = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+    m_clockOffsetNs = static_cast<int64_t>(core::Profiler::now()) - static_cast<int64_t>(gpuNow);
+}
+
+}
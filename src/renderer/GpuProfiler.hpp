@@ -0,0 +1,85 @@
+#pragma once
+
+#include "core/Profiler.hpp"
+#include <GL/glew.h>
+#include <array>
+#include <cstdint>
+
+namespace roblox_clone::renderer {
+
+// Records nested GPU zones with GL_TIMESTAMP queries and forwards them to the
+// core profiler on a "GPU" track once the results are available, a few frames
+// later, so reading them back never stalls the pipeline.
+class GpuProfiler {
+public:
+    static constexpr int Latency = 4;
+    static constexpr int MaxZones = 64;
+    
+    GpuProfiler();
+    ~GpuProfiler();
+    
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+    
+    void beginFrame();
+    void endFrame();
+    
+    int beginZone(const char* name);
+    void endZone(int zone);
+    
+    uint64_t getDroppedFrames() const { return m_droppedFrames; }
+    
+    static GpuProfiler* getActive() { return s_active; }
+
+private:
+    struct Zone {
+        const char* name = nullptr;
+        uint16_t depth = 0;
+    };
+    
+    struct Frame {
+        std::array<GLuint, MaxZones * 2> queries{};
+        std::array<Zone, MaxZones> zones{};
+        int zoneCount = 0;
+        bool pending = false;
+    };
+    
+    bool collect(Frame& frame);
+    void calibrate();
+    
+    std::array<Frame, Latency> m_frames;
+    int m_frameIndex = 0;
+    bool m_recording = false;
+    uint16_t m_depth = 0;
+    int64_t m_clockOffsetNs = 0;
+    uint64_t m_droppedFrames = 0;
+    core::ProfileTrack* m_track = nullptr;
+    
+    static GpuProfiler* s_active;
+};
+
+class GpuProfileScope {
+public:
+    explicit GpuProfileScope(const char* name)
+        : m_profiler(GpuProfiler::getActive())
+        , m_zone(m_profiler ? m_profiler->beginZone(name) : -1) {}
+    
+    ~GpuProfileScope() {
+        if (m_zone >= 0) m_profiler->endZone(m_zone);
+    }
+    
+    GpuProfileScope(const GpuProfileScope&) = delete;
+    GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+private:
+    GpuProfiler* m_profiler;
+    int m_zone;
+};
+
+}
+
+#if ROBLOX_CLONE_PROFILING
+#define RC_PROFILE_GPU_SCOPE(name) ::roblox_clone::renderer::GpuProfileScope RC_PROFILE_CONCAT(rcGpuProfileScope, __LINE__)(name)
+#else
+#define RC_PROFILE_GPU_SCOPE(name)
+#endif
@@ -0,0 +1,49 @@
+#include "GpuTimer.hpp"
+
+namespace roblox_clone::renderer {
+
+GpuTimer::GpuTimer() {
+    glGenQueries(Latency * 2, m_queries.data());
+}
+
+GpuTimer::~GpuTimer() {
+    glDeleteQueries(Latency * 2, m_queries.data());
+}
+
+void GpuTimer::begin() {
+    if (m_pending[m_writeIndex]) return;
+    
+    glQueryCounter(m_queries[m_writeIndex * 2], GL_TIMESTAMP);
+    m_active = true;
+}
+
+void GpuTimer::end() {
+    if (!m_active) return;
+    
+    glQueryCounter(m_queries[m_writeIndex * 2 + 1], GL_TIMESTAMP);
+    m_active = false;
+    m_pending[m_writeIndex] = true;
+    m_writeIndex = (m_writeIndex + 1) % Latency;
+}
+
+bool GpuTimer::poll(float& elapsedMs) {
+    if (!m_pending[m_readIndex]) return false;
+    
+    GLint available = 0;
+    glGetQueryObjectiv(m_queries[m_readIndex * 2 + 1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) return false;
+    
+    GLuint64 start = 0;
+    GLuint64 end = 0;
+    glGetQueryObjectui64v(m_queries[m_readIndex * 2], GL_QUERY_RESULT, &start);
+    glGetQueryObjectui64v(m_queries[m_readIndex * 2 + 1], GL_QUERY_RESULT, &end);
+    GLuint64 elapsed = end > start ? end - start : 0;
+    m_pending[m_readIndex] = false;
+    m_readIndex = (m_readIndex + 1) % Latency;
+    
+    m_lastElapsedMs = static_cast<float>(elapsed) / 1.0e6f;
+    elapsedMs = m_lastElapsedMs;
+    return true;
+}
+
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <array>
+
+namespace roblox_clone::renderer {
+
+// Brackets work with a pair of GL_TIMESTAMP queries rather than
+// GL_TIME_ELAPSED so it can enclose passes that run their own timers.
+class GpuTimer {
+public:
+    static constexpr int Latency = 3;
+    
+    GpuTimer();
+    ~GpuTimer();
+    
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+    
+    void begin();
+    void end();
+    
+    bool poll(float& elapsedMs);
+    float getLastElapsedMs() const { return m_lastElapsedMs; }
+
+private:
+    std::array<GLuint, Latency * 2> m_queries{};
+    std::array<bool, Latency> m_pending{};
+    int m_writeIndex = 0;
+    int m_readIndex = 0;
+    bool m_active = false;
+    float m_lastElapsedMs = 0.0f;
+};
+
+}
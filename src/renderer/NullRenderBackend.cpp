@@ -0,0 +1,51 @@
+#include "NullRenderBackend.hpp"
+#include "core/Logger.hpp"
+#include <cstring>
+
+namespace roblox_clone::renderer {
+
+bool NullRenderBackend::initialize(int width, int height) {
+    m_width = width;
+    m_height = height;
+    RC_INFO("Null render backend initialized ({}x{})", width, height);
+    return true;
+}
+
+void NullRenderBackend::shutdown() {
+    m_recordedPackets.clear();
+    m_recordedPackets.shrink_to_fit();
+}
+
+void NullRenderBackend::beginFrame() {
+    if (m_recording) {
+        m_recordedPackets.clear();
+    }
+}
+
+void NullRenderBackend::submit(const RenderFrame& frame) {
+    recordFrameStats(frame);
+    
+    if (!frame.packets) return;
+    
+    // Fold every packet into a checksum so the packet build cannot be optimized away
+    // and benchmark runs can be compared against each other.
+    for (const auto& packet : *frame.packets) {
+        uint32_t bits;
+        std::memcpy(&bits, &packet.model[3][0], sizeof(bits));
+        m_checksum = (m_checksum ^ (bits + packet.entity)) * 0x100000001b3ull;
+    }
+    
+    if (m_recording) {
+        m_recordedPackets.insert(m_recordedPackets.end(), frame.packets->begin(), frame.packets->end());
+    }
+}
+
+void NullRenderBackend::endFrame() {
+}
+
+void NullRenderBackend::resize(int width, int height) {
+    m_width = width;
+    m_height = height;
+}
+
+}
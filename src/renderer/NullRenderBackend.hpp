@@ -0,0 +1,36 @@
+#pragma once
+
+#include "RenderBackend.hpp"
+#include <vector>
+
+namespace roblox_clone::renderer {
+
+class NullRenderBackend : public RenderBackend {
+public:
+    NullRenderBackend() = default;
+    ~NullRenderBackend() override = default;
+    
+    bool initialize(int width, int height) override;
+    void shutdown() override;
+    
+    void beginFrame() override;
+    void submit(const RenderFrame& frame) override;
+    void endFrame() override;
+    
+    void resize(int width, int height) override;
+    
+    bool isHeadless() const override { return true; }
+    
+    void setRecording(bool recording) { m_recording = recording; }
+    const std::vector<DrawPacket>& getRecordedPackets() const { return m_recordedPackets; }
+    uint64_t getChecksum() const { return m_checksum; }
+
+private:
+    std::vector<DrawPacket> m_recordedPackets;
+    bool m_recording = false;
+    uint64_t m_checksum = 0;
+    int m_width = 0;
+    int m_height = 0;
+};
+
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace roblox_clone::renderer {
+
+class CascadedShadowMap;
+class DynamicResolution;
+
+struct DirectionalLight {
+    glm::vec3 direction = glm::normalize(glm::vec3(-0.4f, -1.0f, -0.3f));
+    glm::vec3 color = glm::vec3(1.0f);
+    float ambientStrength = 0.3f;
+};
+
+struct DrawPacket {
+    glm::mat4 model = glm::mat4(1.0f);
+    uint32_t entity = 0;
+    bool receiveShadows = true;
+};
+
+struct ShadowCaster {
+    glm::mat4 model = glm::mat4(1.0f);
+    glm::vec3 boundsMin = glm::vec3(0.0f);
+    glm::vec3 boundsMax = glm::vec3(0.0f);
+    bool isStatic = false;
+};
+
+struct RenderFrame {
+    glm::mat4 view = glm::mat4(1.0f);
+    glm::mat4 projection = glm::mat4(1.0f);
+    float fov = 60.0f;
+    float aspectRatio = 1.0f;
+    float nearPlane = 0.1f;
+    DirectionalLight sun;
+    bool shadowsEnabled = true;
+    uint64_t staticGeometryVersion = 0;
+    const std::vector<DrawPacket>* packets = nullptr;
+    const std::vector<ShadowCaster>* shadowCasters = nullptr;
+};
+
+struct RenderStats {
+    uint64_t frameCount = 0;
+    uint64_t packetCount = 0;
+    uint64_t shadowCasterCount = 0;
+    uint32_t lastFramePackets = 0;
+    uint32_t lastFrameShadowCasters = 0;
+};
+
+class RenderBackend {
+public:
+    virtual ~RenderBackend() = default;
+    
+    virtual bool initialize(int width, int height) = 0;
+    virtual void shutdown() = 0;
+    
+    virtual void beginFrame() = 0;
+    virtual void submit(const RenderFrame& frame) = 0;
+    virtual void endFrame() = 0;
+    
+    virtual void resize(int width, int height) = 0;
+    
+    virtual bool isHeadless() const = 0;
+    virtual const CascadedShadowMap* getShadowMap() const { return nullptr; }
+    virtual DynamicResolution* getDynamicResolution() { return nullptr; }
+    
+    const RenderStats& getStats() const { return m_stats; }
+    void resetStats() { m_stats = RenderStats(); }
+
+protected:
+    void recordFrameStats(const RenderFrame& frame) {
+        m_stats.frameCount++;
+        m_stats.lastFramePackets = frame.packets ? static_cast<uint32_t>(frame.packets->size()) : 0;
+        m_stats.lastFrameShadowCasters = frame.shadowCasters ? static_cast<uint32_t>(frame.shadowCasters->size()) : 0;
+        m_stats.packetCount += m_stats.lastFramePackets;
+        m_stats.shadowCasterCount += m_stats.lastFrameShadowCasters;
+    }
+    
+    RenderStats m_stats;
+};
+
+}
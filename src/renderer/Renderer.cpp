@@ -1,12 +1,13 @@
 #include "Renderer.hpp"
+#include "GLRenderBackend.hpp"
+#include "NullRenderBackend.hpp"
 #include "core/Logger.hpp"
+#include "core/Profiler.hpp"
 #include "scene/Scene.hpp"
 #include "scene/Entity.hpp"
 #include <entt/entt.hpp>
-
-#ifdef ROBLOX_CLONE_BUILD_EDITOR
-#include "editor/Editor.hpp"
-#endif
+#include <glm/gtc/quaternion.hpp>
+#include <numeric>
 
 namespace roblox_clone::renderer {
 
@@ -27,19 +28,13 @@ bool Renderer::initialize(Window* window) {
     m_width = window->getWidth();
     m_height = window->getHeight();
     
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
-    glClearColor(0.1f, 0.1f, 0.2f, 1.0f);
-    
-    if (!loadDefaultShaders()) {
-        RC_ERROR("Failed to load default shaders");
+    m_backend = std::make_unique<GLRenderBackend>();
+    if (!m_backend->initialize(m_width, m_height)) {
+        RC_ERROR("Failed to initialize OpenGL render backend");
+        m_backend.reset();
         return false;
     }
     
-    m_testCube = std::make_unique<Mesh>();
-    m_testCube->createCube(1.0f);
-    
     window->setResizeCallback([this](int w, int h) {
         this->resize(w, h);
     });
@@ -48,118 +43,200 @@ bool Renderer::initialize(Window* window) {
     return true;
 }
 
+bool Renderer::initializeHeadless(int width, int height) {
+    m_window = nullptr;
+    m_width = width;
+    m_height = height;
+    
+    m_backend = std::make_unique<NullRenderBackend>();
+    if (!m_backend->initialize(m_width, m_height)) {
+        RC_ERROR("Failed to initialize null render backend");
+        m_backend.reset();
+        return false;
+    }
+    
+    RC_INFO("Renderer initialized in headless mode");
+    return true;
+}
+
 void Renderer::shutdown() {
-    m_testCube.reset();
-    m_basicShader.reset();
+    if (m_backend) {
+        m_backend->shutdown();
+        m_backend.reset();
+    }
+    m_drawPackets.clear();
+    m_shadowCasters.clear();
     m_window = nullptr;
 }
 
 void Renderer::beginFrame() {
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    m_backend->beginFrame();
 }
 
 void Renderer::endFrame() {
+    m_backend->endFrame();
+}
+
+glm::mat4 Renderer::computeModelMatrix(const scene::TransformComponent& transform) {
+    glm::mat4 model = glm::mat4(1.0f);
+    model = glm::translate(model, transform.position);
+    model = glm::rotate(model, glm::radians(transform.rotation.x), glm::vec3(1, 0, 0));
+    model = glm::rotate(model, glm::radians(transform.rotation.y), glm::vec3(0, 1, 0));
+    model = glm::rotate(model, glm::radians(transform.rotation.z), glm::vec3(0, 0, 1));
+    model = glm::scale(model, transform.scale);
+    return model;
+}
+
+glm::mat4 Renderer::computeModelMatrix(const scene::TransformComponent& previous,
+                                       const scene::TransformComponent& current, float alpha) {
+    auto toQuat = [](const glm::vec3& degrees) {
+        glm::vec3 radians = glm::radians(degrees);
+        return glm::angleAxis(radians.x, glm::vec3(1, 0, 0)) *
+               glm::angleAxis(radians.y, glm::vec3(0, 1, 0)) *
+               glm::angleAxis(radians.z, glm::vec3(0, 0, 1));
+    };
+    
+    glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::mix(previous.position, current.position, alpha));
+    model *= glm::mat4_cast(glm::slerp(toQuat(previous.rotation), toQuat(current.rotation), alpha));
+    return glm::scale(model, glm::mix(previous.scale, current.scale, alpha));
 }
 
-void Renderer::render(scene::Scene* scene) {
+void Renderer::render(scene::Scene* scene, float interpolationAlpha) {
+    RC_PROFILE_SCOPE("Renderer::render");
+    m_interpolationAlpha = glm::clamp(interpolationAlpha, 0.0f, 1.0f);
     float aspectRatio = static_cast<float>(m_width) / static_cast<float>(m_height);
-    glm::mat4 projection = m_camera.getProjectionMatrix(aspectRatio);
-    glm::mat4 view = m_camera.getViewMatrix();
     
-    m_basicShader->bind();
-    m_basicShader->setMat4("projection", projection);
-    m_basicShader->setMat4("view", view);
+    RenderFrame frame;
+    frame.view = m_camera.getViewMatrix();
+    frame.projection = m_camera.getProjectionMatrix(aspectRatio);
+    frame.fov = m_camera.fov;
+    frame.aspectRatio = aspectRatio;
+    frame.nearPlane = m_camera.nearPlane;
+    frame.sun = m_sun;
+    frame.shadowsEnabled = m_shadowsEnabled && scene;
+    
+    m_drawPackets.clear();
+    m_shadowCasters.clear();
     
     if (scene) {
-        auto& registry = scene->registry();
-        auto view = registry.view<scene::TransformComponent>();
-        
-        for (auto entity : view) {
-            auto& transform = view.get<scene::TransformComponent>(entity);
-            
-            glm::mat4 model = glm::mat4(1.0f);
-            model = glm::translate(model, transform.position);
-            model = glm::rotate(model, glm::radians(transform.rotation.x), glm::vec3(1, 0, 0));
-            model = glm::rotate(model, glm::radians(transform.rotation.y), glm::vec3(0, 1, 0));
-            model = glm::rotate(model, glm::radians(transform.rotation.z), glm::vec3(0, 0, 1));
-            model = glm::scale(model, transform.scale);
-            
-            m_basicShader->setMat4("model", model);
-            m_testCube->draw();
+        prepareTransforms(scene);
+        buildDrawPackets(scene, frame.projection * frame.view);
+        if (m_shadowsEnabled) {
+            buildShadowCasters(scene);
         }
+        frame.staticGeometryVersion = scene->getStaticGeometryVersion();
     }
     
-    m_basicShader->unbind();
+    frame.packets = &m_drawPackets;
+    frame.shadowCasters = &m_shadowCasters;
+    m_backend->submit(frame);
 }
 
-#ifdef ROBLOX_CLONE_BUILD_EDITOR
-void Renderer::renderEditorOverlay(editor::Editor* editor) {
-    if (editor) {
-        editor->renderViewport();
+void Renderer::prepareTransforms(scene::Scene* scene) {
+    RC_PROFILE_SCOPE("Renderer::prepareTransforms");
+    auto& registry = scene->registry();
+    const scene::TransformBatch& current = scene->updateTransformBatch();
+    m_models.resize(current.size());
+    scene::composeMatrices(current, m_models.data());
+    
+    // Parts the latest step left alone have a previous transform equal to
+    // their current one, so only the stepped parts need blending.
+    m_blendedIndices.clear();
+    m_blendedEntities.clear();
+    if (m_interpolationAlpha < 1.0f) {
+        const auto& transforms = registry.storage<scene::TransformComponent>();
+        if (scene->allPartsStepped()) {
+            m_blendedEntities.assign(transforms.data(), transforms.data() + transforms.size());
+            m_blendedIndices.resize(transforms.size());
+            std::iota(m_blendedIndices.begin(), m_blendedIndices.end(), 0u);
+        } else {
+            for (entt::entity entity : scene->getSteppedParts()) {
+                if (!transforms.contains(entity)) continue;
+                m_blendedIndices.push_back(static_cast<uint32_t>(transforms.index(entity)));
+                m_blendedEntities.push_back(entity);
+            }
+        }
+    }
+    
+    const size_t count = m_blendedEntities.size();
+    m_transforms.gather(registry, m_blendedEntities.data(), count);
+    m_previousTransforms.gatherPrevious(registry, m_blendedEntities.data(), count);
+    scene::interpolateTransforms(m_previousTransforms, m_transforms, m_interpolationAlpha, m_transforms);
+    m_blendedModels.resize(count);
+    scene::composeMatrices(m_transforms, m_blendedModels.data());
+    for (size_t i = 0; i < count; ++i) {
+        m_models[m_blendedIndices[i]] = m_blendedModels[i];
     }
 }
-#endif
 
-void Renderer::resize(int width, int height) {
-    m_width = width;
-    m_height = height;
-    glViewport(0, 0, width, height);
+// Entities whose unit box is outside the camera frustum get no packet. Shadow
+// casters are not culled, since off-screen parts still cast into view.
+void Renderer::buildDrawPackets(scene::Scene* scene, const glm::mat4& viewProjection) {
+    RC_PROFILE_SCOPE("Renderer::buildDrawPackets");
+    auto& registry = scene->registry();
+    const auto& transforms = registry.storage<scene::TransformComponent>();
+    const entt::entity* entities = transforms.data();
+    const size_t count = transforms.size();
+    
+    m_visible.resize(count);
+    scene::cullTransforms(scene->getTransformBatch().get(), viewProjection, m_visible.data());
+    m_blendedVisible.resize(m_blendedIndices.size());
+    scene::cullTransforms(m_transforms, viewProjection, m_blendedVisible.data());
+    for (size_t i = 0; i < m_blendedIndices.size(); ++i) {
+        m_visible[m_blendedIndices[i]] = m_blendedVisible[i];
+    }
+    
+    m_drawPackets.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (!m_visible[i]) continue;
+        
+        DrawPacket packet;
+        packet.model = m_models[i];
+        packet.entity = static_cast<uint32_t>(entities[i]);
+        
+        if (auto* meshRenderer = registry.try_get<scene::MeshRendererComponent>(entities[i])) {
+            packet.receiveShadows = meshRenderer->receiveShadows;
+        }
+        
+        m_drawPackets.push_back(packet);
+    }
 }
 
-bool Renderer::loadDefaultShaders() {
-    m_basicShader = std::make_unique<Shader>();
+void Renderer::buildShadowCasters(scene::Scene* scene) {
+    RC_PROFILE_SCOPE("Renderer::buildShadowCasters");
+    auto casters = scene->renderables();
+    const entt::entity* entities = casters.handle().data();
+    const size_t count = casters.size();
     
-    if (!m_basicShader->loadFromFiles("assets/shaders/basic.vert", "assets/shaders/basic.frag")) {
-        static const char* vertexSource = R"(
-            #version 450 core
-            layout(location = 0) in vec3 aPosition;
-            layout(location = 1) in vec3 aNormal;
-            layout(location = 2) in vec2 aTexCoords;
-            
-            uniform mat4 model;
-            uniform mat4 view;
-            uniform mat4 projection;
-            
-            out vec3 FragPos;
-            out vec3 Normal;
-            
-            void main() {
-                FragPos = vec3(model * vec4(aPosition, 1.0));
-                Normal = mat3(transpose(inverse(model))) * aNormal;
-                gl_Position = projection * view * vec4(FragPos, 1.0);
-            }
-        )";
+    m_shadowCasters.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const auto& meshRenderer = casters.get<scene::MeshRendererComponent>(entities[i]);
+        if (!meshRenderer.visible || !meshRenderer.castShadows) continue;
         
-        static const char* fragmentSource = R"(
-            #version 450 core
-            in vec3 FragPos;
-            in vec3 Normal;
-            
-            out vec4 FragColor;
-            
-            uniform vec3 lightPos = vec3(5.0, 10.0, 5.0);
-            uniform vec3 lightColor = vec3(1.0, 1.0, 1.0);
-            uniform vec3 objectColor = vec3(0.8, 0.4, 0.2);
-            
-            void main() {
-                vec3 norm = normalize(Normal);
-                vec3 lightDir = normalize(lightPos - FragPos);
-                
-                float ambientStrength = 0.3;
-                vec3 ambient = ambientStrength * lightColor;
-                
-                float diff = max(dot(norm, lightDir), 0.0);
-                vec3 diffuse = diff * lightColor;
-                
-                vec3 result = (ambient + diffuse) * objectColor;
-                FragColor = vec4(result, 1.0);
-            }
-        )";
+        ShadowCaster caster;
+        caster.model = m_models[i];
+        caster.isStatic = meshRenderer.isStatic;
+        
+        glm::vec3 center = glm::vec3(caster.model[3]);
+        glm::vec3 extent(0.0f);
+        for (int axis = 0; axis < 3; ++axis) {
+            extent += glm::abs(glm::vec3(caster.model[axis])) * 0.5f;
+        }
+        caster.boundsMin = center - extent;
+        caster.boundsMax = center + extent;
         
-        return m_basicShader->loadFromSource(vertexSource, fragmentSource);
+        m_shadowCasters.push_back(caster);
     }
-    
-    return true;
+}
+
+void Renderer::resize(int width, int height) {
+    m_width = width;
+    m_height = height;
+    m_backend->resize(width, height);
+}
+
+const CascadedShadowMap* Renderer::getShadowMap() const {
+    return m_backend ? m_backend->getShadowMap() : nullptr;
 }
 
 }
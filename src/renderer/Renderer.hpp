@@ -1,17 +1,18 @@
 #pragma once
 
 #include "Window.hpp"
-#include "Shader.hpp"
-#include "Mesh.hpp"
+#include "RenderBackend.hpp"
+#include "scene/TransformBatch.hpp"
+#include <entt/entity/fwd.hpp>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <memory>
+#include <vector>
 
-namespace roblox_clone::scene { class Scene; }
-
-#ifdef ROBLOX_CLONE_BUILD_EDITOR
-namespace roblox_clone::editor { class Editor; }
-#endif
+namespace roblox_clone::scene {
+class Scene;
+struct TransformComponent;
+}
 
 namespace roblox_clone::renderer {
 
@@ -36,32 +37,65 @@ public:
     Renderer& operator=(const Renderer&) = delete;
     
     bool initialize(Window* window);
+    bool initializeHeadless(int width, int height);
     void shutdown();
     
     void beginFrame();
     void endFrame();
     
-    void render(scene::Scene* scene);
-    
-#ifdef ROBLOX_CLONE_BUILD_EDITOR
-    void renderEditorOverlay(editor::Editor* editor);
-#endif
+    // interpolationAlpha blends each entity between its previous and current
+    // simulated transform; 1 draws the latest simulation state.
+    void render(scene::Scene* scene, float interpolationAlpha = 1.0f);
     
     void setCamera(const Camera& camera) { m_camera = camera; }
     Camera& getCamera() { return m_camera; }
     const Camera& getCamera() const { return m_camera; }
     
+    void setSun(const DirectionalLight& sun) { m_sun = sun; }
+    DirectionalLight& getSun() { return m_sun; }
+    
+    void setShadowsEnabled(bool enabled) { m_shadowsEnabled = enabled; }
+    bool areShadowsEnabled() const { return m_shadowsEnabled; }
+    const CascadedShadowMap* getShadowMap() const;
+    
+    RenderBackend* getBackend() const { return m_backend.get(); }
+    bool isHeadless() const { return m_backend && m_backend->isHeadless(); }
+    
     void resize(int width, int height);
+    
+    static glm::mat4 computeModelMatrix(const scene::TransformComponent& transform);
+    static glm::mat4 computeModelMatrix(const scene::TransformComponent& previous,
+                                        const scene::TransformComponent& current, float alpha);
 
 private:
-    bool loadDefaultShaders();
-    void renderMesh(Mesh* mesh, const glm::mat4& transform);
+    // Composes m_models from the scene's resident transform batch, then
+    // replaces the models of the parts the latest step moved with ones
+    // blended by the interpolation alpha.
+    void prepareTransforms(scene::Scene* scene);
+    void buildDrawPackets(scene::Scene* scene, const glm::mat4& viewProjection);
+    void buildShadowCasters(scene::Scene* scene);
     
     Window* m_window = nullptr;
     Camera m_camera;
+    DirectionalLight m_sun;
     
-    std::unique_ptr<Shader> m_basicShader;
-    std::unique_ptr<Mesh> m_testCube;
+    std::unique_ptr<RenderBackend> m_backend;
+    std::vector<DrawPacket> m_drawPackets;
+    std::vector<ShadowCaster> m_shadowCasters;
+    // Models in TransformComponent storage order, which the renderables()
+    // group shares for its first entries.
+    std::vector<glm::mat4> m_models;
+    std::vector<uint8_t> m_visible;
+    // The parts being blended: their storage indices, entities, transforms
+    // and results.
+    std::vector<uint32_t> m_blendedIndices;
+    std::vector<entt::entity> m_blendedEntities;
+    scene::TransformBatch m_transforms;
+    scene::TransformBatch m_previousTransforms;
+    std::vector<glm::mat4> m_blendedModels;
+    std::vector<uint8_t> m_blendedVisible;
+    bool m_shadowsEnabled = true;
+    float m_interpolationAlpha = 1.0f;
     
     int m_width = 1280;
     int m_height = 720;
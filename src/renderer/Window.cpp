@@ -123,6 +123,19 @@ void Window::pollEvents() {
     }
 }
 
+void Window::setVSync(bool enabled) {
+    if (!enabled) {
+        SDL_GL_SetSwapInterval(0);
+        return;
+    }
+    
+    if (SDL_GL_SetSwapInterval(-1) == 0) {
+        RC_INFO("Adaptive vsync enabled");
+        return;
+    }
+    SDL_GL_SetSwapInterval(1);
+}
+
 void Window::swapBuffers() {
     SDL_GL_SwapWindow(m_window);
 }
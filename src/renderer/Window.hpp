@@ -19,6 +19,7 @@ public:
     
     void pollEvents();
     void swapBuffers();
+    void setVSync(bool enabled);
     bool shouldClose() const;
     
     void setCloseCallback(std::function<void()> callback) { m_closeCallback = callback; }
@@ -0,0 +1,218 @@
+#include "Bvh.hpp"
+#include <array>
+#include <limits>
+#include <numeric>
+
+namespace roblox_clone::scene {
+
+namespace {
+
+constexpr uint32_t BinCount = 16;
+
+float surfaceArea(const Aabb& bounds) {
+    const glm::vec3 size = glm::max(bounds.max - bounds.min, glm::vec3(0.0f));
+    return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+Aabb emptyBounds() {
+    const float infinity = std::numeric_limits<float>::infinity();
+    return { glm::vec3(infinity), glm::vec3(-infinity) };
+}
+
+void grow(Aabb& bounds, const Aabb& other) {
+    bounds.min = glm::min(bounds.min, other.min);
+    bounds.max = glm::max(bounds.max, other.max);
+}
+
+}
+
+void Bvh4::Node::setBounds(uint32_t slot, const Aabb& bounds) {
+    minX[slot] = bounds.min.x;
+    minY[slot] = bounds.min.y;
+    minZ[slot] = bounds.min.z;
+    maxX[slot] = bounds.max.x;
+    maxY[slot] = bounds.max.y;
+    maxZ[slot] = bounds.max.z;
+}
+
+Aabb Bvh4::Node::getBounds(uint32_t slot) const {
+    return { glm::vec3(minX[slot], minY[slot], minZ[slot]), glm::vec3(maxX[slot], maxY[slot], maxZ[slot]) };
+}
+
+void Bvh4::build(const std::vector<Aabb>& bounds) {
+    clear();
+    if (bounds.empty()) return;
+    
+    std::vector<glm::vec3> centroids(bounds.size());
+    for (size_t i = 0; i < bounds.size(); ++i) {
+        centroids[i] = bounds[i].getCenter();
+    }
+    
+    m_order.resize(bounds.size());
+    std::iota(m_order.begin(), m_order.end(), 0u);
+    m_nodes.reserve(bounds.size() / 2 + 1);
+    
+    Aabb rootBounds;
+    buildNode(bounds, centroids, 0, static_cast<uint32_t>(bounds.size()), 0, rootBounds);
+}
+
+void Bvh4::refit(const std::vector<Aabb>& bounds) {
+    if (!m_nodes.empty()) {
+        refitNode(0, bounds);
+    }
+}
+
+void Bvh4::clear() {
+    m_nodes.clear();
+    m_order.clear();
+}
+
+uint32_t Bvh4::buildNode(const std::vector<Aabb>& bounds, const std::vector<glm::vec3>& centroids,
+                         uint32_t begin, uint32_t end, uint32_t depth, Aabb& nodeBounds) {
+    const uint32_t index = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.emplace_back();
+    
+    // Split the largest remaining range until there are four children or
+    // every range is small enough to be a leaf.
+    std::array<std::pair<uint32_t, uint32_t>, Width> ranges;
+    uint32_t rangeCount = 1;
+    ranges[0] = { begin, end };
+    while (rangeCount < Width && depth + 1 < MaxDepth) {
+        uint32_t largest = Width;
+        uint32_t largestSize = LeafSize;
+        for (uint32_t i = 0; i < rangeCount; ++i) {
+            const uint32_t size = ranges[i].second - ranges[i].first;
+            if (size > largestSize) {
+                largest = i;
+                largestSize = size;
+            }
+        }
+        if (largest == Width) break;
+        
+        const auto [first, last] = ranges[largest];
+        const uint32_t middle = split(bounds, centroids, first, last);
+        ranges[largest] = { first, middle };
+        ranges[rangeCount++] = { middle, last };
+    }
+    
+    nodeBounds = emptyBounds();
+    for (uint32_t slot = 0; slot < rangeCount; ++slot) {
+        const auto [first, last] = ranges[slot];
+        Aabb childBounds = emptyBounds();
+        uint32_t child = first;
+        uint32_t count = last - first;
+        if (count > LeafSize && depth + 1 < MaxDepth) {
+            child = buildNode(bounds, centroids, first, last, depth + 1, childBounds);
+            count = 0;
+        } else {
+            for (uint32_t i = first; i < last; ++i) {
+                grow(childBounds, bounds[m_order[i]]);
+            }
+        }
+        
+        Node& node = m_nodes[index];
+        node.setBounds(slot, childBounds);
+        node.child[slot] = child;
+        node.count[slot] = count;
+        grow(nodeBounds, childBounds);
+    }
+    
+    Node& node = m_nodes[index];
+    node.childCount = rangeCount;
+    for (uint32_t slot = rangeCount; slot < Width; ++slot) {
+        node.setBounds(slot, emptyBounds());
+        node.child[slot] = 0;
+        node.count[slot] = 0;
+    }
+    return index;
+}
+
+// Binned SAH split of m_order[begin, end) along the widest centroid axis.
+uint32_t Bvh4::split(const std::vector<Aabb>& bounds, const std::vector<glm::vec3>& centroids,
+                     uint32_t begin, uint32_t end) {
+    Aabb centroidBounds = emptyBounds();
+    for (uint32_t i = begin; i < end; ++i) {
+        grow(centroidBounds, { centroids[m_order[i]], centroids[m_order[i]] });
+    }
+    
+    const glm::vec3 extent = centroidBounds.max - centroidBounds.min;
+    int axis = 0;
+    if (extent.y > extent[axis]) axis = 1;
+    if (extent.z > extent[axis]) axis = 2;
+    
+    const uint32_t median = begin + (end - begin) / 2;
+    auto splitAtMedian = [&]() {
+        std::nth_element(m_order.begin() + begin, m_order.begin() + median, m_order.begin() + end,
+                         [&](uint32_t a, uint32_t b) { return centroids[a][axis] < centroids[b][axis]; });
+        return median;
+    };
+    if (extent[axis] <= 1.0e-6f) return splitAtMedian();
+    
+    struct Bin {
+        Aabb bounds = emptyBounds();
+        uint32_t count = 0;
+    };
+    std::array<Bin, BinCount> bins;
+    const float scale = BinCount / extent[axis];
+    auto binOf = [&](uint32_t primitive) {
+        const float offset = (centroids[primitive][axis] - centroidBounds.min[axis]) * scale;
+        return std::min(static_cast<uint32_t>(offset), BinCount - 1);
+    };
+    for (uint32_t i = begin; i < end; ++i) {
+        Bin& bin = bins[binOf(m_order[i])];
+        grow(bin.bounds, bounds[m_order[i]]);
+        ++bin.count;
+    }
+    
+    std::array<float, BinCount - 1> leftCost;
+    Aabb running = emptyBounds();
+    uint32_t runningCount = 0;
+    for (uint32_t i = 0; i + 1 < BinCount; ++i) {
+        grow(running, bins[i].bounds);
+        runningCount += bins[i].count;
+        leftCost[i] = runningCount > 0 ? surfaceArea(running) * runningCount : 0.0f;
+    }
+    
+    float bestCost = std::numeric_limits<float>::max();
+    uint32_t bestBin = 0;
+    running = emptyBounds();
+    runningCount = 0;
+    for (uint32_t i = BinCount - 1; i > 0; --i) {
+        grow(running, bins[i].bounds);
+        runningCount += bins[i].count;
+        const float cost = leftCost[i - 1] + (runningCount > 0 ? surfaceArea(running) * runningCount : 0.0f);
+        if (cost < bestCost) {
+            bestCost = cost;
+            bestBin = i;
+        }
+    }
+    
+    auto middle = std::partition(m_order.begin() + begin, m_order.begin() + end,
+                                 [&](uint32_t primitive) { return binOf(primitive) < bestBin; });
+    const uint32_t result = static_cast<uint32_t>(middle - m_order.begin());
+    if (result == begin || result == end) return splitAtMedian();
+    return result;
+}
+
+Aabb Bvh4::refitNode(uint32_t index, const std::vector<Aabb>& bounds) {
+    Aabb nodeBounds = emptyBounds();
+    const uint32_t childCount = m_nodes[index].childCount;
+    for (uint32_t slot = 0; slot < childCount; ++slot) {
+        const uint32_t child = m_nodes[index].child[slot];
+        const uint32_t count = m_nodes[index].count[slot];
+        
+        Aabb childBounds = emptyBounds();
+        if (count == 0) {
+            childBounds = refitNode(child, bounds);
+        } else {
+            for (uint32_t i = child; i < child + count; ++i) {
+                grow(childBounds, bounds[i]);
+            }
+        }
+        m_nodes[index].setBounds(slot, childBounds);
+        grow(nodeBounds, childBounds);
+    }
+    return nodeBounds;
+}
+
+}
@@ -0,0 +1,196 @@
+#pragma once
+
+#include "SpatialHash.hpp"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ROBLOX_CLONE_BVH_SSE 1
+#include <emmintrin.h>
+#else
+#define ROBLOX_CLONE_BVH_SSE 0
+#endif
+
+namespace roblox_clone::scene {
+
+struct BvhRay {
+    glm::vec3 origin = glm::vec3(0.0f);
+    glm::vec3 direction = glm::vec3(0.0f, 0.0f, -1.0f);
+    glm::vec3 inverseDirection = glm::vec3(0.0f);
+    float maxDistance = 0.0f;
+    
+    BvhRay() = default;
+    BvhRay(const glm::vec3& rayOrigin, const glm::vec3& rayDirection, float distance)
+        : origin(rayOrigin), direction(rayDirection), inverseDirection(1.0f / rayDirection), maxDistance(distance) {}
+};
+
+// Four-wide bounding volume hierarchy. Each node holds the bounds of up to four
+// children in SoA form so one SSE slab test covers all of them. Primitives are
+// referenced by their slot in getOrder(), which lists them leaf by leaf; callers
+// are expected to store primitive data in that order.
+class Bvh4 {
+public:
+    static constexpr uint32_t Width = 4;
+    static constexpr uint32_t LeafSize = 4;
+    static constexpr uint32_t MaxDepth = 64;
+    
+    struct alignas(16) Node {
+        float minX[Width];
+        float minY[Width];
+        float minZ[Width];
+        float maxX[Width];
+        float maxY[Width];
+        float maxZ[Width];
+        // Inner children store a node index and a count of 0, leaves store the
+        // first primitive slot and the number of primitives.
+        uint32_t child[Width];
+        uint32_t count[Width];
+        uint32_t childCount = 0;
+        
+        void setBounds(uint32_t slot, const Aabb& bounds);
+        Aabb getBounds(uint32_t slot) const;
+    };
+    
+    Bvh4() = default;
+    
+    Bvh4(const Bvh4&) = delete;
+    Bvh4& operator=(const Bvh4&) = delete;
+    
+    void build(const std::vector<Aabb>& bounds);
+    // Recomputes node bounds bottom-up; bounds are indexed by primitive slot.
+    void refit(const std::vector<Aabb>& bounds);
+    void clear();
+    
+    bool isEmpty() const { return m_nodes.empty(); }
+    const std::vector<uint32_t>& getOrder() const { return m_order; }
+    size_t getNodeCount() const { return m_nodes.size(); }
+    
+    // Visits the leaves the ray passes through, nearest node first. Child
+    // bounds are grown by inflate so the same walk serves sphere casts.
+    // leaf(slot, maxDistance) tests one primitive and may shorten maxDistance.
+    template<typename LeafFunc>
+    void traverse(const BvhRay& ray, float inflate, LeafFunc&& leaf) const {
+        if (m_nodes.empty()) return;
+        
+        struct StackEntry {
+            uint32_t node;
+            float distance;
+        };
+        StackEntry stack[MaxDepth * (Width - 1) + 1];
+        uint32_t stackSize = 0;
+        stack[stackSize++] = { 0, 0.0f };
+        float maxDistance = ray.maxDistance;
+        
+        while (stackSize > 0) {
+            const StackEntry entry = stack[--stackSize];
+            if (entry.distance > maxDistance) continue;
+            
+            const Node& node = m_nodes[entry.node];
+            alignas(16) float distances[Width];
+            uint32_t mask = intersectNode(node, ray, inflate, maxDistance, distances);
+            if (mask == 0) continue;
+            
+            // Nearest child first: leaves are tested in order, inner nodes are
+            // pushed far to near so the nearest one is popped next.
+            uint32_t slots[Width];
+            uint32_t hitCount = 0;
+            for (uint32_t slot = 0; slot < Width; ++slot) {
+                if (!(mask & (1u << slot))) continue;
+                uint32_t position = hitCount++;
+                while (position > 0 && distances[slots[position - 1]] > distances[slot]) {
+                    slots[position] = slots[position - 1];
+                    --position;
+                }
+                slots[position] = slot;
+            }
+            
+            for (uint32_t i = 0; i < hitCount; ++i) {
+                const uint32_t slot = slots[i];
+                if (node.count[slot] == 0 || distances[slot] > maxDistance) continue;
+                for (uint32_t primitive = 0; primitive < node.count[slot]; ++primitive) {
+                    leaf(node.child[slot] + primitive, maxDistance);
+                }
+            }
+            for (uint32_t i = hitCount; i-- > 0;) {
+                const uint32_t slot = slots[i];
+                if (node.count[slot] == 0 && distances[slot] <= maxDistance) {
+                    stack[stackSize++] = { node.child[slot], distances[slot] };
+                }
+            }
+        }
+    }
+
+private:
+    static uint32_t intersectNode(const Node& node, const BvhRay& ray, float inflate, float maxDistance,
+                                  float* distances) {
+#if ROBLOX_CLONE_BVH_SSE
+        const __m128 grow = _mm_set1_ps(inflate);
+        const __m128 originX = _mm_set1_ps(ray.origin.x);
+        const __m128 originY = _mm_set1_ps(ray.origin.y);
+        const __m128 originZ = _mm_set1_ps(ray.origin.z);
+        const __m128 inverseX = _mm_set1_ps(ray.inverseDirection.x);
+        const __m128 inverseY = _mm_set1_ps(ray.inverseDirection.y);
+        const __m128 inverseZ = _mm_set1_ps(ray.inverseDirection.z);
+        
+        const __m128 nearX = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(_mm_load_ps(node.minX), grow), originX), inverseX);
+        const __m128 farX = _mm_mul_ps(_mm_sub_ps(_mm_add_ps(_mm_load_ps(node.maxX), grow), originX), inverseX);
+        const __m128 nearY = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(_mm_load_ps(node.minY), grow), originY), inverseY);
+        const __m128 farY = _mm_mul_ps(_mm_sub_ps(_mm_add_ps(_mm_load_ps(node.maxY), grow), originY), inverseY);
+        const __m128 nearZ = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(_mm_load_ps(node.minZ), grow), originZ), inverseZ);
+        const __m128 farZ = _mm_mul_ps(_mm_sub_ps(_mm_add_ps(_mm_load_ps(node.maxZ), grow), originZ), inverseZ);
+        
+        // An axis-aligned ray starting on a slab plane gets 0 * inf = NaN for
+        // it, and runs inside the slab, so that axis must not clip the ray.
+        // Both of its bounds are forced to NaN, and the folds below keep NaN
+        // in the first operand, since SSE min and max then return the second.
+        const __m128 unorderedX = _mm_cmpunord_ps(nearX, farX);
+        const __m128 unorderedY = _mm_cmpunord_ps(nearY, farY);
+        const __m128 unorderedZ = _mm_cmpunord_ps(nearZ, farZ);
+        const __m128 lowX = _mm_or_ps(_mm_min_ps(nearX, farX), unorderedX);
+        const __m128 lowY = _mm_or_ps(_mm_min_ps(nearY, farY), unorderedY);
+        const __m128 lowZ = _mm_or_ps(_mm_min_ps(nearZ, farZ), unorderedZ);
+        const __m128 highX = _mm_or_ps(_mm_max_ps(nearX, farX), unorderedX);
+        const __m128 highY = _mm_or_ps(_mm_max_ps(nearY, farY), unorderedY);
+        const __m128 highZ = _mm_or_ps(_mm_max_ps(nearZ, farZ), unorderedZ);
+        
+        __m128 entry = _mm_max_ps(lowX, _mm_max_ps(lowY, _mm_max_ps(lowZ, _mm_setzero_ps())));
+        __m128 exit = _mm_min_ps(highX, _mm_min_ps(highY, _mm_min_ps(highZ, _mm_set1_ps(maxDistance))));
+        
+        _mm_store_ps(distances, entry);
+        const uint32_t hits = static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(entry, exit)));
+#else
+        uint32_t hits = 0;
+        for (uint32_t slot = 0; slot < Width; ++slot) {
+            const glm::vec3 minimum(node.minX[slot] - inflate, node.minY[slot] - inflate, node.minZ[slot] - inflate);
+            const glm::vec3 maximum(node.maxX[slot] + inflate, node.maxY[slot] + inflate, node.maxZ[slot] + inflate);
+            const glm::vec3 nearT = (minimum - ray.origin) * ray.inverseDirection;
+            const glm::vec3 farT = (maximum - ray.origin) * ray.inverseDirection;
+            float entry = 0.0f;
+            float exit = maxDistance;
+            for (int axis = 0; axis < 3; ++axis) {
+                // NaN from a ray starting on the slab plane: the axis does not clip.
+                if (std::isnan(nearT[axis]) || std::isnan(farT[axis])) continue;
+                entry = std::max(entry, std::min(nearT[axis], farT[axis]));
+                exit = std::min(exit, std::max(nearT[axis], farT[axis]));
+            }
+            distances[slot] = entry;
+            if (entry <= exit) hits |= 1u << slot;
+        }
+#endif
+        return hits & ((1u << node.childCount) - 1u);
+    }
+    
+    uint32_t buildNode(const std::vector<Aabb>& bounds, const std::vector<glm::vec3>& centroids,
+                       uint32_t begin, uint32_t end, uint32_t depth, Aabb& nodeBounds);
+    uint32_t split(const std::vector<Aabb>& bounds, const std::vector<glm::vec3>& centroids,
+                   uint32_t begin, uint32_t end);
+    Aabb refitNode(uint32_t index, const std::vector<Aabb>& bounds);
+    
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_order;
+};
+
+}
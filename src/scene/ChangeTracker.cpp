@@ -0,0 +1,170 @@
+#include "ChangeTracker.hpp"
+#include "core/Profiler.hpp"
+#include <algorithm>
+#include <bitset>
+#include <chrono>
+#include <iterator>
+
+namespace roblox_clone::scene {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct PropertyInfo {
+    const char* name;
+    TrackedComponent component;
+};
+
+constexpr PropertyInfo Properties[] = {
+    { "Position", TrackedComponent::Transform },
+    { "Rotation", TrackedComponent::Transform },
+    { "Scale", TrackedComponent::Transform },
+    { "Name", TrackedComponent::Name },
+    { "Visible", TrackedComponent::MeshRenderer },
+    { "CastShadows", TrackedComponent::MeshRenderer },
+    { "ReceiveShadows", TrackedComponent::MeshRenderer },
+    { "Static", TrackedComponent::MeshRenderer },
+};
+
+static_assert(std::size(Properties) == static_cast<size_t>(Property::Count), "Every property needs an entry");
+static_assert(static_cast<size_t>(Property::Count) <= sizeof(PropertyMask) * 8, "Properties must fit a mask");
+
+}
+
+TrackedComponent getPropertyComponent(Property property) {
+    return Properties[static_cast<size_t>(property)].component;
+}
+
+const char* getPropertyName(Property property) {
+    return Properties[static_cast<size_t>(property)].name;
+}
+
+bool findProperty(std::string_view name, Property& property) {
+    for (size_t i = 0; i < std::size(Properties); ++i) {
+        if (name == Properties[i].name) {
+            property = static_cast<Property>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ChangeTracker::mark(entt::entity entity, Property property) {
+    Changes& changes = m_changes[static_cast<size_t>(getPropertyComponent(property))];
+    const auto index = entt::to_entity(entity);
+    if (index >= changes.entries.size()) {
+        changes.entries.resize(index + 1);
+    }
+    
+    Entry& entry = changes.entries[index];
+    if (entry.entity != entity) {
+        entry.entity = entity;
+        entry.properties = 0;
+        changes.changed.push_back(entity);
+    }
+    entry.properties |= propertyBit(property);
+}
+
+bool ChangeTracker::isChanged(entt::entity entity, Property property) const {
+    const Changes& changes = m_changes[static_cast<size_t>(getPropertyComponent(property))];
+    const auto index = entt::to_entity(entity);
+    return index < changes.entries.size() && changes.entries[index].entity == entity &&
+           (changes.entries[index].properties & propertyBit(property)) != 0;
+}
+
+size_t ChangeTracker::getPendingCount() const {
+    size_t count = 0;
+    for (const Changes& changes : m_changes) {
+        count += changes.changed.size();
+    }
+    return count;
+}
+
+uint32_t ChangeTracker::addListener(TrackedComponent component, Listener listener) {
+    const uint32_t id = m_nextListenerId++;
+    m_listeners.push_back({ id, component, std::move(listener) });
+    return id;
+}
+
+void ChangeTracker::removeListener(uint32_t id) {
+    auto it = std::find_if(m_listeners.begin(), m_listeners.end(),
+                           [id](const ListenerEntry& entry) { return entry.id == id; });
+    if (it == m_listeners.end()) return;
+    
+    // A listener may disconnect itself; the entry is dropped after dispatch.
+    if (m_dispatching) {
+        it->id = 0;
+    } else {
+        m_listeners.erase(it);
+    }
+}
+
+void ChangeTracker::dispatch(const entt::registry& registry) {
+    RC_PROFILE_SCOPE("ChangeTracker::dispatch");
+    const auto start = Clock::now();
+    m_stats.changedEntities = 0;
+    m_stats.changedProperties = 0;
+    m_dispatching = true;
+    
+    // Every component's pending list is taken before any listener runs, so
+    // writes made from a listener, to this component or a later one, queue up
+    // for the next dispatch instead of joining this one.
+    m_batchEntities.clear();
+    m_batchProperties.clear();
+    std::array<size_t, static_cast<size_t>(TrackedComponent::Count) + 1> batchStart;
+    for (size_t component = 0; component < m_changes.size(); ++component) {
+        Changes& changes = m_changes[component];
+        batchStart[component] = m_batchEntities.size();
+        for (entt::entity entity : changes.changed) {
+            Entry& entry = changes.entries[entt::to_entity(entity)];
+            if (registry.valid(entity)) {
+                m_batchEntities.push_back(entity);
+                m_batchProperties.push_back(entry.properties);
+                m_stats.changedProperties += std::bitset<32>(entry.properties).count();
+            }
+            entry = {};
+        }
+        changes.changed.clear();
+    }
+    batchStart.back() = m_batchEntities.size();
+    m_stats.changedEntities = m_batchEntities.size();
+    
+    for (size_t component = 0; component < m_changes.size(); ++component) {
+        const size_t first = batchStart[component];
+        if (batchStart[component + 1] == first) continue;
+        
+        ChangeBatch batch;
+        batch.component = static_cast<TrackedComponent>(component);
+        batch.entities = m_batchEntities.data() + first;
+        batch.properties = m_batchProperties.data() + first;
+        batch.count = batchStart[component + 1] - first;
+        
+        // Listeners added during dispatch wait for the next one.
+        const size_t listenerCount = m_listeners.size();
+        for (size_t i = 0; i < listenerCount; ++i) {
+            if (m_listeners[i].id == 0 || m_listeners[i].component != batch.component) continue;
+            
+            // Copied, since the listener may add others and move the vector.
+            Listener listener = m_listeners[i].listener;
+            listener(batch);
+        }
+    }
+    
+    m_dispatching = false;
+    m_listeners.erase(std::remove_if(m_listeners.begin(), m_listeners.end(),
+                                     [](const ListenerEntry& entry) { return entry.id == 0; }),
+                      m_listeners.end());
+    m_stats.dispatchUs = std::chrono::duration<float, std::micro>(Clock::now() - start).count();
+}
+
+void ChangeTracker::clear() {
+    for (Changes& changes : m_changes) {
+        for (entt::entity entity : changes.changed) {
+            changes.entries[entt::to_entity(entity)] = {};
+        }
+        changes.changed.clear();
+    }
+}
+
+}
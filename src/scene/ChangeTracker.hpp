@@ -0,0 +1,121 @@
+#pragma once
+
+#include <entt/entt.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+namespace roblox_clone::scene {
+
+// Components whose property writes raise change events.
+enum class TrackedComponent : uint8_t {
+    Transform,
+    Name,
+    MeshRenderer,
+    Count,
+};
+
+// Tracked properties, named as scripts see them. Each belongs to one
+// component and is one bit of that component's PropertyMask.
+enum class Property : uint8_t {
+    Position,
+    Rotation,
+    Scale,
+    Name,
+    Visible,
+    CastShadows,
+    ReceiveShadows,
+    Static,
+    Count,
+};
+
+using PropertyMask = uint32_t;
+
+constexpr PropertyMask propertyBit(Property property) {
+    return PropertyMask(1) << static_cast<uint8_t>(property);
+}
+
+TrackedComponent getPropertyComponent(Property property);
+const char* getPropertyName(Property property);
+bool findProperty(std::string_view name, Property& property);
+
+// The entities whose properties on one component changed since the last
+// dispatch, each once, with the properties that changed.
+struct ChangeBatch {
+    TrackedComponent component = TrackedComponent::Transform;
+    const entt::entity* entities = nullptr;
+    const PropertyMask* properties = nullptr;
+    size_t count = 0;
+};
+
+struct ChangeStats {
+    size_t changedEntities = 0;
+    size_t changedProperties = 0;
+    float dispatchUs = 0.0f;
+};
+
+// Dirty bits per component for property writes made through the Entity
+// setters, which the Lua bindings and the editor use. Repeated writes to a
+// property coalesce until dispatch(), which hands each listener one batch per
+// component that changed, so the cost follows the number of changes rather
+// than the number of entities. Writes made straight through views, as systems
+// and physics do, are not tracked.
+class ChangeTracker {
+public:
+    using Listener = std::function<void(const ChangeBatch&)>;
+    
+    ChangeTracker() = default;
+    
+    ChangeTracker(const ChangeTracker&) = delete;
+    ChangeTracker& operator=(const ChangeTracker&) = delete;
+    
+    void mark(entt::entity entity, Property property);
+    bool isChanged(entt::entity entity, Property property) const;
+    size_t getPendingCount() const;
+    
+    // Listeners are called in the order they were added. Returns an id for
+    // removeListener().
+    uint32_t addListener(TrackedComponent component, Listener listener);
+    void removeListener(uint32_t id);
+    
+    // Sends the pending changes of entities that are still alive and clears
+    // them. All components' changes are taken before the first listener runs,
+    // so properties marked by listeners go out with the next dispatch.
+    void dispatch(const entt::registry& registry);
+    void clear();
+    
+    const ChangeStats& getStats() const { return m_stats; }
+
+private:
+    struct Entry {
+        entt::entity entity = entt::null;
+        PropertyMask properties = 0;
+    };
+    
+    // Entries are indexed by entity index and keyed by the full handle, so a
+    // recycled index starts clean.
+    struct Changes {
+        std::vector<Entry> entries;
+        std::vector<entt::entity> changed;
+    };
+    
+    struct ListenerEntry {
+        uint32_t id = 0;
+        TrackedComponent component = TrackedComponent::Transform;
+        Listener listener;
+    };
+    
+    std::array<Changes, static_cast<size_t>(TrackedComponent::Count)> m_changes;
+    std::vector<ListenerEntry> m_listeners;
+    uint32_t m_nextListenerId = 1;
+    bool m_dispatching = false;
+    
+    std::vector<entt::entity> m_batchEntities;
+    std::vector<PropertyMask> m_batchProperties;
+    ChangeStats m_stats;
+};
+
+}
@@ -0,0 +1,142 @@
+#include "CommandBuffer.hpp"
+#include "Scene.hpp"
+#include "core/Profiler.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace roblox_clone::scene {
+
+CommandEntity CommandBuffer::create() {
+    ++m_commandCount;
+    return CommandEntity::makeDeferred(m_createCount++);
+}
+
+CommandEntity CommandBuffer::createEntity(const std::string& name) {
+    CommandEntity entity = create();
+    emplace<TransformComponent>(entity);
+    emplace<NameComponent>(entity, name);
+    return entity;
+}
+
+void CommandBuffer::destroy(CommandEntity entity) {
+    m_destroyed.push_back(entity);
+    ++m_commandCount;
+}
+
+void CommandBuffer::clear() {
+    for (auto& batch : m_batches) {
+        batch->clear();
+    }
+    m_destroyed.clear();
+    m_createCount = 0;
+    m_commandCount = 0;
+}
+
+CommandQueue::CommandQueue() : m_lifetime(std::make_shared<char>()) {}
+
+CommandBuffer& CommandQueue::local() {
+    // Entries outlive their queue until the thread next looks up a buffer,
+    // which drops them, so the list only ever holds a pass's worth of dead
+    // queues on top of the live ones.
+    thread_local std::vector<std::pair<std::weak_ptr<char>, CommandBuffer*>> t_buffers;
+    for (auto it = t_buffers.begin(); it != t_buffers.end();) {
+        if (it->first.expired()) {
+            it = t_buffers.erase(it);
+        } else if (!it->first.owner_before(m_lifetime) && !m_lifetime.owner_before(it->first)) {
+            return *it->second;
+        } else {
+            ++it;
+        }
+    }
+    
+    CommandBuffer* buffer;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_buffers.push_back(std::make_unique<CommandBuffer>());
+        buffer = m_buffers.back().get();
+    }
+    t_buffers.emplace_back(m_lifetime, buffer);
+    return *buffer;
+}
+
+CommandPlaybackStats CommandQueue::playback(entt::registry& registry) {
+    RC_PROFILE_SCOPE("CommandQueue::playback");
+    auto start = std::chrono::steady_clock::now();
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    CommandPlaybackStats stats;
+    
+    uint32_t createCount = 0;
+    for (const auto& buffer : m_buffers) {
+        createCount += buffer->m_createCount;
+        stats.commands += buffer->m_commandCount;
+    }
+    if (stats.commands == 0) {
+        m_lastStats = stats;
+        return stats;
+    }
+    
+    m_created.resize(createCount);
+    registry.create(m_created.begin(), m_created.end());
+    stats.created = createCount;
+    
+    m_reservations.clear();
+    for (const auto& buffer : m_buffers) {
+        for (const auto& batch : buffer->m_batches) {
+            auto it = std::find_if(m_reservations.begin(), m_reservations.end(), [&batch](const auto& reservation) {
+                return reservation.first->type == batch->type;
+            });
+            if (it == m_reservations.end()) {
+                m_reservations.emplace_back(batch.get(), batch->pendingEmplaces());
+            } else {
+                it->second += batch->pendingEmplaces();
+            }
+        }
+    }
+    for (const auto& [batch, total] : m_reservations) {
+        if (total > 0) batch->reserve(registry, total);
+    }
+    
+    uint32_t offset = 0;
+    for (const auto& buffer : m_buffers) {
+        for (const auto& batch : buffer->m_batches) {
+            batch->applyEmplaces(registry, m_created.data() + offset);
+        }
+        offset += buffer->m_createCount;
+    }
+    
+    offset = 0;
+    for (const auto& buffer : m_buffers) {
+        for (const auto& batch : buffer->m_batches) {
+            batch->applyPatches(registry, m_created.data() + offset);
+        }
+        offset += buffer->m_createCount;
+    }
+    
+    offset = 0;
+    for (const auto& buffer : m_buffers) {
+        for (const auto& batch : buffer->m_batches) {
+            batch->applyRemovals(registry, m_created.data() + offset);
+        }
+        offset += buffer->m_createCount;
+    }
+    
+    offset = 0;
+    for (const auto& buffer : m_buffers) {
+        for (auto entity : buffer->m_destroyed) {
+            const entt::entity handle = CommandBuffer::resolve(entity, m_created.data() + offset);
+            if (registry.valid(handle)) {
+                registry.destroy(handle);
+                ++stats.destroyed;
+            }
+        }
+        offset += buffer->m_createCount;
+        buffer->clear();
+    }
+    
+    stats.timeMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    m_lastStats = stats;
+    return stats;
+}
+
+}
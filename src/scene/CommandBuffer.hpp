@@ -0,0 +1,278 @@
+#pragma once
+
+#include <entt/entt.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace roblox_clone::scene {
+
+// Either an existing entity or one created earlier in the same buffer, which
+// only gets a real handle during playback. The flag is kept apart from the
+// handle because every bit of an entt::entity is in use once versions grow.
+struct CommandEntity {
+    entt::entity entity = entt::null;
+    uint32_t index = 0;
+    bool deferred = false;
+    
+    CommandEntity() = default;
+    CommandEntity(entt::entity entity) : entity(entity) {}
+    
+    static CommandEntity makeDeferred(uint32_t index) {
+        CommandEntity entity;
+        entity.index = index;
+        entity.deferred = true;
+        return entity;
+    }
+    
+    bool isDeferred() const { return deferred; }
+    uint32_t getDeferredIndex() const { return index; }
+};
+
+class CommandBuffer {
+public:
+    CommandBuffer() = default;
+    
+    CommandBuffer(const CommandBuffer&) = delete;
+    CommandBuffer& operator=(const CommandBuffer&) = delete;
+    
+    CommandEntity create();
+    // Mirrors Scene::createEntity: a bare entity plus Transform and Name.
+    CommandEntity createEntity(const std::string& name = "Entity");
+    // May name an entity created in this buffer, which is then created and
+    // destroyed again during playback.
+    void destroy(CommandEntity entity);
+    
+    // Of an emplace and a remove of one component on one entity, whichever
+    // was recorded last wins, as if the buffer were played in order.
+    template<typename T, typename... Args>
+    void emplace(CommandEntity entity, Args&&... args) {
+        auto& batch = getBatch<T>();
+        batch.entities.push_back(entity);
+        batch.values.emplace_back(std::forward<Args>(args)...);
+        batch.emplaceOrder.push_back(++m_commandCount);
+    }
+    
+    template<typename T>
+    void remove(CommandEntity entity) {
+        auto& batch = getBatch<T>();
+        batch.removals.push_back(entity);
+        batch.removalOrder.push_back(++m_commandCount);
+    }
+    
+    // Raises on_update for a component written in place, as registry.patch()
+    // does, so observers such as the scene's spatial hash see writes made from
+    // systems and jobs. Skipped if the entity lacks the component by then.
+    template<typename T>
+    void patch(CommandEntity entity) {
+        getBatch<T>().patches.push_back(entity);
+        ++m_commandCount;
+    }
+    
+    void clear();
+    bool isEmpty() const { return m_commandCount == 0; }
+    size_t getCommandCount() const { return m_commandCount; }
+    uint32_t getCreateCount() const { return m_createCount; }
+
+private:
+    friend class CommandQueue;
+    
+    struct BatchBase {
+        virtual ~BatchBase() = default;
+        virtual size_t pendingEmplaces() const = 0;
+        virtual void reserve(entt::registry& registry, size_t extra) = 0;
+        virtual void applyEmplaces(entt::registry& registry, const entt::entity* created) = 0;
+        virtual void applyPatches(entt::registry& registry, const entt::entity* created) = 0;
+        virtual void applyRemovals(entt::registry& registry, const entt::entity* created) = 0;
+        virtual void clear() = 0;
+        
+        entt::id_type type = 0;
+    };
+    
+    static entt::entity resolve(CommandEntity entity, const entt::entity* created) {
+        return entity.isDeferred() ? created[entity.getDeferredIndex()] : entity.entity;
+    }
+    
+    template<typename T>
+    struct Batch final : BatchBase {
+        std::vector<CommandEntity> entities;
+        std::vector<T> values;
+        std::vector<CommandEntity> removals;
+        std::vector<CommandEntity> patches;
+        // Position of each emplace and remove in the buffer, counted from 1.
+        std::vector<size_t> emplaceOrder;
+        std::vector<size_t> removalOrder;
+        std::vector<entt::entity> resolved;
+        std::vector<T> inserted;
+        std::vector<uint32_t> slots;
+        // Latest emplace and remove per entity index during playback, or 0.
+        std::vector<size_t> lastEmplace;
+        std::vector<size_t> lastRemoval;
+        
+        static constexpr uint32_t NoSlot = ~0u;
+        
+        static void track(std::vector<size_t>& latest, entt::entity entity, size_t order) {
+            auto index = static_cast<size_t>(entt::to_entity(entity));
+            if (index >= latest.size()) latest.resize(index + 1, 0);
+            latest[index] = std::max(latest[index], order);
+        }
+        
+        static size_t latestOf(const std::vector<size_t>& latest, entt::entity entity) {
+            auto index = static_cast<size_t>(entt::to_entity(entity));
+            return index < latest.size() ? latest[index] : 0;
+        }
+        
+        static void untrack(std::vector<size_t>& latest, entt::entity entity) {
+            auto index = static_cast<size_t>(entt::to_entity(entity));
+            if (index < latest.size()) latest[index] = 0;
+        }
+        
+        size_t pendingEmplaces() const override { return entities.size(); }
+        
+        void reserve(entt::registry& registry, size_t extra) override {
+            auto& storage = registry.storage<T>();
+            storage.reserve(storage.size() + extra);
+        }
+        
+        void applyEmplaces(entt::registry& registry, const entt::entity* created) override {
+            auto& storage = registry.storage<T>();
+            // Only a batch with removals has anything to settle.
+            const bool ordered = !removals.empty();
+            for (size_t i = 0; i < removals.size(); ++i) {
+                entt::entity entity = resolve(removals[i], created);
+                if (registry.valid(entity)) track(lastRemoval, entity, removalOrder[i]);
+            }
+            
+            resolved.clear();
+            inserted.clear();
+            for (size_t i = 0; i < entities.size(); ++i) {
+                entt::entity entity = resolve(entities[i], created);
+                if (!registry.valid(entity)) continue;
+                if (ordered) {
+                    if (latestOf(lastRemoval, entity) > emplaceOrder[i]) continue;
+                    track(lastEmplace, entity, emplaceOrder[i]);
+                }
+                
+                // Later values win, matching emplace_or_replace done in order.
+                auto index = static_cast<size_t>(entt::to_entity(entity));
+                if (index >= slots.size()) slots.resize(index + 1, NoSlot);
+                if (slots[index] != NoSlot) {
+                    inserted[slots[index]] = std::move(values[i]);
+                } else if (storage.contains(entity)) {
+                    registry.replace<T>(entity, std::move(values[i]));
+                } else {
+                    slots[index] = static_cast<uint32_t>(resolved.size());
+                    resolved.push_back(entity);
+                    inserted.push_back(std::move(values[i]));
+                }
+            }
+            
+            for (auto entity : resolved) {
+                slots[static_cast<size_t>(entt::to_entity(entity))] = NoSlot;
+            }
+            
+            if constexpr (std::is_empty_v<T>) {
+                storage.insert(resolved.begin(), resolved.end());
+            } else {
+                storage.insert(resolved.begin(), resolved.end(), std::make_move_iterator(inserted.begin()));
+            }
+        }
+        
+        void applyPatches(entt::registry& registry, const entt::entity* created) override {
+            auto& storage = registry.storage<T>();
+            for (auto entity : patches) {
+                entt::entity handle = resolve(entity, created);
+                if (storage.contains(handle)) {
+                    registry.patch<T>(handle);
+                }
+            }
+        }
+        
+        void applyRemovals(entt::registry& registry, const entt::entity* created) override {
+            if (removals.empty()) return;
+            for (size_t i = 0; i < removals.size(); ++i) {
+                entt::entity handle = resolve(removals[i], created);
+                if (registry.valid(handle) && latestOf(lastEmplace, handle) < removalOrder[i]) {
+                    registry.remove<T>(handle);
+                }
+            }
+            
+            for (auto entity : entities) {
+                untrack(lastEmplace, resolve(entity, created));
+            }
+            for (auto entity : removals) {
+                untrack(lastRemoval, resolve(entity, created));
+            }
+        }
+        
+        void clear() override {
+            entities.clear();
+            values.clear();
+            removals.clear();
+            patches.clear();
+            emplaceOrder.clear();
+            removalOrder.clear();
+        }
+    };
+    
+    template<typename T>
+    Batch<T>& getBatch() {
+        const entt::id_type type = entt::type_hash<T>::value();
+        for (auto& batch : m_batches) {
+            if (batch->type == type) return static_cast<Batch<T>&>(*batch);
+        }
+        auto batch = std::make_unique<Batch<T>>();
+        batch->type = type;
+        m_batches.push_back(std::move(batch));
+        return static_cast<Batch<T>&>(*m_batches.back());
+    }
+    
+    uint32_t m_createCount = 0;
+    std::vector<CommandEntity> m_destroyed;
+    std::vector<std::unique_ptr<BatchBase>> m_batches;
+    size_t m_commandCount = 0;
+};
+
+struct CommandPlaybackStats {
+    uint32_t created = 0;
+    uint32_t destroyed = 0;
+    size_t commands = 0;
+    float timeMs = 0.0f;
+};
+
+// One CommandBuffer per recording thread. Playback happens at a sync point on
+// a single thread in five bulk phases across all buffers: create, emplace
+// (with each pool reserved once up front), patch, remove, destroy. Emplaces
+// and removes that cancel out within a buffer are settled in recorded order
+// first, so the phases only differ from in-order playback in the signals
+// raised: a remove followed by an emplace replaces the component. Buffers of
+// different threads have no order between them.
+class CommandQueue {
+public:
+    CommandQueue();
+    
+    CommandQueue(const CommandQueue&) = delete;
+    CommandQueue& operator=(const CommandQueue&) = delete;
+    
+    CommandBuffer& local();
+    
+    CommandPlaybackStats playback(entt::registry& registry);
+    const CommandPlaybackStats& getLastPlaybackStats() const { return m_lastStats; }
+
+private:
+    // Lets each thread's buffer list notice when this queue is gone.
+    std::shared_ptr<char> m_lifetime;
+    std::mutex m_mutex;
+    std::vector<std::unique_ptr<CommandBuffer>> m_buffers;
+    std::vector<entt::entity> m_created;
+    std::vector<std::pair<CommandBuffer::BatchBase*, size_t>> m_reservations;
+    CommandPlaybackStats m_lastStats;
+};
+
+}
@@ -6,4 +6,82 @@ Entity::Entity(entt::entity handle, Scene* scene)
     : m_handle(handle), m_scene(scene) {
 }
 
+void Entity::setPosition(const glm::vec3& position) {
+    auto& transform = getComponent<TransformComponent>();
+    if (transform.position == position) return;
+    
+    transform.position = position;
+    m_scene->transformChanged(m_handle);
+    markChanged(Property::Position);
+}
+
+void Entity::setRotation(const glm::vec3& rotation) {
+    auto& transform = getComponent<TransformComponent>();
+    if (transform.rotation == rotation) return;
+    
+    transform.rotation = rotation;
+    m_scene->transformChanged(m_handle);
+    markChanged(Property::Rotation);
+}
+
+void Entity::setScale(const glm::vec3& scale) {
+    auto& transform = getComponent<TransformComponent>();
+    if (transform.scale == scale) return;
+    
+    transform.scale = scale;
+    m_scene->transformChanged(m_handle);
+    markChanged(Property::Scale);
+}
+
+void Entity::setName(const std::string& name) {
+    auto& component = getComponent<NameComponent>();
+    const core::StringId id(name);
+    if (component.name == id) return;
+    
+    component.name = id;
+    markChanged(Property::Name);
+}
+
+// Visibility, shadow casting and static flags decide what the cached static
+// shadow cascades hold, so changing them on a static part, or changing the
+// static flag itself, rebuilds the static geometry.
+void Entity::setVisible(bool visible) {
+    auto& meshRenderer = getComponent<MeshRendererComponent>();
+    if (meshRenderer.visible == visible) return;
+    
+    meshRenderer.visible = visible;
+    if (meshRenderer.isStatic) m_scene->markStaticGeometryDirty();
+    markChanged(Property::Visible);
+}
+
+void Entity::setCastShadows(bool castShadows) {
+    auto& meshRenderer = getComponent<MeshRendererComponent>();
+    if (meshRenderer.castShadows == castShadows) return;
+    
+    meshRenderer.castShadows = castShadows;
+    if (meshRenderer.isStatic) m_scene->markStaticGeometryDirty();
+    markChanged(Property::CastShadows);
+}
+
+void Entity::setReceiveShadows(bool receiveShadows) {
+    auto& meshRenderer = getComponent<MeshRendererComponent>();
+    if (meshRenderer.receiveShadows == receiveShadows) return;
+    
+    meshRenderer.receiveShadows = receiveShadows;
+    markChanged(Property::ReceiveShadows);
+}
+
+void Entity::setStatic(bool isStatic) {
+    auto& meshRenderer = getComponent<MeshRendererComponent>();
+    if (meshRenderer.isStatic == isStatic) return;
+    
+    meshRenderer.isStatic = isStatic;
+    m_scene->markStaticGeometryDirty();
+    markChanged(Property::Static);
+}
+
+void Entity::markChanged(Property property) {
+    m_scene->m_changes.mark(m_handle, property);
+}
+
 }
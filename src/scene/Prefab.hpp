@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Scene.hpp"
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace roblox_clone::scene {
+
+struct PrefabSpawnStats {
+    size_t instanceCount = 0;
+    size_t entityCount = 0;
+    float reserveMs = 0.0f;
+    float insertMs = 0.0f;
+};
+
+// A model captured once and stamped out many times. Parts keep the components
+// scene files keep, and every instance gets plain copies of them: names and
+// paths are interned ids, so spawning allocates no strings and writing a field
+// of one instance changes only that instance.
+//
+// Part positions are stored relative to the capture origin and instances are
+// placed by translation alone.
+class Prefab {
+public:
+    Prefab() = default;
+    
+    // Captures the given entities, in order, as the prefab's parts.
+    static Prefab capture(const Scene& scene, const std::vector<entt::entity>& entities,
+                          const glm::vec3& origin = glm::vec3(0.0f));
+    // Captures every entity of a scene file.
+    bool load(const std::string& filepath, const glm::vec3& origin = glm::vec3(0.0f));
+    
+    size_t getPartCount() const { return m_partCount; }
+    bool empty() const { return m_partCount == 0; }
+    
+    // Adds one instance per position. Entity capacity and every storage are
+    // reserved once for the whole batch. created receives the new entities
+    // instance by instance, parts in capture order.
+    void instantiate(Scene& scene, const std::vector<glm::vec3>& positions,
+                     std::vector<entt::entity>* created = nullptr, PrefabSpawnStats* stats = nullptr) const;
+    std::vector<entt::entity> instantiate(Scene& scene, const glm::vec3& position) const;
+
+private:
+    // The parts that have Component, as part indices and values.
+    template<typename Component>
+    struct Parts {
+        std::vector<uint32_t> indices;
+        std::vector<Component> values;
+    };
+    
+    template<typename Func>
+    void forEachParts(Func&& func) const {
+        func(m_transforms);
+        func(m_names);
+        func(m_meshRenderers);
+        func(m_scripts);
+        func(m_networks);
+    }
+    
+    size_t m_partCount = 0;
+    Parts<TransformComponent> m_transforms;
+    Parts<NameComponent> m_names;
+    Parts<MeshRendererComponent> m_meshRenderers;
+    Parts<ScriptComponent> m_scripts;
+    Parts<NetworkComponent> m_networks;
+};
+
+}
@@ -0,0 +1,134 @@
+#include "PropertyReplication.hpp"
+#include "Entity.hpp"
+#include "core/Profiler.hpp"
+#include <cstring>
+
+namespace roblox_clone::scene {
+
+namespace {
+
+constexpr Property VectorProperties[] = { Property::Position, Property::Rotation, Property::Scale };
+constexpr Property FlagProperties[] = { Property::Visible, Property::CastShadows, Property::ReceiveShadows,
+                                        Property::Static };
+constexpr PropertyMask FlagMask = propertyBit(Property::Visible) | propertyBit(Property::CastShadows) |
+                                  propertyBit(Property::ReceiveShadows) | propertyBit(Property::Static);
+
+static_assert(static_cast<size_t>(Property::Count) <= 8, "Property bits are sent as one byte");
+
+const glm::vec3& getVector(const TransformComponent& transform, Property property) {
+    switch (property) {
+        case Property::Position: return transform.position;
+        case Property::Rotation: return transform.rotation;
+        default: return transform.scale;
+    }
+}
+
+bool getFlag(const MeshRendererComponent& meshRenderer, Property property) {
+    switch (property) {
+        case Property::Visible: return meshRenderer.visible;
+        case Property::CastShadows: return meshRenderer.castShadows;
+        case Property::ReceiveShadows: return meshRenderer.receiveShadows;
+        default: return meshRenderer.isStatic;
+    }
+}
+
+void setVector(Entity& entity, Property property, const glm::vec3& value) {
+    switch (property) {
+        case Property::Position: entity.setPosition(value); break;
+        case Property::Rotation: entity.setRotation(value); break;
+        default: entity.setScale(value); break;
+    }
+}
+
+void setFlag(Entity& entity, Property property, bool value) {
+    switch (property) {
+        case Property::Visible: entity.setVisible(value); break;
+        case Property::CastShadows: entity.setCastShadows(value); break;
+        case Property::ReceiveShadows: entity.setReceiveShadows(value); break;
+        default: entity.setStatic(value); break;
+    }
+}
+
+}
+
+uint32_t writePropertyChanges(const entt::registry& registry, const ChangeBatch& batch, std::vector<uint8_t>& out) {
+    RC_PROFILE_SCOPE("writePropertyChanges");
+    uint32_t count = 0;
+    for (size_t i = 0; i < batch.count; ++i) {
+        const entt::entity entity = batch.entities[i];
+        const auto* network = registry.try_get<NetworkComponent>(entity);
+        if (!network || !network->isReplicated) continue;
+        
+        const auto* transform = registry.try_get<TransformComponent>(entity);
+        const auto* meshRenderer = registry.try_get<MeshRendererComponent>(entity);
+        PropertyMask properties = batch.properties[i] & ReplicatedProperties;
+        if (!transform) properties &= FlagMask;
+        if (!meshRenderer) properties &= ~FlagMask;
+        if (properties == 0) continue;
+        
+        size_t offset = out.size();
+        out.resize(offset + sizeof(uint32_t) + sizeof(uint8_t) + sizeof(float) * 9 + sizeof(uint8_t));
+        memcpy(&out[offset], &network->networkId, sizeof(uint32_t));
+        offset += sizeof(uint32_t);
+        out[offset++] = static_cast<uint8_t>(properties);
+        for (Property property : VectorProperties) {
+            if ((properties & propertyBit(property)) == 0) continue;
+            memcpy(&out[offset], &getVector(*transform, property), sizeof(float) * 3);
+            offset += sizeof(float) * 3;
+        }
+        if (properties & FlagMask) {
+            uint8_t flags = 0;
+            for (Property property : FlagProperties) {
+                if (getFlag(*meshRenderer, property)) flags |= static_cast<uint8_t>(propertyBit(property));
+            }
+            out[offset++] = flags;
+        }
+        out.resize(offset);
+        ++count;
+    }
+    return count;
+}
+
+bool applyPropertyChanges(Scene& scene, const uint8_t* data, size_t size, uint32_t count) {
+    RC_PROFILE_SCOPE("applyPropertyChanges");
+    size_t offset = 0;
+    for (uint32_t record = 0; record < count; ++record) {
+        if (size - offset < sizeof(uint32_t) + sizeof(uint8_t)) return false;
+        uint32_t networkId = 0;
+        memcpy(&networkId, data + offset, sizeof(uint32_t));
+        offset += sizeof(uint32_t);
+        const PropertyMask properties = data[offset++];
+        
+        size_t recordSize = 0;
+        for (Property property : VectorProperties) {
+            if (properties & propertyBit(property)) recordSize += sizeof(float) * 3;
+        }
+        if (properties & FlagMask) recordSize += sizeof(uint8_t);
+        if (size - offset < recordSize) return false;
+        
+        const uint8_t* values = data + offset;
+        offset += recordSize;
+        const entt::entity handle = scene.findNetworkEntity(networkId);
+        if (handle == entt::null) continue;
+        
+        Entity entity(handle, &scene);
+        if (entity.hasComponent<TransformComponent>()) {
+            for (Property property : VectorProperties) {
+                if ((properties & propertyBit(property)) == 0) continue;
+                glm::vec3 value;
+                memcpy(&value, values, sizeof(float) * 3);
+                values += sizeof(float) * 3;
+                setVector(entity, property, value);
+            }
+        }
+        if ((properties & FlagMask) && entity.hasComponent<MeshRendererComponent>()) {
+            const uint8_t flags = data[offset - 1];
+            for (Property property : FlagProperties) {
+                if (properties & propertyBit(property)) setFlag(entity, property, (flags & propertyBit(property)) != 0);
+            }
+        }
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "ChangeTracker.hpp"
+#include <entt/entt.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace roblox_clone::scene {
+
+class Scene;
+
+// Properties the server replicates. Names are strings and are not sent.
+constexpr PropertyMask ReplicatedProperties =
+    propertyBit(Property::Position) | propertyBit(Property::Rotation) | propertyBit(Property::Scale) |
+    propertyBit(Property::Visible) | propertyBit(Property::CastShadows) | propertyBit(Property::ReceiveShadows) |
+    propertyBit(Property::Static);
+
+// Change records of entities with a replicated NetworkComponent. A record is a
+// uint32 network id and a byte of Property bits, followed by three floats for
+// each of Position, Rotation and Scale that is set, then, if any mesh renderer
+// property is set, one byte holding their values at the same bits. Appends to
+// out and returns the number of records written.
+uint32_t writePropertyChanges(const entt::registry& registry, const ChangeBatch& batch, std::vector<uint8_t>& out);
+
+// Applies count records through the Entity setters, so the receiving scene
+// raises its own change events. Records for unknown network ids or missing
+// components are skipped. Returns false if the data ends inside a record.
+bool applyPropertyChanges(Scene& scene, const uint8_t* data, size_t size, uint32_t count);
+
+}
@@ -0,0 +1,254 @@
+#include "RaycastService.hpp"
+#include "Scene.hpp"
+#include "core/JobSystem.hpp"
+#include "core/Profiler.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace roblox_clone::scene {
+
+namespace {
+
+constexpr float ParallelEpsilon = 1.0e-8f;
+constexpr float ContactEpsilon = 1.0e-3f;
+constexpr int MaxAdvanceSteps = 64;
+
+// Slab test against a box grown by margin. entry is negative when the ray
+// starts inside the box.
+bool intersectObb(const Obb& box, const glm::vec3& origin, const glm::vec3& direction, float margin,
+                  float& entry, glm::vec3& normal) {
+    const glm::vec3 offset = origin - box.center;
+    entry = -std::numeric_limits<float>::infinity();
+    float exit = std::numeric_limits<float>::infinity();
+    int entryAxis = 0;
+    float entrySign = -1.0f;
+    
+    for (int axis = 0; axis < 3; ++axis) {
+        const float start = glm::dot(box.axes[axis], offset);
+        const float speed = glm::dot(box.axes[axis], direction);
+        const float halfExtent = box.halfExtents[axis] + margin;
+        
+        if (std::abs(speed) < ParallelEpsilon) {
+            if (std::abs(start) > halfExtent) return false;
+            continue;
+        }
+        
+        float nearT = (-halfExtent - start) / speed;
+        float farT = (halfExtent - start) / speed;
+        float sign = -1.0f;
+        if (nearT > farT) {
+            std::swap(nearT, farT);
+            sign = 1.0f;
+        }
+        if (nearT > entry) {
+            entry = nearT;
+            entryAxis = axis;
+            entrySign = sign;
+        }
+        exit = std::min(exit, farT);
+        if (entry > exit) return false;
+    }
+    
+    if (exit < 0.0f) return false;
+    normal = box.axes[entryAxis] * entrySign;
+    return true;
+}
+
+}
+
+Obb Obb::fromTransform(const TransformComponent& transform) {
+    glm::mat4 rotation = glm::rotate(glm::mat4(1.0f), glm::radians(transform.rotation.x), glm::vec3(1, 0, 0));
+    rotation = glm::rotate(rotation, glm::radians(transform.rotation.y), glm::vec3(0, 1, 0));
+    rotation = glm::rotate(rotation, glm::radians(transform.rotation.z), glm::vec3(0, 0, 1));
+    
+    Obb box;
+    box.center = transform.position;
+    for (int axis = 0; axis < 3; ++axis) {
+        box.axes[axis] = glm::vec3(rotation[axis]);
+    }
+    box.halfExtents = glm::abs(transform.scale) * 0.5f;
+    return box;
+}
+
+Aabb Obb::getBounds() const {
+    glm::vec3 extent(0.0f);
+    for (int axis = 0; axis < 3; ++axis) {
+        extent += glm::abs(axes[axis]) * halfExtents[axis];
+    }
+    return Aabb::fromCenter(center, extent);
+}
+
+glm::vec3 Obb::closestPoint(const glm::vec3& point) const {
+    const glm::vec3 offset = point - center;
+    glm::vec3 result = center;
+    for (int axis = 0; axis < 3; ++axis) {
+        const float distance = glm::clamp(glm::dot(offset, axes[axis]), -halfExtents[axis], halfExtents[axis]);
+        result += axes[axis] * distance;
+    }
+    return result;
+}
+
+RaycastService::RaycastService(const RaycastSettings& settings)
+    : m_settings(settings) {
+}
+
+void RaycastService::sync(Scene& scene) {
+    const uint64_t layoutVersion = scene.getPartLayoutVersion();
+    const uint64_t motionVersion = scene.getPartMotionVersion();
+    if (layoutVersion == m_layoutVersion && motionVersion == m_motionVersion) return;
+    
+    RC_PROFILE_SCOPE("RaycastService::sync");
+    auto start = std::chrono::steady_clock::now();
+    if (layoutVersion != m_layoutVersion || m_refitsSinceRebuild >= m_settings.refitsBeforeRebuild) {
+        rebuild(scene);
+    } else {
+        refit(scene);
+    }
+    m_layoutVersion = layoutVersion;
+    m_motionVersion = motionVersion;
+    m_stats.lastUpdateMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void RaycastService::clear() {
+    m_bvh.clear();
+    m_entities.clear();
+    m_boxes.clear();
+    m_bounds.clear();
+    m_layoutVersion = ~uint64_t(0);
+    m_motionVersion = ~uint64_t(0);
+    m_stats.partCount = 0;
+    m_stats.nodeCount = 0;
+}
+
+RaycastResult RaycastService::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                                      const RaycastParams& params) const {
+    RaycastResult result;
+    const float length = glm::length(direction);
+    if (length <= 0.0f || maxDistance <= 0.0f) return result;
+    
+    const BvhRay ray(origin, direction / length, maxDistance);
+    m_bvh.traverse(ray, 0.0f, [&](uint32_t slot, float& closest) {
+        float distance = 0.0f;
+        glm::vec3 normal;
+        // Parts the ray starts inside are not hit.
+        if (!intersectObb(m_boxes[slot], ray.origin, ray.direction, 0.0f, distance, normal)) return;
+        if (distance < 0.0f || distance > closest || isIgnored(m_entities[slot], params)) return;
+        
+        closest = distance;
+        result.entity = m_entities[slot];
+        result.distance = distance;
+        result.normal = normal;
+    });
+    
+    if (result) {
+        result.position = ray.origin + ray.direction * result.distance;
+    }
+    return result;
+}
+
+RaycastResult RaycastService::spherecast(const glm::vec3& origin, float radius, const glm::vec3& direction,
+                                         float maxDistance, const RaycastParams& params) const {
+    if (radius <= 0.0f) return raycast(origin, direction, maxDistance, params);
+    
+    RaycastResult result;
+    const float length = glm::length(direction);
+    if (length <= 0.0f || maxDistance <= 0.0f) return result;
+    
+    const BvhRay ray(origin, direction / length, maxDistance);
+    m_bvh.traverse(ray, radius, [&](uint32_t slot, float& closest) {
+        const Obb& box = m_boxes[slot];
+        float distance = 0.0f;
+        glm::vec3 normal;
+        if (!intersectObb(box, ray.origin, ray.direction, radius, distance, normal)) return;
+        if (distance > closest || isIgnored(m_entities[slot], params)) return;
+        
+        // The grown box overestimates near edges and corners, so advance from
+        // its entry point until the sphere actually touches the box. Parts the
+        // sphere already overlaps at the origin are not hit.
+        if (distance < 0.0f) {
+            if (glm::length(ray.origin - box.closestPoint(ray.origin)) <= radius) return;
+            distance = 0.0f;
+        }
+        for (int step = 0; step < MaxAdvanceSteps && distance <= closest; ++step) {
+            const glm::vec3 center = ray.origin + ray.direction * distance;
+            const glm::vec3 contact = box.closestPoint(center);
+            const float gap = glm::length(center - contact) - radius;
+            if (gap <= ContactEpsilon) {
+                closest = distance;
+                result.entity = m_entities[slot];
+                result.distance = distance;
+                result.position = contact;
+                result.normal = gap + radius > 1.0e-6f ? (center - contact) / (gap + radius) : -ray.direction;
+                return;
+            }
+            distance += gap;
+        }
+    });
+    return result;
+}
+
+void RaycastService::raycastBatch(const RaycastRay* rays, RaycastResult* results, size_t count,
+                                  const RaycastParams& params) const {
+    RC_PROFILE_SCOPE("RaycastService::raycastBatch");
+    core::JobSystem::get().parallelFor(count, [this, rays, results, &params](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            results[i] = raycast(rays[i].origin, rays[i].direction, rays[i].maxDistance, params);
+        }
+    }, PacketSize);
+}
+
+bool RaycastService::isIgnored(entt::entity entity, const RaycastParams& params) const {
+    for (entt::entity ignored : params.ignore) {
+        if (ignored == entity) return true;
+    }
+    return false;
+}
+
+void RaycastService::rebuild(Scene& scene) {
+    std::vector<entt::entity> entities;
+    std::vector<Obb> boxes;
+    std::vector<Aabb> bounds;
+    auto parts = scene.renderables();
+    entities.reserve(parts.size());
+    boxes.reserve(parts.size());
+    bounds.reserve(parts.size());
+    for (auto [entity, transform, meshRenderer] : parts.each()) {
+        (void)meshRenderer;
+        entities.push_back(entity);
+        boxes.push_back(Obb::fromTransform(transform));
+        bounds.push_back(boxes.back().getBounds());
+    }
+    
+    m_bvh.build(bounds);
+    
+    const auto& order = m_bvh.getOrder();
+    m_entities.resize(order.size());
+    m_boxes.resize(order.size());
+    m_bounds.resize(order.size());
+    for (size_t slot = 0; slot < order.size(); ++slot) {
+        m_entities[slot] = entities[order[slot]];
+        m_boxes[slot] = boxes[order[slot]];
+        m_bounds[slot] = bounds[order[slot]];
+    }
+    
+    m_refitsSinceRebuild = 0;
+    ++m_stats.rebuildCount;
+    m_stats.partCount = m_entities.size();
+    m_stats.nodeCount = m_bvh.getNodeCount();
+}
+
+void RaycastService::refit(Scene& scene) {
+    const auto& transforms = scene.registry().storage<TransformComponent>();
+    for (size_t slot = 0; slot < m_entities.size(); ++slot) {
+        m_boxes[slot] = Obb::fromTransform(transforms.get(m_entities[slot]));
+        m_bounds[slot] = m_boxes[slot].getBounds();
+    }
+    m_bvh.refit(m_bounds);
+    
+    ++m_refitsSinceRebuild;
+    ++m_stats.refitCount;
+}
+
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "Bvh.hpp"
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace roblox_clone::scene {
+
+class Scene;
+struct TransformComponent;
+
+// Oriented box of a part; axes are unit length.
+struct Obb {
+    glm::vec3 center = glm::vec3(0.0f);
+    glm::vec3 axes[3] = { glm::vec3(1, 0, 0), glm::vec3(0, 1, 0), glm::vec3(0, 0, 1) };
+    glm::vec3 halfExtents = glm::vec3(0.5f);
+    
+    static Obb fromTransform(const TransformComponent& transform);
+    Aabb getBounds() const;
+    glm::vec3 closestPoint(const glm::vec3& point) const;
+};
+
+struct RaycastParams {
+    // Parts the cast passes through, such as the character that fired it.
+    std::vector<entt::entity> ignore;
+};
+
+struct RaycastResult {
+    entt::entity entity = entt::null;
+    glm::vec3 position = glm::vec3(0.0f);
+    glm::vec3 normal = glm::vec3(0.0f);
+    float distance = 0.0f;
+    
+    explicit operator bool() const { return entity != entt::null; }
+};
+
+struct RaycastRay {
+    glm::vec3 origin = glm::vec3(0.0f);
+    glm::vec3 direction = glm::vec3(0.0f, 0.0f, -1.0f);
+    float maxDistance = 1000.0f;
+};
+
+struct RaycastSettings {
+    // Refitting keeps the tree topology, which degrades as parts drift apart;
+    // rebuild after this many refits in a row.
+    uint32_t refitsBeforeRebuild = 120;
+};
+
+struct RaycastStats {
+    size_t partCount = 0;
+    size_t nodeCount = 0;
+    uint64_t rebuildCount = 0;
+    uint64_t refitCount = 0;
+    float lastUpdateMs = 0.0f;
+};
+
+// Ray and sphere casts against parts (entities with a transform and a mesh
+// renderer) through a four-wide BVH. sync() rebuilds the tree after parts were
+// added or removed and refits it after they moved. Casts are const and may run
+// from jobs between syncs.
+class RaycastService {
+public:
+    static constexpr size_t PacketSize = 64;
+    
+    explicit RaycastService(const RaycastSettings& settings = {});
+    
+    RaycastService(const RaycastService&) = delete;
+    RaycastService& operator=(const RaycastService&) = delete;
+    
+    void sync(Scene& scene);
+    void clear();
+    
+    // direction does not need to be normalized.
+    RaycastResult raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                          const RaycastParams& params = {}) const;
+    RaycastResult spherecast(const glm::vec3& origin, float radius, const glm::vec3& direction, float maxDistance,
+                             const RaycastParams& params = {}) const;
+    
+    // Splits the rays into packets of PacketSize that run as jobs on the job
+    // system; results[i] answers rays[i].
+    void raycastBatch(const RaycastRay* rays, RaycastResult* results, size_t count,
+                      const RaycastParams& params = {}) const;
+    
+    void setSettings(const RaycastSettings& settings) { m_settings = settings; }
+    const RaycastSettings& getSettings() const { return m_settings; }
+    const RaycastStats& getStats() const { return m_stats; }
+
+private:
+    bool isIgnored(entt::entity entity, const RaycastParams& params) const;
+    void rebuild(Scene& scene);
+    void refit(Scene& scene);
+    
+    RaycastSettings m_settings;
+    RaycastStats m_stats;
+    Bvh4 m_bvh;
+    
+    // Stored in BVH slot order.
+    std::vector<entt::entity> m_entities;
+    std::vector<Obb> m_boxes;
+    std::vector<Aabb> m_bounds;
+    
+    uint64_t m_layoutVersion = ~uint64_t(0);
+    uint64_t m_motionVersion = ~uint64_t(0);
+    uint32_t m_refitsSinceRebuild = 0;
+};
+
+}
@@ -1,9 +1,40 @@
 #include "Scene.hpp"
 #include "Entity.hpp"
+#include "core/Profiler.hpp"
+#include <algorithm>
 
 namespace roblox_clone::scene {
 
+namespace {
+
+constexpr uint64_t FnvOffset = 14695981039346656037ull;
+constexpr uint64_t FnvPrime = 1099511628211ull;
+
+uint64_t hashBytes(uint64_t hash, const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * FnvPrime;
+    }
+    return hash;
+}
+
+}
+
 Scene::Scene() {
+    m_registry.on_construct<MeshRendererComponent>().connect<&Scene::onMeshRendererChanged>(this);
+    m_registry.on_update<MeshRendererComponent>().connect<&Scene::onMeshRendererChanged>(this);
+    m_registry.on_destroy<MeshRendererComponent>().connect<&Scene::onMeshRendererRemoved>(this);
+    renderables();
+    
+    m_registry.on_construct<TransformComponent>().connect<&Scene::onPartAdded>(this);
+    m_registry.on_update<TransformComponent>().connect<&Scene::onPartChanged>(this);
+    m_registry.on_destroy<TransformComponent>().connect<&Scene::onPartRemoved>(this);
+    m_registry.on_construct<MeshRendererComponent>().connect<&Scene::onPartAdded>(this);
+    m_registry.on_destroy<MeshRendererComponent>().connect<&Scene::onPartRemoved>(this);
+    
+    m_registry.on_construct<NetworkComponent>().connect<&Scene::onNetworkChanged>(this);
+    m_registry.on_update<NetworkComponent>().connect<&Scene::onNetworkChanged>(this);
+    m_registry.on_destroy<NetworkComponent>().connect<&Scene::onNetworkRemoved>(this);
 }
 
 Entity Scene::createEntity(const std::string& name) {
@@ -17,10 +48,23 @@ void Scene::destroyEntity(Entity entity) {
     m_registry.destroy(entity);
 }
 
+void Scene::clear() {
+    m_registry.clear();
+    m_changes.clear();
+    m_networkEntities.clear();
+    m_unindexedNetworkEntities.clear();
+    m_staticParts.clear();
+    m_mainCamera = entt::null;
+}
+
 Entity Scene::getEntityByName(const std::string& name) {
+    // Text that was never interned names nothing.
+    const core::StringId id = core::StringId::find(name);
+    if (id.empty() && !name.empty()) return {};
+    
     auto view = m_registry.view<NameComponent>();
     for (auto entity : view) {
-        if (view.get<NameComponent>(entity).name == name) {
+        if (view.get<NameComponent>(entity).name == id) {
             return { entity, this };
         }
     }
@@ -28,11 +72,172 @@ Entity Scene::getEntityByName(const std::string& name) {
 }
 
 void Scene::update(float deltaTime) {
-    (void)deltaTime;
+    RC_PROFILE_SCOPE("Scene::update");
+    m_scheduler.execute(*this, m_registry, deltaTime);
+    // Systems report the transforms they wrote as patch commands, which land
+    // in onPartChanged here, so only those parts are re-binned.
+    flushCommands();
+    updateSpatialHash();
+}
+
+void Scene::beginSimulationStep() {
+    RC_PROFILE_SCOPE("Scene::beginSimulationStep");
+    auto view = m_registry.view<TransformComponent>();
+    auto& previous = m_registry.storage<PreviousTransformComponent>();
+    for (auto entity : view) {
+        const auto& transform = view.get<TransformComponent>(entity);
+        if (previous.contains(entity)) {
+            previous.get(entity).transform = transform;
+        } else {
+            previous.emplace(entity, PreviousTransformComponent{ transform });
+        }
+    }
+    m_steppedParts.clear();
+    m_allPartsStepped = false;
+    m_simulating = true;
+}
+
+void Scene::endSimulationStep() {
+    std::sort(m_steppedParts.begin(), m_steppedParts.end());
+    m_steppedParts.erase(std::unique(m_steppedParts.begin(), m_steppedParts.end()), m_steppedParts.end());
+    m_simulating = false;
 }
 
 void Scene::setMainCamera(Entity camera) {
     m_mainCamera = camera;
 }
 
+Entity Scene::getMainCamera() const {
+    return { m_mainCamera, const_cast<Scene*>(this) };
+}
+
+void Scene::transformChanged(entt::entity entity) {
+    // Edits made outside a simulation step (editor, network snapshots) are
+    // teleports and must not be smeared across the interpolation window.
+    if (!m_simulating) {
+        if (auto* previous = m_registry.try_get<PreviousTransformComponent>(entity)) {
+            previous->transform = m_registry.get<TransformComponent>(entity);
+        }
+    }
+    
+    auto* meshRenderer = m_registry.try_get<MeshRendererComponent>(entity);
+    if (meshRenderer && meshRenderer->isStatic) {
+        markStaticGeometryDirty();
+    }
+    partMoved(entity);
+}
+
+void Scene::markAllTransformsChanged() {
+    m_spatialHash.markAllDirty();
+    m_transformBatch.markAll();
+    m_allPartsStepped = true;
+    ++m_partMotionVersion;
+    m_allTransformsChanged.publish();
+}
+
+const TransformBatch& Scene::updateTransformBatch() {
+    m_transformBatch.sync(m_registry, m_partLayoutVersion);
+    return m_transformBatch.get();
+}
+
+uint64_t Scene::computeStateHash() {
+    RC_PROFILE_SCOPE("Scene::computeStateHash");
+    const auto& transforms = m_registry.storage<TransformComponent>();
+    m_hashOrder.assign(transforms.data(), transforms.data() + transforms.size());
+    std::sort(m_hashOrder.begin(), m_hashOrder.end());
+    
+    // Ranges are hashed in parallel and folded in order; their bounds depend
+    // only on the entity count, so the thread count cannot change the result.
+    const uint64_t count = m_hashOrder.size();
+    return core::JobSystem::get().parallelReduce(m_hashOrder.size(), hashBytes(FnvOffset, &count, sizeof(count)),
+        [this, &transforms](size_t begin, size_t end) {
+            uint64_t hash = FnvOffset;
+            for (size_t i = begin; i < end; ++i) {
+                const entt::entity entity = m_hashOrder[i];
+                const TransformComponent& transform = transforms.get(entity);
+                hash = hashBytes(hash, &entity, sizeof(entity));
+                hash = hashBytes(hash, &transform.position, sizeof(transform.position));
+                hash = hashBytes(hash, &transform.rotation, sizeof(transform.rotation));
+                hash = hashBytes(hash, &transform.scale, sizeof(transform.scale));
+            }
+            return hash;
+        },
+        [](uint64_t hash, uint64_t range) { return hashBytes(hash, &range, sizeof(range)); }, 1024);
+}
+
+void Scene::onMeshRendererChanged(entt::registry& registry, entt::entity entity) {
+    // Only static parts are in the cached shadow cascades. A part that was
+    // static when last seen counts too, so clearing the flag still rebuilds.
+    const bool wasStatic = m_staticParts.contains(entity);
+    const bool isStatic = registry.get<MeshRendererComponent>(entity).isStatic;
+    if (wasStatic || isStatic) {
+        markStaticGeometryDirty();
+    }
+    
+    if (isStatic && !wasStatic) {
+        m_staticParts.push(entity);
+    } else if (wasStatic && !isStatic) {
+        m_staticParts.remove(entity);
+    }
+}
+
+void Scene::onMeshRendererRemoved(entt::registry& registry, entt::entity entity) {
+    if (m_staticParts.remove(entity) || registry.get<MeshRendererComponent>(entity).isStatic) {
+        markStaticGeometryDirty();
+    }
+}
+
+void Scene::onPartAdded(entt::registry& registry, entt::entity entity) {
+    (void)registry;
+    m_spatialHash.markDirty(entity);
+    ++m_partLayoutVersion;
+}
+
+void Scene::onPartChanged(entt::registry& registry, entt::entity entity) {
+    (void)registry;
+    partMoved(entity);
+}
+
+void Scene::onPartRemoved(entt::registry& registry, entt::entity entity) {
+    (void)registry;
+    m_spatialHash.remove(entity);
+    ++m_partLayoutVersion;
+}
+
+void Scene::onNetworkChanged(entt::registry& registry, entt::entity entity) {
+    (void)registry;
+    m_unindexedNetworkEntities.push_back(entity);
+}
+
+void Scene::onNetworkRemoved(entt::registry& registry, entt::entity entity) {
+    const auto found = m_networkEntities.find(registry.get<NetworkComponent>(entity).networkId);
+    if (found != m_networkEntities.end() && found->second == entity) {
+        m_networkEntities.erase(found);
+    }
+}
+
+entt::entity Scene::findNetworkEntity(uint32_t networkId) {
+    for (entt::entity entity : m_unindexedNetworkEntities) {
+        if (const auto* network = m_registry.try_get<NetworkComponent>(entity)) {
+            m_networkEntities[network->networkId] = entity;
+        }
+    }
+    m_unindexedNetworkEntities.clear();
+    
+    // An entry left behind by an id that was patched to another value no
+    // longer matches its entity.
+    const auto found = m_networkEntities.find(networkId);
+    if (found == m_networkEntities.end()) return entt::null;
+    const auto* network = m_registry.try_get<NetworkComponent>(found->second);
+    return network && network->networkId == networkId ? found->second : entt::null;
+}
+
+void Scene::partMoved(entt::entity entity) {
+    m_spatialHash.markDirty(entity);
+    m_transformBatch.markDirty(entity);
+    if (m_simulating) m_steppedParts.push_back(entity);
+    ++m_partMotionVersion;
+    m_transformChanged.publish(entity);
+}
+
 }
@@ -1,9 +1,22 @@
 #pragma once
 
+#include "ChangeTracker.hpp"
+#include "CommandBuffer.hpp"
+#include "RaycastService.hpp"
+#include "SpatialHash.hpp"
+#include "SystemScheduler.hpp"
+#include "TransformBatch.hpp"
+#include "core/JobSystem.hpp"
+#include "core/StringInterner.hpp"
 #include <entt/entt.hpp>
 #include <glm/glm.hpp>
 #include <string>
 #include <functional>
+#include <cstdint>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace roblox_clone::scene {
 
@@ -17,8 +30,16 @@ struct TransformComponent {
     TransformComponent(const glm::vec3& pos) : position(pos) {}
 };
 
+// Transform at the start of the latest simulation step, kept so rendering can
+// interpolate between the last two simulated states.
+struct PreviousTransformComponent {
+    TransformComponent transform;
+};
+
+// Names and asset paths are interned ids; resolve them with str() for UI and
+// files.
 struct NameComponent {
-    std::string name;
+    core::StringId name;
     
     NameComponent() = default;
     NameComponent(const NameComponent&) = default;
@@ -26,18 +47,19 @@ struct NameComponent {
 };
 
 struct MeshRendererComponent {
-    std::string meshPath;
-    std::string materialPath;
+    core::StringId meshPath;
+    core::StringId materialPath;
     bool visible = true;
     bool castShadows = true;
     bool receiveShadows = true;
+    bool isStatic = false;
     
     MeshRendererComponent() = default;
     MeshRendererComponent(const MeshRendererComponent&) = default;
 };
 
 struct ScriptComponent {
-    std::string scriptPath;
+    core::StringId scriptPath;
     bool enabled = true;
     
     ScriptComponent() = default;
@@ -61,6 +83,9 @@ public:
     
     Entity createEntity(const std::string& name = "Entity");
     void destroyEntity(Entity entity);
+    // Destroys every entity, as before opening another scene file. Systems
+    // stay registered.
+    void clear();
     
     Entity getEntityByName(const std::string& name);
     
@@ -74,25 +99,181 @@ public:
         return m_registry.view<Components...>();
     }
     
-    template<typename Func>
+    // Calls func(entity, Components&...) for every entity that has all of
+    // Components, walking the packed storage of the smallest pool. Empty tag
+    // components are matched but not passed. Defaults to TransformComponent.
+    template<typename... Components, typename Func>
     void each(Func&& func) {
-        m_registry.each([&](entt::entity entity) {
-            if (m_registry.all_of<TransformComponent>(entity)) {
-                func(entity, m_registry.get<TransformComponent>(entity));
+        if constexpr (sizeof...(Components) == 0) {
+            each<TransformComponent>(std::forward<Func>(func));
+        } else {
+            m_registry.view<Components...>().each(std::forward<Func>(func));
+        }
+    }
+    
+    // Same contract as each(), with the leading pool split into chunks that
+    // run on the job system. func must only touch the entity it is given and
+    // must not add or remove components; record those through commands(),
+    // along with commands().patch<TransformComponent>() for each part moved.
+    template<typename... Components, typename Func>
+    void parallelEach(Func&& func, size_t minGrain = 256) {
+        if constexpr (sizeof...(Components) == 0) {
+            parallelEach<TransformComponent>(std::forward<Func>(func), minGrain);
+        } else {
+            auto view = m_registry.view<Components...>();
+            const auto* leading = view.handle();
+            if (!leading || leading->empty()) return;
+            
+            const entt::entity* entities = leading->data();
+            core::JobSystem::get().parallelFor(leading->size(), [&view, &func, entities](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    const entt::entity entity = entities[i];
+                    if constexpr (sizeof...(Components) > 1) {
+                        if (!view.contains(entity)) continue;
+                    }
+                    std::apply([&func, entity](auto&... components) { func(entity, components...); },
+                               view.get(entity));
+                }
+            }, minGrain);
+        }
+    }
+    
+    // Transform and MeshRenderer are owned by one group, so both pools keep
+    // renderable entities packed in the same order at the front. Iterating the
+    // group is a linear walk of two arrays with no sparse lookups.
+    auto renderables() {
+        return m_registry.group<TransformComponent, MeshRendererComponent>();
+    }
+    
+    template<typename Func>
+    void eachRenderable(Func&& func) {
+        renderables().each(std::forward<Func>(func));
+    }
+    
+    template<typename Func>
+    void parallelEachRenderable(Func&& func, size_t minGrain = 256) {
+        auto group = renderables();
+        if (group.empty()) return;
+        
+        const entt::entity* entities = group.handle().data();
+        core::JobSystem::get().parallelFor(group.size(), [&group, &func, entities](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const entt::entity entity = entities[i];
+                auto [transform, meshRenderer] = group.get<TransformComponent, MeshRendererComponent>(entity);
+                func(entity, transform, meshRenderer);
             }
-        });
+        }, minGrain);
     }
     
     entt::registry& registry() { return m_registry; }
     const entt::registry& registry() const { return m_registry; }
     
     void update(float deltaTime);
+    
+    SystemScheduler& getScheduler() { return m_scheduler; }
+    
+    // Structural changes recorded from systems, jobs or scripts are applied in
+    // bulk at the end of update(), or earlier with flushCommands().
+    CommandBuffer& commands() { return m_commands.local(); }
+    CommandQueue& getCommandQueue() { return m_commands; }
+    CommandPlaybackStats flushCommands() { return m_commands.playback(m_registry); }
+    
+    // Part bounds for proximity queries. Structural changes, patches and
+    // transformChanged() mark parts dirty; updateSpatialHash() (run at the end
+    // of update()) re-bins them. Query from jobs only between updates.
+    SpatialHash& getSpatialHash() { return m_spatialHash; }
+    const SpatialHash& getSpatialHash() const { return m_spatialHash; }
+    void updateSpatialHash() { m_spatialHash.sync(m_registry); }
+    
+    // Ray and sphere casts against parts. Synced lazily: call updateRaycaster()
+    // before casting, which only rebuilds or refits when parts changed.
+    RaycastService& getRaycaster() { return m_raycaster; }
+    const RaycastService& getRaycaster() const { return m_raycaster; }
+    void updateRaycaster() { m_raycaster.sync(*this); }
+    
+    // Bumped when parts are added or removed, and when any part moves.
+    uint64_t getPartLayoutVersion() const { return m_partLayoutVersion; }
+    uint64_t getPartMotionVersion() const { return m_partMotionVersion; }
+    
+    void beginSimulationStep();
+    void endSimulationStep();
+    bool isSimulating() const { return m_simulating; }
     void setMainCamera(Entity camera);
-    Entity getMainCamera() const { return m_mainCamera; }
+    Entity getMainCamera() const;
+    
+    void transformChanged(entt::entity entity);
+    // For bulk writes that bypass the registry, such as snapshot restores.
+    void markAllTransformsChanged();
+    
+    // Raised for each part passed to transformChanged() or written through
+    // registry.patch() or replace(), and once per markAllTransformsChanged(),
+    // so systems that keep per-part state can follow edits without polling.
+    entt::sink<entt::sigh<void(entt::entity)>> onTransformChanged() { return { m_transformChanged }; }
+    entt::sink<entt::sigh<void()>> onAllTransformsChanged() { return { m_allTransformsChanged }; }
+    
+    // Every TransformComponent as a TransformBatch kept across frames, in the
+    // storage's packed order. An update reloads only the parts reported moved
+    // since the last one, or everything after parts were added or removed.
+    const TransformBatch& updateTransformBatch();
+    const ResidentTransformBatch& getTransformBatch() const { return m_transformBatch; }
+    
+    // Parts written during the current or latest simulation step, each once
+    // after endSimulationStep(): the only ones whose PreviousTransformComponent
+    // can differ from their transform, unless allPartsStepped() says a bulk
+    // write may have moved any part.
+    const std::vector<entt::entity>& getSteppedParts() const { return m_steppedParts; }
+    bool allPartsStepped() const { return m_allPartsStepped; }
+    void markStaticGeometryDirty() { ++m_staticGeometryVersion; }
+    
+    // Property changes made through Entity since the last dispatchChanges(),
+    // which runs at the end of each tick.
+    ChangeTracker& getChangeTracker() { return m_changes; }
+    void dispatchChanges() { m_changes.dispatch(m_registry); }
+    
+    // The entity whose NetworkComponent carries networkId, or entt::null.
+    // Components added or patched since the last lookup are indexed first, so
+    // an id assigned right after emplace is found; an id changed in place
+    // later needs a patch() to be found under its new value.
+    entt::entity findNetworkEntity(uint32_t networkId);
+    
+    // FNV-1a over the bits of every TransformComponent, walked in entity id
+    // order rather than storage order, since the packed order depends on how
+    // the registry was filled. Identical simulations hash identically on any
+    // machine, so peers compare it per tick to catch desyncs.
+    uint64_t computeStateHash();
+    uint64_t getStaticGeometryVersion() const { return m_staticGeometryVersion; }
 
 private:
+    void onMeshRendererChanged(entt::registry& registry, entt::entity entity);
+    void onMeshRendererRemoved(entt::registry& registry, entt::entity entity);
+    void onPartAdded(entt::registry& registry, entt::entity entity);
+    void onPartChanged(entt::registry& registry, entt::entity entity);
+    void onPartRemoved(entt::registry& registry, entt::entity entity);
+    void onNetworkChanged(entt::registry& registry, entt::entity entity);
+    void onNetworkRemoved(entt::registry& registry, entt::entity entity);
+    void partMoved(entt::entity entity);
+    
     entt::registry m_registry;
-    Entity m_mainCamera;
+    SystemScheduler m_scheduler;
+    CommandQueue m_commands;
+    SpatialHash m_spatialHash;
+    RaycastService m_raycaster;
+    ResidentTransformBatch m_transformBatch;
+    std::vector<entt::entity> m_steppedParts;
+    bool m_allPartsStepped = false;
+    ChangeTracker m_changes;
+    // Parts whose mesh renderer was static at its latest signal.
+    entt::sparse_set m_staticParts;
+    std::unordered_map<uint32_t, entt::entity> m_networkEntities;
+    std::vector<entt::entity> m_unindexedNetworkEntities;
+    entt::sigh<void(entt::entity)> m_transformChanged;
+    entt::sigh<void()> m_allTransformsChanged;
+    uint64_t m_partLayoutVersion = 0;
+    uint64_t m_partMotionVersion = 0;
+    entt::entity m_mainCamera = entt::null;
+    uint64_t m_staticGeometryVersion = 0;
+    bool m_simulating = false;
+    std::vector<entt::entity> m_hashOrder;
     
     friend class Entity;
 };
@@ -122,6 +303,19 @@ public:
         m_scene->m_registry.remove<T>(m_handle);
     }
     
+    // Tracked writes: each marks its property changed for the end-of-tick
+    // change events, unless the value is the same. Writes through
+    // getComponent() are not seen; follow them with markChanged().
+    void setPosition(const glm::vec3& position);
+    void setRotation(const glm::vec3& rotation);
+    void setScale(const glm::vec3& scale);
+    void setName(const std::string& name);
+    void setVisible(bool visible);
+    void setCastShadows(bool castShadows);
+    void setReceiveShadows(bool receiveShadows);
+    void setStatic(bool isStatic);
+    void markChanged(Property property);
+    
     operator bool() const { return m_handle != entt::null && m_scene; }
     operator entt::entity() const { return m_handle; }
     
@@ -0,0 +1,755 @@
+#include "SceneFile.hpp"
+#include "Scene.hpp"
+#include "core/Logger.hpp"
+#include "core/MappedFile.hpp"
+#include "core/Profiler.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace roblox_clone::scene {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+float elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+}
+
+constexpr char Magic[4] = { 'R', 'C', 'S', 'N' };
+constexpr uint32_t Version = 1;
+constexpr size_t DecodeGrain = 4096;
+
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t entityCount;
+    uint64_t stringTableOffset;
+    uint32_t chunkCount;
+    uint32_t stringCount;
+};
+
+struct ChunkEntry {
+    uint32_t tag;
+    uint32_t recordSize;
+    uint64_t count;
+    uint64_t offset;
+};
+
+struct TransformRecord {
+    float position[3];
+    float rotation[3];
+    float scale[3];
+};
+
+struct NameRecord {
+    uint32_t name;
+};
+
+struct MeshRendererRecord {
+    uint32_t meshPath;
+    uint32_t materialPath;
+    uint32_t flags;
+};
+
+struct ScriptRecord {
+    uint32_t scriptPath;
+    uint32_t enabled;
+};
+
+struct NetworkRecord {
+    uint32_t networkId;
+    uint32_t flags;
+};
+
+constexpr uint32_t makeTag(const char (&name)[5]) {
+    return uint32_t(uint8_t(name[0])) | uint32_t(uint8_t(name[1])) << 8 |
+           uint32_t(uint8_t(name[2])) << 16 | uint32_t(uint8_t(name[3])) << 24;
+}
+
+constexpr uint64_t alignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Entity indices of a chunk take four bytes each and its records start on the
+// next eight byte boundary.
+constexpr uint64_t recordsOffset(uint64_t count) {
+    return alignUp(count * sizeof(uint32_t), 8);
+}
+
+template<typename T>
+void append(std::vector<uint8_t>& buffer, const T& value) {
+    const size_t offset = buffer.size();
+    buffer.resize(offset + sizeof(T));
+    std::memcpy(buffer.data() + offset, &value, sizeof(T));
+}
+
+template<typename T>
+T read(const uint8_t* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+// Strings are deduplicated by interned id, so a thousand parts sharing a mesh
+// store its path once and only resolve it once.
+class StringTableWriter {
+public:
+    uint32_t add(core::StringId value) {
+        auto [it, inserted] = m_ids.try_emplace(value.value(), static_cast<uint32_t>(m_offsets.size()));
+        if (inserted) {
+            const std::string& text = value.str();
+            m_offsets.push_back(static_cast<uint32_t>(m_chars.size()));
+            m_chars.insert(m_chars.end(), text.begin(), text.end());
+        }
+        return it->second;
+    }
+    
+    uint32_t count() const { return static_cast<uint32_t>(m_offsets.size()); }
+    
+    void write(std::vector<uint8_t>& buffer) const {
+        for (uint32_t offset : m_offsets) {
+            append(buffer, offset);
+        }
+        append(buffer, static_cast<uint32_t>(m_chars.size()));
+        buffer.insert(buffer.end(), m_chars.begin(), m_chars.end());
+    }
+
+private:
+    std::unordered_map<uint32_t, uint32_t> m_ids;
+    std::vector<uint32_t> m_offsets;
+    std::vector<char> m_chars;
+};
+
+// Each string of a file is interned once when the file is read.
+struct StringTable {
+    std::vector<core::StringId> values;
+    
+    bool get(uint32_t id, core::StringId& out) const {
+        if (id >= values.size()) return false;
+        out = values[id];
+        return true;
+    }
+};
+
+template<typename Component>
+struct Codec;
+
+template<>
+struct Codec<TransformComponent> {
+    static constexpr uint32_t Tag = makeTag("XFRM");
+    using Record = TransformRecord;
+    
+    static Record encode(const TransformComponent& transform, StringTableWriter&) {
+        Record record;
+        for (int i = 0; i < 3; ++i) {
+            record.position[i] = transform.position[i];
+            record.rotation[i] = transform.rotation[i];
+            record.scale[i] = transform.scale[i];
+        }
+        return record;
+    }
+    
+    static bool decode(const Record& record, const StringTable&, TransformComponent& transform) {
+        for (int i = 0; i < 3; ++i) {
+            transform.position[i] = record.position[i];
+            transform.rotation[i] = record.rotation[i];
+            transform.scale[i] = record.scale[i];
+        }
+        return true;
+    }
+};
+
+template<>
+struct Codec<NameComponent> {
+    static constexpr uint32_t Tag = makeTag("NAME");
+    using Record = NameRecord;
+    
+    static Record encode(const NameComponent& name, StringTableWriter& strings) {
+        return { strings.add(name.name) };
+    }
+    
+    static bool decode(const Record& record, const StringTable& strings, NameComponent& name) {
+        return strings.get(record.name, name.name);
+    }
+};
+
+template<>
+struct Codec<MeshRendererComponent> {
+    static constexpr uint32_t Tag = makeTag("MESH");
+    using Record = MeshRendererRecord;
+    
+    enum Flags : uint32_t {
+        Visible = 1 << 0,
+        CastShadows = 1 << 1,
+        ReceiveShadows = 1 << 2,
+        Static = 1 << 3,
+    };
+    
+    static Record encode(const MeshRendererComponent& mesh, StringTableWriter& strings) {
+        uint32_t flags = 0;
+        if (mesh.visible) flags |= Visible;
+        if (mesh.castShadows) flags |= CastShadows;
+        if (mesh.receiveShadows) flags |= ReceiveShadows;
+        if (mesh.isStatic) flags |= Static;
+        return { strings.add(mesh.meshPath), strings.add(mesh.materialPath), flags };
+    }
+    
+    static bool decode(const Record& record, const StringTable& strings, MeshRendererComponent& mesh) {
+        mesh.visible = (record.flags & Visible) != 0;
+        mesh.castShadows = (record.flags & CastShadows) != 0;
+        mesh.receiveShadows = (record.flags & ReceiveShadows) != 0;
+        mesh.isStatic = (record.flags & Static) != 0;
+        return strings.get(record.meshPath, mesh.meshPath) && strings.get(record.materialPath, mesh.materialPath);
+    }
+};
+
+template<>
+struct Codec<ScriptComponent> {
+    static constexpr uint32_t Tag = makeTag("SCRP");
+    using Record = ScriptRecord;
+    
+    static Record encode(const ScriptComponent& script, StringTableWriter& strings) {
+        return { strings.add(script.scriptPath), script.enabled ? 1u : 0u };
+    }
+    
+    static bool decode(const Record& record, const StringTable& strings, ScriptComponent& script) {
+        script.enabled = record.enabled != 0;
+        return strings.get(record.scriptPath, script.scriptPath);
+    }
+};
+
+template<>
+struct Codec<NetworkComponent> {
+    static constexpr uint32_t Tag = makeTag("NETW");
+    using Record = NetworkRecord;
+    
+    enum Flags : uint32_t {
+        Replicated = 1 << 0,
+        Owned = 1 << 1,
+    };
+    
+    static Record encode(const NetworkComponent& network, StringTableWriter&) {
+        uint32_t flags = 0;
+        if (network.isReplicated) flags |= Replicated;
+        if (network.isOwned) flags |= Owned;
+        return { network.networkId, flags };
+    }
+    
+    static bool decode(const Record& record, const StringTable&, NetworkComponent& network) {
+        network.networkId = record.networkId;
+        network.isReplicated = (record.flags & Replicated) != 0;
+        network.isOwned = (record.flags & Owned) != 0;
+        return true;
+    }
+};
+
+template<typename T>
+struct ComponentType {
+    using type = T;
+};
+
+// Components written to scene files, in file order. Runtime state such as
+// previous transforms and rigid bodies is rebuilt after loading.
+template<typename Func>
+void forEachComponent(Func&& func) {
+    func(ComponentType<TransformComponent>{});
+    func(ComponentType<NameComponent>{});
+    func(ComponentType<MeshRendererComponent>{});
+    func(ComponentType<ScriptComponent>{});
+    func(ComponentType<NetworkComponent>{});
+}
+
+template<typename Func>
+bool forComponentTag(uint32_t tag, Func&& func) {
+    bool found = false;
+    forEachComponent([&](auto type) {
+        using Component = typename decltype(type)::type;
+        if (!found && Codec<Component>::Tag == tag) {
+            found = true;
+            func(type);
+        }
+    });
+    return found;
+}
+
+template<typename Component>
+struct DecodedChunk {
+    std::vector<uint32_t> indices;
+    std::vector<Component> values;
+};
+
+// Registry bytes per component: the value plus its packed and sparse entries.
+template<typename Component>
+constexpr size_t componentBytes() {
+    return sizeof(Component) + 2 * sizeof(entt::entity);
+}
+
+template<typename Component>
+void writeChunk(const entt::registry& registry, const std::vector<entt::entity>& entities,
+                StringTableWriter& strings, std::vector<uint8_t>& body, std::vector<ChunkEntry>& chunks,
+                size_t& memoryBytes) {
+    using Record = typename Codec<Component>::Record;
+    const auto* storage = registry.storage<Component>();
+    if (!storage || storage->empty()) return;
+    
+    // Walking the entity list rather than the storage keeps a chunk in file
+    // order and costs nothing for components the subset does not have.
+    std::vector<uint32_t> members;
+    for (size_t i = 0; i < entities.size(); ++i) {
+        if (storage->contains(entities[i])) members.push_back(static_cast<uint32_t>(i));
+    }
+    if (members.empty()) return;
+    
+    body.resize(alignUp(body.size(), 8));
+    const size_t count = members.size();
+    chunks.push_back({ Codec<Component>::Tag, sizeof(Record), count, body.size() });
+    
+    const size_t indices = body.size();
+    const size_t records = indices + recordsOffset(count);
+    body.resize(records + count * sizeof(Record));
+    for (size_t i = 0; i < count; ++i) {
+        const Component& component = storage->get(entities[members[i]]);
+        const Record record = Codec<Component>::encode(component, strings);
+        std::memcpy(body.data() + indices + i * sizeof(uint32_t), &members[i], sizeof(uint32_t));
+        std::memcpy(body.data() + records + i * sizeof(Record), &record, sizeof(Record));
+        memoryBytes += componentBytes<Component>();
+    }
+}
+
+// Decodes the records on the job system. Indices are checked against the
+// file's entity count, so instantiating cannot fail.
+template<typename Component>
+bool decodeChunk(const ChunkEntry& chunk, const uint8_t* data, uint64_t entityCount, const StringTable& strings,
+                 std::vector<uint8_t>& seen, DecodedChunk<Component>& decoded, size_t& memoryBytes) {
+    using Record = typename Codec<Component>::Record;
+    if (chunk.recordSize != sizeof(Record)) {
+        RC_ERROR("Scene chunk has records of {} bytes, expected {}", chunk.recordSize, sizeof(Record));
+        return false;
+    }
+    if (!decoded.indices.empty()) {
+        RC_ERROR("Scene file has two chunks for one component");
+        return false;
+    }
+    
+    const uint8_t* indices = data + chunk.offset;
+    const uint8_t* records = indices + recordsOffset(chunk.count);
+    decoded.indices.resize(chunk.count);
+    decoded.values.resize(chunk.count);
+    std::atomic<bool> valid{ true };
+    core::JobSystem::get().parallelFor(chunk.count, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const uint32_t index = read<uint32_t>(indices + i * sizeof(uint32_t));
+            const Record record = read<Record>(records + i * sizeof(Record));
+            if (index >= entityCount || !Codec<Component>::decode(record, strings, decoded.values[i])) {
+                valid.store(false, std::memory_order_relaxed);
+                return;
+            }
+            decoded.indices[i] = index;
+        }
+    }, DecodeGrain);
+    if (!valid.load()) {
+        RC_ERROR("Scene chunk references a missing entity or string");
+        return false;
+    }
+    
+    std::fill(seen.begin(), seen.end(), 0);
+    for (uint32_t index : decoded.indices) {
+        if (seen[index]) {
+            RC_ERROR("Scene chunk lists an entity twice");
+            return false;
+        }
+        seen[index] = 1;
+    }
+    memoryBytes += chunk.count * componentBytes<Component>();
+    return true;
+}
+
+template<typename Component>
+void reserveChunk(entt::registry& registry, const DecodedChunk<Component>& decoded) {
+    if (decoded.indices.empty()) return;
+    auto& storage = registry.storage<Component>();
+    storage.reserve(storage.size() + decoded.indices.size());
+}
+
+// Hands the values to the storage in one insert so it grows once.
+template<typename Component>
+void insertChunk(entt::registry& registry, DecodedChunk<Component>& decoded, const std::vector<entt::entity>& entities,
+                 std::vector<entt::entity>& owners) {
+    if (decoded.indices.empty()) return;
+    owners.resize(decoded.indices.size());
+    for (size_t i = 0; i < owners.size(); ++i) {
+        owners[i] = entities[decoded.indices[i]];
+    }
+    registry.storage<Component>().insert(owners.begin(), owners.end(), std::make_move_iterator(decoded.values.begin()));
+}
+
+nlohmann::json vec3ToJson(const glm::vec3& value) {
+    return nlohmann::json::array({ value.x, value.y, value.z });
+}
+
+glm::vec3 vec3FromJson(const nlohmann::json& value, const glm::vec3& fallback) {
+    if (!value.is_array() || value.size() != 3) return fallback;
+    return glm::vec3(value[0].get<float>(), value[1].get<float>(), value[2].get<float>());
+}
+
+}
+
+struct SceneData::Chunks {
+    DecodedChunk<TransformComponent> transforms;
+    DecodedChunk<NameComponent> names;
+    DecodedChunk<MeshRendererComponent> meshRenderers;
+    DecodedChunk<ScriptComponent> scripts;
+    DecodedChunk<NetworkComponent> networks;
+    
+    template<typename Component>
+    DecodedChunk<Component>& get() {
+        if constexpr (std::is_same_v<Component, TransformComponent>) return transforms;
+        else if constexpr (std::is_same_v<Component, NameComponent>) return names;
+        else if constexpr (std::is_same_v<Component, MeshRendererComponent>) return meshRenderers;
+        else if constexpr (std::is_same_v<Component, ScriptComponent>) return scripts;
+        else return networks;
+    }
+};
+
+SceneData::SceneData() = default;
+SceneData::~SceneData() = default;
+SceneData::SceneData(SceneData&& other) noexcept = default;
+SceneData& SceneData::operator=(SceneData&& other) noexcept = default;
+
+bool saveScene(const Scene& scene, const std::string& filepath, SceneSaveStats* stats) {
+    const auto& entities = *scene.registry().storage<entt::entity>();
+    return saveScene(scene, std::vector<entt::entity>(entities.data(), entities.data() + entities.free_list()),
+                     filepath, stats);
+}
+
+bool saveScene(const Scene& scene, const std::vector<entt::entity>& entities, const std::string& filepath,
+               SceneSaveStats* stats) {
+    RC_PROFILE_SCOPE("saveScene");
+    const entt::registry& registry = scene.registry();
+    
+    StringTableWriter strings;
+    std::vector<ChunkEntry> chunks;
+    std::vector<uint8_t> body;
+    size_t memoryBytes = entities.size() * sizeof(entt::entity);
+    forEachComponent([&](auto type) {
+        writeChunk<typename decltype(type)::type>(registry, entities, strings, body, chunks, memoryBytes);
+    });
+    
+    const size_t prefix = sizeof(FileHeader) + chunks.size() * sizeof(ChunkEntry);
+    for (ChunkEntry& chunk : chunks) {
+        chunk.offset += prefix;
+    }
+    
+    FileHeader header;
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.entityCount = entities.size();
+    header.stringTableOffset = alignUp(prefix + body.size(), 8);
+    header.chunkCount = static_cast<uint32_t>(chunks.size());
+    header.stringCount = strings.count();
+    
+    std::vector<uint8_t> buffer;
+    buffer.reserve(header.stringTableOffset);
+    append(buffer, header);
+    for (const ChunkEntry& chunk : chunks) {
+        append(buffer, chunk);
+    }
+    buffer.insert(buffer.end(), body.begin(), body.end());
+    buffer.resize(header.stringTableOffset);
+    strings.write(buffer);
+    
+    std::ofstream file(filepath, std::ios::binary);
+    if (!file.is_open()) {
+        RC_ERROR("Failed to create scene file: {}", filepath);
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    if (!file) {
+        RC_ERROR("Failed to write scene file: {}", filepath);
+        return false;
+    }
+    
+    if (stats) {
+        stats->entityCount = entities.size();
+        stats->fileBytes = buffer.size();
+        stats->memoryBytes = memoryBytes;
+    }
+    RC_DEBUG("Saved {} entities to {} ({} bytes)", entities.size(), filepath, buffer.size());
+    return true;
+}
+
+bool loadScene(Scene& scene, const std::string& filepath, SceneLoadStats* outStats) {
+    RC_PROFILE_SCOPE("loadScene");
+    const auto start = Clock::now();
+    SceneLoadStats stats;
+    SceneData data;
+    if (!readScene(filepath, data, &stats) || !instantiateScene(scene, std::move(data), nullptr, &stats)) {
+        return false;
+    }
+    
+    stats.totalMs = elapsedMs(start);
+    if (outStats) *outStats = stats;
+    RC_INFO("Loaded {} entities from {} in {:.1f} ms", stats.entityCount, filepath, stats.totalMs);
+    return true;
+}
+
+bool readScene(const std::string& filepath, SceneData& data, SceneLoadStats* stats) {
+    RC_PROFILE_SCOPE("readScene");
+    auto start = Clock::now();
+    core::MappedFile file;
+    if (!file.open(filepath)) return false;
+    
+    const uint8_t* bytes = file.data();
+    const size_t size = file.size();
+    if (size < sizeof(FileHeader)) {
+        RC_ERROR("Scene file is truncated: {}", filepath);
+        return false;
+    }
+    
+    const FileHeader header = read<FileHeader>(bytes);
+    if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version) {
+        RC_ERROR("Not a version {} scene file: {}", Version, filepath);
+        return false;
+    }
+    
+    // Everything below is bounds checked against the mapping, so a damaged
+    // file fails to load rather than reading out of range. Offsets come from
+    // the file, so lengths are compared against what remains after them and
+    // never added to them.
+    const uint64_t indexEnd = sizeof(FileHeader) + uint64_t(header.chunkCount) * sizeof(ChunkEntry);
+    const uint64_t offsetsBytes = (uint64_t(header.stringCount) + 1) * sizeof(uint32_t);
+    if (header.entityCount > UINT32_MAX || header.stringTableOffset > size || indexEnd > header.stringTableOffset ||
+        offsetsBytes > size - header.stringTableOffset) {
+        RC_ERROR("Scene file is corrupt: {}", filepath);
+        return false;
+    }
+    const uint64_t stringsEnd = header.stringTableOffset + offsetsBytes;
+    
+    const uint8_t* offsets = bytes + header.stringTableOffset;
+    const char* chars = reinterpret_cast<const char*>(bytes + stringsEnd);
+    StringTable strings;
+    strings.values.reserve(header.stringCount);
+    uint32_t previous = 0;
+    for (uint32_t i = 0; i <= header.stringCount; ++i) {
+        const uint32_t offset = read<uint32_t>(offsets + i * sizeof(uint32_t));
+        if (offset < previous || offset > size - stringsEnd) {
+            RC_ERROR("Scene file has a corrupt string table: {}", filepath);
+            return false;
+        }
+        if (i > 0) strings.values.emplace_back(std::string_view(chars + previous, offset - previous));
+        previous = offset;
+    }
+    
+    std::vector<ChunkEntry> chunks(header.chunkCount);
+    for (uint32_t i = 0; i < header.chunkCount; ++i) {
+        chunks[i] = read<ChunkEntry>(bytes + sizeof(FileHeader) + i * sizeof(ChunkEntry));
+        const ChunkEntry& chunk = chunks[i];
+        if (chunk.count > header.entityCount || chunk.recordSize > 4096 || chunk.offset < indexEnd ||
+            chunk.offset > header.stringTableOffset ||
+            recordsOffset(chunk.count) + chunk.count * chunk.recordSize > header.stringTableOffset - chunk.offset) {
+            RC_ERROR("Scene file has a corrupt chunk index: {}", filepath);
+            return false;
+        }
+    }
+    const float mapMs = elapsedMs(start);
+    
+    start = Clock::now();
+    auto decoded = std::make_unique<SceneData::Chunks>();
+    std::vector<uint8_t> seen(header.entityCount);
+    size_t memoryBytes = header.entityCount * sizeof(entt::entity);
+    for (const ChunkEntry& chunk : chunks) {
+        bool valid = true;
+        const bool known = forComponentTag(chunk.tag, [&](auto type) {
+            using Component = typename decltype(type)::type;
+            valid = decodeChunk(chunk, bytes, header.entityCount, strings, seen, decoded->get<Component>(),
+                                memoryBytes);
+        });
+        if (!valid) return false;
+        if (!known) {
+            RC_WARN("Skipping unknown scene chunk {:#010x} in {}", chunk.tag, filepath);
+        }
+    }
+    
+    data.m_chunks = std::move(decoded);
+    data.m_entityCount = header.entityCount;
+    data.m_memoryBytes = memoryBytes;
+    if (stats) {
+        stats->fileBytes = size;
+        stats->mapMs = mapMs;
+        stats->decodeMs = elapsedMs(start);
+    }
+    return true;
+}
+
+bool instantiateScene(Scene& scene, SceneData&& data, std::vector<entt::entity>* created, SceneLoadStats* stats) {
+    RC_PROFILE_SCOPE("instantiateScene");
+    if (!data.m_chunks) return false;
+    
+    auto start = Clock::now();
+    entt::registry& registry = scene.registry();
+    auto& entityStorage = registry.storage<entt::entity>();
+    entityStorage.reserve(entityStorage.size() + data.m_entityCount);
+    forEachComponent([&](auto type) {
+        reserveChunk(registry, data.m_chunks->get<typename decltype(type)::type>());
+    });
+    std::vector<entt::entity> entities(data.m_entityCount);
+    registry.create(entities.begin(), entities.end());
+    const float reserveMs = elapsedMs(start);
+    
+    start = Clock::now();
+    std::vector<entt::entity> owners;
+    forEachComponent([&](auto type) {
+        insertChunk(registry, data.m_chunks->get<typename decltype(type)::type>(), entities, owners);
+    });
+    data.m_chunks.reset();
+    
+    if (stats) {
+        stats->entityCount = entities.size();
+        stats->reserveMs = reserveMs;
+        stats->insertMs = elapsedMs(start);
+    }
+    if (created) *created = std::move(entities);
+    return true;
+}
+
+bool exportSceneJson(const Scene& scene, const std::string& filepath) {
+    RC_PROFILE_SCOPE("exportSceneJson");
+    const entt::registry& registry = scene.registry();
+    const auto& entities = *registry.storage<entt::entity>();
+    
+    nlohmann::json list = nlohmann::json::array();
+    for (size_t i = 0; i < entities.free_list(); ++i) {
+        const entt::entity entity = entities.data()[i];
+        nlohmann::json object = nlohmann::json::object();
+        if (const auto* name = registry.try_get<NameComponent>(entity)) {
+            object["name"] = name->name.str();
+        }
+        if (const auto* transform = registry.try_get<TransformComponent>(entity)) {
+            object["transform"] = {
+                { "position", vec3ToJson(transform->position) },
+                { "rotation", vec3ToJson(transform->rotation) },
+                { "scale", vec3ToJson(transform->scale) },
+            };
+        }
+        if (const auto* mesh = registry.try_get<MeshRendererComponent>(entity)) {
+            object["meshRenderer"] = {
+                { "mesh", mesh->meshPath.str() },
+                { "material", mesh->materialPath.str() },
+                { "visible", mesh->visible },
+                { "castShadows", mesh->castShadows },
+                { "receiveShadows", mesh->receiveShadows },
+                { "static", mesh->isStatic },
+            };
+        }
+        if (const auto* script = registry.try_get<ScriptComponent>(entity)) {
+            object["script"] = { { "path", script->scriptPath.str() }, { "enabled", script->enabled } };
+        }
+        if (const auto* network = registry.try_get<NetworkComponent>(entity)) {
+            object["network"] = {
+                { "id", network->networkId },
+                { "replicated", network->isReplicated },
+                { "owned", network->isOwned },
+            };
+        }
+        list.push_back(std::move(object));
+    }
+    
+    std::ofstream file(filepath);
+    if (!file.is_open()) {
+        RC_ERROR("Failed to create scene file: {}", filepath);
+        return false;
+    }
+    
+    nlohmann::json root = { { "format", "rcscene" }, { "version", Version }, { "entities", std::move(list) } };
+    file << root.dump(4);
+    RC_INFO("Exported {} entities to {}", entities.free_list(), filepath);
+    return true;
+}
+
+bool importSceneJson(Scene& scene, const std::string& filepath) {
+    RC_PROFILE_SCOPE("importSceneJson");
+    std::ifstream file(filepath);
+    if (!file.is_open()) {
+        RC_ERROR("Failed to open scene file: {}", filepath);
+        return false;
+    }
+    
+    nlohmann::json root;
+    try {
+        file >> root;
+    } catch (const nlohmann::json::parse_error& e) {
+        RC_ERROR("Failed to parse scene file: {}", e.what());
+        return false;
+    }
+    
+    const auto list = root.find("entities");
+    if (root.value("format", "") != "rcscene" || list == root.end() || !list->is_array()) {
+        RC_ERROR("Not a scene file: {}", filepath);
+        return false;
+    }
+    
+    entt::registry& registry = scene.registry();
+    std::vector<entt::entity> created;
+    created.reserve(list->size());
+    try {
+        for (const nlohmann::json& object : *list) {
+            const entt::entity entity = registry.create();
+            created.push_back(entity);
+            if (object.contains("name")) {
+                registry.emplace<NameComponent>(entity, object["name"].get<std::string>());
+            }
+            if (object.contains("transform")) {
+                const nlohmann::json& value = object["transform"];
+                TransformComponent transform;
+                transform.position = vec3FromJson(value.value("position", nlohmann::json()), transform.position);
+                transform.rotation = vec3FromJson(value.value("rotation", nlohmann::json()), transform.rotation);
+                transform.scale = vec3FromJson(value.value("scale", nlohmann::json()), transform.scale);
+                registry.emplace<TransformComponent>(entity, transform);
+            }
+            if (object.contains("meshRenderer")) {
+                const nlohmann::json& value = object["meshRenderer"];
+                MeshRendererComponent mesh;
+                mesh.meshPath = value.value("mesh", "");
+                mesh.materialPath = value.value("material", "");
+                mesh.visible = value.value("visible", true);
+                mesh.castShadows = value.value("castShadows", true);
+                mesh.receiveShadows = value.value("receiveShadows", true);
+                mesh.isStatic = value.value("static", false);
+                registry.emplace<MeshRendererComponent>(entity, mesh);
+            }
+            if (object.contains("script")) {
+                const nlohmann::json& value = object["script"];
+                ScriptComponent script(value.value("path", ""));
+                script.enabled = value.value("enabled", true);
+                registry.emplace<ScriptComponent>(entity, script);
+            }
+            if (object.contains("network")) {
+                const nlohmann::json& value = object["network"];
+                NetworkComponent network;
+                network.networkId = value.value("id", 0u);
+                network.isReplicated = value.value("replicated", true);
+                network.isOwned = value.value("owned", false);
+                registry.emplace<NetworkComponent>(entity, network);
+            }
+        }
+    } catch (const nlohmann::json::exception& e) {
+        RC_ERROR("Invalid scene file {}: {}", filepath, e.what());
+        registry.destroy(created.begin(), created.end());
+        return false;
+    }
+    
+    RC_INFO("Imported {} entities from {}", created.size(), filepath);
+    return true;
+}
+
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <entt/entity/fwd.hpp>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace roblox_clone::scene {
+
+class Scene;
+
+struct SceneLoadStats {
+    size_t entityCount = 0;
+    size_t fileBytes = 0;
+    float mapMs = 0.0f;
+    float reserveMs = 0.0f;
+    float decodeMs = 0.0f;
+    float insertMs = 0.0f;
+    float totalMs = 0.0f;
+};
+
+struct SceneSaveStats {
+    size_t entityCount = 0;
+    size_t fileBytes = 0;
+    // Estimated bytes the entities occupy once loaded, as SceneData reports.
+    size_t memoryBytes = 0;
+};
+
+// A scene file decoded into memory but not yet added to a scene. Reading one
+// touches no registry, so it can happen on any thread; instantiating must
+// happen on the thread that owns the scene.
+class SceneData {
+public:
+    SceneData();
+    ~SceneData();
+    
+    SceneData(SceneData&& other) noexcept;
+    SceneData& operator=(SceneData&& other) noexcept;
+    
+    size_t getEntityCount() const { return m_entityCount; }
+    // Approximate bytes the entities take in a registry. Their strings are
+    // interned for the whole process and not counted.
+    size_t getMemoryBytes() const { return m_memoryBytes; }
+
+private:
+    struct Chunks;
+    
+    std::unique_ptr<Chunks> m_chunks;
+    size_t m_entityCount = 0;
+    size_t m_memoryBytes = 0;
+    
+    friend bool readScene(const std::string& filepath, SceneData& data, SceneLoadStats* stats);
+    friend bool instantiateScene(Scene& scene, SceneData&& data, std::vector<entt::entity>* created,
+                                 SceneLoadStats* stats);
+};
+
+// Binary scenes (.rcscene). After a header come one chunk per component type
+// and a string table. A chunk is the file indices of the entities that have
+// the component, then their packed fixed-size records; names and paths are
+// string table indices. An index of chunk offsets follows the header, so a
+// loader maps the file, decodes the chunks on the job system and reserves
+// every storage once. Files are little-endian.
+//
+// Every live entity is saved, in storage order, unless a subset is given.
+// Loading appends to the scene.
+bool saveScene(const Scene& scene, const std::string& filepath, SceneSaveStats* stats = nullptr);
+bool saveScene(const Scene& scene, const std::vector<entt::entity>& entities, const std::string& filepath,
+               SceneSaveStats* stats = nullptr);
+bool loadScene(Scene& scene, const std::string& filepath, SceneLoadStats* stats = nullptr);
+
+// loadScene in two halves. created receives the new entities in file order.
+bool readScene(const std::string& filepath, SceneData& data, SceneLoadStats* stats = nullptr);
+bool instantiateScene(Scene& scene, SceneData&& data, std::vector<entt::entity>* created = nullptr,
+                      SceneLoadStats* stats = nullptr);
+
+// The same content as readable JSON, one object per entity, for diffs and
+// hand edits.
+bool exportSceneJson(const Scene& scene, const std::string& filepath);
+bool importSceneJson(Scene& scene, const std::string& filepath);
+
+}
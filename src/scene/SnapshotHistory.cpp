@@ -0,0 +1,145 @@
+#include "SnapshotHistory.hpp"
+#include "Scene.hpp"
+#include "core/Profiler.hpp"
+#include <chrono>
+
+namespace roblox_clone::scene {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+float elapsedUs(Clock::time_point start) {
+    return std::chrono::duration<float, std::micro>(Clock::now() - start).count();
+}
+
+}
+
+SnapshotHistory::SnapshotHistory(size_t frameCount) : m_frames(std::max<size_t>(frameCount, 1)) {}
+
+void SnapshotHistory::save(const entt::registry& registry, uint64_t tick) {
+    RC_PROFILE_SCOPE("SnapshotHistory::save");
+    const auto start = Clock::now();
+    Frame& frame = m_frames[tick % m_frames.size()];
+    frame.tick = tick;
+    
+    const auto& entities = *registry.storage<entt::entity>();
+    frame.entities.assign(entities.data(), entities.data() + entities.free_list());
+    
+    size_t size = 0;
+    frame.sections.resize(m_tracked.size());
+    for (size_t i = 0; i < m_tracked.size(); ++i) {
+        const entt::sparse_set* set = registry.storage(m_tracked[i].id);
+        frame.sections[i].offset = size;
+        frame.sections[i].count = set ? set->size() : 0;
+        size += frame.sections[i].count * (sizeof(entt::entity) + m_tracked[i].componentSize);
+    }
+    
+    // Frames keep their capacity, so once the ring has warmed up a save never
+    // allocates.
+    size_t reserved = frame.data.capacity();
+    frame.data.resize(size);
+    m_stats.reservedBytes += frame.data.capacity() - reserved;
+    for (size_t i = 0; i < m_tracked.size(); ++i) {
+        const Section& section = frame.sections[i];
+        if (section.count == 0) continue;
+        
+        const entt::sparse_set& set = *registry.storage(m_tracked[i].id);
+        std::byte* target = frame.data.data() + section.offset;
+        std::memcpy(target, set.data(), section.count * sizeof(entt::entity));
+        m_tracked[i].copyOut(set, target + section.count * sizeof(entt::entity));
+    }
+    
+    m_stats.frameBytes = size + frame.entities.size() * sizeof(entt::entity);
+    m_stats.saveUs = elapsedUs(start);
+}
+
+bool SnapshotHistory::restore(Scene& scene, uint64_t tick) {
+    RC_PROFILE_SCOPE("SnapshotHistory::restore");
+    if (!contains(tick)) return false;
+    
+    const auto start = Clock::now();
+    const Frame& frame = m_frames[tick % m_frames.size()];
+    entt::registry& registry = scene.registry();
+    restoreEntities(registry, frame);
+    
+    m_stats.rebuiltStorages = 0;
+    for (size_t i = 0; i < m_tracked.size(); ++i) {
+        const Section& section = frame.sections[i];
+        const std::byte* source = frame.data.data() + section.offset;
+        const auto* entities = reinterpret_cast<const entt::entity*>(source);
+        const std::byte* components = source + section.count * sizeof(entt::entity);
+        
+        entt::sparse_set& set = m_tracked[i].assure(registry);
+        if (set.size() == section.count &&
+            (section.count == 0 || std::memcmp(set.data(), entities, section.count * sizeof(entt::entity)) == 0)) {
+            m_tracked[i].copyIn(set, components);
+        } else {
+            rebuildStorage(set, m_tracked[i], entities, components, section.count);
+            ++m_stats.rebuiltStorages;
+        }
+    }
+    
+    // Pages were written behind the registry's back, so no update signals
+    // fired for the restored transforms.
+    scene.markAllTransformsChanged();
+    m_stats.restoreUs = elapsedUs(start);
+    return true;
+}
+
+bool SnapshotHistory::contains(uint64_t tick) const {
+    return m_frames[tick % m_frames.size()].tick == tick;
+}
+
+void SnapshotHistory::clear() {
+    for (Frame& frame : m_frames) {
+        frame.tick = ~0ull;
+    }
+}
+
+void SnapshotHistory::restoreEntities(entt::registry& registry, const Frame& frame) {
+    const auto& entities = registry.storage<entt::entity>();
+    const size_t alive = entities.free_list();
+    if (alive == frame.entities.size() &&
+        std::memcmp(entities.data(), frame.entities.data(), alive * sizeof(entt::entity)) == 0) {
+        return;
+    }
+    
+    // Destroy first, so the handles of entities that were destroyed and
+    // recycled since the frame are free again when they are recreated.
+    m_scratch.assign(frame.entities.begin(), frame.entities.end());
+    std::sort(m_scratch.begin(), m_scratch.end());
+    std::vector<entt::entity> created;
+    for (size_t i = 0; i < alive; ++i) {
+        const entt::entity entity = entities.data()[i];
+        if (!std::binary_search(m_scratch.begin(), m_scratch.end(), entity)) {
+            created.push_back(entity);
+        }
+    }
+    registry.destroy(created.begin(), created.end());
+    
+    for (entt::entity entity : frame.entities) {
+        if (!registry.valid(entity)) {
+            (void)registry.create(entity);
+        }
+    }
+}
+
+void SnapshotHistory::rebuildStorage(entt::sparse_set& set, const Tracked& tracked, const entt::entity* entities,
+                                     const std::byte* components, size_t count) {
+    m_scratch.assign(entities, entities + count);
+    std::sort(m_scratch.begin(), m_scratch.end());
+    std::vector<entt::entity> removed;
+    for (entt::entity entity : set) {
+        if (!std::binary_search(m_scratch.begin(), m_scratch.end(), entity)) {
+            removed.push_back(entity);
+        }
+    }
+    set.remove(removed.begin(), removed.end());
+    
+    for (size_t i = 0; i < count; ++i) {
+        tracked.assign(set, entities[i], components + i * tracked.componentSize);
+    }
+}
+
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <entt/entt.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace roblox_clone::scene {
+
+class Scene;
+
+struct SnapshotStats {
+    // Bytes the latest save copied and the bytes held by all frames.
+    size_t frameBytes = 0;
+    size_t reservedBytes = 0;
+    float saveUs = 0.0f;
+    float restoreUs = 0.0f;
+    // Storages the latest restore had to rebuild entity by entity because
+    // their entities had changed since the frame was saved.
+    size_t rebuiltStorages = 0;
+};
+
+// Ring of registry snapshots for rollback. Each frame keeps the live entity
+// list and, for every tracked component, its packed entity array and a raw
+// copy of its component pages, so saving is a few memcpys per storage.
+//
+// Restoring a storage whose entities are still the same ones in the same
+// order copies the pages straight back. Otherwise the storage is rebuilt
+// through emplace and remove, which fires the usual signals, and entities
+// created since the frame are destroyed while destroyed ones are recreated
+// with their old handles. Untracked components of recreated entities are not
+// brought back.
+//
+// Tracked components must be trivially copyable.
+class SnapshotHistory {
+public:
+    explicit SnapshotHistory(size_t frameCount = 64);
+    
+    SnapshotHistory(const SnapshotHistory&) = delete;
+    SnapshotHistory& operator=(const SnapshotHistory&) = delete;
+    
+    template<typename... Components>
+    void track() {
+        (addTracked<Components>(), ...);
+    }
+    
+    void save(const entt::registry& registry, uint64_t tick);
+    // Returns false if the frame for tick was never saved or was overwritten.
+    bool restore(Scene& scene, uint64_t tick);
+    bool contains(uint64_t tick) const;
+    void clear();
+    
+    size_t getFrameCount() const { return m_frames.size(); }
+    const SnapshotStats& getStats() const { return m_stats; }
+
+private:
+    struct Tracked {
+        entt::id_type id = 0;
+        std::string_view name;
+        size_t componentSize = 0;
+        entt::sparse_set& (*assure)(entt::registry& registry) = nullptr;
+        void (*copyOut)(const entt::sparse_set& set, std::byte* target) = nullptr;
+        void (*copyIn)(entt::sparse_set& set, const std::byte* source) = nullptr;
+        void (*assign)(entt::sparse_set& set, entt::entity entity, const std::byte* component) = nullptr;
+    };
+    
+    // A tracked storage's entities followed by its components, within data.
+    struct Section {
+        size_t offset = 0;
+        size_t count = 0;
+    };
+    
+    struct Frame {
+        uint64_t tick = ~0ull;
+        std::vector<entt::entity> entities;
+        std::vector<Section> sections;
+        std::vector<std::byte> data;
+    };
+    
+    template<typename Component>
+    void addTracked() {
+        static_assert(std::is_trivially_copyable_v<Component>, "Snapshots copy components as raw bytes");
+        static_assert(entt::component_traits<Component>::page_size > 0, "Empty components have no pages to copy");
+        
+        Tracked tracked;
+        tracked.id = entt::type_hash<Component>::value();
+        tracked.name = entt::type_name<Component>::value();
+        tracked.componentSize = sizeof(Component);
+        tracked.assure = [](entt::registry& registry) -> entt::sparse_set& { return registry.storage<Component>(); };
+        tracked.copyOut = [](const entt::sparse_set& set, std::byte* target) {
+            const auto& storage = static_cast<const entt::storage_for_t<Component>&>(set);
+            forEachPage<Component>(storage.size(), [&](size_t first, size_t count) {
+                std::memcpy(target + first * sizeof(Component), storage.raw()[first / pageSize<Component>()],
+                            count * sizeof(Component));
+            });
+        };
+        tracked.copyIn = [](entt::sparse_set& set, const std::byte* source) {
+            auto& storage = static_cast<entt::storage_for_t<Component>&>(set);
+            forEachPage<Component>(storage.size(), [&](size_t first, size_t count) {
+                std::memcpy(storage.raw()[first / pageSize<Component>()], source + first * sizeof(Component),
+                            count * sizeof(Component));
+            });
+        };
+        // The registry's storages carry the signal mixin; emplacing through it
+        // is what fires on_construct for groups and attached systems.
+        tracked.assign = [](entt::sparse_set& set, entt::entity entity, const std::byte* component) {
+            auto& storage = static_cast<entt::storage_for_t<Component>&>(set);
+            Component value;
+            std::memcpy(&value, component, sizeof(Component));
+            if (storage.contains(entity)) {
+                storage.get(entity) = value;
+            } else {
+                storage.emplace(entity, value);
+            }
+        };
+        m_tracked.push_back(tracked);
+    }
+    
+    template<typename Component>
+    static constexpr size_t pageSize() {
+        return entt::component_traits<Component>::page_size;
+    }
+    
+    template<typename Component, typename Func>
+    static void forEachPage(size_t size, Func&& func) {
+        for (size_t first = 0; first < size; first += pageSize<Component>()) {
+            func(first, std::min(pageSize<Component>(), size - first));
+        }
+    }
+    
+    void restoreEntities(entt::registry& registry, const Frame& frame);
+    void rebuildStorage(entt::sparse_set& set, const Tracked& tracked, const entt::entity* entities,
+                        const std::byte* components, size_t count);
+    
+    std::vector<Tracked> m_tracked;
+    std::vector<Frame> m_frames;
+    std::vector<entt::entity> m_scratch;
+    SnapshotStats m_stats;
+};
+
+}
@@ -0,0 +1,239 @@
+#include "SpatialHash.hpp"
+#include "Scene.hpp"
+#include "core/Profiler.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <utility>
+
+namespace roblox_clone::scene {
+
+Aabb Aabb::fromTransform(const TransformComponent& transform) {
+    glm::mat4 rotation = glm::rotate(glm::mat4(1.0f), glm::radians(transform.rotation.x), glm::vec3(1, 0, 0));
+    rotation = glm::rotate(rotation, glm::radians(transform.rotation.y), glm::vec3(0, 1, 0));
+    rotation = glm::rotate(rotation, glm::radians(transform.rotation.z), glm::vec3(0, 0, 1));
+    
+    glm::vec3 extent(0.0f);
+    for (int axis = 0; axis < 3; ++axis) {
+        extent += glm::abs(glm::vec3(rotation[axis])) * (std::abs(transform.scale[axis]) * 0.5f);
+    }
+    return fromCenter(transform.position, extent);
+}
+
+SpatialHash::SpatialHash(const SpatialHashSettings& settings) {
+    setSettings(settings);
+}
+
+void SpatialHash::setSettings(const SpatialHashSettings& settings) {
+    m_settings = settings;
+    m_settings.cellSize = std::max(m_settings.cellSize, 0.01f);
+    m_inverseCellSize = 1.0f / m_settings.cellSize;
+    
+    // Cell placement depends on the cell size, so every part has to be re-binned.
+    std::vector<Item> items = std::move(m_items);
+    clear();
+    for (const Item& item : items) {
+        update(item.entity, item.bounds);
+    }
+}
+
+void SpatialHash::markDirty(entt::entity entity) {
+    if (m_allDirty) return;
+    
+    // Keyed by the full handle so a recycled index still gets queued after its
+    // previous owner was marked in the same tick.
+    const auto index = entt::to_entity(entity);
+    if (index >= m_dirtyMarks.size()) {
+        m_dirtyMarks.resize(index + 1, entt::null);
+    }
+    if (m_dirtyMarks[index] != entity) {
+        m_dirtyMarks[index] = entity;
+        m_dirty.push_back(entity);
+    }
+}
+
+void SpatialHash::remove(entt::entity entity) {
+    const uint32_t index = itemIndex(entity);
+    if (index == NoIndex) return;
+    
+    unlink(index);
+    m_itemLookup[entt::to_entity(entity)] = NoIndex;
+    
+    const uint32_t last = static_cast<uint32_t>(m_items.size() - 1);
+    if (index != last) {
+        m_items[index] = m_items[last];
+        Item& moved = m_items[index];
+        m_itemLookup[entt::to_entity(moved.entity)] = index;
+        if (moved.cell == OversizedCell) {
+            m_oversized[moved.slot] = index;
+        } else {
+            m_cells[moved.cell].items[moved.slot] = index;
+        }
+    }
+    m_items.pop_back();
+}
+
+void SpatialHash::clear() {
+    m_items.clear();
+    m_itemLookup.clear();
+    m_cells.clear();
+    m_cellLookup.clear();
+    m_oversized.clear();
+}
+
+size_t SpatialHash::sync(const entt::registry& registry) {
+    RC_PROFILE_SCOPE("SpatialHash::sync");
+    const auto* transforms = registry.storage<TransformComponent>();
+    const auto* meshRenderers = registry.storage<MeshRendererComponent>();
+    
+    auto refresh = [&](entt::entity entity) {
+        if (transforms && meshRenderers && transforms->contains(entity) && meshRenderers->contains(entity)) {
+            update(entity, Aabb::fromTransform(transforms->get(entity)));
+        } else {
+            remove(entity);
+        }
+    };
+    
+    size_t refreshed = 0;
+    if (m_allDirty) {
+        // Drop stale items first, walking backwards so swap-removal stays safe.
+        for (size_t i = m_items.size(); i-- > 0;) {
+            const entt::entity entity = m_items[i].entity;
+            if (!registry.valid(entity) || !meshRenderers || !meshRenderers->contains(entity) ||
+                !transforms || !transforms->contains(entity)) {
+                remove(entity);
+            }
+        }
+        if (transforms && meshRenderers) {
+            auto parts = registry.view<const TransformComponent, const MeshRendererComponent>();
+            for (auto entity : parts) {
+                update(entity, Aabb::fromTransform(parts.get<const TransformComponent>(entity)));
+                ++refreshed;
+            }
+        }
+        m_allDirty = false;
+    } else {
+        for (entt::entity entity : m_dirty) {
+            refresh(entity);
+            ++refreshed;
+        }
+    }
+    
+    for (entt::entity entity : m_dirty) {
+        m_dirtyMarks[entt::to_entity(entity)] = entt::null;
+    }
+    m_dirty.clear();
+    return refreshed;
+}
+
+void SpatialHash::queryBox(const Aabb& box, std::vector<entt::entity>& results) const {
+    forEachInBox(box, [&results](entt::entity entity, const Aabb&) {
+        results.push_back(entity);
+    });
+}
+
+void SpatialHash::queryRadius(const glm::vec3& center, float radius, std::vector<entt::entity>& results) const {
+    const float radiusSquared = radius * radius;
+    forEachInBox(Aabb::fromCenter(center, glm::vec3(radius)), [&](entt::entity entity, const Aabb& bounds) {
+        if (bounds.distanceSquared(center) <= radiusSquared) results.push_back(entity);
+    });
+}
+
+void SpatialHash::queryNearest(const glm::vec3& point, size_t count, std::vector<entt::entity>& results,
+                               float maxDistance) const {
+    if (count == 0 || m_items.empty()) return;
+    
+    // Grow the search radius until it holds enough parts; anything outside the
+    // radius is farther than everything inside it.
+    std::vector<std::pair<float, entt::entity>> candidates;
+    float radius = std::min(m_settings.cellSize, maxDistance);
+    while (true) {
+        candidates.clear();
+        const float radiusSquared = radius * radius;
+        forEachInBox(Aabb::fromCenter(point, glm::vec3(radius)), [&](entt::entity entity, const Aabb& bounds) {
+            float distanceSquared = bounds.distanceSquared(point);
+            if (distanceSquared <= radiusSquared) candidates.emplace_back(distanceSquared, entity);
+        });
+        
+        if (candidates.size() >= count || candidates.size() == m_items.size() || radius >= maxDistance) break;
+        radius = std::min(radius * 2.0f, maxDistance);
+    }
+    
+    const size_t found = std::min(count, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + found, candidates.end());
+    for (size_t i = 0; i < found; ++i) {
+        results.push_back(candidates[i].second);
+    }
+}
+
+bool SpatialHash::contains(entt::entity entity) const {
+    return itemIndex(entity) != NoIndex;
+}
+
+const Aabb* SpatialHash::getBounds(entt::entity entity) const {
+    const uint32_t index = itemIndex(entity);
+    return index != NoIndex ? &m_items[index].bounds : nullptr;
+}
+
+uint32_t SpatialHash::itemIndex(entt::entity entity) const {
+    const auto index = entt::to_entity(entity);
+    if (index >= m_itemLookup.size()) return NoIndex;
+    
+    const uint32_t item = m_itemLookup[index];
+    return item != NoIndex && m_items[item].entity == entity ? item : NoIndex;
+}
+
+uint32_t SpatialHash::placeCell(const Aabb& bounds) {
+    const glm::vec3 extent = bounds.getExtent();
+    if (glm::max(extent.x, glm::max(extent.y, extent.z)) > m_settings.cellSize * 0.5f) {
+        return OversizedCell;
+    }
+    
+    const glm::ivec3 coord = cellCoord(bounds.getCenter());
+    auto [it, inserted] = m_cellLookup.try_emplace(cellKey(coord), static_cast<uint32_t>(m_cells.size()));
+    if (inserted) {
+        m_cells.push_back({ coord, {} });
+    }
+    return it->second;
+}
+
+void SpatialHash::link(uint32_t itemIndex, uint32_t cell) {
+    Item& item = m_items[itemIndex];
+    auto& items = cell == OversizedCell ? m_oversized : m_cells[cell].items;
+    item.cell = cell;
+    item.slot = static_cast<uint32_t>(items.size());
+    items.push_back(itemIndex);
+}
+
+void SpatialHash::unlink(uint32_t itemIndex) {
+    Item& item = m_items[itemIndex];
+    auto& items = item.cell == OversizedCell ? m_oversized : m_cells[item.cell].items;
+    
+    const uint32_t moved = items.back();
+    items[item.slot] = moved;
+    m_items[moved].slot = item.slot;
+    items.pop_back();
+    item.cell = NoIndex;
+}
+
+void SpatialHash::update(entt::entity entity, const Aabb& bounds) {
+    uint32_t index = itemIndex(entity);
+    if (index == NoIndex) {
+        const auto lookup = entt::to_entity(entity);
+        if (lookup >= m_itemLookup.size()) {
+            m_itemLookup.resize(lookup + 1, NoIndex);
+        }
+        index = static_cast<uint32_t>(m_items.size());
+        m_itemLookup[lookup] = index;
+        m_items.push_back({ entity, bounds, NoIndex, 0 });
+    }
+    
+    // Parts that stay within their loose cell only need their bounds rewritten.
+    const uint32_t cell = placeCell(bounds);
+    m_items[index].bounds = bounds;
+    if (cell != m_items[index].cell) {
+        if (m_items[index].cell != NoIndex) unlink(index);
+        link(index, cell);
+    }
+}
+
+}
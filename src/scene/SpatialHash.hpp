@@ -0,0 +1,189 @@
+#pragma once
+
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace roblox_clone::scene {
+
+struct TransformComponent;
+
+struct Aabb {
+    glm::vec3 min = glm::vec3(0.0f);
+    glm::vec3 max = glm::vec3(0.0f);
+    
+    Aabb() = default;
+    Aabb(const glm::vec3& minimum, const glm::vec3& maximum) : min(minimum), max(maximum) {}
+    
+    static Aabb fromCenter(const glm::vec3& center, const glm::vec3& extent) {
+        return { center - extent, center + extent };
+    }
+    // Bounds of the unit cube every part mesh is built from, after the transform.
+    static Aabb fromTransform(const TransformComponent& transform);
+    
+    glm::vec3 getCenter() const { return (min + max) * 0.5f; }
+    glm::vec3 getExtent() const { return (max - min) * 0.5f; }
+    
+    bool overlaps(const Aabb& other) const {
+        return min.x <= other.max.x && max.x >= other.min.x &&
+               min.y <= other.max.y && max.y >= other.min.y &&
+               min.z <= other.max.z && max.z >= other.min.z;
+    }
+    
+    float distanceSquared(const glm::vec3& point) const {
+        glm::vec3 delta = glm::max(glm::max(min - point, point - max), glm::vec3(0.0f));
+        return glm::dot(delta, delta);
+    }
+};
+
+struct SpatialHashSettings {
+    float cellSize = 16.0f;
+};
+
+// Loose uniform grid over part bounds. Each part is stored in the one cell that
+// holds its center, so cell contents may spill half a cell past the cell edges
+// and queries widen their search by that margin. Parts bigger than a cell go in
+// an oversized list that every query scans.
+//
+// Queries are const and may run concurrently from jobs, as long as nothing
+// calls sync() or the mutators at the same time.
+class SpatialHash {
+public:
+    explicit SpatialHash(const SpatialHashSettings& settings = {});
+    
+    SpatialHash(const SpatialHash&) = delete;
+    SpatialHash& operator=(const SpatialHash&) = delete;
+    
+    void setSettings(const SpatialHashSettings& settings);
+    const SpatialHashSettings& getSettings() const { return m_settings; }
+    
+    void markDirty(entt::entity entity);
+    void markAllDirty() { m_allDirty = true; }
+    void remove(entt::entity entity);
+    void clear();
+    
+    // Re-reads the bounds of every dirty entity. Entities that no longer have
+    // both a transform and a mesh renderer are dropped. Returns the number of
+    // entities refreshed.
+    size_t sync(const entt::registry& registry);
+    
+    // Calls func(entity, bounds) for every part whose bounds overlap box.
+    template<typename Func>
+    void forEachInBox(const Aabb& box, Func&& func) const {
+        const float margin = m_settings.cellSize * 0.5f;
+        const glm::ivec3 first = cellCoord(box.min - margin);
+        const glm::ivec3 last = cellCoord(box.max + margin);
+        const glm::dvec3 span = glm::dvec3(last) - glm::dvec3(first) + 1.0;
+        
+        auto visitCell = [this, &box, &func](const Cell& cell) {
+            for (uint32_t itemIndex : cell.items) {
+                const Item& item = m_items[itemIndex];
+                if (item.bounds.overlaps(box)) func(item.entity, item.bounds);
+            }
+        };
+        
+        if (span.x * span.y * span.z > static_cast<double>(m_cells.size())) {
+            for (const Cell& cell : m_cells) {
+                if (!cell.items.empty() && cellOverlaps(cell.coord, first, last)) visitCell(cell);
+            }
+        } else {
+            for (int z = first.z; z <= last.z; ++z) {
+                for (int y = first.y; y <= last.y; ++y) {
+                    for (int x = first.x; x <= last.x; ++x) {
+                        auto it = m_cellLookup.find(cellKey(glm::ivec3(x, y, z)));
+                        if (it != m_cellLookup.end()) visitCell(m_cells[it->second]);
+                    }
+                }
+            }
+        }
+        
+        for (uint32_t itemIndex : m_oversized) {
+            const Item& item = m_items[itemIndex];
+            if (item.bounds.overlaps(box)) func(item.entity, item.bounds);
+        }
+    }
+    
+    void queryBox(const Aabb& box, std::vector<entt::entity>& results) const;
+    void queryRadius(const glm::vec3& center, float radius, std::vector<entt::entity>& results) const;
+    // Up to count parts ordered by the distance from point to their bounds.
+    void queryNearest(const glm::vec3& point, size_t count, std::vector<entt::entity>& results,
+                      float maxDistance = std::numeric_limits<float>::infinity()) const;
+    
+    bool contains(entt::entity entity) const;
+    const Aabb* getBounds(entt::entity entity) const;
+    size_t size() const { return m_items.size(); }
+    size_t getCellCount() const { return m_cellLookup.size(); }
+    size_t getOversizedCount() const { return m_oversized.size(); }
+
+private:
+    static constexpr uint32_t NoIndex = ~0u;
+    static constexpr uint32_t OversizedCell = ~0u - 1;
+    
+    struct Item {
+        entt::entity entity = entt::null;
+        Aabb bounds;
+        uint32_t cell = NoIndex;
+        uint32_t slot = 0;
+    };
+    
+    struct Cell {
+        glm::ivec3 coord = glm::ivec3(0);
+        std::vector<uint32_t> items;
+    };
+    
+    // Cell keys hold 21 bits per axis, so coordinates are clamped to that range
+    // while still floats: converting an infinite, NaN or huge value to int is
+    // undefined. A query reaching past the range then spans more cells than
+    // exist and falls back to scanning every cell.
+    static constexpr float CellLimit = static_cast<float>(1 << 20);
+    
+    static int clampCell(float cell) {
+        if (!(cell > -CellLimit)) return -(1 << 20);
+        if (!(cell < CellLimit - 1.0f)) return (1 << 20) - 1;
+        return static_cast<int>(cell);
+    }
+    
+    glm::ivec3 cellCoord(const glm::vec3& position) const {
+        const glm::vec3 cell = glm::floor(position * m_inverseCellSize);
+        return glm::ivec3(clampCell(cell.x), clampCell(cell.y), clampCell(cell.z));
+    }
+    
+    static uint64_t cellKey(const glm::ivec3& coord) {
+        constexpr uint64_t Mask = (1u << 21) - 1;
+        constexpr int Bias = 1 << 20;
+        return (static_cast<uint64_t>(coord.x + Bias) & Mask) |
+               ((static_cast<uint64_t>(coord.y + Bias) & Mask) << 21) |
+               ((static_cast<uint64_t>(coord.z + Bias) & Mask) << 42);
+    }
+    
+    static bool cellOverlaps(const glm::ivec3& coord, const glm::ivec3& first, const glm::ivec3& last) {
+        return coord.x >= first.x && coord.x <= last.x &&
+               coord.y >= first.y && coord.y <= last.y &&
+               coord.z >= first.z && coord.z <= last.z;
+    }
+    
+    uint32_t itemIndex(entt::entity entity) const;
+    uint32_t placeCell(const Aabb& bounds);
+    void link(uint32_t itemIndex, uint32_t cell);
+    void unlink(uint32_t itemIndex);
+    void update(entt::entity entity, const Aabb& bounds);
+    
+    SpatialHashSettings m_settings;
+    float m_inverseCellSize = 1.0f;
+    
+    std::vector<Item> m_items;
+    std::vector<uint32_t> m_itemLookup;
+    std::vector<Cell> m_cells;
+    std::unordered_map<uint64_t, uint32_t> m_cellLookup;
+    std::vector<uint32_t> m_oversized;
+    
+    std::vector<entt::entity> m_dirty;
+    std::vector<entt::entity> m_dirtyMarks;
+    bool m_allDirty = false;
+};
+
+}
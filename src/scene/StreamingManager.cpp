@@ -0,0 +1,366 @@
+#include "StreamingManager.hpp"
+#include "Scene.hpp"
+#include "core/Logger.hpp"
+#include "core/Profiler.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <utility>
+
+namespace roblox_clone::scene {
+
+namespace {
+
+constexpr const char* ManifestName = "streaming.json";
+constexpr const char* GlobalName = "global.rcscene";
+constexpr int ManifestVersion = 1;
+
+std::string joinPath(const std::string& directory, const std::string& file) {
+    return (std::filesystem::path(directory) / file).string();
+}
+
+}
+
+bool partitionScene(const Scene& scene, const std::string& directory, float cellSize) {
+    RC_PROFILE_SCOPE("partitionScene");
+    if (cellSize <= 0.0f) {
+        RC_ERROR("Streaming cell size must be positive");
+        return false;
+    }
+    
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error) {
+        RC_ERROR("Failed to create streaming directory {}: {}", directory, error.message());
+        return false;
+    }
+    
+    const entt::registry& registry = scene.registry();
+    const auto& entities = *registry.storage<entt::entity>();
+    std::map<std::pair<int, int>, std::vector<entt::entity>> cells;
+    std::vector<entt::entity> global;
+    for (size_t i = 0; i < entities.free_list(); ++i) {
+        const entt::entity entity = entities.data()[i];
+        if (const auto* transform = registry.try_get<TransformComponent>(entity)) {
+            const int x = static_cast<int>(std::floor(transform->position.x / cellSize));
+            const int z = static_cast<int>(std::floor(transform->position.z / cellSize));
+            cells[{ x, z }].push_back(entity);
+        } else {
+            global.push_back(entity);
+        }
+    }
+    
+    nlohmann::json list = nlohmann::json::array();
+    for (const auto& [coords, members] : cells) {
+        const std::string file =
+            "cell_" + std::to_string(coords.first) + "_" + std::to_string(coords.second) + ".rcscene";
+        SceneSaveStats stats;
+        if (!saveScene(scene, members, joinPath(directory, file), &stats)) return false;
+        list.push_back({
+            { "x", coords.first },
+            { "z", coords.second },
+            { "file", file },
+            { "entities", stats.entityCount },
+            { "bytes", stats.memoryBytes },
+        });
+    }
+    if (!saveScene(scene, global, joinPath(directory, GlobalName))) return false;
+    
+    nlohmann::json manifest = {
+        { "format", "rcstream" },
+        { "version", ManifestVersion },
+        { "cellSize", cellSize },
+        { "global", GlobalName },
+        { "cells", std::move(list) },
+    };
+    std::ofstream file(joinPath(directory, ManifestName));
+    if (!file.is_open()) {
+        RC_ERROR("Failed to create streaming manifest in {}", directory);
+        return false;
+    }
+    file << manifest.dump(4);
+    
+    RC_INFO("Partitioned {} entities into {} cells of {} in {}", entities.free_list(), cells.size(), cellSize,
+            directory);
+    return true;
+}
+
+StreamingManager::StreamingManager(Scene& scene, const StreamingSettings& settings)
+    : m_scene(scene), m_settings(settings) {}
+
+StreamingManager::~StreamingManager() {
+    close();
+}
+
+bool StreamingManager::open(const std::string& directory) {
+    close();
+    
+    std::ifstream file(joinPath(directory, ManifestName));
+    if (!file.is_open()) {
+        RC_ERROR("No streaming manifest in {}", directory);
+        return false;
+    }
+    
+    std::string global;
+    try {
+        nlohmann::json manifest;
+        file >> manifest;
+        if (manifest.value("format", "") != "rcstream" || manifest.value("version", 0) != ManifestVersion) {
+            RC_ERROR("Unsupported streaming manifest in {}", directory);
+            return false;
+        }
+        
+        m_cellSize = manifest.at("cellSize").get<float>();
+        global = manifest.value("global", "");
+        for (const nlohmann::json& entry : manifest.at("cells")) {
+            Cell cell;
+            cell.x = entry.at("x").get<int>();
+            cell.z = entry.at("z").get<int>();
+            cell.file = entry.at("file").get<std::string>();
+            cell.entityCount = entry.value("entities", size_t(0));
+            cell.memoryBytes = entry.value("bytes", size_t(0));
+            m_cells.push_back(std::move(cell));
+        }
+    } catch (const nlohmann::json::exception& e) {
+        RC_ERROR("Failed to parse streaming manifest in {}: {}", directory, e.what());
+        m_cells.clear();
+        return false;
+    }
+    
+    m_directory = directory;
+    if (!global.empty() && !loadScene(m_scene, joinPath(directory, global))) {
+        m_cells.clear();
+        return false;
+    }
+    
+    m_running = true;
+    for (int i = 0; i < std::max(m_settings.loaderThreads, 1); ++i) {
+        m_loaders.emplace_back(&StreamingManager::loaderThread, this);
+    }
+    
+    RC_INFO("Streaming {} cells from {}", m_cells.size(), directory);
+    return true;
+}
+
+void StreamingManager::close() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+    m_wake.notify_all();
+    for (std::thread& loader : m_loaders) {
+        loader.join();
+    }
+    m_loaders.clear();
+    
+    m_requests.clear();
+    m_results.clear();
+    m_cells.clear();
+    m_residentBytes = 0;
+    m_reservedBytes = 0;
+    m_residentEntities = 0;
+    m_pendingLoads = 0;
+}
+
+bool StreamingManager::update(const std::vector<glm::vec3>& focusPoints) {
+    RC_PROFILE_SCOPE("StreamingManager::update");
+    if (m_cells.empty()) return false;
+    
+    m_focus.assign(focusPoints.begin(), focusPoints.end());
+    auto focusView = m_scene.view<StreamingFocusComponent, TransformComponent>();
+    for (auto [entity, focus, transform] : focusView.each()) {
+        m_focus.push_back(transform.position);
+    }
+    computeDistances(m_focus);
+    
+    bool changed = false;
+    for (Cell& cell : m_cells) {
+        if (cell.state == CellState::Loaded && cell.distance > m_settings.unloadRadius) {
+            changed = unloadCell(cell) || changed;
+        }
+    }
+    // A lowered budget, or cells that decoded larger than the manifest said,
+    // evicts from the far end.
+    while (m_residentBytes > m_settings.memoryBudget) {
+        Cell* farthest = findFarthestLoaded(-1.0f);
+        if (!farthest) break;
+        changed = unloadCell(*farthest) || changed;
+    }
+    changed = instantiateReady() || changed;
+    changed = requestLoads() || changed;
+    return changed;
+}
+
+bool StreamingManager::isIdle() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_pendingLoads == 0 && m_requests.empty() && m_results.empty();
+}
+
+bool StreamingManager::isCellLoaded(int x, int z) const {
+    return std::any_of(m_cells.begin(), m_cells.end(), [x, z](const Cell& cell) {
+        return cell.x == x && cell.z == z && cell.state == CellState::Loaded;
+    });
+}
+
+StreamingStats StreamingManager::getStats() const {
+    StreamingStats stats;
+    stats.cellCount = m_cells.size();
+    for (const Cell& cell : m_cells) {
+        if (cell.state == CellState::Loaded) ++stats.loadedCells;
+        if (cell.state == CellState::Loading) ++stats.pendingCells;
+    }
+    stats.residentEntities = m_residentEntities;
+    stats.residentBytes = m_residentBytes;
+    stats.loads = m_loads;
+    stats.unloads = m_unloads;
+    stats.instantiateMs = m_instantiateMs;
+    return stats;
+}
+
+void StreamingManager::loaderThread() {
+    while (true) {
+        uint32_t index = 0;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this]() { return !m_running || !m_requests.empty(); });
+            if (!m_running) return;
+            index = m_requests.front();
+            m_requests.pop_front();
+        }
+        
+        // Cell files never change after open(), so reading them here does not
+        // race with the owning thread.
+        LoadResult result;
+        result.cell = index;
+        result.success = readScene(joinPath(m_directory, m_cells[index].file), result.data);
+        
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_results.push_back(std::move(result));
+    }
+}
+
+// Distance in x and z from each cell's square to the nearest focus.
+void StreamingManager::computeDistances(const std::vector<glm::vec3>& focusPoints) {
+    for (Cell& cell : m_cells) {
+        const float minX = cell.x * m_cellSize;
+        const float minZ = cell.z * m_cellSize;
+        float nearest = std::numeric_limits<float>::max();
+        for (const glm::vec3& point : focusPoints) {
+            const float dx = std::max({ minX - point.x, 0.0f, point.x - (minX + m_cellSize) });
+            const float dz = std::max({ minZ - point.z, 0.0f, point.z - (minZ + m_cellSize) });
+            nearest = std::min(nearest, dx * dx + dz * dz);
+        }
+        cell.distance = std::sqrt(nearest);
+    }
+}
+
+StreamingManager::Cell* StreamingManager::findFarthestLoaded(float beyond) {
+    Cell* farthest = nullptr;
+    for (Cell& cell : m_cells) {
+        if (cell.state == CellState::Loaded && cell.distance > beyond &&
+            (!farthest || cell.distance > farthest->distance)) {
+            farthest = &cell;
+        }
+    }
+    return farthest;
+}
+
+bool StreamingManager::unloadCell(Cell& cell) {
+    entt::registry& registry = m_scene.registry();
+    const size_t created = cell.entities.size();
+    cell.entities.erase(std::remove_if(cell.entities.begin(), cell.entities.end(),
+                                       [&registry](entt::entity entity) { return !registry.valid(entity); }),
+                        cell.entities.end());
+    registry.destroy(cell.entities.begin(), cell.entities.end());
+    
+    m_residentBytes -= std::min(m_residentBytes, cell.memoryBytes);
+    m_residentEntities -= std::min(m_residentEntities, created);
+    cell.entities.clear();
+    cell.entities.shrink_to_fit();
+    cell.state = CellState::Unloaded;
+    ++m_unloads;
+    return created > 0;
+}
+
+bool StreamingManager::instantiateReady() {
+    std::vector<LoadResult> ready;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const size_t limit = static_cast<size_t>(std::max(m_settings.maxInstantiatesPerUpdate, 1));
+        while (!m_results.empty() && ready.size() < limit) {
+            ready.push_back(std::move(m_results.front()));
+            m_results.pop_front();
+        }
+        m_pendingLoads -= static_cast<int>(ready.size());
+    }
+    
+    bool changed = false;
+    const auto start = std::chrono::steady_clock::now();
+    for (LoadResult& result : ready) {
+        Cell& cell = m_cells[result.cell];
+        m_reservedBytes -= std::min(m_reservedBytes, cell.memoryBytes);
+        cell.state = CellState::Unloaded;
+        // The focus moved away while the cell was loading.
+        if (!result.success || cell.distance > m_settings.unloadRadius) continue;
+        
+        cell.memoryBytes = result.data.getMemoryBytes();
+        instantiateScene(m_scene, std::move(result.data), &cell.entities);
+        cell.state = CellState::Loaded;
+        m_residentBytes += cell.memoryBytes;
+        m_residentEntities += cell.entities.size();
+        ++m_loads;
+        changed = changed || !cell.entities.empty();
+    }
+    if (!ready.empty()) {
+        m_instantiateMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    return changed;
+}
+
+bool StreamingManager::requestLoads() {
+    m_order.clear();
+    for (uint32_t i = 0; i < m_cells.size(); ++i) {
+        if (m_cells[i].state == CellState::Unloaded && m_cells[i].distance <= m_settings.loadRadius) {
+            m_order.push_back(i);
+        }
+    }
+    std::sort(m_order.begin(), m_order.end(), [this](uint32_t a, uint32_t b) {
+        return m_cells[a].distance < m_cells[b].distance;
+    });
+    
+    bool changed = false;
+    std::vector<uint32_t> requested;
+    for (uint32_t index : m_order) {
+        if (m_pendingLoads >= m_settings.maxPendingLoads) break;
+        
+        Cell& cell = m_cells[index];
+        while (m_residentBytes + m_reservedBytes + cell.memoryBytes > m_settings.memoryBudget) {
+            Cell* farthest = findFarthestLoaded(cell.distance);
+            if (!farthest) break;
+            changed = unloadCell(*farthest) || changed;
+        }
+        // Cells farther out would only have to evict nearer ones.
+        if (m_residentBytes + m_reservedBytes + cell.memoryBytes > m_settings.memoryBudget) break;
+        
+        cell.state = CellState::Loading;
+        m_reservedBytes += cell.memoryBytes;
+        ++m_pendingLoads;
+        requested.push_back(index);
+    }
+    
+    if (!requested.empty()) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_requests.insert(m_requests.end(), requested.begin(), requested.end());
+        }
+        m_wake.notify_all();
+    }
+    return changed;
+}
+
+}
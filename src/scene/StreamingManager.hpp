@@ -0,0 +1,140 @@
+#pragma once
+
+#include "SceneFile.hpp"
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace roblox_clone::scene {
+
+class Scene;
+
+// Marks an entity the world streams around, such as a player's character on
+// the server. Clients usually pass their camera to update() instead.
+struct StreamingFocusComponent {
+    uint32_t clientId = 0;
+};
+
+struct StreamingSettings {
+    // Cells within loadRadius of a focus are loaded, nearest first, and stay
+    // until every focus is more than unloadRadius away. The gap between the
+    // two keeps a player walking along a cell edge from thrashing it.
+    float loadRadius = 256.0f;
+    float unloadRadius = 320.0f;
+    // Estimated bytes of streamed entities. Loading a cell over budget evicts
+    // the farthest cells that are farther than it; if that is not enough the
+    // cell waits.
+    size_t memoryBudget = 256ull << 20;
+    int loaderThreads = 1;
+    int maxPendingLoads = 4;
+    // Loaded cells added to the scene per update, to bound the hitch.
+    int maxInstantiatesPerUpdate = 2;
+};
+
+struct StreamingStats {
+    size_t cellCount = 0;
+    size_t loadedCells = 0;
+    size_t pendingCells = 0;
+    size_t residentEntities = 0;
+    size_t residentBytes = 0;
+    uint64_t loads = 0;
+    uint64_t unloads = 0;
+    float instantiateMs = 0.0f;
+};
+
+// Writes scene as a streamable world: entities with a transform go to the
+// sub-scene of the square cell (in x and z) their position falls in, the rest
+// to an always-loaded global file, plus a manifest listing the cells.
+bool partitionScene(const Scene& scene, const std::string& directory, float cellSize);
+
+// Loads and unloads the cells of a partitioned world around focus points.
+// Files are read and decoded on background threads; adding them to the scene
+// and removing them happens in update(), on the thread that owns the scene.
+// Cells own the entities they created, wherever those have moved since.
+class StreamingManager {
+public:
+    explicit StreamingManager(Scene& scene, const StreamingSettings& settings = {});
+    ~StreamingManager();
+    
+    StreamingManager(const StreamingManager&) = delete;
+    StreamingManager& operator=(const StreamingManager&) = delete;
+    
+    // Reads the manifest, loads the global file and starts the loaders.
+    bool open(const std::string& directory);
+    void close();
+    
+    // Streams around the given points and every StreamingFocusComponent.
+    // Returns true if entities were added or removed.
+    bool update(const std::vector<glm::vec3>& focusPoints = {});
+    
+    // True once no loads are queued, running or waiting to be added.
+    bool isIdle() const;
+    bool isCellLoaded(int x, int z) const;
+    
+    const StreamingSettings& getSettings() const { return m_settings; }
+    void setSettings(const StreamingSettings& settings) { m_settings = settings; }
+    StreamingStats getStats() const;
+
+private:
+    enum class CellState : uint8_t {
+        Unloaded,
+        Loading,
+        Loaded,
+    };
+    
+    struct Cell {
+        int x = 0;
+        int z = 0;
+        std::string file;
+        size_t entityCount = 0;
+        size_t memoryBytes = 0;
+        CellState state = CellState::Unloaded;
+        float distance = 0.0f;
+        std::vector<entt::entity> entities;
+    };
+    
+    struct LoadResult {
+        uint32_t cell = 0;
+        bool success = false;
+        SceneData data;
+    };
+    
+    void loaderThread();
+    void computeDistances(const std::vector<glm::vec3>& focusPoints);
+    Cell* findFarthestLoaded(float beyond);
+    bool unloadCell(Cell& cell);
+    bool instantiateReady();
+    bool requestLoads();
+    
+    Scene& m_scene;
+    StreamingSettings m_settings;
+    std::string m_directory;
+    float m_cellSize = 0.0f;
+    std::vector<Cell> m_cells;
+    std::vector<uint32_t> m_order;
+    std::vector<glm::vec3> m_focus;
+    
+    size_t m_residentBytes = 0;
+    size_t m_reservedBytes = 0;
+    size_t m_residentEntities = 0;
+    int m_pendingLoads = 0;
+    uint64_t m_loads = 0;
+    uint64_t m_unloads = 0;
+    float m_instantiateMs = 0.0f;
+    
+    std::vector<std::thread> m_loaders;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<uint32_t> m_requests;
+    std::deque<LoadResult> m_results;
+    std::atomic<bool> m_running{false};
+};
+
+}
@@ -0,0 +1,230 @@
+#include "SystemScheduler.hpp"
+#include "Scene.hpp"
+#include "core/Logger.hpp"
+#include "core/Profiler.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace roblox_clone::scene {
+
+namespace {
+
+bool containsComponent(const std::vector<ComponentAccess>& accesses, entt::id_type id) {
+    return std::any_of(accesses.begin(), accesses.end(), [id](const ComponentAccess& access) {
+        return access.id == id;
+    });
+}
+
+}
+
+bool SystemAccess::canRead(entt::id_type id) const {
+    return exclusive || containsComponent(reads, id) || containsComponent(writes, id);
+}
+
+bool SystemAccess::canWrite(entt::id_type id) const {
+    return exclusive || containsComponent(writes, id);
+}
+
+bool SystemAccess::conflictsWith(const SystemAccess& other) const {
+    if (exclusive || other.exclusive) return true;
+    
+    for (const auto& write : writes) {
+        if (other.canRead(write.id)) return true;
+    }
+    for (const auto& write : other.writes) {
+        if (canRead(write.id)) return true;
+    }
+    return false;
+}
+
+CommandBuffer& SystemContext::commands() {
+    return m_scene.commands();
+}
+
+void SystemContext::checkAccess(entt::id_type id, std::string_view name, bool write) const {
+    if (write ? m_access.canWrite(id) : m_access.canRead(id)) return;
+    
+    RC_ERROR("System touched {} with {} access it did not declare", name, write ? "write" : "read");
+}
+
+SystemScheduler::System& SystemScheduler::addSystem(const std::string& name, SystemAccess access,
+                                                    SystemFunction function) {
+    auto system = std::make_unique<System>();
+    system->name = name;
+    system->access = std::move(access);
+    system->function = std::move(function);
+    m_systems.push_back(std::move(system));
+    return *m_systems.back();
+}
+
+SystemScheduler::System* SystemScheduler::getSystem(const std::string& name) {
+    for (auto& system : m_systems) {
+        if (system->name == name) return system.get();
+    }
+    return nullptr;
+}
+
+void SystemScheduler::setEnabled(const std::string& name, bool enabled) {
+    if (auto* system = getSystem(name)) {
+        system->enabled = enabled;
+    }
+}
+
+void SystemScheduler::buildGraph(entt::registry& registry) {
+    uint32_t count = 0;
+    for (const auto& system : m_systems) {
+        if (system->enabled) ++count;
+    }
+    
+    if (count != m_nodeCount) {
+        m_nodes = std::make_unique<Node[]>(count);
+        m_nodeCount = count;
+    }
+    
+    std::vector<entt::id_type> componentIds;
+    uint32_t nodeIndex = 0;
+    for (auto& system : m_systems) {
+        if (!system->enabled) continue;
+        
+        Node& node = m_nodes[nodeIndex++];
+        node.system = system.get();
+        node.successors.clear();
+        node.dependencies = 0;
+        
+        // Views lazily create missing pools, which is a structural change, so
+        // every declared pool exists before any system runs in parallel.
+        for (const auto* accesses : { &system->access.reads, &system->access.writes }) {
+            for (const auto& access : *accesses) {
+                access.assure(registry);
+                componentIds.push_back(access.id);
+            }
+        }
+    }
+    
+    m_levelCount = 0;
+    for (uint32_t j = 0; j < m_nodeCount; ++j) {
+        Node& node = m_nodes[j];
+        uint32_t level = 0;
+        for (uint32_t i = 0; i < j; ++i) {
+            if (m_nodes[i].system->access.conflictsWith(node.system->access)) {
+                m_nodes[i].successors.push_back(j);
+                ++node.dependencies;
+                level = std::max(level, m_nodes[i].system->stats.level + 1);
+            }
+        }
+        node.remaining.store(node.dependencies, std::memory_order_relaxed);
+        node.system->stats.dependencyCount = node.dependencies;
+        node.system->stats.level = level;
+        m_levelCount = std::max(m_levelCount, level + 1);
+    }
+    
+#ifndef NDEBUG
+    std::sort(componentIds.begin(), componentIds.end());
+    componentIds.erase(std::unique(componentIds.begin(), componentIds.end()), componentIds.end());
+    if (componentIds.size() != m_accessStateCount) {
+        m_accessStates = std::make_unique<AccessState[]>(componentIds.size());
+        m_accessStateCount = componentIds.size();
+    }
+    for (size_t i = 0; i < componentIds.size(); ++i) {
+        m_accessStates[i].id = componentIds[i];
+        m_accessStates[i].readers.store(0, std::memory_order_relaxed);
+        m_accessStates[i].writers.store(0, std::memory_order_relaxed);
+    }
+#endif
+}
+
+void SystemScheduler::execute(Scene& scene, entt::registry& registry, float deltaTime) {
+    RC_PROFILE_SCOPE("SystemScheduler::execute");
+    
+    buildGraph(registry);
+    if (m_nodeCount == 0) return;
+    
+    auto& jobs = core::JobSystem::get();
+    core::JobCounter counter;
+    for (uint32_t i = 0; i < m_nodeCount; ++i) {
+        if (m_nodes[i].dependencies == 0) {
+            jobs.run([this, i, &scene, &registry, deltaTime, &counter]() {
+                runNode(i, scene, registry, deltaTime, counter);
+            }, &counter);
+        }
+    }
+    jobs.wait(counter);
+}
+
+void SystemScheduler::runNode(uint32_t index, Scene& scene, entt::registry& registry, float deltaTime,
+                              core::JobCounter& counter) {
+    Node& node = m_nodes[index];
+    System& system = *node.system;
+    
+    {
+        RC_PROFILE_SCOPE(system.name.c_str());
+#ifndef NDEBUG
+        beginAccess(system.access);
+#endif
+        auto start = std::chrono::steady_clock::now();
+        
+        SystemContext context(scene, registry, system.access, deltaTime);
+        system.function(context);
+        
+        float elapsedMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+        system.stats.lastTimeMs = elapsedMs;
+        system.stats.averageTimeMs = system.stats.averageTimeMs == 0.0f
+            ? elapsedMs : system.stats.averageTimeMs * 0.9f + elapsedMs * 0.1f;
+#ifndef NDEBUG
+        endAccess(system.access);
+#endif
+    }
+    
+    auto& jobs = core::JobSystem::get();
+    for (uint32_t successor : node.successors) {
+        if (m_nodes[successor].remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            jobs.run([this, successor, &scene, &registry, deltaTime, &counter]() {
+                runNode(successor, scene, registry, deltaTime, counter);
+            }, &counter);
+        }
+    }
+}
+
+void SystemScheduler::beginAccess(const SystemAccess& access) {
+    if (access.exclusive) return;
+    
+    auto findState = [this](entt::id_type id) -> AccessState* {
+        for (size_t i = 0; i < m_accessStateCount; ++i) {
+            if (m_accessStates[i].id == id) return &m_accessStates[i];
+        }
+        return nullptr;
+    };
+    
+    for (const auto& write : access.writes) {
+        AccessState* state = findState(write.id);
+        if (state->writers.fetch_add(1, std::memory_order_acq_rel) > 0 ||
+            state->readers.load(std::memory_order_acquire) > 0) {
+            m_conflicts.fetch_add(1, std::memory_order_relaxed);
+            RC_ERROR("System conflict: {} written while another system uses it", write.name);
+        }
+    }
+    for (const auto& read : access.reads) {
+        AccessState* state = findState(read.id);
+        state->readers.fetch_add(1, std::memory_order_acq_rel);
+        if (state->writers.load(std::memory_order_acquire) > 0 && !containsComponent(access.writes, read.id)) {
+            m_conflicts.fetch_add(1, std::memory_order_relaxed);
+            RC_ERROR("System conflict: {} read while another system writes it", read.name);
+        }
+    }
+}
+
+void SystemScheduler::endAccess(const SystemAccess& access) {
+    if (access.exclusive) return;
+    
+    for (size_t i = 0; i < m_accessStateCount; ++i) {
+        AccessState& state = m_accessStates[i];
+        if (containsComponent(access.writes, state.id)) {
+            state.writers.fetch_sub(1, std::memory_order_acq_rel);
+        }
+        if (containsComponent(access.reads, state.id)) {
+            state.readers.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+}
+
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "core/JobSystem.hpp"
+#include <entt/entt.hpp>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace roblox_clone::scene {
+
+class Scene;
+class CommandBuffer;
+
+struct ComponentAccess {
+    entt::id_type id = 0;
+    std::string_view name;
+    void (*assure)(entt::registry&) = nullptr;
+};
+
+// Components a system touches. Systems whose accesses do not conflict (no
+// shared component with at least one writer) may run concurrently; exclusive
+// systems run alone and are the only ones allowed to change structure.
+struct SystemAccess {
+    std::vector<ComponentAccess> reads;
+    std::vector<ComponentAccess> writes;
+    bool exclusive = false;
+    
+    template<typename... Components>
+    SystemAccess& read() {
+        (reads.push_back(describe<Components>()), ...);
+        return *this;
+    }
+    
+    template<typename... Components>
+    SystemAccess& write() {
+        (writes.push_back(describe<Components>()), ...);
+        return *this;
+    }
+    
+    SystemAccess& setExclusive() {
+        exclusive = true;
+        return *this;
+    }
+    
+    bool canRead(entt::id_type id) const;
+    bool canWrite(entt::id_type id) const;
+    bool conflictsWith(const SystemAccess& other) const;
+
+private:
+    template<typename Component>
+    static ComponentAccess describe() {
+        using Type = std::remove_const_t<Component>;
+        return { entt::type_hash<Type>::value(), entt::type_name<Type>::value(),
+                 [](entt::registry& registry) { registry.storage<Type>(); } };
+    }
+};
+
+class SystemContext {
+public:
+    SystemContext(Scene& scene, entt::registry& registry, const SystemAccess& access, float deltaTime)
+        : m_scene(scene), m_registry(registry), m_access(access), m_deltaTime(deltaTime) {}
+    
+    // Returns a view over the requested components. Const components need read
+    // or write access, mutable ones write access; debug builds report any
+    // component the system did not declare.
+    template<typename... Components>
+    auto view() {
+#ifndef NDEBUG
+        (checkAccess(entt::type_hash<std::remove_const_t<Components>>::value(),
+                     entt::type_name<std::remove_const_t<Components>>::value(), !std::is_const_v<Components>), ...);
+#endif
+        return m_registry.view<Components...>();
+    }
+    
+    Scene& getScene() { return m_scene; }
+    // This thread's command buffer; the only way non-exclusive systems may
+    // create, destroy or add and remove components.
+    CommandBuffer& commands();
+    entt::registry& registry() { return m_registry; }
+    float getDeltaTime() const { return m_deltaTime; }
+    const SystemAccess& getAccess() const { return m_access; }
+
+private:
+    void checkAccess(entt::id_type id, std::string_view name, bool write) const;
+    
+    Scene& m_scene;
+    entt::registry& m_registry;
+    const SystemAccess& m_access;
+    float m_deltaTime;
+};
+
+using SystemFunction = std::function<void(SystemContext&)>;
+
+struct SystemStats {
+    float lastTimeMs = 0.0f;
+    float averageTimeMs = 0.0f;
+    uint32_t dependencyCount = 0;
+    uint32_t level = 0;
+};
+
+class SystemScheduler {
+public:
+    struct System {
+        std::string name;
+        SystemAccess access;
+        SystemFunction function;
+        bool enabled = true;
+        SystemStats stats;
+    };
+    
+    SystemScheduler() = default;
+    
+    SystemScheduler(const SystemScheduler&) = delete;
+    SystemScheduler& operator=(const SystemScheduler&) = delete;
+    
+    // Systems keep their registration order wherever they conflict.
+    System& addSystem(const std::string& name, SystemAccess access, SystemFunction function);
+    System* getSystem(const std::string& name);
+    void setEnabled(const std::string& name, bool enabled);
+    
+    void execute(Scene& scene, entt::registry& registry, float deltaTime);
+    
+    size_t getSystemCount() const { return m_systems.size(); }
+    const System& getSystem(size_t index) const { return *m_systems[index]; }
+    uint32_t getLevelCount() const { return m_levelCount; }
+    uint64_t getConflictCount() const { return m_conflicts.load(std::memory_order_relaxed); }
+
+private:
+    struct Node {
+        System* system = nullptr;
+        std::vector<uint32_t> successors;
+        uint32_t dependencies = 0;
+        std::atomic<uint32_t> remaining{0};
+    };
+    
+    void buildGraph(entt::registry& registry);
+    void runNode(uint32_t index, Scene& scene, entt::registry& registry, float deltaTime, core::JobCounter& counter);
+    void beginAccess(const SystemAccess& access);
+    void endAccess(const SystemAccess& access);
+    
+    // Stable addresses: profiler zones keep pointers to system names.
+    std::vector<std::unique_ptr<System>> m_systems;
+    std::unique_ptr<Node[]> m_nodes;
+    uint32_t m_nodeCount = 0;
+    uint32_t m_levelCount = 0;
+    
+    struct AccessState {
+        entt::id_type id = 0;
+        std::atomic<int32_t> readers{0};
+        std::atomic<int32_t> writers{0};
+    };
+    std::unique_ptr<AccessState[]> m_accessStates;
+    size_t m_accessStateCount = 0;
+    std::atomic<uint64_t> m_conflicts{0};
+};
+
+}
@@ -0,0 +1,331 @@
+#include "TransformBatchKernel.hpp"
+#include "Scene.hpp"
+#include "core/Profiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <new>
+
+#ifndef ROBLOX_CLONE_SCENE_AVX2
+#define ROBLOX_CLONE_SCENE_AVX2 0
+#endif
+
+namespace roblox_clone::scene {
+
+#if ROBLOX_CLONE_SCENE_AVX2
+// Built with AVX2 enabled in TransformBatchAvx2.cpp; only called after the CPU
+// check. Each handles whole groups of eight and returns how many it did.
+size_t composeMatricesAvx2(const TransformBatch& transforms, glm::mat4* matrices);
+size_t interpolateTransformsAvx2(const TransformBatch& from, const TransformBatch& to, float alpha,
+                                 TransformBatch& out);
+size_t cullTransformsAvx2(const TransformBatch& transforms, const FrustumPlanes& frustum, uint8_t* visible);
+size_t eulerToQuatAvx2(TransformBatch& transforms, size_t first, size_t end);
+#endif
+
+namespace {
+
+constexpr size_t Alignment = 32;
+constexpr float Identity[TransformBatch::FieldCount] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+
+// Inverse of eulerToQuatLanes: the matrix is Rx * Ry * Rz.
+glm::vec3 quatToEuler(const glm::quat& rotation) {
+    const glm::mat3 m = glm::mat3_cast(rotation);
+    const float x = std::atan2(-m[2][1], m[2][2]);
+    const float y = std::asin(std::clamp(m[2][0], -1.0f, 1.0f));
+    const float z = std::atan2(-m[1][0], m[0][0]);
+    return glm::degrees(glm::vec3(x, y, z));
+}
+
+// Gribb and Hartmann: each plane is the last row of the matrix plus or minus
+// one of the others.
+FrustumPlanes extractPlanes(const glm::mat4& viewProjection) {
+    FrustumPlanes frustum;
+    for (int i = 0; i < 6; ++i) {
+        const int row = i / 2;
+        const float sign = i % 2 == 0 ? 1.0f : -1.0f;
+        for (int column = 0; column < 4; ++column) {
+            frustum.planes[i][column] = viewProjection[column][3] + sign * viewProjection[column][row];
+        }
+    }
+    return frustum;
+}
+
+template<typename V>
+void storeVisible(V mask, uint8_t* visible) {
+    alignas(Alignment) float lanes[V::Width];
+    mask.store(lanes);
+    for (int lane = 0; lane < V::Width; ++lane) {
+        visible[lane] = lanes[lane] != 0.0f ? 1 : 0;
+    }
+}
+
+}
+
+void TransformBatch::AlignedDelete::operator()(float* data) const {
+    ::operator delete(data, std::align_val_t(Alignment));
+}
+
+void TransformBatch::resize(size_t count) {
+    const size_t stride = (count + Padding - 1) / Padding * Padding;
+    if (stride > m_stride) {
+        const size_t capacity = std::max(stride, m_stride * 2);
+        std::unique_ptr<float[], AlignedDelete> data(static_cast<float*>(
+            ::operator new(capacity * FieldCount * sizeof(float), std::align_val_t(Alignment))));
+        for (int field = 0; field < FieldCount; ++field) {
+            float* target = data.get() + field * capacity;
+            if (m_size > 0) std::memcpy(target, this->data(static_cast<Field>(field)), m_size * sizeof(float));
+            std::fill(target + m_size, target + capacity, Identity[field]);
+        }
+        m_data = std::move(data);
+        m_stride = capacity;
+    } else if (count < m_size) {
+        for (int field = 0; field < FieldCount; ++field) {
+            float* values = data(static_cast<Field>(field));
+            std::fill(values + count, values + m_size, Identity[field]);
+        }
+    }
+    m_size = count;
+}
+
+void TransformBatch::set(size_t index, const TransformComponent& transform) {
+    store(index, transform);
+    eulerToQuatLanes<Lanes1>(*this, index);
+}
+
+void TransformBatch::store(size_t index, const TransformComponent& transform) {
+    const float values[FieldCount] = { transform.position.x, transform.position.y, transform.position.z,
+                                       transform.rotation.x, transform.rotation.y, transform.rotation.z, 0.0f,
+                                       transform.scale.x, transform.scale.y, transform.scale.z };
+    for (int field = 0; field < FieldCount; ++field) {
+        data(static_cast<Field>(field))[index] = values[field];
+    }
+}
+
+void TransformBatch::convertRotations(core::SimdKernel kernel, size_t first, size_t end) {
+    if (!isTransformKernelSupported(kernel)) kernel = getBestTransformKernel();
+    switch (kernel) {
+#if ROBLOX_CLONE_SCENE_AVX2
+        case core::SimdKernel::Avx2:
+            first = eulerToQuatAvx2(*this, first, end);
+            break;
+#endif
+#if ROBLOX_CLONE_SSE
+        case core::SimdKernel::Sse:
+            for (; first + Lanes4::Width <= end; first += Lanes4::Width) {
+                eulerToQuatLanes<Lanes4>(*this, first);
+            }
+            break;
+#endif
+        default:
+            break;
+    }
+    for (; first < end; ++first) {
+        eulerToQuatLanes<Lanes1>(*this, first);
+    }
+}
+
+TransformComponent TransformBatch::get(size_t index) const {
+    TransformComponent transform;
+    transform.position = glm::vec3(data(PositionX)[index], data(PositionY)[index], data(PositionZ)[index]);
+    transform.rotation = quatToEuler(getRotation(index));
+    transform.scale = glm::vec3(data(ScaleX)[index], data(ScaleY)[index], data(ScaleZ)[index]);
+    return transform;
+}
+
+glm::quat TransformBatch::getRotation(size_t index) const {
+    return glm::quat(data(RotationW)[index], data(RotationX)[index], data(RotationY)[index], data(RotationZ)[index]);
+}
+
+void TransformBatch::copy(size_t index, const TransformBatch& source, size_t sourceIndex) {
+    for (int field = 0; field < FieldCount; ++field) {
+        data(static_cast<Field>(field))[index] = source.data(static_cast<Field>(field))[sourceIndex];
+    }
+}
+
+void TransformBatch::gather(const entt::registry& registry, const entt::entity* entities, size_t count,
+                            core::SimdKernel kernel) {
+    RC_PROFILE_SCOPE("TransformBatch::gather");
+    resize(count);
+    regather(registry, entities, 0, count, kernel);
+}
+
+void TransformBatch::regather(const entt::registry& registry, const entt::entity* entities, size_t first, size_t end,
+                              core::SimdKernel kernel) {
+    const auto* storage = registry.storage<TransformComponent>();
+    for (size_t i = first; i < end; ++i) {
+        store(i, storage && storage->contains(entities[i]) ? storage->get(entities[i]) : TransformComponent());
+    }
+    convertRotations(kernel, first, end);
+}
+
+void TransformBatch::gatherPrevious(const entt::registry& registry, const entt::entity* entities, size_t count,
+                                    core::SimdKernel kernel) {
+    RC_PROFILE_SCOPE("TransformBatch::gatherPrevious");
+    resize(count);
+    const auto* storage = registry.storage<TransformComponent>();
+    const auto* previous = registry.storage<PreviousTransformComponent>();
+    for (size_t i = 0; i < count; ++i) {
+        const entt::entity entity = entities[i];
+        if (previous && previous->contains(entity)) {
+            store(i, previous->get(entity).transform);
+        } else {
+            store(i, storage && storage->contains(entity) ? storage->get(entity) : TransformComponent());
+        }
+    }
+    convertRotations(kernel, 0, count);
+}
+
+// Without a sync() to drain them, marks stop piling up once there are as
+// many as transforms, and the next sync() refills everything.
+void ResidentTransformBatch::markDirty(entt::entity entity) {
+    if (m_all) return;
+    if (m_dirty.size() >= m_batch.size()) {
+        markAll();
+        return;
+    }
+    m_dirty.push_back(entity);
+}
+
+void ResidentTransformBatch::markAll() {
+    m_all = true;
+    m_dirty.clear();
+}
+
+void ResidentTransformBatch::sync(const entt::registry& registry, uint64_t layoutVersion, core::SimdKernel kernel) {
+    RC_PROFILE_SCOPE("ResidentTransformBatch::sync");
+    const auto* storage = registry.storage<TransformComponent>();
+    const size_t count = storage ? storage->size() : 0;
+    if (m_all || layoutVersion != m_layoutVersion || count != m_batch.size()) {
+        m_batch.gather(registry, storage ? storage->data() : nullptr, count, kernel);
+        m_layoutVersion = layoutVersion;
+        m_reloaded = count;
+        m_all = false;
+        m_dirty.clear();
+        return;
+    }
+    
+    // Whole blocks are reloaded so the wide kernels convert them, and
+    // neighbouring blocks merge into one run.
+    m_dirtyBlocks.clear();
+    for (entt::entity entity : m_dirty) {
+        if (storage->contains(entity)) {
+            m_dirtyBlocks.push_back(static_cast<uint32_t>(storage->index(entity) / TransformBatch::Padding));
+        }
+    }
+    m_dirty.clear();
+    std::sort(m_dirtyBlocks.begin(), m_dirtyBlocks.end());
+    m_dirtyBlocks.erase(std::unique(m_dirtyBlocks.begin(), m_dirtyBlocks.end()), m_dirtyBlocks.end());
+    
+    m_reloaded = 0;
+    for (size_t i = 0; i < m_dirtyBlocks.size();) {
+        size_t last = i;
+        while (last + 1 < m_dirtyBlocks.size() && m_dirtyBlocks[last + 1] == m_dirtyBlocks[last] + 1) ++last;
+        const size_t first = m_dirtyBlocks[i] * TransformBatch::Padding;
+        const size_t end = std::min(count, (m_dirtyBlocks[last] + 1) * TransformBatch::Padding);
+        m_batch.regather(registry, storage->data(), first, end, kernel);
+        m_reloaded += end - first;
+        i = last + 1;
+    }
+}
+
+bool isTransformKernelSupported(core::SimdKernel kernel) {
+    switch (kernel) {
+        case core::SimdKernel::Scalar:
+            return true;
+        case core::SimdKernel::Sse:
+            return ROBLOX_CLONE_SSE != 0;
+        case core::SimdKernel::Avx2:
+            return ROBLOX_CLONE_SCENE_AVX2 != 0 && core::cpuSupportsAvx2();
+    }
+    return false;
+}
+
+core::SimdKernel getBestTransformKernel() {
+    if (isTransformKernelSupported(core::SimdKernel::Avx2)) return core::SimdKernel::Avx2;
+    if (isTransformKernelSupported(core::SimdKernel::Sse)) return core::SimdKernel::Sse;
+    return core::SimdKernel::Scalar;
+}
+
+void composeMatrices(const TransformBatch& transforms, glm::mat4* matrices, core::SimdKernel kernel) {
+    RC_PROFILE_SCOPE("composeMatrices");
+    if (!isTransformKernelSupported(kernel)) kernel = getBestTransformKernel();
+    const size_t count = transforms.size();
+    size_t first = 0;
+    switch (kernel) {
+#if ROBLOX_CLONE_SCENE_AVX2
+        case core::SimdKernel::Avx2:
+            first = composeMatricesAvx2(transforms, matrices);
+            break;
+#endif
+#if ROBLOX_CLONE_SSE
+        case core::SimdKernel::Sse:
+            for (; first + Lanes4::Width <= count; first += Lanes4::Width) {
+                composeLanes<Lanes4>(transforms, first, matrices);
+            }
+            break;
+#endif
+        default:
+            break;
+    }
+    for (; first < count; ++first) {
+        composeLanes<Lanes1>(transforms, first, matrices);
+    }
+}
+
+void interpolateTransforms(const TransformBatch& from, const TransformBatch& to, float alpha, TransformBatch& out,
+                           core::SimdKernel kernel) {
+    RC_PROFILE_SCOPE("interpolateTransforms");
+    if (!isTransformKernelSupported(kernel)) kernel = getBestTransformKernel();
+    const size_t count = std::min(from.size(), to.size());
+    out.resize(count);
+    size_t first = 0;
+    switch (kernel) {
+#if ROBLOX_CLONE_SCENE_AVX2
+        case core::SimdKernel::Avx2:
+            first = interpolateTransformsAvx2(from, to, alpha, out);
+            break;
+#endif
+#if ROBLOX_CLONE_SSE
+        case core::SimdKernel::Sse:
+            for (; first + Lanes4::Width <= count; first += Lanes4::Width) {
+                interpolateLanes<Lanes4>(from, to, alpha, out, first);
+            }
+            break;
+#endif
+        default:
+            break;
+    }
+    for (; first < count; ++first) {
+        interpolateLanes<Lanes1>(from, to, alpha, out, first);
+    }
+}
+
+void cullTransforms(const TransformBatch& transforms, const glm::mat4& viewProjection, uint8_t* visible,
+                    core::SimdKernel kernel) {
+    RC_PROFILE_SCOPE("cullTransforms");
+    if (!isTransformKernelSupported(kernel)) kernel = getBestTransformKernel();
+    const FrustumPlanes frustum = extractPlanes(viewProjection);
+    const size_t count = transforms.size();
+    size_t first = 0;
+    switch (kernel) {
+#if ROBLOX_CLONE_SCENE_AVX2
+        case core::SimdKernel::Avx2:
+            first = cullTransformsAvx2(transforms, frustum, visible);
+            break;
+#endif
+#if ROBLOX_CLONE_SSE
+        case core::SimdKernel::Sse:
+            for (; first + Lanes4::Width <= count; first += Lanes4::Width) {
+                storeVisible(cullLanes<Lanes4>(transforms, frustum, first), visible + first);
+            }
+            break;
+#endif
+        default:
+            break;
+    }
+    for (; first < count; ++first) {
+        storeVisible(cullLanes<Lanes1>(transforms, frustum, first), visible + first);
+    }
+}
+
+}
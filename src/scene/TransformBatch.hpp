@@ -0,0 +1,135 @@
+#pragma once
+
+#include "core/Simd.hpp"
+#include <entt/entity/fwd.hpp>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace roblox_clone::scene {
+
+struct TransformComponent;
+
+bool isTransformKernelSupported(core::SimdKernel kernel);
+// The widest kernel this build and CPU can run.
+core::SimdKernel getBestTransformKernel();
+
+// Transforms in structure of arrays form: every coordinate of position,
+// rotation (as a quaternion) and scale has its own 32-byte aligned float
+// array, padded with identity transforms to a multiple of eight, so the batch
+// kernels below load eight, four or one transform per instruction.
+//
+// The registry keeps storing TransformComponent, which physics, scripts,
+// snapshots and scene files read and write in place; a batch is a copy, kept
+// up to date by ResidentTransformBatch below. set() and get() convert from and
+// to its Euler angles in degrees. gather() copies the components field by
+// field and then converts all the angles with the same SIMD kernels, so
+// consumers stop converting angles entity by entity.
+class TransformBatch {
+public:
+    enum Field : uint8_t {
+        PositionX,
+        PositionY,
+        PositionZ,
+        RotationX,
+        RotationY,
+        RotationZ,
+        RotationW,
+        ScaleX,
+        ScaleY,
+        ScaleZ,
+        FieldCount
+    };
+    
+    static constexpr size_t Padding = 8;
+    
+    // Keeps the first transforms; added ones are identity.
+    void resize(size_t count);
+    size_t size() const { return m_size; }
+    
+    float* data(Field field) { return m_data.get() + field * m_stride; }
+    const float* data(Field field) const { return m_data.get() + field * m_stride; }
+    
+    void set(size_t index, const TransformComponent& transform);
+    TransformComponent get(size_t index) const;
+    glm::quat getRotation(size_t index) const;
+    // Copies transform sourceIndex of source as is, without converting.
+    void copy(size_t index, const TransformBatch& source, size_t sourceIndex);
+    
+    // Copies the transforms of entities, in order. Entities without one get
+    // the identity.
+    void gather(const entt::registry& registry, const entt::entity* entities, size_t count,
+                core::SimdKernel kernel = getBestTransformKernel());
+    // The same for the previous simulation step. Entities without a previous
+    // transform use their current one.
+    void gatherPrevious(const entt::registry& registry, const entt::entity* entities, size_t count,
+                        core::SimdKernel kernel = getBestTransformKernel());
+    // Reloads transforms [first, end) from entities[first, end) without
+    // resizing, converting the range as gather() does.
+    void regather(const entt::registry& registry, const entt::entity* entities, size_t first, size_t end,
+                  core::SimdKernel kernel = getBestTransformKernel());
+
+private:
+    // Writes the Euler angles in degrees where the quaternion goes; gather()
+    // converts them once every transform is in.
+    void store(size_t index, const TransformComponent& transform);
+    void convertRotations(core::SimdKernel kernel, size_t first, size_t end);
+    
+    struct AlignedDelete {
+        void operator()(float* data) const;
+    };
+    
+    std::unique_ptr<float[], AlignedDelete> m_data;
+    size_t m_size = 0;
+    size_t m_stride = 0;
+};
+
+// A TransformBatch that mirrors a registry's TransformComponent storage across
+// frames, in its packed order, so the parts of Scene::renderables() are its
+// first entries. sync() refills it after the storage's layout changed or
+// after markAll(), and otherwise reloads only the eight-wide blocks holding
+// entities passed to markDirty(), converting each block with the SIMD kernel.
+class ResidentTransformBatch {
+public:
+    void markDirty(entt::entity entity);
+    void markAll();
+    
+    // layoutVersion must change whenever entities join, leave or reorder the
+    // storage, as Scene::getPartLayoutVersion() does.
+    void sync(const entt::registry& registry, uint64_t layoutVersion,
+              core::SimdKernel kernel = getBestTransformKernel());
+    
+    const TransformBatch& get() const { return m_batch; }
+    // Transforms the latest sync() reloaded.
+    size_t getReloadedCount() const { return m_reloaded; }
+
+private:
+    TransformBatch m_batch;
+    std::vector<entt::entity> m_dirty;
+    std::vector<uint32_t> m_dirtyBlocks;
+    uint64_t m_layoutVersion = ~uint64_t(0);
+    size_t m_reloaded = 0;
+    bool m_all = true;
+};
+
+// Fills matrices[0, size) with translate * rotate * scale, the model matrices
+// Renderer::computeModelMatrix builds from components. Rotations must be unit
+// quaternions, which set() and interpolateTransforms() ensure.
+void composeMatrices(const TransformBatch& transforms, glm::mat4* matrices,
+                     core::SimdKernel kernel = getBestTransformKernel());
+
+// Blends from toward to by alpha: positions and scales linearly, rotations by
+// normalized lerp along the shorter arc, which for the small steps between
+// two ticks is indistinguishable from slerp. out may be from or to.
+void interpolateTransforms(const TransformBatch& from, const TransformBatch& to, float alpha, TransformBatch& out,
+                           core::SimdKernel kernel = getBestTransformKernel());
+
+// Sets visible[i] to 0 if the unit box of transform i, as parts are drawn,
+// lies entirely outside one plane of the viewProjection frustum, else to 1.
+void cullTransforms(const TransformBatch& transforms, const glm::mat4& viewProjection, uint8_t* visible,
+                    core::SimdKernel kernel = getBestTransformKernel());
+
+}
@@ -0,0 +1,49 @@
+// Compiled with AVX2 enabled (see src/CMakeLists.txt) and only entered after
+// the CPU check in TransformBatch.cpp. FMA stays disabled so results match the
+// SSE and scalar kernels bit for bit.
+
+#include "TransformBatchKernel.hpp"
+
+#if ROBLOX_CLONE_SCENE_AVX2
+
+namespace roblox_clone::scene {
+
+size_t composeMatricesAvx2(const TransformBatch& transforms, glm::mat4* matrices) {
+    size_t first = 0;
+    for (; first + Lanes8::Width <= transforms.size(); first += Lanes8::Width) {
+        composeLanes<Lanes8>(transforms, first, matrices);
+    }
+    return first;
+}
+
+size_t interpolateTransformsAvx2(const TransformBatch& from, const TransformBatch& to, float alpha,
+                                 TransformBatch& out) {
+    size_t first = 0;
+    for (; first + Lanes8::Width <= out.size(); first += Lanes8::Width) {
+        interpolateLanes<Lanes8>(from, to, alpha, out, first);
+    }
+    return first;
+}
+
+size_t cullTransformsAvx2(const TransformBatch& transforms, const FrustumPlanes& frustum, uint8_t* visible) {
+    size_t first = 0;
+    for (; first + Lanes8::Width <= transforms.size(); first += Lanes8::Width) {
+        const __m256 mask = _mm256_cmp_ps(cullLanes<Lanes8>(transforms, frustum, first).value,
+                                          _mm256_setzero_ps(), _CMP_NEQ_OQ);
+        const int bits = _mm256_movemask_ps(mask);
+        for (int lane = 0; lane < Lanes8::Width; ++lane) {
+            visible[first + lane] = static_cast<uint8_t>((bits >> lane) & 1);
+        }
+    }
+    return first;
+}
+
+size_t eulerToQuatAvx2(TransformBatch& transforms, size_t first, size_t end) {
+    for (; first + Lanes8::Width <= end; first += Lanes8::Width) {
+        eulerToQuatLanes<Lanes8>(transforms, first);
+    }
+    return first;
+}
+
+}
+#endif
@@ -0,0 +1,218 @@
+#pragma once
+
+// The kernels behind TransformBatch::gather, composeMatrices,
+// interpolateTransforms and cullTransforms, written once against the lane types of core/SimdLanes.hpp.
+// TransformBatch.cpp and TransformBatchAvx2.cpp both include this with
+// different target flags, so it all lives in an anonymous namespace.
+
+#include "TransformBatch.hpp"
+#include "core/SimdLanes.hpp"
+
+namespace roblox_clone::scene {
+
+// Frustum planes as a, b, c, d with a point p inside when a p.x + b p.y +
+// c p.z + d >= 0.
+struct FrustumPlanes {
+    float planes[6][4];
+};
+
+namespace {
+
+using core::Lanes1;
+#if ROBLOX_CLONE_SSE
+using core::Lanes4;
+#endif
+
+// Writes column `column` of the matrices of V::Width transforms, lane k's
+// column being (x[k], y[k], z[k], w[k]).
+inline void storeColumn(Lanes1 x, Lanes1 y, Lanes1 z, Lanes1 w, glm::mat4* matrices, int column) {
+    matrices[0][column] = glm::vec4(x.value, y.value, z.value, w.value);
+}
+
+#if ROBLOX_CLONE_SSE
+inline void storeColumn(__m128 x, __m128 y, __m128 z, __m128 w, glm::mat4* matrices, int column) {
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+    _mm_storeu_ps(&matrices[0][column][0], x);
+    _mm_storeu_ps(&matrices[1][column][0], y);
+    _mm_storeu_ps(&matrices[2][column][0], z);
+    _mm_storeu_ps(&matrices[3][column][0], w);
+}
+
+inline void storeColumn(Lanes4 x, Lanes4 y, Lanes4 z, Lanes4 w, glm::mat4* matrices, int column) {
+    storeColumn(x.value, y.value, z.value, w.value, matrices, column);
+}
+#endif
+
+#if defined(__AVX2__)
+using core::Lanes8;
+
+inline void storeColumn(Lanes8 x, Lanes8 y, Lanes8 z, Lanes8 w, glm::mat4* matrices, int column) {
+    storeColumn(_mm256_castps256_ps128(x.value), _mm256_castps256_ps128(y.value), _mm256_castps256_ps128(z.value),
+                _mm256_castps256_ps128(w.value), matrices, column);
+    storeColumn(_mm256_extractf128_ps(x.value, 1), _mm256_extractf128_ps(y.value, 1),
+                _mm256_extractf128_ps(z.value, 1), _mm256_extractf128_ps(w.value, 1), matrices + 4, column);
+}
+#endif
+
+template<typename V>
+V loadField(const TransformBatch& transforms, TransformBatch::Field field, size_t first) {
+    return V::load(transforms.data(field) + first);
+}
+
+// Sine and cosine of half of each angle in degrees. The angle is reduced in
+// degrees, so no multiple of pi is rounded, to [-180, 180] for the half angle
+// and folded to [-90, 90], where Taylor series to degree 11 and 12 are within
+// float precision and a zero angle gives exactly 0 and 1.
+template<typename V>
+void halfAngleSinCos(V degrees, V& sine, V& cosine) {
+    constexpr float Radians = 3.14159265358979f / 180.0f;
+    const V turns = max(min(degrees * V(1.0f / 720.0f), V(4194304.0f)), V(-4194304.0f));
+    const V half = (degrees - nearest(turns) * V(720.0f)) * V(0.5f);
+    const auto high = half > V(90.0f);
+    const auto low = half < V(-90.0f);
+    const V x = select(high, V(180.0f) - half, select(low, V(-180.0f) - half, half)) * V(Radians);
+    const V x2 = x * x;
+    
+    V sineSeries(-1.0f / 39916800.0f);
+    for (float coefficient : { 1.0f / 362880.0f, -1.0f / 5040.0f, 1.0f / 120.0f, -1.0f / 6.0f, 1.0f }) {
+        sineSeries = sineSeries * x2 + V(coefficient);
+    }
+    V cosineSeries(1.0f / 479001600.0f);
+    for (float coefficient : { -1.0f / 3628800.0f, 1.0f / 40320.0f, -1.0f / 720.0f, 1.0f / 24.0f, -0.5f, 1.0f }) {
+        cosineSeries = cosineSeries * x2 + V(coefficient);
+    }
+    sine = sineSeries * x;
+    cosine = select(high | low, -cosineSeries, cosineSeries);
+}
+
+// Replaces the Euler angles in degrees that gather() leaves in RotationX, Y
+// and Z with the quaternion of Rx * Ry * Rz.
+template<typename V>
+void eulerToQuatLanes(TransformBatch& transforms, size_t first) {
+    using Field = TransformBatch::Field;
+    V sx, cx, sy, cy, sz, cz;
+    halfAngleSinCos(loadField<V>(transforms, Field::RotationX, first), sx, cx);
+    halfAngleSinCos(loadField<V>(transforms, Field::RotationY, first), sy, cy);
+    halfAngleSinCos(loadField<V>(transforms, Field::RotationZ, first), sz, cz);
+    
+    const V w = cx * cy;
+    const V x = sx * cy;
+    const V y = cx * sy;
+    const V z = sx * sy;
+    (x * cz + y * sz).store(transforms.data(Field::RotationX) + first);
+    (y * cz - x * sz).store(transforms.data(Field::RotationY) + first);
+    (z * cz + w * sz).store(transforms.data(Field::RotationZ) + first);
+    (w * cz - z * sz).store(transforms.data(Field::RotationW) + first);
+}
+
+template<typename V>
+void composeLanes(const TransformBatch& transforms, size_t first, glm::mat4* matrices) {
+    using Field = TransformBatch::Field;
+    const V x = loadField<V>(transforms, Field::RotationX, first);
+    const V y = loadField<V>(transforms, Field::RotationY, first);
+    const V z = loadField<V>(transforms, Field::RotationZ, first);
+    const V w = loadField<V>(transforms, Field::RotationW, first);
+    const V scaleX = loadField<V>(transforms, Field::ScaleX, first);
+    const V scaleY = loadField<V>(transforms, Field::ScaleY, first);
+    const V scaleZ = loadField<V>(transforms, Field::ScaleZ, first);
+    const V one(1.0f);
+    const V two(2.0f);
+    const V zero(0.0f);
+    
+    const V xx = x * x;
+    const V yy = y * y;
+    const V zz = z * z;
+    const V xy = x * y;
+    const V xz = x * z;
+    const V yz = y * z;
+    const V wx = w * x;
+    const V wy = w * y;
+    const V wz = w * z;
+    
+    matrices += first;
+    storeColumn((one - two * (yy + zz)) * scaleX, two * (xy + wz) * scaleX, two * (xz - wy) * scaleX, zero, matrices,
+                0);
+    storeColumn(two * (xy - wz) * scaleY, (one - two * (xx + zz)) * scaleY, two * (yz + wx) * scaleY, zero, matrices,
+                1);
+    storeColumn(two * (xz + wy) * scaleZ, two * (yz - wx) * scaleZ, (one - two * (xx + yy)) * scaleZ, zero, matrices,
+                2);
+    storeColumn(loadField<V>(transforms, Field::PositionX, first), loadField<V>(transforms, Field::PositionY, first),
+                loadField<V>(transforms, Field::PositionZ, first), one, matrices, 3);
+}
+
+template<typename V>
+void interpolateLanes(const TransformBatch& from, const TransformBatch& to, float alpha, TransformBatch& out,
+                      size_t first) {
+    using Field = TransformBatch::Field;
+    const V t(alpha);
+    for (Field field : { Field::PositionX, Field::PositionY, Field::PositionZ, Field::ScaleX, Field::ScaleY,
+                         Field::ScaleZ }) {
+        const V a = loadField<V>(from, field, first);
+        const V b = loadField<V>(to, field, first);
+        (a + (b - a) * t).store(out.data(field) + first);
+    }
+    
+    V a[4];
+    V b[4];
+    V dot(0.0f);
+    for (int i = 0; i < 4; ++i) {
+        const auto field = static_cast<Field>(Field::RotationX + i);
+        a[i] = loadField<V>(from, field, first);
+        b[i] = loadField<V>(to, field, first);
+        dot = dot + a[i] * b[i];
+    }
+    const V sign = select(dot < V(0.0f), V(-1.0f), V(1.0f));
+    V q[4];
+    V length(0.0f);
+    for (int i = 0; i < 4; ++i) {
+        q[i] = a[i] + (b[i] * sign - a[i]) * t;
+        length = length + q[i] * q[i];
+    }
+    length = sqrt(length);
+    for (int i = 0; i < 4; ++i) {
+        (q[i] / length).store(out.data(static_cast<Field>(Field::RotationX + i)) + first);
+    }
+}
+
+// Lane k of the result is 1 if transform first + k may be visible, else 0.
+template<typename V>
+V cullLanes(const TransformBatch& transforms, const FrustumPlanes& frustum, size_t first) {
+    using Field = TransformBatch::Field;
+    const V x = loadField<V>(transforms, Field::RotationX, first);
+    const V y = loadField<V>(transforms, Field::RotationY, first);
+    const V z = loadField<V>(transforms, Field::RotationZ, first);
+    const V w = loadField<V>(transforms, Field::RotationW, first);
+    const V half(0.5f);
+    const V one(1.0f);
+    const V two(2.0f);
+    const V scaleX = loadField<V>(transforms, Field::ScaleX, first) * half;
+    const V scaleY = loadField<V>(transforms, Field::ScaleY, first) * half;
+    const V scaleZ = loadField<V>(transforms, Field::ScaleZ, first) * half;
+    
+    // World space half extents of the rotated box: the absolute rotation
+    // matrix, row by row, times the half scale.
+    const V extentX = abs((one - two * (y * y + z * z)) * scaleX) + abs(two * (x * y - w * z) * scaleY) +
+                      abs(two * (x * z + w * y) * scaleZ);
+    const V extentY = abs(two * (x * y + w * z) * scaleX) + abs((one - two * (x * x + z * z)) * scaleY) +
+                      abs(two * (y * z - w * x) * scaleZ);
+    const V extentZ = abs(two * (x * z - w * y) * scaleX) + abs(two * (y * z + w * x) * scaleY) +
+                      abs((one - two * (x * x + y * y)) * scaleZ);
+    const V centerX = loadField<V>(transforms, Field::PositionX, first);
+    const V centerY = loadField<V>(transforms, Field::PositionY, first);
+    const V centerZ = loadField<V>(transforms, Field::PositionZ, first);
+    
+    V visible(1.0f);
+    for (const auto& plane : frustum.planes) {
+        const V a(plane[0]);
+        const V b(plane[1]);
+        const V c(plane[2]);
+        const V distance = a * centerX + b * centerY + c * centerZ + V(plane[3]);
+        const V radius = abs(a) * extentX + abs(b) * extentY + abs(c) * extentZ;
+        visible = select(distance + radius < V(0.0f), V(0.0f), visible);
+    }
+    return visible;
+}
+
+}
+
+}
@@ -18,11 +18,17 @@ void registerEntityBindings(sol::state& lua) {
     
     entityType["getName"] = [](roblox_clone::scene::Entity& e) -> std::string {
         if (e.hasComponent<roblox_clone::scene::NameComponent>()) {
-            return e.getComponent<roblox_clone::scene::NameComponent>().name;
+            return e.getComponent<roblox_clone::scene::NameComponent>().name.str();
         }
         return "";
     };
     
+    entityType["setName"] = [](roblox_clone::scene::Entity& e, const std::string& name) {
+        if (e.hasComponent<roblox_clone::scene::NameComponent>()) {
+            e.setName(name);
+        }
+    };
+    
     entityType["getPosition"] = [](roblox_clone::scene::Entity& e) -> glm::vec3 {
         if (e.hasComponent<roblox_clone::scene::TransformComponent>()) {
             return e.getComponent<roblox_clone::scene::TransformComponent>().position;
@@ -32,7 +38,7 @@ void registerEntityBindings(sol::state& lua) {
     
     entityType["setPosition"] = [](roblox_clone::scene::Entity& e, const glm::vec3& pos) {
         if (e.hasComponent<roblox_clone::scene::TransformComponent>()) {
-            e.getComponent<roblox_clone::scene::TransformComponent>().position = pos;
+            e.setPosition(pos);
         }
     };
     
@@ -45,7 +51,7 @@ void registerEntityBindings(sol::state& lua) {
     
     entityType["setRotation"] = [](roblox_clone::scene::Entity& e, const glm::vec3& rot) {
         if (e.hasComponent<roblox_clone::scene::TransformComponent>()) {
-            e.getComponent<roblox_clone::scene::TransformComponent>().rotation = rot;
+            e.setRotation(rot);
         }
     };
     
@@ -58,7 +64,7 @@ void registerEntityBindings(sol::state& lua) {
     
     entityType["setScale"] = [](roblox_clone::scene::Entity& e, const glm::vec3& scale) {
         if (e.hasComponent<roblox_clone::scene::TransformComponent>()) {
-            e.getComponent<roblox_clone::scene::TransformComponent>().scale = scale;
+            e.setScale(scale);
         }
     };
 }
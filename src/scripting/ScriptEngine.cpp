@@ -1,16 +1,70 @@
 #include "ScriptEngine.hpp"
 #include "ScriptBindings.hpp"
+#include "core/FrameAllocator.hpp"
 #include "core/Logger.hpp"
+#include "core/Profiler.hpp"
+#include "scene/Entity.hpp"
+#include "scene/Scene.hpp"
+#include <algorithm>
+#include <limits>
+#include <vector>
 
 namespace roblox_clone::scripting {
 
+namespace {
+
+sol::table makePartList(sol::this_state state, scene::Scene* scene, const std::vector<entt::entity>& entities) {
+    sol::state_view lua(state);
+    sol::table parts = lua.create_table(static_cast<int>(entities.size()), 0);
+    for (size_t i = 0; i < entities.size(); ++i) {
+        parts[i + 1] = scene::Entity(entities[i], scene);
+    }
+    return parts;
+}
+
+scene::RaycastParams makeRaycastParams(const sol::optional<sol::table>& ignore) {
+    scene::RaycastParams params;
+    if (ignore) {
+        for (const auto& entry : *ignore) {
+            if (entry.second.is<scene::Entity>()) {
+                params.ignore.push_back(entry.second.as<scene::Entity>());
+            }
+        }
+    }
+    return params;
+}
+
+// Returned to scripts by onChanged and onPropertyChanged.
+struct ChangeConnection {
+    uint32_t id = 0;
+};
+
+sol::object makeRaycastResult(sol::this_state state, scene::Scene* scene, const scene::RaycastResult& hit) {
+    if (!hit) return sol::nil;
+    
+    sol::state_view lua(state);
+    sol::table result = lua.create_table(0, 4);
+    result["instance"] = scene::Entity(hit.entity, scene);
+    result["position"] = hit.position;
+    result["normal"] = hit.normal;
+    result["distance"] = hit.distance;
+    return result;
+}
+
+}
+
 ScriptEngine::ScriptEngine() {
     m_lua = std::make_unique<sol::state>();
 }
 
+ScriptEngine::~ScriptEngine() {
+    disconnectScene();
+}
+
 bool ScriptEngine::initialize() {
     m_lua->open_libraries(sol::lib::base, sol::lib::math, sol::lib::string, sol::lib::table, sol::lib::debug);
     
+    registerAllBindings(*m_lua);
     registerEngineAPI();
     
     RC_INFO("Script engine initialized (Lua {})", LUA_VERSION);
@@ -18,9 +72,21 @@ bool ScriptEngine::initialize() {
 }
 
 void ScriptEngine::shutdown() {
+    disconnectScene();
     m_lua.reset();
 }
 
+void ScriptEngine::update(float deltaTime) {
+    RC_PROFILE_SCOPE("ScriptEngine::update");
+    m_time += deltaTime;
+    (*m_lua)["game"]["deltaTime"] = deltaTime;
+    (*m_lua)["game"]["time"] = m_time;
+}
+
+void ScriptEngine::seedRandom(int64_t seed) {
+    (*m_lua)["math"]["randomseed"](seed);
+}
+
 bool ScriptEngine::loadScript(const std::string& filepath) {
     try {
         auto result = m_lua->script_file(filepath);
@@ -54,12 +120,12 @@ bool ScriptEngine::runScript(const std::string& code) {
 
 void ScriptEngine::registerEngineAPI() {
     (*m_lua)["print"] = [](sol::variadic_args args) {
-        std::string output;
+        core::FrameString output;
         for (auto arg : args) {
-            output += arg.get<std::string>();
+            output += arg.get<std::string_view>();
             output += " ";
         }
-        RC_INFO("[Lua] {}", output);
+        RC_INFO("[Lua] {}", std::string_view(output));
     };
     
     (*m_lua)["Vector3"] = sol::overload(
@@ -89,17 +155,171 @@ void ScriptEngine::registerEngineAPI() {
 void ScriptEngine::registerSceneAPI(scene::Scene* scene) {
     (*m_lua)["workspace"] = (*m_lua).create_table();
     
-    (*m_lua)["workspace"]["findPartByName"] = [scene](const std::string& name) -> sol::object {
+    (*m_lua)["workspace"]["findPartByName"] = [scene](const std::string& name, sol::this_state state) -> sol::object {
         auto entity = scene->getEntityByName(name);
         if (entity) {
-            return sol::make_object(*m_lua, entity);
+            return sol::make_object(state, entity);
         }
         return sol::nil;
     };
     
+    // Spatial queries see edits made earlier in the same script; the hash is
+    // synced on demand, which is a no-op when nothing moved.
+    (*m_lua)["workspace"]["getPartsInRadius"] = [scene](const glm::vec3& center, float radius,
+                                                        sol::this_state state) {
+        scene->updateSpatialHash();
+        std::vector<entt::entity> results;
+        scene->getSpatialHash().queryRadius(center, radius, results);
+        return makePartList(state, scene, results);
+    };
+    
+    (*m_lua)["workspace"]["getPartsInBox"] = [scene](const glm::vec3& center, const glm::vec3& size,
+                                                     sol::this_state state) {
+        scene->updateSpatialHash();
+        std::vector<entt::entity> results;
+        scene->getSpatialHash().queryBox(scene::Aabb::fromCenter(center, glm::abs(size) * 0.5f), results);
+        return makePartList(state, scene, results);
+    };
+    
+    (*m_lua)["workspace"]["getNearestParts"] = [scene](const glm::vec3& position, int count,
+                                                       sol::optional<float> maxDistance, sol::this_state state) {
+        scene->updateSpatialHash();
+        std::vector<entt::entity> results;
+        scene->getSpatialHash().queryNearest(position, static_cast<size_t>(std::max(count, 0)), results,
+                                             maxDistance.value_or(std::numeric_limits<float>::infinity()));
+        return makePartList(state, scene, results);
+    };
+    
+    // Like Roblox, the direction's length is the cast distance.
+    (*m_lua)["workspace"]["raycast"] = [scene](const glm::vec3& origin, const glm::vec3& direction,
+                                               sol::optional<sol::table> ignore, sol::this_state state) {
+        scene->updateRaycaster();
+        auto hit = scene->getRaycaster().raycast(origin, direction, glm::length(direction), makeRaycastParams(ignore));
+        return makeRaycastResult(state, scene, hit);
+    };
+    
+    (*m_lua)["workspace"]["spherecast"] = [scene](const glm::vec3& origin, float radius, const glm::vec3& direction,
+                                                  sol::optional<sol::table> ignore, sol::this_state state) {
+        scene->updateRaycaster();
+        auto hit = scene->getRaycaster().spherecast(origin, radius, direction, glm::length(direction),
+                                                    makeRaycastParams(ignore));
+        return makeRaycastResult(state, scene, hit);
+    };
+    
     (*m_lua)["workspace"]["createPart"] = [scene](const std::string& name) {
         return scene->createEntity(name);
     };
+    
+    // Change events arrive at the end of the tick, once per property however
+    // often it was written, with the property's name:
+    //   part:onChanged(function(property) ... end)
+    //   part:onPropertyChanged("Position", function() ... end)
+    auto connectionType = m_lua->new_usertype<ChangeConnection>("ChangeConnection", sol::no_constructor);
+    connectionType["disconnect"] = [this](ChangeConnection& connection) {
+        disconnectChanged(connection.id);
+        connection.id = 0;
+    };
+    
+    auto entityType = (*m_lua)["Entity"].get<sol::usertype<scene::Entity>>();
+    entityType["onChanged"] = [this](scene::Entity& entity, sol::protected_function callback) {
+        return ChangeConnection{ connectChanged(entity, ~scene::PropertyMask(0), std::move(callback)) };
+    };
+    entityType["onPropertyChanged"] = [this](scene::Entity& entity, const std::string& name,
+                                             sol::protected_function callback, sol::this_state state) -> sol::object {
+        scene::Property property;
+        if (!scene::findProperty(name, property)) {
+            RC_WARN("Unknown property '{}'", name);
+            return sol::nil;
+        }
+        return sol::make_object(state, ChangeConnection{ connectChanged(entity, scene::propertyBit(property),
+                                                                        std::move(callback)) });
+    };
+    
+    disconnectScene();
+    m_scene = scene;
+    for (size_t component = 0; component < static_cast<size_t>(scene::TrackedComponent::Count); ++component) {
+        m_trackerListeners.push_back(scene->getChangeTracker().addListener(
+            static_cast<scene::TrackedComponent>(component), [this](const scene::ChangeBatch& batch) {
+                onChangeBatch(batch);
+            }));
+    }
+    scene->registry().on_destroy<entt::entity>().connect<&ScriptEngine::onEntityDestroyed>(this);
+}
+
+uint32_t ScriptEngine::connectChanged(entt::entity entity, scene::PropertyMask properties,
+                                      sol::protected_function callback) {
+    const uint32_t id = m_nextConnectionId++;
+    m_changeListeners[entity].push_back({ id, properties, std::move(callback) });
+    m_changeConnections[id] = entity;
+    return id;
+}
+
+void ScriptEngine::disconnectChanged(uint32_t id) {
+    auto connection = m_changeConnections.find(id);
+    if (connection == m_changeConnections.end()) return;
+    
+    auto it = m_changeListeners.find(connection->second);
+    if (it != m_changeListeners.end()) {
+        auto& listeners = it->second;
+        listeners.erase(std::remove_if(listeners.begin(), listeners.end(),
+                                       [id](const ChangeListener& listener) { return listener.id == id; }),
+                        listeners.end());
+        if (listeners.empty()) {
+            m_changeListeners.erase(it);
+        }
+    }
+    m_changeConnections.erase(connection);
+}
+
+void ScriptEngine::disconnectScene() {
+    m_changeListeners.clear();
+    m_changeConnections.clear();
+    if (!m_scene) return;
+    
+    for (uint32_t id : m_trackerListeners) {
+        m_scene->getChangeTracker().removeListener(id);
+    }
+    m_trackerListeners.clear();
+    m_scene->registry().on_destroy<entt::entity>().disconnect<&ScriptEngine::onEntityDestroyed>(this);
+    m_scene = nullptr;
+}
+
+void ScriptEngine::onChangeBatch(const scene::ChangeBatch& batch) {
+    if (m_changeListeners.empty()) return;
+    
+    RC_PROFILE_SCOPE("ScriptEngine::onChangeBatch");
+    for (size_t i = 0; i < batch.count; ++i) {
+        auto it = m_changeListeners.find(batch.entities[i]);
+        if (it == m_changeListeners.end()) continue;
+        
+        // Copied, since callbacks may connect or disconnect.
+        const std::vector<ChangeListener> listeners = it->second;
+        for (const ChangeListener& listener : listeners) {
+            const scene::PropertyMask properties = batch.properties[i] & listener.properties;
+            for (uint8_t bit = 0; bit < static_cast<uint8_t>(scene::Property::Count); ++bit) {
+                const auto property = static_cast<scene::Property>(bit);
+                if ((properties & scene::propertyBit(property)) == 0) continue;
+                if (m_changeConnections.find(listener.id) == m_changeConnections.end()) break;
+                
+                auto result = listener.callback(scene::getPropertyName(property));
+                if (!result.valid()) {
+                    sol::error err = result;
+                    RC_ERROR("Change listener error: {}", err.what());
+                }
+            }
+        }
+    }
+}
+
+void ScriptEngine::onEntityDestroyed(entt::registry& registry, entt::entity entity) {
+    (void)registry;
+    auto it = m_changeListeners.find(entity);
+    if (it == m_changeListeners.end()) return;
+    
+    for (const ChangeListener& listener : it->second) {
+        m_changeConnections.erase(listener.id);
+    }
+    m_changeListeners.erase(it);
 }
 
 }
@@ -1,8 +1,12 @@
 #pragma once
 
+#include "scene/ChangeTracker.hpp"
 #include <sol/sol.hpp>
+#include <cstdint>
 #include <string>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace roblox_clone::scene { class Scene; }
 
@@ -11,10 +15,11 @@ namespace roblox_clone::scripting {
 class ScriptEngine {
 public:
     ScriptEngine();
-    ~ScriptEngine() = default;
+    ~ScriptEngine();
     
     bool initialize();
     void shutdown();
+    void update(float deltaTime);
     
     bool loadScript(const std::string& filepath);
     bool runScript(const std::string& code);
@@ -24,13 +29,36 @@ public:
     void registerEngineAPI();
     void registerSceneAPI(scene::Scene* scene);
     
+    // Lua seeds math.random from the clock; lockstep peers need the same seed.
+    void seedRandom(int64_t seed);
+    
     template<typename T>
     void setGlobal(const std::string& name, T&& value) {
         (*m_lua)[name] = std::forward<T>(value);
     }
 
 private:
+    // A Lua function connected to property changes of one entity.
+    struct ChangeListener {
+        uint32_t id = 0;
+        scene::PropertyMask properties = 0;
+        sol::protected_function callback;
+    };
+    
+    uint32_t connectChanged(entt::entity entity, scene::PropertyMask properties, sol::protected_function callback);
+    void disconnectChanged(uint32_t id);
+    void disconnectScene();
+    void onChangeBatch(const scene::ChangeBatch& batch);
+    void onEntityDestroyed(entt::registry& registry, entt::entity entity);
+    
     std::unique_ptr<sol::state> m_lua;
+    float m_time = 0.0f;
+    
+    scene::Scene* m_scene = nullptr;
+    std::vector<uint32_t> m_trackerListeners;
+    std::unordered_map<entt::entity, std::vector<ChangeListener>> m_changeListeners;
+    std::unordered_map<uint32_t, entt::entity> m_changeConnections;
+    uint32_t m_nextConnectionId = 1;
 };
 
 }
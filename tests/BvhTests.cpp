@@ -0,0 +1,226 @@
+#include "BvhTests.hpp"
+#include "TestUtils.hpp"
+#include "scene/Scene.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace roblox_clone;
+
+namespace {
+
+constexpr float MaxDistance = 1000.0f;
+
+// Same slab test the tree runs on its nodes, so distances compare exactly.
+bool intersectAabb(const scene::Aabb& bounds, const scene::BvhRay& ray, float maxDistance, float& distance) {
+    const glm::vec3 nearT = (bounds.min - ray.origin) * ray.inverseDirection;
+    const glm::vec3 farT = (bounds.max - ray.origin) * ray.inverseDirection;
+    distance = 0.0f;
+    float exit = maxDistance;
+    for (int axis = 0; axis < 3; ++axis) {
+        if (std::isnan(nearT[axis]) || std::isnan(farT[axis])) continue;
+        distance = std::max(distance, std::min(nearT[axis], farT[axis]));
+        exit = std::min(exit, std::max(nearT[axis], farT[axis]));
+    }
+    return distance <= exit;
+}
+
+std::vector<scene::Aabb> randomBounds(std::mt19937& random, size_t count) {
+    std::uniform_real_distribution<float> coordinate(-200.0f, 200.0f);
+    std::uniform_real_distribution<float> size(0.25f, 6.0f);
+    std::vector<scene::Aabb> bounds;
+    for (size_t i = 0; i < count; ++i) {
+        const glm::vec3 center(coordinate(random), coordinate(random), coordinate(random));
+        bounds.push_back(scene::Aabb::fromCenter(center, glm::vec3(size(random), size(random), size(random))));
+    }
+    return bounds;
+}
+
+// Rays start outside the boxes and aim at a random point among them.
+scene::BvhRay randomRay(std::mt19937& random) {
+    std::uniform_real_distribution<float> coordinate(-200.0f, 200.0f);
+    std::normal_distribution<float> axis(0.0f, 1.0f);
+    const glm::vec3 origin = glm::normalize(glm::vec3(axis(random), axis(random), axis(random))) * 400.0f;
+    const glm::vec3 target(coordinate(random), coordinate(random), coordinate(random));
+    return scene::BvhRay(origin, glm::normalize(target - origin), MaxDistance);
+}
+
+// Nearest hit through the tree; slotBounds is indexed by primitive slot.
+float nearestInTree(const scene::Bvh4& bvh, const std::vector<scene::Aabb>& slotBounds, const scene::BvhRay& ray) {
+    float nearest = std::numeric_limits<float>::infinity();
+    bvh.traverse(ray, 0.0f, [&](uint32_t slot, float& closest) {
+        float distance = 0.0f;
+        if (!intersectAabb(slotBounds[slot], ray, closest, distance)) return;
+        closest = distance;
+        nearest = std::min(nearest, distance);
+    });
+    return nearest;
+}
+
+float nearestBruteForce(const std::vector<scene::Aabb>& bounds, const scene::BvhRay& ray) {
+    float nearest = std::numeric_limits<float>::infinity();
+    for (const scene::Aabb& box : bounds) {
+        float distance = 0.0f;
+        if (intersectAabb(box, ray, ray.maxDistance, distance)) nearest = std::min(nearest, distance);
+    }
+    return nearest;
+}
+
+std::vector<scene::Aabb> inSlotOrder(const scene::Bvh4& bvh, const std::vector<scene::Aabb>& bounds) {
+    std::vector<scene::Aabb> slotBounds;
+    for (uint32_t primitive : bvh.getOrder()) {
+        slotBounds.push_back(bounds[primitive]);
+    }
+    return slotBounds;
+}
+
+// Every primitive appears once in the order and the nearest hit matches a
+// scan over all boxes, including trees deep enough to need several levels.
+bool testNearestMatchesBruteForce() {
+    const char* name = "NearestMatchesBruteForce";
+    std::mt19937 random(17);
+    bool passed = true;
+    for (size_t count : { size_t(1), size_t(3), size_t(17), size_t(3000) }) {
+        const std::vector<scene::Aabb> bounds = randomBounds(random, count);
+        scene::Bvh4 bvh;
+        bvh.build(bounds);
+        
+        std::vector<uint32_t> order = bvh.getOrder();
+        std::sort(order.begin(), order.end());
+        bool complete = order.size() == count;
+        for (size_t i = 0; complete && i < count; ++i) {
+            complete = order[i] == i;
+        }
+        passed = expect(complete, name, "order is not a permutation of the primitives") && passed;
+        
+        const std::vector<scene::Aabb> slotBounds = inSlotOrder(bvh, bounds);
+        for (int query = 0; passed && query < 300; ++query) {
+            const scene::BvhRay ray = randomRay(random);
+            passed = expect(nearestInTree(bvh, slotBounds, ray) == nearestBruteForce(bounds, ray), name,
+                            "nearest hit differs") && passed;
+        }
+    }
+    
+    scene::Bvh4 empty;
+    empty.build({});
+    bool visited = false;
+    empty.traverse(scene::BvhRay(glm::vec3(0.0f), glm::vec3(0, 0, -1), MaxDistance),
+                   0.0f, [&](uint32_t, float&) { visited = true; });
+    passed = expect(empty.isEmpty() && !visited, name, "empty tree visited a leaf") && passed;
+    return passed;
+}
+
+// After the boxes move, a refit tree still finds the same hits as a scan.
+bool testRefitFollowsBounds() {
+    const char* name = "RefitFollowsBounds";
+    std::mt19937 random(23);
+    std::vector<scene::Aabb> bounds = randomBounds(random, 1500);
+    scene::Bvh4 bvh;
+    bvh.build(bounds);
+    
+    std::uniform_real_distribution<float> offset(-40.0f, 40.0f);
+    for (scene::Aabb& box : bounds) {
+        const glm::vec3 delta(offset(random), offset(random), offset(random));
+        box = scene::Aabb(box.min + delta, box.max + delta);
+    }
+    const std::vector<scene::Aabb> slotBounds = inSlotOrder(bvh, bounds);
+    bvh.refit(slotBounds);
+    
+    bool passed = true;
+    for (int query = 0; passed && query < 500; ++query) {
+        const scene::BvhRay ray = randomRay(random);
+        passed = expect(nearestInTree(bvh, slotBounds, ray) == nearestBruteForce(bounds, ray), name,
+                        "nearest hit differs after refit");
+    }
+    return passed;
+}
+
+// Rays along an axis that start on a box's slab plane divide zero by zero in
+// the slab test. They still hit the box, whichever sign the zero has.
+bool testRayOnSlabPlane() {
+    const char* name = "RayOnSlabPlane";
+    std::vector<scene::Aabb> bounds;
+    for (int i = 0; i < 9; ++i) {
+        const glm::vec3 corner(static_cast<float>(i % 3) * 4.0f, static_cast<float>(i / 3) * 4.0f, 0.0f);
+        bounds.emplace_back(corner, corner + glm::vec3(2.0f));
+    }
+    scene::Bvh4 bvh;
+    bvh.build(bounds);
+    const std::vector<scene::Aabb> slotBounds = inSlotOrder(bvh, bounds);
+    
+    bool passed = true;
+    for (float zero : { 0.0f, -0.0f }) {
+        for (const glm::vec3& origin : { glm::vec3(4.0f, 5.0f, 10.0f), glm::vec3(6.0f, 4.0f, 10.0f),
+                                         glm::vec3(0.0f, 0.0f, 10.0f) }) {
+            const scene::BvhRay ray(origin, glm::vec3(zero, zero, -1.0f), MaxDistance);
+            passed = expect(nearestInTree(bvh, slotBounds, ray) == 8.0f, name, "ray on a slab plane missed") &&
+                     passed;
+        }
+    }
+    return passed;
+}
+
+// Axis-aligned parts so the scan can use their bounds as the part shape.
+bool testSceneRaycasts() {
+    const char* name = "SceneRaycasts";
+    scene::Scene scene;
+    auto& registry = scene.registry();
+    std::mt19937 random(31);
+    std::vector<entt::entity> parts;
+    for (const scene::Aabb& box : randomBounds(random, 1000)) {
+        const entt::entity entity = registry.create();
+        scene::TransformComponent transform(box.getCenter());
+        transform.scale = box.max - box.min;
+        registry.emplace<scene::TransformComponent>(entity, transform);
+        registry.emplace<scene::MeshRendererComponent>(entity);
+        parts.push_back(entity);
+    }
+    scene.updateRaycaster();
+    const auto& raycaster = scene.getRaycaster();
+    
+    auto bruteForce = [&](const scene::BvhRay& ray, entt::entity ignored) {
+        float nearest = std::numeric_limits<float>::infinity();
+        for (entt::entity entity : parts) {
+            float distance = 0.0f;
+            const auto bounds = scene::Aabb::fromTransform(registry.get<scene::TransformComponent>(entity));
+            if (entity != ignored && intersectAabb(bounds, ray, ray.maxDistance, distance)) {
+                nearest = std::min(nearest, distance);
+            }
+        }
+        return nearest;
+    };
+    auto matches = [](const scene::RaycastResult& result, float expected) {
+        if (!result) return std::isinf(expected);
+        return std::abs(result.distance - expected) < 1.0e-3f;
+    };
+    
+    bool passed = true;
+    for (int query = 0; passed && query < 300; ++query) {
+        const scene::BvhRay ray = randomRay(random);
+        const scene::RaycastResult hit = raycaster.raycast(ray.origin, ray.direction * 3.0f, ray.maxDistance);
+        passed = expect(matches(hit, bruteForce(ray, entt::null)), name, "raycast differs from scan") && passed;
+        if (!hit) continue;
+        
+        scene::RaycastParams params;
+        params.ignore.push_back(hit.entity);
+        const scene::RaycastResult behind = raycaster.raycast(ray.origin, ray.direction, ray.maxDistance, params);
+        passed = expect(matches(behind, bruteForce(ray, hit.entity)), name, "ignored part still hit") && passed;
+    }
+    
+    // Moving a part refits the tree and the cast finds it at its new place.
+    const uint64_t refits = raycaster.getStats().refitCount;
+    scene::Entity(parts[7], &scene).setPosition(glm::vec3(0.0f, 600.0f, 0.0f));
+    scene.updateRaycaster();
+    const scene::RaycastResult moved = raycaster.raycast(glm::vec3(0.0f, 700.0f, 0.0f), glm::vec3(0, -1, 0), 200.0f);
+    passed = expect(raycaster.getStats().refitCount == refits + 1, name, "move did not refit") && passed;
+    passed = expect(moved.entity == parts[7], name, "moved part not hit") && passed;
+    return passed;
+}
+
+}
+
+int runBvhTests() {
+    return runTests({ testNearestMatchesBruteForce, testRefitFollowsBounds, testRayOnSlabPlane, testSceneRaycasts });
+}
@@ -0,0 +1,264 @@
+#include "ChangeTrackerTests.hpp"
+#include "TestUtils.hpp"
+#include "scene/Entity.hpp"
+#include "scene/PropertyReplication.hpp"
+#include "scene/Scene.hpp"
+#include <vector>
+
+using namespace roblox_clone;
+
+namespace {
+
+struct Received {
+    scene::TrackedComponent component;
+    std::vector<entt::entity> entities;
+    std::vector<scene::PropertyMask> properties;
+};
+
+void listenToAll(scene::Scene& scene, std::vector<Received>& received) {
+    for (size_t component = 0; component < static_cast<size_t>(scene::TrackedComponent::Count); ++component) {
+        scene.getChangeTracker().addListener(static_cast<scene::TrackedComponent>(component),
+            [&received](const scene::ChangeBatch& batch) {
+                received.push_back({ batch.component, { batch.entities, batch.entities + batch.count },
+                                     { batch.properties, batch.properties + batch.count } });
+            });
+    }
+}
+
+// Repeated writes to a property make one event, and a write of the current
+// value makes none.
+bool testCoalesce() {
+    const char* name = "Coalesce";
+    scene::Scene scene;
+    scene::Entity part = scene.createEntity("Part");
+    scene::Entity other = scene.createEntity("Other");
+    std::vector<Received> received;
+    listenToAll(scene, received);
+    
+    for (int i = 1; i <= 5; ++i) {
+        part.setPosition(glm::vec3(static_cast<float>(i)));
+    }
+    part.setScale(glm::vec3(2.0f));
+    part.setName("Renamed");
+    other.setRotation(glm::vec3(0.0f));
+    other.setName("Other");
+    bool passed = expect(scene.getChangeTracker().isChanged(part, scene::Property::Position), name, "not marked");
+    scene.dispatchChanges();
+    
+    passed = expect(received.size() == 2, name, "expected a transform and a name batch") && passed;
+    if (received.size() == 2) {
+        const Received& transforms = received[0];
+        passed = expect(transforms.component == scene::TrackedComponent::Transform &&
+                        transforms.entities.size() == 1 && transforms.entities[0] == entt::entity(part),
+                        name, "wrong transform batch") && passed;
+        passed = expect(transforms.properties[0] == (scene::propertyBit(scene::Property::Position) |
+                                                     scene::propertyBit(scene::Property::Scale)),
+                        name, "wrong transform properties") && passed;
+        passed = expect(received[1].component == scene::TrackedComponent::Name &&
+                        received[1].entities.size() == 1, name, "wrong name batch") && passed;
+    }
+    passed = expect(part.getComponent<scene::TransformComponent>().position == glm::vec3(5.0f), name,
+                    "last write lost") && passed;
+    
+    received.clear();
+    scene.dispatchChanges();
+    passed = expect(received.empty() && scene.getChangeTracker().getPendingCount() == 0, name,
+                    "changes sent twice") && passed;
+    return passed;
+}
+
+// Listeners see only the changed entities, however many there are; writes
+// from a listener go out with the next dispatch, and destroyed entities drop
+// out.
+bool testOnlyChanged() {
+    const char* name = "OnlyChanged";
+    scene::Scene scene;
+    std::vector<scene::Entity> parts;
+    for (int i = 0; i < 10000; ++i) {
+        parts.push_back(scene.createEntity("Part"));
+    }
+    
+    size_t batches = 0;
+    size_t seen = 0;
+    bool wroteBack = false;
+    scene.getChangeTracker().addListener(scene::TrackedComponent::Transform,
+        [&](const scene::ChangeBatch& batch) {
+            ++batches;
+            seen += batch.count;
+            if (!wroteBack) {
+                parts[0].setPosition(glm::vec3(-1.0f));
+                wroteBack = true;
+            }
+        });
+    
+    parts[17].setPosition(glm::vec3(1.0f));
+    parts[4242].setRotation(glm::vec3(90.0f, 0.0f, 0.0f));
+    parts[9999].setScale(glm::vec3(3.0f));
+    parts[5000].setPosition(glm::vec3(4.0f));
+    scene.destroyEntity(parts[5000]);
+    scene.dispatchChanges();
+    bool passed = expect(batches == 1 && seen == 3, name, "listener saw unchanged or destroyed entities");
+    passed = expect(scene.getChangeTracker().getStats().changedEntities == 3, name, "wrong stats") && passed;
+    
+    scene.dispatchChanges();
+    passed = expect(batches == 2 && seen == 4, name, "write from listener not sent next dispatch") && passed;
+    scene.dispatchChanges();
+    passed = expect(batches == 2, name, "empty dispatch called listener") && passed;
+    return passed;
+}
+
+// A write from a Transform listener to a component dispatched later in the
+// same loop still waits for the next dispatch.
+bool testListenerWritesOtherComponent() {
+    const char* name = "ListenerWritesOtherComponent";
+    scene::Scene scene;
+    scene::Entity part = scene.createEntity("Part");
+    part.addComponent<scene::MeshRendererComponent>();
+    
+    size_t nameBatches = 0;
+    size_t meshBatches = 0;
+    auto& tracker = scene.getChangeTracker();
+    tracker.addListener(scene::TrackedComponent::Transform, [&](const scene::ChangeBatch&) {
+        part.setName("Renamed");
+        part.setVisible(false);
+    });
+    tracker.addListener(scene::TrackedComponent::Name, [&](const scene::ChangeBatch&) { ++nameBatches; });
+    tracker.addListener(scene::TrackedComponent::MeshRenderer, [&](const scene::ChangeBatch&) { ++meshBatches; });
+    
+    part.setPosition(glm::vec3(1.0f));
+    scene.dispatchChanges();
+    bool passed = expect(nameBatches == 0 && meshBatches == 0, name, "listener write joined the same dispatch");
+    passed = expect(tracker.getPendingCount() == 2, name, "listener writes not queued") && passed;
+    scene.dispatchChanges();
+    passed = expect(nameBatches == 1 && meshBatches == 1, name, "listener writes not sent next dispatch") && passed;
+    return passed;
+}
+
+// Only static parts invalidate the cached static geometry: adding, patching
+// or removing a dynamic part's mesh renderer leaves the version alone, while
+// a part leaving the static set still bumps it.
+bool testStaticGeometryVersion() {
+    const char* name = "StaticGeometryVersion";
+    scene::Scene scene;
+    auto& registry = scene.registry();
+    scene::Entity dynamicPart = scene.createEntity("Dynamic");
+    scene::Entity staticPart = scene.createEntity("Static");
+    
+    uint64_t version = scene.getStaticGeometryVersion();
+    dynamicPart.addComponent<scene::MeshRendererComponent>();
+    registry.patch<scene::MeshRendererComponent>(dynamicPart, [](auto& meshRenderer) { meshRenderer.visible = false; });
+    dynamicPart.setCastShadows(false);
+    dynamicPart.removeComponent<scene::MeshRendererComponent>();
+    bool passed = expect(scene.getStaticGeometryVersion() == version, name, "dynamic part invalidated the cache");
+    
+    staticPart.addComponent<scene::MeshRendererComponent>().isStatic = true;
+    registry.patch<scene::MeshRendererComponent>(staticPart);
+    passed = expect(scene.getStaticGeometryVersion() > version, name, "static part not seen") && passed;
+    version = scene.getStaticGeometryVersion();
+    registry.patch<scene::MeshRendererComponent>(staticPart, [](auto& meshRenderer) { meshRenderer.isStatic = false; });
+    passed = expect(scene.getStaticGeometryVersion() > version, name, "part leaving the static set not seen") && passed;
+    version = scene.getStaticGeometryVersion();
+    staticPart.removeComponent<scene::MeshRendererComponent>();
+    passed = expect(scene.getStaticGeometryVersion() == version, name, "former static part invalidated") && passed;
+    return passed;
+}
+
+// Three parts with network ids; created in a different order on each side so
+// the entity handles do not line up.
+std::vector<scene::Entity> spawnReplicated(scene::Scene& scene, bool reversed) {
+    std::vector<scene::Entity> parts(3);
+    for (int i = 0; i < 3; ++i) {
+        const int index = reversed ? 2 - i : i;
+        parts[index] = scene.createEntity("Part");
+        parts[index].addComponent<scene::MeshRendererComponent>();
+        parts[index].addComponent<scene::NetworkComponent>().networkId = 100 + index;
+    }
+    parts[2].getComponent<scene::NetworkComponent>().isReplicated = false;
+    return parts;
+}
+
+// The server's change records, applied on a client, reproduce the replicated
+// properties through the setters, so the client raises its own events.
+bool testReplicateToClient() {
+    const char* name = "ReplicateToClient";
+    scene::Scene server;
+    scene::Scene client;
+    (void)client.createEntity("Unreplicated");
+    std::vector<scene::Entity> serverParts = spawnReplicated(server, false);
+    std::vector<scene::Entity> clientParts = spawnReplicated(client, true);
+    
+    std::vector<uint8_t> packet;
+    uint32_t count = 0;
+    for (auto component : { scene::TrackedComponent::Transform, scene::TrackedComponent::MeshRenderer }) {
+        server.getChangeTracker().addListener(component, [&](const scene::ChangeBatch& batch) {
+            count += scene::writePropertyChanges(server.registry(), batch, packet);
+        });
+    }
+    std::vector<Received> received;
+    listenToAll(client, received);
+    
+    serverParts[0].setPosition(glm::vec3(1.0f, 2.0f, 3.0f));
+    serverParts[0].setVisible(false);
+    serverParts[1].setScale(glm::vec3(4.0f));
+    serverParts[1].setStatic(true);
+    serverParts[1].setName("NotSent");
+    serverParts[2].setPosition(glm::vec3(9.0f));
+    server.dispatchChanges();
+    bool passed = expect(count == 4, name, "expected a transform and a mesh renderer record per part");
+    
+    passed = expect(scene::applyPropertyChanges(client, packet.data(), packet.size(), count), name,
+                    "well-formed packet rejected") && passed;
+    const auto& first = clientParts[0].getComponent<scene::TransformComponent>();
+    const auto& second = clientParts[1].getComponent<scene::TransformComponent>();
+    passed = expect(first.position == glm::vec3(1.0f, 2.0f, 3.0f) && first.scale == glm::vec3(1.0f) &&
+                    second.scale == glm::vec3(4.0f), name, "transforms not applied") && passed;
+    passed = expect(!clientParts[0].getComponent<scene::MeshRendererComponent>().visible &&
+                    clientParts[1].getComponent<scene::MeshRendererComponent>().isStatic &&
+                    clientParts[1].getComponent<scene::MeshRendererComponent>().visible,
+                    name, "mesh renderer flags not applied") && passed;
+    passed = expect(clientParts[2].getComponent<scene::TransformComponent>().position == glm::vec3(0.0f) &&
+                    clientParts[1].getComponent<scene::NameComponent>().name == core::StringId("Part"),
+                    name, "unreplicated change applied") && passed;
+    
+    client.dispatchChanges();
+    size_t changed = 0;
+    for (const Received& batch : received) {
+        changed += batch.entities.size();
+    }
+    passed = expect(changed == 4, name, "client did not raise change events") && passed;
+    
+    passed = expect(!scene::applyPropertyChanges(client, packet.data(), packet.size() - 1, count), name,
+                    "truncated packet accepted") && passed;
+    return passed;
+}
+
+// The network id index follows components added after the first lookup, ids
+// patched to new values, and destroyed entities.
+bool testNetworkLookup() {
+    const char* name = "NetworkLookup";
+    scene::Scene scene;
+    std::vector<scene::Entity> parts = spawnReplicated(scene, false);
+    bool passed = expect(scene.findNetworkEntity(101) == parts[1], name, "id not found");
+    passed = expect(scene.findNetworkEntity(7) == entt::null, name, "unknown id found") && passed;
+    
+    scene::Entity late = scene.createEntity("Late");
+    late.addComponent<scene::NetworkComponent>().networkId = 7;
+    passed = expect(scene.findNetworkEntity(7) == late, name, "later component not indexed") && passed;
+    
+    scene.registry().patch<scene::NetworkComponent>(parts[0], [](scene::NetworkComponent& network) {
+        network.networkId = 200;
+    });
+    passed = expect(scene.findNetworkEntity(200) == parts[0] && scene.findNetworkEntity(100) == entt::null, name,
+                    "patched id not followed") && passed;
+    
+    scene.destroyEntity(parts[1]);
+    passed = expect(scene.findNetworkEntity(101) == entt::null, name, "destroyed entity found") && passed;
+    return passed;
+}
+
+}
+
+int runChangeTrackerTests() {
+    return runTests({ testCoalesce, testOnlyChanged, testListenerWritesOtherComponent, testStaticGeometryVersion,
+                      testReplicateToClient, testNetworkLookup });
+}
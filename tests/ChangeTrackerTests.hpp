@@ -0,0 +1,4 @@
+#pragma once
+
+// Returns the number of failed tests.
+int runChangeTrackerTests();
@@ -0,0 +1,130 @@
+#include "CommandBufferTests.hpp"
+#include "TestUtils.hpp"
+#include "core/JobSystem.hpp"
+#include "scene/Scene.hpp"
+
+using namespace roblox_clone;
+
+namespace {
+
+struct Tag {};
+
+// Entities created in a buffer only exist after playback, where they pick up
+// everything queued against them.
+bool testDeferredCreate() {
+    const char* name = "DeferredCreate";
+    scene::Scene scene;
+    auto& commands = scene.commands();
+    auto first = commands.createEntity("First");
+    auto second = commands.create();
+    commands.emplace<Tag>(second);
+    commands.emplace<scene::MeshRendererComponent>(first);
+    commands.remove<scene::MeshRendererComponent>(first);
+    bool passed = expect(scene.registry().view<Tag>().size() == 0, name, "created before playback");
+    
+    const scene::CommandPlaybackStats stats = scene.flushCommands();
+    passed = expect(stats.created == 2, name, "expected two created entities") && passed;
+    auto named = scene.registry().view<scene::NameComponent>();
+    auto tagged = scene.registry().view<Tag>();
+    passed = expect(named.size() == 1 && tagged.size() == 1, name, "components missing after playback") && passed;
+    if (passed) {
+        const entt::entity entity = named.front();
+        passed = expect(scene.registry().get<scene::NameComponent>(entity).name == "First", name, "wrong name");
+        passed = expect(!scene.registry().all_of<scene::MeshRendererComponent>(entity), name,
+                        "remove did not follow emplace") && passed;
+        passed = expect(tagged.front() != entity, name, "tag landed on the wrong entity") && passed;
+    }
+    return passed;
+}
+
+// Emplaces and removes of one component settle in recorded order, and an
+// entity created in a buffer can be destroyed by the same buffer.
+bool testRecordedOrder() {
+    const char* name = "RecordedOrder";
+    scene::Scene scene;
+    auto& registry = scene.registry();
+    const entt::entity existing = registry.create();
+    registry.emplace<scene::NameComponent>(existing, "Old");
+    
+    auto& commands = scene.commands();
+    commands.remove<scene::NameComponent>(existing);
+    commands.emplace<scene::NameComponent>(existing, "New");
+    commands.emplace<Tag>(existing);
+    commands.remove<Tag>(existing);
+    commands.emplace<Tag>(existing);
+    auto temporary = commands.createEntity("Temporary");
+    commands.destroy(temporary);
+    const scene::CommandPlaybackStats stats = scene.flushCommands();
+    
+    bool passed = expect(registry.all_of<scene::NameComponent>(existing) &&
+                         registry.get<scene::NameComponent>(existing).name == "New", name,
+                         "emplace after remove was dropped");
+    passed = expect(registry.all_of<Tag>(existing), name, "last emplace lost to an earlier remove") && passed;
+    passed = expect(stats.created == 1 && stats.destroyed == 1, name, "created entity not destroyed") && passed;
+    passed = expect(registry.view<scene::NameComponent>().size() == 1, name, "destroyed entity still alive") &&
+             passed;
+    
+    commands.emplace<Tag>(existing);
+    commands.remove<Tag>(existing);
+    scene.flushCommands();
+    passed = expect(!registry.all_of<Tag>(existing), name, "remove after emplace was dropped") && passed;
+    return passed;
+}
+
+// Once an entity has been recycled enough times every bit of its handle is in
+// use, so it must not be mistaken for a deferred one.
+bool testHighVersionEntity() {
+    const char* name = "HighVersionEntity";
+    scene::Scene scene;
+    auto& registry = scene.registry();
+    entt::entity entity = registry.create();
+    for (int i = 0; i < 2048; ++i) {
+        registry.destroy(entity);
+        entity = registry.create();
+    }
+    bool passed = expect(entt::to_integral(entity) >= 0x80000000u, name, "version did not reach the top bit");
+    
+    // Without a deferred create there would be nothing to misread it as.
+    scene.commands().emplace<Tag>(entity);
+    scene.flushCommands();
+    passed = expect(registry.all_of<Tag>(entity), name, "tag missing without deferred creates") && passed;
+    
+    registry.remove<Tag>(entity);
+    auto& commands = scene.commands();
+    auto created = commands.create();
+    commands.emplace<scene::NameComponent>(created, "Created");
+    commands.emplace<Tag>(entity);
+    scene.flushCommands();
+    passed = expect(registry.all_of<Tag>(entity), name, "tag missing with deferred creates") && passed;
+    passed = expect(registry.view<Tag>().size() == 1, name, "tag landed on a created entity") && passed;
+    return passed;
+}
+
+// Workers record into their own buffers, and a new queue never reuses a
+// buffer that belonged to a destroyed one.
+bool testThreadLocalBuffers() {
+    const char* name = "ThreadLocalBuffers";
+    core::JobSystem& jobs = core::JobSystem::get();
+    jobs.initialize(3);
+    bool passed = true;
+    for (int round = 0; passed && round < 4; ++round) {
+        scene::Scene scene;
+        jobs.parallelFor(1000, [&scene](size_t begin, size_t end) {
+            auto& commands = scene.commands();
+            for (size_t i = begin; i < end; ++i) {
+                commands.emplace<Tag>(commands.create());
+            }
+        });
+        const scene::CommandPlaybackStats stats = scene.flushCommands();
+        passed = expect(stats.created == 1000 && stats.commands == 2000, name, "wrong command count");
+        passed = expect(scene.registry().view<Tag>().size() == 1000, name, "tags missing") && passed;
+    }
+    jobs.shutdown();
+    return passed;
+}
+
+}
+
+int runCommandBufferTests() {
+    return runTests({ testDeferredCreate, testRecordedOrder, testHighVersionEntity, testThreadLocalBuffers });
+}
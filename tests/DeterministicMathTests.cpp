@@ -0,0 +1,44 @@
+#include "DeterministicMathTests.hpp"
+#include "TestUtils.hpp"
+#include "core/DeterministicMath.hpp"
+#include <cmath>
+
+using namespace roblox_clone;
+
+namespace {
+
+constexpr float Tolerance = 4.0e-7f;
+
+// Deterministic trig must stay within a few float ulps of libm everywhere
+// the simulation uses it.
+bool testTrigMatchesLibm() {
+    const char* name = "TrigMatchesLibm";
+    bool passed = true;
+    for (int i = -20000; passed && i <= 20000; ++i) {
+        const float angle = static_cast<float>(i) * 0.001f;
+        passed = expect(std::abs(core::deterministicSin(angle) - std::sin(angle)) < Tolerance, name, "sin differs");
+        passed = expect(std::abs(core::deterministicCos(angle) - std::cos(angle)) < Tolerance, name,
+                        "cos differs") && passed;
+    }
+    for (int i = -1000; passed && i <= 1000; ++i) {
+        const float value = static_cast<float>(i) * 0.001f;
+        passed = expect(std::abs(core::deterministicAsin(value) - std::asin(value)) < Tolerance, name, "asin differs");
+    }
+    for (int i = 0; passed && i < 3600; ++i) {
+        const float angle = static_cast<float>(i) * 0.1f * 0.017453292f;
+        const float y = 3.0f * std::sin(angle);
+        const float x = 3.0f * std::cos(angle);
+        passed = expect(std::abs(core::deterministicAtan2(y, x) - std::atan2(y, x)) < 2.0f * Tolerance, name,
+                        "atan2 differs");
+    }
+    passed = expect(core::deterministicAtan2(0.0f, 0.0f) == 0.0f, name, "atan2 of the origin") && passed;
+    passed = expect(core::deterministicAtan2(1.0f, 0.0f) == std::atan2(1.0f, 0.0f), name, "atan2 on the y axis") &&
+             passed;
+    return passed;
+}
+
+}
+
+int runDeterministicMathTests() {
+    return runTests({ testTrigMatchesLibm });
+}
@@ -0,0 +1,86 @@
+#include "JobSystemTests.hpp"
+#include "TestUtils.hpp"
+#include "core/JobSystem.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace roblox_clone;
+
+namespace {
+
+constexpr uint32_t Overflow = core::JobSystem::JobPoolSize * 3;
+
+// More jobs in flight than one thread's pool holds must all run exactly once.
+bool testPoolOverflow() {
+    const char* name = "PoolOverflow";
+    core::JobSystem& jobs = core::JobSystem::get();
+    jobs.initialize(3);
+    std::vector<std::atomic<uint32_t>> runs(Overflow);
+    core::JobCounter counter;
+    for (uint32_t i = 0; i < Overflow; ++i) {
+        jobs.run([&runs, i]() { runs[i].fetch_add(1, std::memory_order_relaxed); }, &counter);
+    }
+    jobs.wait(counter);
+    jobs.shutdown();
+    
+    bool passed = true;
+    for (uint32_t i = 0; passed && i < Overflow; ++i) {
+        passed = expect(runs[i].load() == 1, name, "a job ran twice or not at all");
+    }
+    return passed;
+}
+
+// Continuations parked on a counter hold their slots until they run, even
+// when there are more of them than the pool has slots. Once the pool runs
+// out runAfter waits on the dependency, so a separate thread releases it.
+bool testParkedContinuations() {
+    const char* name = "ParkedContinuations";
+    core::JobSystem& jobs = core::JobSystem::get();
+    jobs.initialize(3);
+    std::atomic<bool> release{false};
+    std::atomic<uint32_t> submitted{0};
+    std::atomic<uint32_t> continued{0};
+    core::JobCounter dependency;
+    core::JobCounter done;
+    jobs.run([&release]() {
+        while (!release.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }, &dependency);
+    std::thread releaser([&]() {
+        while (submitted.load(std::memory_order_acquire) < core::JobSystem::JobPoolSize - 8) {
+            std::this_thread::yield();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        release.store(true, std::memory_order_release);
+    });
+    for (uint32_t i = 0; i < Overflow; ++i) {
+        jobs.runAfter(dependency, [&continued]() { continued.fetch_add(1, std::memory_order_relaxed); }, &done);
+        submitted.fetch_add(1, std::memory_order_release);
+    }
+    jobs.wait(done);
+    releaser.join();
+    jobs.shutdown();
+    return expect(continued.load() == Overflow, name, "continuations lost or repeated");
+}
+
+// Jobs still queued at shutdown run instead of being dropped.
+bool testShutdownDrains() {
+    const char* name = "ShutdownDrains";
+    core::JobSystem& jobs = core::JobSystem::get();
+    jobs.initialize(2);
+    std::atomic<uint32_t> ran{0};
+    for (uint32_t i = 0; i < 1000; ++i) {
+        jobs.run([&ran]() { ran.fetch_add(1, std::memory_order_relaxed); });
+    }
+    jobs.shutdown();
+    return expect(ran.load() == 1000, name, "shutdown dropped queued jobs");
+}
+
+}
+
+int runJobSystemTests() {
+    return runTests({ testPoolOverflow, testParkedContinuations, testShutdownDrains });
+}
@@ -0,0 +1,376 @@
+#include "PhysicsTests.hpp"
+#include "TestUtils.hpp"
+#include "physics/BoxBatch.hpp"
+#include "physics/PhysicsWorld.hpp"
+#include "core/JobSystem.hpp"
+#include "scene/Scene.hpp"
+#include <glm/gtc/quaternion.hpp>
+#include <spdlog/spdlog.h>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace roblox_clone;
+using namespace roblox_clone::physics;
+
+namespace {
+
+constexpr float Margin = 0.05f;
+
+struct BoxPair {
+    glm::vec3 halfA;
+    Pose poseA;
+    glm::vec3 halfB;
+    Pose poseB;
+};
+
+bool sameBits(const ContactManifold& a, const ContactManifold& b) {
+    if (a.pointCount != b.pointCount) return false;
+    if (std::memcmp(&a.normal, &b.normal, sizeof(a.normal)) != 0) return false;
+    for (int i = 0; i < a.pointCount; ++i) {
+        if (std::memcmp(&a.points[i].position, &b.points[i].position, sizeof(a.points[i].position)) != 0) return false;
+        if (std::memcmp(&a.points[i].penetration, &b.points[i].penetration, sizeof(float)) != 0) return false;
+    }
+    return true;
+}
+
+Pose makePose(const glm::vec3& position, const glm::quat& orientation) {
+    return { position, glm::mat3_cast(glm::normalize(orientation)) };
+}
+
+// Random orientations plus the degenerate cases clipping gets wrong most
+// easily: identical aligned boxes whose corners coincide, quarter turns,
+// parallel edges and pairs just outside the margin.
+std::vector<BoxPair> makePairs(int count) {
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> size(0.2f, 1.5f);
+    const glm::quat quarterTurn = glm::angleAxis(glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    
+    std::vector<BoxPair> pairs;
+    for (int i = 0; i < count; ++i) {
+        BoxPair pair;
+        pair.halfA = glm::vec3(size(random), size(random), size(random));
+        pair.halfB = glm::vec3(size(random), size(random), size(random));
+        const glm::quat randomA(unit(random), unit(random), unit(random), unit(random) + 1.5f);
+        const glm::quat randomB(unit(random), unit(random), unit(random), unit(random) + 1.5f);
+        const glm::vec3 offset(unit(random), unit(random), unit(random));
+        switch (i % 5) {
+            case 0:
+                pair.poseA = makePose(glm::vec3(0.0f), randomA);
+                pair.poseB = makePose(offset * 1.5f, randomB);
+                break;
+            case 1:
+                pair.halfB = pair.halfA;
+                pair.poseA = makePose(glm::vec3(offset.x, 0.0f, offset.z), glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+                pair.poseB = makePose(pair.poseA.position + glm::vec3(0.0f, 2.0f * pair.halfA.y - 0.01f, 0.0f),
+                                      glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+                break;
+            case 2:
+                pair.poseA = makePose(glm::vec3(0.0f), quarterTurn);
+                pair.poseB = makePose(glm::vec3(offset.x * 0.5f, pair.halfA.y + pair.halfB.y - 0.02f, offset.z * 0.5f),
+                                      quarterTurn * quarterTurn);
+                break;
+            case 3:
+                pair.poseA = makePose(glm::vec3(0.0f), randomA);
+                pair.poseB = makePose(offset * 0.3f, randomA * quarterTurn);
+                break;
+            default:
+                pair.poseA = makePose(glm::vec3(0.0f), randomA);
+                pair.poseB = makePose(glm::normalize(offset) * (glm::length(pair.halfA) + glm::length(pair.halfB) + 0.06f),
+                                      randomB);
+                break;
+        }
+        pairs.push_back(pair);
+    }
+    return pairs;
+}
+
+// Runs pairs through a kernel in batches of 1 to 8, so partly filled
+// batches are covered too.
+std::vector<ContactManifold> collideAll(const std::vector<BoxPair>& pairs, SimdKernel kernel,
+                                        std::vector<bool>& touching) {
+    std::vector<ContactManifold> manifolds(pairs.size());
+    touching.assign(pairs.size(), false);
+    size_t next = 0;
+    for (int batchSize = 1; next < pairs.size(); batchSize = batchSize % BoxPairBatch::MaxPairs + 1) {
+        BoxPairBatch batch;
+        const size_t first = next;
+        for (; next < pairs.size() && batch.count < batchSize; ++next) {
+            batch.add(pairs[next].halfA, pairs[next].poseA, pairs[next].halfB, pairs[next].poseB);
+        }
+        const uint32_t mask = collideBoxBatch(batch, Margin, &manifolds[first], kernel);
+        for (int lane = 0; lane < batch.count; ++lane) {
+            touching[first + lane] = (mask & (1u << lane)) != 0;
+        }
+    }
+    return manifolds;
+}
+
+bool testRestingBox() {
+    const char* name = "RestingBox";
+    ContactManifold manifold;
+    const Pose ground = makePose(glm::vec3(0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+    const Pose box = makePose(glm::vec3(0.2f, 1.49f, -0.1f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+    bool passed = expect(collideBoxes(glm::vec3(4.0f, 1.0f, 4.0f), ground, glm::vec3(0.5f), box, Margin, manifold),
+                         name, "no contact");
+    passed = passed && expect(manifold.pointCount == 4, name, "expected four points");
+    passed = passed && expect(glm::length(manifold.normal - glm::vec3(0.0f, 1.0f, 0.0f)) < 1.0e-5f, name, "wrong normal");
+    for (int i = 0; passed && i < manifold.pointCount; ++i) {
+        passed = expect(std::abs(manifold.points[i].penetration - 0.01f) < 1.0e-4f, name, "wrong penetration");
+    }
+    return passed;
+}
+
+bool testCrossedEdges() {
+    const char* name = "CrossedEdges";
+    ContactManifold manifold;
+    const glm::quat tiltA = glm::angleAxis(glm::radians(45.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+    const glm::quat tiltB = glm::angleAxis(glm::radians(45.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+    const Pose poseA = makePose(glm::vec3(0.0f), tiltA);
+    const Pose poseB = makePose(glm::vec3(0.0f, std::sqrt(2.0f) - 0.02f, 0.0f), tiltB);
+    bool passed = expect(collideBoxes(glm::vec3(0.5f), poseA, glm::vec3(0.5f), poseB, Margin, manifold), name,
+                         "no contact");
+    passed = passed && expect(manifold.pointCount == 1, name, "expected one point");
+    passed = passed && expect(manifold.normal.y > 0.999f, name, "wrong normal");
+    return passed;
+}
+
+bool testSeparatedBoxes() {
+    ContactManifold manifold;
+    const Pose poseA = makePose(glm::vec3(0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+    const Pose poseB = makePose(glm::vec3(1.1f, 0.0f, 0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+    return expect(!collideBoxes(glm::vec3(0.5f), poseA, glm::vec3(0.5f), poseB, Margin, manifold), "SeparatedBoxes",
+                  "reported a contact");
+}
+
+// Every SIMD kernel must reproduce the scalar kernel's manifolds bit for bit.
+bool testKernelsMatchScalar() {
+    const char* name = "KernelsMatchScalar";
+    const std::vector<BoxPair> pairs = makePairs(20000);
+    std::vector<bool> expectedTouching;
+    const std::vector<ContactManifold> expected = collideAll(pairs, SimdKernel::Scalar, expectedTouching);
+    
+    bool passed = true;
+    for (SimdKernel kernel : { SimdKernel::Sse, SimdKernel::Avx2 }) {
+        if (!isKernelSupported(kernel)) {
+            spdlog::info("{}: {} kernel not available, skipped", name, getKernelName(kernel));
+            continue;
+        }
+        std::vector<bool> touching;
+        const std::vector<ContactManifold> manifolds = collideAll(pairs, kernel, touching);
+        size_t mismatches = 0;
+        for (size_t i = 0; i < pairs.size(); ++i) {
+            if (touching[i] != expectedTouching[i] || (touching[i] && !sameBits(manifolds[i], expected[i]))) {
+                ++mismatches;
+            }
+        }
+        if (mismatches > 0) {
+            spdlog::error("{}: {} kernel differs from scalar on {} of {} pairs", name, getKernelName(kernel),
+                          mismatches, pairs.size());
+            passed = false;
+        }
+    }
+    
+    // Single pairs go through the scalar lane as well.
+    for (size_t i = 0; i < pairs.size() && passed; ++i) {
+        ContactManifold manifold;
+        const bool touching = collideBoxes(pairs[i].halfA, pairs[i].poseA, pairs[i].halfB, pairs[i].poseB, Margin,
+                                           manifold);
+        passed = expect(touching == expectedTouching[i] && (!touching || sameBits(manifold, expected[i])), name,
+                        "collideBoxes differs from the batch");
+    }
+    return passed;
+}
+
+// A projectile covering ten studs a step fired at a wall a tenth of a stud
+// thick. Without continuous collision it passes straight through; with it,
+// it stops in front of the wall. Runs the same steps every time, so the
+// outcome never depends on timing.
+struct ShotResult {
+    float finalZ = 0.0f;
+    size_t continuousBodies = 0;
+};
+
+ShotResult fireAtWall(ShapeType shape, bool continuous) {
+    scene::Scene scene;
+    auto& registry = scene.registry();
+    const entt::entity wall = registry.create();
+    scene::TransformComponent wallTransform(glm::vec3(0.0f));
+    wallTransform.scale = glm::vec3(10.0f, 10.0f, 0.1f);
+    registry.emplace<scene::TransformComponent>(wall, wallTransform);
+    registry.emplace<RigidBodyComponent>(wall, BodyType::Static, ShapeType::Box);
+    
+    const entt::entity projectile = registry.create();
+    scene::TransformComponent transform(glm::vec3(0.0f, 0.0f, -5.0f));
+    transform.scale = glm::vec3(0.5f);
+    registry.emplace<scene::TransformComponent>(projectile, transform);
+    RigidBodyComponent& rigidBody = registry.emplace<RigidBodyComponent>(projectile, BodyType::Dynamic, shape);
+    rigidBody.linearVelocity = glm::vec3(0.0f, 0.0f, 600.0f);
+    rigidBody.continuous = continuous;
+    
+    PhysicsSettings settings;
+    settings.gravity = glm::vec3(0.0f);
+    PhysicsWorld world(settings);
+    world.attach(scene);
+    ShotResult result;
+    for (int step = 0; step < 30; ++step) {
+        world.step(1.0f / 60.0f);
+        result.continuousBodies = std::max(result.continuousBodies, world.getStats().continuousBodyCount);
+    }
+    result.finalZ = registry.get<scene::TransformComponent>(projectile).position.z;
+    return result;
+}
+
+bool testContinuousCollision() {
+    const char* name = "ContinuousCollision";
+    bool passed = true;
+    for (ShapeType shape : { ShapeType::Box, ShapeType::Sphere }) {
+        const ShotResult discrete = fireAtWall(shape, false);
+        const ShotResult continuous = fireAtWall(shape, true);
+        passed = expect(discrete.finalZ > 0.0f, name, "discrete projectile should tunnel") && passed;
+        passed = expect(discrete.continuousBodies == 0, name, "discrete projectile counted as continuous") && passed;
+        passed = expect(continuous.finalZ < -0.25f && continuous.finalZ > -0.35f, name,
+                        "continuous projectile did not stop at the wall") && passed;
+        passed = expect(continuous.continuousBodies == 1, name, "continuous projectile not counted") && passed;
+    }
+    return passed;
+}
+
+// A box asleep on the ground must fall once a script moves the ground out
+// from under it, even though only the ground was edited.
+bool testWakeWhenSupportMoves() {
+    const char* name = "WakeWhenSupportMoves";
+    scene::Scene scene;
+    auto& registry = scene.registry();
+    const entt::entity ground = registry.create();
+    scene::TransformComponent groundTransform(glm::vec3(0.0f, -0.5f, 0.0f));
+    groundTransform.scale = glm::vec3(4.0f, 1.0f, 4.0f);
+    registry.emplace<scene::TransformComponent>(ground, groundTransform);
+    registry.emplace<RigidBodyComponent>(ground, BodyType::Static, ShapeType::Box);
+    
+    const entt::entity box = registry.create();
+    registry.emplace<scene::TransformComponent>(box, glm::vec3(0.0f, 0.5f, 0.0f));
+    registry.emplace<RigidBodyComponent>(box, BodyType::Dynamic, ShapeType::Box);
+    
+    PhysicsWorld world;
+    world.attach(scene);
+    for (int step = 0; step < 120 && (step == 0 || world.getStats().awakeBodyCount > 0); ++step) {
+        world.step(1.0f / 60.0f);
+    }
+    bool passed = expect(world.getStats().awakeBodyCount == 0, name, "box never fell asleep");
+    
+    registry.patch<scene::TransformComponent>(ground, [](scene::TransformComponent& transform) {
+        transform.position.x += 100.0f;
+    });
+    for (int step = 0; step < 30; ++step) {
+        world.step(1.0f / 60.0f);
+    }
+    passed = expect(registry.get<scene::TransformComponent>(box).position.y < 0.0f, name,
+                    "box kept floating where the ground was") && passed;
+    return passed;
+}
+
+// Sleeping bodies are only read back when an edit is reported: a move made
+// through Entity and a velocity set through registry.patch() must both wake
+// the body they touch.
+bool testEditsWakeSleepingBodies() {
+    const char* name = "EditsWakeSleepingBodies";
+    scene::Scene scene;
+    auto& registry = scene.registry();
+    const entt::entity ground = registry.create();
+    registry.emplace<scene::TransformComponent>(ground);
+    registry.emplace<RigidBodyComponent>(ground, BodyType::Static, ShapeType::Plane);
+    const entt::entity lifted = registry.create();
+    registry.emplace<scene::TransformComponent>(lifted, glm::vec3(0.0f, 0.5f, 0.0f));
+    registry.emplace<RigidBodyComponent>(lifted, BodyType::Dynamic, ShapeType::Box);
+    const entt::entity pushed = registry.create();
+    registry.emplace<scene::TransformComponent>(pushed, glm::vec3(10.0f, 0.5f, 0.0f));
+    registry.emplace<RigidBodyComponent>(pushed, BodyType::Dynamic, ShapeType::Box);
+    
+    PhysicsWorld world;
+    world.attach(scene);
+    for (int step = 0; step < 120 && (step == 0 || world.getStats().awakeBodyCount > 0); ++step) {
+        world.step(1.0f / 60.0f);
+    }
+    bool passed = expect(world.getStats().awakeBodyCount == 0, name, "boxes never fell asleep");
+    passed = expect(world.getStats().contactCount == 2, name, "resting contacts not counted") && passed;
+    
+    scene::Entity(lifted, &scene).setPosition(glm::vec3(0.0f, 5.0f, 0.0f));
+    registry.patch<RigidBodyComponent>(pushed, [](RigidBodyComponent& rigidBody) {
+        rigidBody.linearVelocity = glm::vec3(0.0f, 0.0f, 20.0f);
+    });
+    world.step(1.0f / 60.0f);
+    passed = expect(world.getStats().awakeBodyCount == 2, name, "edits did not wake both boxes") && passed;
+    passed = expect(registry.get<scene::TransformComponent>(lifted).position.y < 5.0f, name,
+                    "lifted box did not fall") && passed;
+    passed = expect(registry.get<scene::TransformComponent>(pushed).position.z > 0.0f, name,
+                    "pushed box did not move") && passed;
+    return passed;
+}
+
+// Separate piles of tumbling boxes and balls, so steps have many islands to
+// spread over the workers. Returns the state hash after every step.
+std::vector<uint64_t> simulatePiles(int steps) {
+    scene::Scene scene;
+    auto& registry = scene.registry();
+    const entt::entity ground = registry.create();
+    scene::TransformComponent groundTransform(glm::vec3(0.0f, -0.5f, 0.0f));
+    groundTransform.scale = glm::vec3(200.0f, 1.0f, 200.0f);
+    registry.emplace<scene::TransformComponent>(ground, groundTransform);
+    registry.emplace<RigidBodyComponent>(ground, BodyType::Static, ShapeType::Box);
+    
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> jitter(-0.2f, 0.2f);
+    for (int pile = 0; pile < 16; ++pile) {
+        const glm::vec3 base(static_cast<float>(pile % 4) * 8.0f, 0.5f, static_cast<float>(pile / 4) * 8.0f);
+        for (int level = 0; level < 6; ++level) {
+            const entt::entity entity = registry.create();
+            scene::TransformComponent transform(base + glm::vec3(jitter(random), level * 1.1f, jitter(random)));
+            transform.rotation = glm::vec3(jitter(random), jitter(random), jitter(random)) * 50.0f;
+            registry.emplace<scene::TransformComponent>(entity, transform);
+            registry.emplace<RigidBodyComponent>(entity, BodyType::Dynamic,
+                                                 level % 3 == 2 ? ShapeType::Sphere : ShapeType::Box);
+        }
+    }
+    
+    PhysicsWorld world;
+    world.attach(scene);
+    std::vector<uint64_t> hashes;
+    for (int step = 0; step < steps; ++step) {
+        world.step(1.0f / 60.0f);
+        hashes.push_back(scene.computeStateHash());
+    }
+    return hashes;
+}
+
+// The same scene must hash identically every tick whether it runs serially
+// or spread over workers.
+bool testDeterministicSimulation() {
+    const char* name = "DeterministicSimulation";
+    core::JobSystem& jobs = core::JobSystem::get();
+    jobs.setDeterministic(true);
+    const std::vector<uint64_t> serial = simulatePiles(120);
+    jobs.initialize(3);
+    const std::vector<uint64_t> threaded = simulatePiles(120);
+    jobs.shutdown();
+    jobs.setDeterministic(false);
+    
+    bool passed = expect(serial.front() != serial.back(), name, "piles did not move");
+    for (size_t step = 0; passed && step < serial.size(); ++step) {
+        if (serial[step] != threaded[step]) {
+            spdlog::error("{}: state hashes differ from step {}", name, step);
+            passed = false;
+        }
+    }
+    return passed;
+}
+
+}
+
+int runPhysicsTests() {
+    return runTests({ testRestingBox, testCrossedEdges, testSeparatedBoxes, testKernelsMatchScalar,
+                      testContinuousCollision, testWakeWhenSupportMoves, testEditsWakeSleepingBodies,
+                      testDeterministicSimulation });
+}
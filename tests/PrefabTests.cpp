@@ -0,0 +1,97 @@
+#include "PrefabTests.hpp"
+#include "TestUtils.hpp"
+#include "scene/Prefab.hpp"
+#include "scene/Scene.hpp"
+#include <string>
+#include <vector>
+
+using namespace roblox_clone;
+
+namespace {
+
+// A small model around (10, 0, 10): a scripted base and three meshed parts,
+// one of them without a name.
+scene::Prefab buildModel() {
+    scene::Scene source;
+    auto& registry = source.registry();
+    std::vector<entt::entity> parts;
+    for (int i = 0; i < 4; ++i) {
+        const entt::entity entity = registry.create();
+        registry.emplace<scene::TransformComponent>(entity, glm::vec3(10.0f + i, 0.0f, 10.0f));
+        if (i != 2) registry.emplace<scene::NameComponent>(entity, "Part" + std::to_string(i));
+        if (i == 0) {
+            registry.emplace<scene::ScriptComponent>(entity, "scripts/spin.lua");
+        } else {
+            auto& mesh = registry.emplace<scene::MeshRendererComponent>(entity);
+            mesh.meshPath = "meshes/wheel.obj";
+            mesh.materialPath = "materials/rubber.mat";
+        }
+        parts.push_back(entity);
+    }
+    return scene::Prefab::capture(source, parts, glm::vec3(10.0f, 0.0f, 10.0f));
+}
+
+bool testBulkInstantiate() {
+    const char* name = "BulkInstantiate";
+    const scene::Prefab prefab = buildModel();
+    scene::Scene scene;
+    std::vector<glm::vec3> positions;
+    for (int i = 0; i < 100; ++i) {
+        positions.push_back(glm::vec3(i * 20.0f, 5.0f, 0.0f));
+    }
+    std::vector<entt::entity> created;
+    scene::PrefabSpawnStats stats;
+    prefab.instantiate(scene, positions, &created, &stats);
+    
+    auto& registry = scene.registry();
+    bool passed = expect(prefab.getPartCount() == 4, name, "wrong part count");
+    passed = expect(created.size() == 400 && stats.entityCount == 400, name, "wrong entity count") && passed;
+    passed = expect(registry.storage<scene::NameComponent>().size() == 300, name, "wrong name count") && passed;
+    passed = expect(registry.storage<scene::ScriptComponent>().size() == 100, name, "wrong script count") && passed;
+    passed = expect(scene.renderables().size() == 300, name, "instances not renderable") && passed;
+    
+    bool placed = true;
+    for (size_t i = 0; i < created.size(); ++i) {
+        const glm::vec3 expected = positions[i / 4] + glm::vec3(static_cast<float>(i % 4), 0.0f, 0.0f);
+        placed = placed && registry.get<scene::TransformComponent>(created[i]).position == expected;
+    }
+    passed = expect(placed, name, "parts not placed relative to the instance") && passed;
+    passed = expect(!registry.all_of<scene::NameComponent>(created[6]), name, "unnamed part got a name") && passed;
+    passed = expect(registry.get<scene::NameComponent>(created[5]).name == "Part1", name, "wrong part order") &&
+             passed;
+    return passed;
+}
+
+// Instances hold the prefab's string ids until one of them writes a field.
+bool testSharedUntilWritten() {
+    const char* name = "SharedUntilWritten";
+    const scene::Prefab prefab = buildModel();
+    scene::Scene scene;
+    const std::vector<entt::entity> first = prefab.instantiate(scene, glm::vec3(0.0f));
+    const std::vector<entt::entity> second = prefab.instantiate(scene, glm::vec3(50.0f, 0.0f, 0.0f));
+    auto& registry = scene.registry();
+    
+    auto& mesh = registry.get<scene::MeshRendererComponent>(first[1]);
+    const auto& other = registry.get<scene::MeshRendererComponent>(second[1]);
+    bool passed = expect(mesh.meshPath == other.meshPath && mesh.meshPath.str() == "meshes/wheel.obj", name,
+                         "instances disagree on the mesh path");
+    passed = expect(registry.get<scene::NameComponent>(first[0]).name ==
+                        registry.get<scene::NameComponent>(second[0]).name, name, "instances disagree on the name") &&
+             passed;
+    
+    mesh.meshPath = "meshes/tire.obj";
+    passed = expect(mesh.meshPath == "meshes/tire.obj", name, "write lost") && passed;
+    passed = expect(other.meshPath == "meshes/wheel.obj", name, "write leaked into another instance") && passed;
+    passed = expect(mesh.materialPath == other.materialPath, name, "untouched field changed") && passed;
+    
+    const std::vector<entt::entity> third = prefab.instantiate(scene, glm::vec3(100.0f, 0.0f, 0.0f));
+    passed = expect(registry.get<scene::MeshRendererComponent>(third[1]).meshPath == "meshes/wheel.obj", name,
+                    "write leaked into the prefab") && passed;
+    return passed;
+}
+
+}
+
+int runPrefabTests() {
+    return runTests({ testBulkInstantiate, testSharedUntilWritten });
+}
@@ -0,0 +1,183 @@
+#include "SceneFileTests.hpp"
+#include "TestUtils.hpp"
+#include "scene/Scene.hpp"
+#include "scene/SceneFile.hpp"
+#include <filesystem>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace roblox_clone;
+
+namespace {
+
+std::string tempPath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// Parts with every saved component, plus bare entities and ones that only
+// have some of them, so chunks cover different subsets.
+void buildScene(scene::Scene& scene, int count) {
+    std::mt19937 random(11);
+    std::uniform_real_distribution<float> unit(-100.0f, 100.0f);
+    for (int i = 0; i < count; ++i) {
+        scene::Entity entity = scene.createEntity("Part" + std::to_string(i));
+        auto& transform = entity.getComponent<scene::TransformComponent>();
+        transform.position = glm::vec3(unit(random), unit(random), unit(random));
+        transform.rotation = glm::vec3(unit(random), 0.0f, unit(random));
+        transform.scale = glm::vec3(1.0f + i % 4);
+        if (i % 2 == 0) {
+            auto& mesh = entity.addComponent<scene::MeshRendererComponent>();
+            mesh.meshPath = i % 4 == 0 ? "meshes/cube.obj" : "meshes/sphere.obj";
+            mesh.materialPath = "materials/plastic.mat";
+            mesh.isStatic = i % 3 == 0;
+            mesh.castShadows = i % 5 != 0;
+        }
+        if (i % 7 == 0) {
+            entity.addComponent<scene::ScriptComponent>("scripts/spin.lua").enabled = i % 14 == 0;
+        }
+        if (i % 3 == 0) {
+            auto& network = entity.addComponent<scene::NetworkComponent>();
+            network.networkId = static_cast<uint32_t>(i);
+            network.isOwned = i % 2 == 0;
+        }
+    }
+    (void)scene.registry().create();
+}
+
+bool sameContent(scene::Scene& a, scene::Scene& b, const char* test) {
+    bool passed = expect(a.computeStateHash() == b.computeStateHash(), test, "transforms differ");
+    auto& left = a.registry();
+    auto& right = b.registry();
+    passed = expect(left.storage<entt::entity>().free_list() == right.storage<entt::entity>().free_list(), test,
+                    "entity counts differ") && passed;
+    for (auto [entity, name] : left.view<scene::NameComponent>().each()) {
+        const auto* other = right.try_get<scene::NameComponent>(entity);
+        if (!other || other->name != name.name) return expect(false, test, "names differ");
+    }
+    for (auto [entity, mesh] : left.view<scene::MeshRendererComponent>().each()) {
+        const auto* other = right.try_get<scene::MeshRendererComponent>(entity);
+        if (!other || other->meshPath != mesh.meshPath || other->materialPath != mesh.materialPath ||
+            other->isStatic != mesh.isStatic || other->castShadows != mesh.castShadows) {
+            return expect(false, test, "mesh renderers differ");
+        }
+    }
+    for (auto [entity, script] : left.view<scene::ScriptComponent>().each()) {
+        const auto* other = right.try_get<scene::ScriptComponent>(entity);
+        if (!other || other->scriptPath != script.scriptPath || other->enabled != script.enabled) {
+            return expect(false, test, "scripts differ");
+        }
+    }
+    for (auto [entity, network] : left.view<scene::NetworkComponent>().each()) {
+        const auto* other = right.try_get<scene::NetworkComponent>(entity);
+        if (!other || other->networkId != network.networkId || other->isOwned != network.isOwned) {
+            return expect(false, test, "network components differ");
+        }
+    }
+    passed = expect(left.storage<scene::MeshRendererComponent>().size() ==
+                    right.storage<scene::MeshRendererComponent>().size(), test, "mesh renderer counts differ") && passed;
+    passed = expect(left.storage<scene::ScriptComponent>().size() == right.storage<scene::ScriptComponent>().size(),
+                    test, "script counts differ") && passed;
+    return passed;
+}
+
+bool testBinaryRoundTrip() {
+    const char* name = "BinaryRoundTrip";
+    const std::string path = tempPath("rc_roundtrip.rcscene");
+    scene::Scene original;
+    buildScene(original, 20000);
+    bool passed = expect(scene::saveScene(original, path), name, "save failed");
+    
+    scene::Scene loaded;
+    scene::SceneLoadStats stats;
+    passed = expect(scene::loadScene(loaded, path, &stats), name, "load failed") && passed;
+    passed = expect(stats.entityCount == 20001, name, "wrong entity count") && passed;
+    passed = sameContent(original, loaded, name) && passed;
+    passed = expect(loaded.renderables().size() == 10000, name, "renderables group not filled") && passed;
+    
+    // Loading appends, so a second load doubles the scene.
+    passed = expect(scene::loadScene(loaded, path), name, "second load failed") && passed;
+    passed = expect(loaded.registry().storage<scene::NameComponent>().size() == 40000, name,
+                    "second load did not append") && passed;
+    std::filesystem::remove(path);
+    return passed;
+}
+
+bool testJsonRoundTrip() {
+    const char* name = "JsonRoundTrip";
+    const std::string path = tempPath("rc_roundtrip.json");
+    scene::Scene original;
+    buildScene(original, 500);
+    bool passed = expect(scene::exportSceneJson(original, path), name, "export failed");
+    
+    scene::Scene loaded;
+    passed = expect(scene::importSceneJson(loaded, path), name, "import failed") && passed;
+    passed = sameContent(original, loaded, name) && passed;
+    std::filesystem::remove(path);
+    return passed;
+}
+
+// Damaged files are rejected without leaving half a scene behind.
+bool testRejectsCorruptFile() {
+    const char* name = "RejectsCorruptFile";
+    const std::string path = tempPath("rc_corrupt.rcscene");
+    scene::Scene original;
+    buildScene(original, 1000);
+    bool passed = expect(scene::saveScene(original, path), name, "save failed");
+    
+    std::vector<char> bytes(std::filesystem::file_size(path));
+    std::ifstream(path, std::ios::binary).read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    auto writeVariant = [&](const std::vector<char>& content) {
+        std::ofstream(path, std::ios::binary | std::ios::trunc)
+            .write(content.data(), static_cast<std::streamsize>(content.size()));
+    };
+    
+    scene::Scene loaded;
+    writeVariant(std::vector<char>(bytes.begin(), bytes.begin() + bytes.size() / 2));
+    passed = expect(!scene::loadScene(loaded, path), name, "loaded a truncated file") && passed;
+    
+    // Point the first chunk's first entity index past the entity count.
+    std::vector<char> badIndex = bytes;
+    uint64_t chunkOffset = 0;
+    std::memcpy(&chunkOffset, badIndex.data() + 32 + 16, sizeof(chunkOffset));
+    const uint32_t outOfRange = 1u << 30;
+    std::memcpy(badIndex.data() + chunkOffset, &outOfRange, sizeof(outOfRange));
+    writeVariant(badIndex);
+    passed = expect(!scene::loadScene(loaded, path), name, "loaded a chunk with a bad entity index") && passed;
+    passed = expect(loaded.registry().storage<entt::entity>().free_list() == 0, name,
+                    "failed load left entities behind") && passed;
+    std::filesystem::remove(path);
+    return passed;
+}
+
+// A string table offset near 2^64 wraps around once the table's length is
+// added, which must not slip past the bounds checks.
+bool testRejectsCorruptHeader() {
+    const char* name = "RejectsCorruptHeader";
+    const std::string path = tempPath("rc_corrupt_header.rcscene");
+    scene::Scene original;
+    buildScene(original, 10);
+    bool passed = expect(scene::saveScene(original, path), name, "save failed");
+    
+    std::vector<char> bytes(std::filesystem::file_size(path));
+    std::ifstream(path, std::ios::binary).read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    uint32_t stringCount = 0;
+    std::memcpy(&stringCount, bytes.data() + 28, sizeof(stringCount));
+    const uint64_t wrappingOffset = 40 - (uint64_t(stringCount) + 1) * sizeof(uint32_t);
+    std::memcpy(bytes.data() + 16, &wrappingOffset, sizeof(wrappingOffset));
+    std::ofstream(path, std::ios::binary | std::ios::trunc)
+        .write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    
+    scene::Scene loaded;
+    passed = expect(!scene::loadScene(loaded, path), name, "loaded a wrapping string table offset") && passed;
+    std::filesystem::remove(path);
+    return passed;
+}
+
+}
+
+int runSceneFileTests() {
+    return runTests({ testBinaryRoundTrip, testJsonRoundTrip, testRejectsCorruptFile, testRejectsCorruptHeader });
+}
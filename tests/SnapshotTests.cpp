@@ -0,0 +1,205 @@
+#include "SnapshotTests.hpp"
+#include "TestUtils.hpp"
+#include "physics/PhysicsWorld.hpp"
+#include "scene/Scene.hpp"
+#include "scene/SnapshotHistory.hpp"
+#include <random>
+#include <vector>
+
+using namespace roblox_clone;
+
+namespace {
+
+std::vector<entt::entity> spawnParts(scene::Scene& scene, int count) {
+    auto& registry = scene.registry();
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> unit(-50.0f, 50.0f);
+    std::vector<entt::entity> parts;
+    for (int i = 0; i < count; ++i) {
+        const entt::entity entity = registry.create();
+        registry.emplace<scene::TransformComponent>(entity, glm::vec3(unit(random), unit(random), unit(random)));
+        registry.emplace<scene::NetworkComponent>(entity).networkId = static_cast<uint32_t>(i);
+        parts.push_back(entity);
+    }
+    return parts;
+}
+
+void scramble(scene::Scene& scene) {
+    scene.each([](entt::entity, scene::TransformComponent& transform) {
+        transform.position += glm::vec3(1.0f, 2.0f, 3.0f);
+        transform.rotation.y += 45.0f;
+    });
+}
+
+// Unchanged entities restore by copying pages straight back.
+bool testRestoreInPlace() {
+    const char* name = "RestoreInPlace";
+    scene::Scene scene;
+    spawnParts(scene, 3000);
+    scene::SnapshotHistory history(8);
+    history.track<scene::TransformComponent, scene::NetworkComponent>();
+    
+    const uint64_t saved = scene.computeStateHash();
+    history.save(scene.registry(), 0);
+    scramble(scene);
+    bool passed = expect(scene.computeStateHash() != saved, name, "scramble did not change the state");
+    passed = expect(history.restore(scene, 0), name, "restore failed") && passed;
+    passed = expect(scene.computeStateHash() == saved, name, "state differs after restore") && passed;
+    passed = expect(history.getStats().rebuiltStorages == 0, name, "storages were rebuilt") && passed;
+    passed = expect(history.getStats().frameBytes >= 3000 * sizeof(scene::TransformComponent), name,
+                    "frame smaller than the transforms") && passed;
+    passed = expect(!history.restore(scene, 8), name, "restored a tick that was never saved") && passed;
+    return passed;
+}
+
+// Entities spawned after the frame go away, despawned ones come back with
+// their old handles.
+bool testRestoreSpawns() {
+    const char* name = "RestoreSpawns";
+    scene::Scene scene;
+    auto& registry = scene.registry();
+    const std::vector<entt::entity> parts = spawnParts(scene, 500);
+    scene::SnapshotHistory history(8);
+    history.track<scene::TransformComponent, scene::NetworkComponent>();
+    
+    const uint64_t saved = scene.computeStateHash();
+    history.save(registry, 3);
+    registry.destroy(parts[10]);
+    registry.remove<scene::NetworkComponent>(parts[20]);
+    const entt::entity spawned = registry.create();
+    registry.emplace<scene::TransformComponent>(spawned);
+    scramble(scene);
+    
+    bool passed = expect(history.restore(scene, 3), name, "restore failed");
+    passed = expect(scene.computeStateHash() == saved, name, "state differs after restore") && passed;
+    passed = expect(registry.valid(parts[10]), name, "despawned entity not recreated") && passed;
+    passed = expect(registry.all_of<scene::NetworkComponent>(parts[20]), name, "removed component not restored") &&
+             passed;
+    passed = expect(!registry.valid(spawned), name, "spawned entity survived") && passed;
+    passed = expect(history.getStats().rebuiltStorages > 0, name, "nothing was rebuilt") && passed;
+    return passed;
+}
+
+// A despawned part comes back through the storages' signals, so it rejoins
+// the renderables group and physics registers a fresh body for it.
+bool testRestoreDespawnedPart() {
+    const char* name = "RestoreDespawnedPart";
+    scene::Scene scene;
+    auto& registry = scene.registry();
+    const entt::entity part = registry.create();
+    registry.emplace<scene::TransformComponent>(part, glm::vec3(0.0f, 50.0f, 0.0f));
+    registry.emplace<scene::MeshRendererComponent>(part);
+    registry.emplace<physics::RigidBodyComponent>(part, physics::BodyType::Dynamic, physics::ShapeType::Box);
+    
+    physics::PhysicsWorld world;
+    world.attach(scene);
+    world.step(1.0f / 60.0f);
+    scene::SnapshotHistory history(8);
+    history.track<scene::TransformComponent, scene::MeshRendererComponent, physics::RigidBodyComponent>();
+    history.save(registry, 0);
+    
+    registry.destroy(part);
+    world.step(1.0f / 60.0f);
+    bool passed = expect(world.getStats().bodyCount == 0, name, "despawned body still counted");
+    
+    passed = expect(history.restore(scene, 0), name, "restore failed") && passed;
+    passed = expect(scene.renderables().contains(part), name, "restored part missing from renderables") && passed;
+    passed = expect(registry.get<physics::RigidBodyComponent>(part).body == physics::RigidBodyComponent::NoBody,
+                    name, "restored part kept a stale body index") && passed;
+    
+    const float height = registry.get<scene::TransformComponent>(part).position.y;
+    world.step(1.0f / 60.0f);
+    passed = expect(world.getStats().bodyCount == 1, name, "restored body not registered") && passed;
+    passed = expect(registry.get<scene::TransformComponent>(part).position.y < height, name,
+                    "restored body did not fall") && passed;
+    return passed;
+}
+
+// Replaying ticks from a snapshot lands on the same state. The bodies fly
+// without touching anything, so no contact impulses carry over from the
+// ticks that were rolled back.
+bool testResimulate() {
+    const char* name = "Resimulate";
+    scene::Scene scene;
+    auto& registry = scene.registry();
+    std::mt19937 random(11);
+    std::uniform_real_distribution<float> unit(-20.0f, 20.0f);
+    for (int i = 0; i < 200; ++i) {
+        const entt::entity entity = registry.create();
+        registry.emplace<scene::TransformComponent>(entity, glm::vec3(i * 50.0f, 100.0f, 0.0f));
+        auto& rigidBody = registry.emplace<physics::RigidBodyComponent>(entity, physics::BodyType::Dynamic,
+                                                                        physics::ShapeType::Sphere);
+        rigidBody.linearVelocity = glm::vec3(unit(random), unit(random), unit(random));
+    }
+    
+    physics::PhysicsWorld world;
+    world.attach(scene);
+    scene::SnapshotHistory history(16);
+    history.track<scene::TransformComponent, physics::RigidBodyComponent>();
+    std::vector<uint64_t> hashes;
+    for (uint64_t tick = 0; tick < 20; ++tick) {
+        history.save(registry, tick);
+        world.step(1.0f / 60.0f);
+        hashes.push_back(scene.computeStateHash());
+    }
+    
+    bool passed = expect(history.restore(scene, 12), name, "restore failed");
+    for (uint64_t tick = 12; passed && tick < 20; ++tick) {
+        world.step(1.0f / 60.0f);
+        passed = expect(scene.computeStateHash() == hashes[tick], name, "replayed tick differs");
+    }
+    passed = expect(!history.contains(3), name, "ring kept an overwritten tick") && passed;
+    return passed;
+}
+
+
+// With the physics state saved alongside each frame, replaying ticks of a
+// settling pile lands on the same state too: warm starting impulses, sleep
+// counters and orientations come back with the transforms.
+bool testResimulateContacts() {
+    const char* name = "ResimulateContacts";
+    scene::Scene scene;
+    auto& registry = scene.registry();
+    const entt::entity floor = registry.create();
+    registry.emplace<scene::TransformComponent>(floor).scale = glm::vec3(100.0f, 1.0f, 100.0f);
+    registry.emplace<physics::RigidBodyComponent>(floor, physics::BodyType::Static, physics::ShapeType::Box);
+    for (int i = 0; i < 27; ++i) {
+        const entt::entity entity = registry.create();
+        auto& transform = registry.emplace<scene::TransformComponent>(
+            entity, glm::vec3(i % 3 * 1.1f, 1.0f + i / 9 * 1.2f, i / 3 % 3 * 1.1f));
+        transform.rotation.y = i * 7.0f;
+        registry.emplace<physics::RigidBodyComponent>(entity, physics::BodyType::Dynamic,
+                                                      i % 2 ? physics::ShapeType::Box : physics::ShapeType::Sphere);
+    }
+    
+    physics::PhysicsWorld world;
+    world.attach(scene);
+    scene::SnapshotHistory history(16);
+    history.track<scene::TransformComponent, physics::RigidBodyComponent>();
+    std::vector<physics::PhysicsWorld::State> states(16);
+    std::vector<uint64_t> hashes;
+    for (uint64_t tick = 0; tick < 90; ++tick) {
+        history.save(registry, tick);
+        world.saveState(states[tick % states.size()]);
+        world.step(1.0f / 60.0f);
+        hashes.push_back(scene.computeStateHash());
+    }
+    const size_t contactCount = world.getStats().contactCount;
+    
+    bool passed = expect(contactCount > 0, name, "pile never touched");
+    passed = expect(history.restore(scene, 80), name, "restore failed") && passed;
+    world.restoreState(states[80 % states.size()]);
+    for (uint64_t tick = 80; passed && tick < 90; ++tick) {
+        world.step(1.0f / 60.0f);
+        passed = expect(scene.computeStateHash() == hashes[tick], name, "replayed tick differs");
+    }
+    passed = expect(world.getStats().contactCount == contactCount, name, "contact cache differs") && passed;
+    return passed;
+}
+
+}
+
+int runSnapshotTests() {
+    return runTests({ testRestoreInPlace, testRestoreSpawns, testRestoreDespawnedPart, testResimulate,
+                      testResimulateContacts });
+}
@@ -0,0 +1,136 @@
+#include "SpatialHashTests.hpp"
+#include "TestUtils.hpp"
+#include "scene/Scene.hpp"
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace roblox_clone;
+
+namespace {
+
+// Small parts spread over a few cells plus some bigger than a cell, which
+// land in the oversized list.
+std::vector<entt::entity> spawnParts(scene::Scene& scene) {
+    auto& registry = scene.registry();
+    std::mt19937 random(99);
+    std::uniform_real_distribution<float> coordinate(-200.0f, 200.0f);
+    std::uniform_real_distribution<float> size(0.5f, 4.0f);
+    std::vector<entt::entity> parts;
+    for (int i = 0; i < 2000; ++i) {
+        const entt::entity entity = registry.create();
+        scene::TransformComponent transform(glm::vec3(coordinate(random), coordinate(random), coordinate(random)));
+        transform.scale = i % 100 == 0 ? glm::vec3(40.0f) : glm::vec3(size(random), size(random), size(random));
+        registry.emplace<scene::TransformComponent>(entity, transform);
+        registry.emplace<scene::MeshRendererComponent>(entity);
+        parts.push_back(entity);
+    }
+    scene.updateSpatialHash();
+    return parts;
+}
+
+std::vector<entt::entity> bruteForceRadius(const scene::Scene& scene, const std::vector<entt::entity>& parts,
+                                           const glm::vec3& center, float radius) {
+    std::vector<entt::entity> results;
+    for (entt::entity entity : parts) {
+        const auto bounds = scene::Aabb::fromTransform(scene.registry().get<scene::TransformComponent>(entity));
+        if (bounds.distanceSquared(center) <= radius * radius) results.push_back(entity);
+    }
+    std::sort(results.begin(), results.end());
+    return results;
+}
+
+// Radius queries return exactly the parts a brute-force scan finds.
+bool testRadiusMatchesBruteForce() {
+    const char* name = "RadiusMatchesBruteForce";
+    scene::Scene scene;
+    const std::vector<entt::entity> parts = spawnParts(scene);
+    const auto& hash = scene.getSpatialHash();
+    bool passed = expect(hash.size() == parts.size(), name, "not every part was indexed");
+    passed = expect(hash.getOversizedCount() == 20, name, "big parts not kept apart") && passed;
+    
+    std::mt19937 random(5);
+    std::uniform_real_distribution<float> coordinate(-220.0f, 220.0f);
+    for (int query = 0; passed && query < 200; ++query) {
+        const glm::vec3 center(coordinate(random), coordinate(random), coordinate(random));
+        const float radius = static_cast<float>(query % 8) * 6.0f + 1.0f;
+        std::vector<entt::entity> results;
+        hash.queryRadius(center, radius, results);
+        std::sort(results.begin(), results.end());
+        passed = expect(results == bruteForceRadius(scene, parts, center, radius), name, "results differ");
+    }
+    return passed;
+}
+
+// Infinite or huge extents must still find every part instead of wrapping
+// the cell range around.
+bool testUnboundedQueries() {
+    const char* name = "UnboundedQueries";
+    scene::Scene scene;
+    const std::vector<entt::entity> parts = spawnParts(scene);
+    const auto& hash = scene.getSpatialHash();
+    bool passed = true;
+    for (float radius : { std::numeric_limits<float>::infinity(), 1.0e30f, 3.0e9f }) {
+        std::vector<entt::entity> results;
+        hash.queryRadius(glm::vec3(0.0f), radius, results);
+        passed = expect(results.size() == parts.size(), name, "unbounded radius missed parts") && passed;
+    }
+    
+    std::vector<entt::entity> results;
+    hash.queryNearest(glm::vec3(1.0e12f, 0.0f, 0.0f), 3, results);
+    passed = expect(results.size() == 3, name, "nearest from far away found too few") && passed;
+    return passed;
+}
+
+// Moved parts are found at their new place once the hash syncs.
+bool testMovedPartsResync() {
+    const char* name = "MovedPartsResync";
+    scene::Scene scene;
+    auto& registry = scene.registry();
+    const std::vector<entt::entity> parts = spawnParts(scene);
+    const entt::entity moved = parts[1];
+    registry.get<scene::TransformComponent>(moved).position = glm::vec3(5000.0f);
+    scene.getSpatialHash().markDirty(moved);
+    scene.updateSpatialHash();
+    
+    std::vector<entt::entity> results;
+    scene.getSpatialHash().queryRadius(glm::vec3(5000.0f), 1.0f, results);
+    bool passed = expect(results.size() == 1 && results[0] == moved, name, "moved part not found");
+    
+    registry.remove<scene::MeshRendererComponent>(moved);
+    scene.updateSpatialHash();
+    passed = expect(!scene.getSpatialHash().contains(moved), name, "part without a mesh kept") && passed;
+    return passed;
+}
+
+// A system that moves a part through a view and reports it with a patch
+// command gets just that part re-binned and reloaded.
+bool testSystemWritesResync() {
+    const char* name = "SystemWritesResync";
+    scene::Scene scene;
+    const std::vector<entt::entity> parts = spawnParts(scene);
+    const entt::entity moved = parts[7];
+    scene.getScheduler().addSystem("Mover", scene::SystemAccess().write<scene::TransformComponent>(),
+        [moved](scene::SystemContext& context) {
+            auto view = context.view<scene::TransformComponent>();
+            view.get<scene::TransformComponent>(moved).position = glm::vec3(-5000.0f);
+            context.commands().patch<scene::TransformComponent>(moved);
+        });
+    scene.updateTransformBatch();
+    scene.update(1.0f / 60.0f);
+    
+    std::vector<entt::entity> results;
+    scene.getSpatialHash().queryRadius(glm::vec3(-5000.0f), 1.0f, results);
+    bool passed = expect(results.size() == 1 && results[0] == moved, name, "patched part not re-binned");
+    scene.updateTransformBatch();
+    passed = expect(scene.getTransformBatch().getReloadedCount() <= 8, name, "unpatched parts reloaded") && passed;
+    return passed;
+}
+
+}
+
+int runSpatialHashTests() {
+    return runTests({ testRadiusMatchesBruteForce, testUnboundedQueries, testMovedPartsResync,
+                      testSystemWritesResync });
+}
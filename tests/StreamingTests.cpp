@@ -0,0 +1,133 @@
+#include "StreamingTests.hpp"
+#include "TestUtils.hpp"
+#include "scene/Scene.hpp"
+#include "scene/StreamingManager.hpp"
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace roblox_clone;
+
+namespace {
+
+constexpr float CellSize = 100.0f;
+
+// A 1000 x 1000 world of parts every 10 units, in 10 x 10 cells, plus a few
+// entities without a transform that always stay loaded.
+std::string partitionWorld() {
+    const std::string directory = (std::filesystem::temp_directory_path() / "rc_streaming").string();
+    std::filesystem::remove_all(directory);
+    scene::Scene world;
+    auto& registry = world.registry();
+    for (int x = 0; x < 100; ++x) {
+        for (int z = 0; z < 100; ++z) {
+            const entt::entity entity = registry.create();
+            registry.emplace<scene::TransformComponent>(entity, glm::vec3(x * 10.0f + 5.0f, 0.0f, z * 10.0f + 5.0f));
+            registry.emplace<scene::NameComponent>(entity, "Part");
+            auto& mesh = registry.emplace<scene::MeshRendererComponent>(entity);
+            mesh.meshPath = "meshes/cube.obj";
+        }
+    }
+    for (int i = 0; i < 3; ++i) {
+        registry.emplace<scene::NameComponent>(registry.create(), "Lighting");
+    }
+    scene::partitionScene(world, directory, CellSize);
+    return directory;
+}
+
+// Updates until nothing is queued, loading or waiting to be added.
+void settle(scene::StreamingManager& streaming, const std::vector<glm::vec3>& focus) {
+    for (int i = 0; i < 10000; ++i) {
+        streaming.update(focus);
+        if (streaming.isIdle()) return;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+size_t partCount(scene::Scene& scene) {
+    return scene.registry().storage<scene::TransformComponent>().size();
+}
+
+bool testStreamsAroundFocus(const std::string& directory) {
+    const char* name = "StreamsAroundFocus";
+    scene::Scene scene;
+    scene::StreamingSettings settings;
+    settings.loadRadius = 150.0f;
+    settings.unloadRadius = 250.0f;
+    scene::StreamingManager streaming(scene, settings);
+    bool passed = expect(streaming.open(directory), name, "open failed");
+    passed = expect(scene.registry().storage<scene::NameComponent>().size() == 3, name,
+                    "global entities not loaded") && passed;
+    
+    settle(streaming, { glm::vec3(50.0f, 0.0f, 50.0f) });
+    passed = expect(streaming.isCellLoaded(0, 0) && streaming.isCellLoaded(1, 1), name, "near cells missing") && passed;
+    passed = expect(!streaming.isCellLoaded(3, 0) && !streaming.isCellLoaded(9, 9), name, "far cells loaded") && passed;
+    passed = expect(partCount(scene) == streaming.getStats().residentEntities && partCount(scene) < 10000, name,
+                    "resident parts do not match the loaded cells") && passed;
+    
+    // Inside the unload radius the cell stays, though it would not load there.
+    settle(streaming, { glm::vec3(50.0f, 0.0f, 300.0f) });
+    passed = expect(streaming.isCellLoaded(0, 0), name, "hysteresis did not keep the cell") && passed;
+    settle(streaming, { glm::vec3(50.0f, 0.0f, 400.0f) });
+    passed = expect(!streaming.isCellLoaded(0, 0), name, "cell past the unload radius stayed") && passed;
+    
+    settle(streaming, { glm::vec3(950.0f, 0.0f, 950.0f) });
+    passed = expect(streaming.isCellLoaded(9, 9) && !streaming.isCellLoaded(0, 4), name, "did not follow") && passed;
+    passed = expect(partCount(scene) == streaming.getStats().residentEntities, name, "parts leaked") && passed;
+    return passed;
+}
+
+// Nearest cells win when the budget runs out.
+bool testMemoryBudget(const std::string& directory) {
+    const char* name = "MemoryBudget";
+    scene::Scene scene;
+    scene::StreamingSettings settings;
+    settings.loadRadius = 2000.0f;
+    settings.unloadRadius = 2500.0f;
+    scene::StreamingManager streaming(scene, settings);
+    bool passed = expect(streaming.open(directory), name, "open failed");
+    
+    settle(streaming, { glm::vec3(50.0f, 0.0f, 50.0f) });
+    const size_t cellBytes = streaming.getStats().residentBytes / 100;
+    passed = expect(streaming.getStats().loadedCells == 100, name, "unlimited budget did not load everything") &&
+             passed;
+    
+    settings.memoryBudget = cellBytes * 5;
+    streaming.setSettings(settings);
+    settle(streaming, { glm::vec3(550.0f, 0.0f, 550.0f) });
+    const auto stats = streaming.getStats();
+    passed = expect(stats.residentBytes <= settings.memoryBudget, name, "over budget") && passed;
+    passed = expect(streaming.isCellLoaded(5, 5) && !streaming.isCellLoaded(0, 0), name,
+                    "budget did not keep the nearest cells") && passed;
+    return passed;
+}
+
+// Servers stream around player characters rather than a camera.
+bool testFocusComponent(const std::string& directory) {
+    const char* name = "FocusComponent";
+    scene::Scene scene;
+    scene::StreamingSettings settings;
+    settings.loadRadius = 50.0f;
+    settings.unloadRadius = 100.0f;
+    scene::StreamingManager streaming(scene, settings);
+    bool passed = expect(streaming.open(directory), name, "open failed");
+    
+    const entt::entity player = scene.registry().create();
+    scene.registry().emplace<scene::TransformComponent>(player, glm::vec3(750.0f, 0.0f, 250.0f));
+    scene.registry().emplace<scene::StreamingFocusComponent>(player).clientId = 1;
+    settle(streaming, {});
+    passed = expect(streaming.isCellLoaded(7, 2) && !streaming.isCellLoaded(0, 0), name,
+                    "did not stream around the player") && passed;
+    return passed;
+}
+
+}
+
+int runStreamingTests() {
+    const std::string directory = partitionWorld();
+    const int failures = runTests({ testStreamsAroundFocus, testMemoryBudget, testFocusComponent }, directory);
+    std::filesystem::remove_all(directory);
+    return failures;
+}
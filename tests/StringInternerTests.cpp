@@ -0,0 +1,61 @@
+#include "StringInternerTests.hpp"
+#include "TestUtils.hpp"
+#include "core/StringInterner.hpp"
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace roblox_clone;
+
+namespace {
+
+bool testInternAndResolve() {
+    const char* name = "InternAndResolve";
+    const core::StringId first = "meshes/tests/cube.obj";
+    const core::StringId second = std::string("meshes/tests/") + "cube.obj";
+    const core::StringId other = "meshes/tests/sphere.obj";
+    bool passed = expect(first == second && !first.empty(), name, "equal text got different ids");
+    passed = expect(first != other, name, "different text got the same id") && passed;
+    passed = expect(first.str() == "meshes/tests/cube.obj", name, "wrong text") && passed;
+    passed = expect(core::StringId().str().empty() && core::StringId("").empty(), name, "empty id has text") &&
+             passed;
+    passed = expect(core::StringId::find("meshes/tests/sphere.obj") == other, name, "find missed") && passed;
+    passed = expect(core::StringId::find("never interned by any test").empty(), name, "find interned") && passed;
+    passed = expect(RC_STRING_ID("meshes/tests/cube.obj") == first, name, "literal id differs") && passed;
+    return passed;
+}
+
+// Threads interning overlapping names agree on every id, while the table
+// grows under them.
+bool testConcurrentIntern() {
+    const char* name = "ConcurrentIntern";
+    constexpr int ThreadCount = 4;
+    constexpr int NameCount = 20000;
+    std::vector<std::vector<core::StringId>> ids(ThreadCount);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < ThreadCount; ++t) {
+        threads.emplace_back([t, &ids]() {
+            for (int i = 0; i < NameCount; ++i) {
+                const int index = t % 2 == 0 ? i : NameCount - 1 - i;
+                ids[t].push_back(core::StringId("ConcurrentPart" + std::to_string(index)));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    bool agree = true;
+    for (int i = 0; i < NameCount; ++i) {
+        const core::StringId id = ids[0][i];
+        agree = agree && id.str() == "ConcurrentPart" + std::to_string(i);
+        agree = agree && ids[1][NameCount - 1 - i] == id && ids[2][i] == id && ids[3][NameCount - 1 - i] == id;
+    }
+    return expect(agree, name, "threads disagree on ids");
+}
+
+}
+
+int runStringInternerTests() {
+    return runTests({ testInternAndResolve, testConcurrentIntern });
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <spdlog/spdlog.h>
+#include <initializer_list>
+
+// Logs what went wrong when a check fails, so a test can keep going and
+// report every broken expectation at once.
+inline bool expect(bool condition, const char* test, const char* what) {
+    if (!condition) spdlog::error("{}: {}", test, what);
+    return condition;
+}
+
+// Runs each test with the same arguments and returns the number that failed.
+template<typename Test, typename... Args>
+int runTests(std::initializer_list<Test> tests, const Args&... args) {
+    int failures = 0;
+    for (Test test : tests) {
+        if (!test(args...)) ++failures;
+    }
+    return failures;
+}
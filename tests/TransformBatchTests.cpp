@@ -0,0 +1,268 @@
+#include "TransformBatchTests.hpp"
+#include "TestUtils.hpp"
+#include "scene/Entity.hpp"
+#include "scene/Scene.hpp"
+#include "scene/TransformBatch.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+#include <spdlog/spdlog.h>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace roblox_clone;
+using core::SimdKernel;
+
+namespace {
+
+constexpr SimdKernel Kernels[] = { SimdKernel::Scalar, SimdKernel::Sse, SimdKernel::Avx2 };
+
+// Random transforms, 37 of them so every kernel also runs its scalar tail.
+scene::TransformBatch randomBatch(std::vector<scene::TransformComponent>& components, unsigned seed) {
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+    std::uniform_real_distribution<float> angle(-80.0f, 80.0f);
+    std::uniform_real_distribution<float> scale(0.5f, 4.0f);
+    components.resize(37);
+    scene::TransformBatch batch;
+    batch.resize(components.size());
+    for (size_t i = 0; i < components.size(); ++i) {
+        auto& transform = components[i];
+        transform.position = glm::vec3(position(random), position(random), position(random));
+        transform.rotation = glm::vec3(angle(random), angle(random), angle(random));
+        transform.scale = glm::vec3(scale(random), scale(random), scale(random));
+        batch.set(i, transform);
+    }
+    return batch;
+}
+
+// The matrix the renderer built per entity before batching.
+glm::mat4 eulerMatrix(const scene::TransformComponent& transform) {
+    glm::mat4 model = glm::translate(glm::mat4(1.0f), transform.position);
+    model = glm::rotate(model, glm::radians(transform.rotation.x), glm::vec3(1, 0, 0));
+    model = glm::rotate(model, glm::radians(transform.rotation.y), glm::vec3(0, 1, 0));
+    model = glm::rotate(model, glm::radians(transform.rotation.z), glm::vec3(0, 0, 1));
+    return glm::scale(model, transform.scale);
+}
+
+bool nearlyEqual(const glm::mat4& a, const glm::mat4& b, float tolerance) {
+    for (int column = 0; column < 4; ++column) {
+        for (int row = 0; row < 4; ++row) {
+            if (std::abs(a[column][row] - b[column][row]) > tolerance) return false;
+        }
+    }
+    return true;
+}
+
+bool testComposeMatchesComponents() {
+    const char* name = "ComposeMatchesComponents";
+    std::vector<scene::TransformComponent> components;
+    const scene::TransformBatch batch = randomBatch(components, 5);
+    std::vector<glm::mat4> expected(components.size());
+    scene::composeMatrices(batch, expected.data(), SimdKernel::Scalar);
+    
+    bool matches = true;
+    bool roundTrips = true;
+    for (size_t i = 0; i < components.size(); ++i) {
+        matches = matches && nearlyEqual(expected[i], eulerMatrix(components[i]), 1.0e-3f);
+        const scene::TransformComponent view = batch.get(i);
+        roundTrips = roundTrips && glm::all(glm::lessThan(glm::abs(view.rotation - components[i].rotation),
+                                                          glm::vec3(1.0e-2f)));
+    }
+    bool passed = expect(matches, name, "matrix differs from the Euler angle matrix");
+    passed = expect(roundTrips, name, "get() does not give back the Euler angles") && passed;
+    
+    for (SimdKernel kernel : Kernels) {
+        if (!scene::isTransformKernelSupported(kernel)) {
+            spdlog::info("{}: {} kernel not available, skipped", name, core::getKernelName(kernel));
+            continue;
+        }
+        std::vector<glm::mat4> matrices(components.size());
+        scene::composeMatrices(batch, matrices.data(), kernel);
+        const bool identical = std::memcmp(matrices.data(), expected.data(), matrices.size() * sizeof(glm::mat4)) == 0;
+        passed = expect(identical, name, "kernel differs from scalar") && passed;
+    }
+    return passed;
+}
+
+bool testInterpolate() {
+    const char* name = "Interpolate";
+    std::vector<scene::TransformComponent> fromComponents;
+    std::vector<scene::TransformComponent> toComponents;
+    const scene::TransformBatch from = randomBatch(fromComponents, 7);
+    const scene::TransformBatch to = randomBatch(toComponents, 8);
+    
+    scene::TransformBatch expected;
+    scene::interpolateTransforms(from, to, 0.25f, expected, SimdKernel::Scalar);
+    bool passed = true;
+    bool blended = true;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        const glm::vec3 position = glm::mix(fromComponents[i].position, toComponents[i].position, 0.25f);
+        blended = blended && glm::all(glm::lessThan(glm::abs(expected.get(i).position - position), glm::vec3(1.0e-4f)));
+        const glm::quat rotation = expected.getRotation(i);
+        blended = blended && std::abs(glm::dot(rotation, rotation) - 1.0f) < 1.0e-5f;
+    }
+    passed = expect(blended, name, "positions not blended or rotations not normalized") && passed;
+    
+    for (SimdKernel kernel : Kernels) {
+        if (!scene::isTransformKernelSupported(kernel)) continue;
+        // Writing over one input is allowed.
+        scene::TransformBatch out = randomBatch(toComponents, 8);
+        scene::interpolateTransforms(from, out, 0.25f, out, kernel);
+        bool identical = true;
+        for (int field = 0; field < scene::TransformBatch::FieldCount; ++field) {
+            const auto f = static_cast<scene::TransformBatch::Field>(field);
+            identical = identical && std::memcmp(out.data(f), expected.data(f), out.size() * sizeof(float)) == 0;
+        }
+        passed = expect(identical, name, "kernel differs from scalar") && passed;
+    }
+    return passed;
+}
+
+bool testCull() {
+    const char* name = "Cull";
+    const glm::mat4 viewProjection = glm::perspective(glm::radians(60.0f), 1.0f, 0.1f, 100.0f) *
+                                     glm::lookAt(glm::vec3(0.0f), glm::vec3(0, 0, -1), glm::vec3(0, 1, 0));
+    scene::TransformComponent inFront(glm::vec3(0.0f, 0.0f, -10.0f));
+    scene::TransformComponent behind(glm::vec3(0.0f, 0.0f, 10.0f));
+    scene::TransformComponent aside(glm::vec3(40.0f, 0.0f, -10.0f));
+    scene::TransformComponent beyond(glm::vec3(0.0f, 0.0f, -200.0f));
+    // Centered outside the view but long enough to reach into it once turned.
+    scene::TransformComponent straddling(glm::vec3(20.0f, 0.0f, -10.0f));
+    straddling.scale = glm::vec3(40.0f, 1.0f, 1.0f);
+    straddling.rotation = glm::vec3(0.0f, 10.0f, 0.0f);
+    
+    const scene::TransformComponent cases[] = { inFront, behind, aside, beyond, straddling };
+    const uint8_t expected[] = { 1, 0, 0, 0, 1 };
+    scene::TransformBatch batch;
+    batch.resize(20);
+    for (size_t i = 0; i < batch.size(); ++i) {
+        batch.set(i, cases[i % 5]);
+    }
+    
+    bool passed = true;
+    for (SimdKernel kernel : Kernels) {
+        if (!scene::isTransformKernelSupported(kernel)) continue;
+        std::vector<uint8_t> visible(batch.size(), 2);
+        scene::cullTransforms(batch, viewProjection, visible.data(), kernel);
+        bool correct = true;
+        for (size_t i = 0; i < visible.size(); ++i) {
+            correct = correct && visible[i] == expected[i % 5];
+        }
+        passed = expect(correct, name, core::getKernelName(kernel)) && passed;
+    }
+    return passed;
+}
+
+// gather() converts every angle with the SIMD kernels; each kernel gives the
+// same quaternions, which match glm's to float precision even for angles far
+// outside one turn.
+bool testGather() {
+    const char* name = "Gather";
+    entt::registry registry;
+    std::mt19937 random(11);
+    std::uniform_real_distribution<float> angle(-720.0f, 720.0f);
+    std::vector<entt::entity> entities;
+    for (int i = 0; i < 61; ++i) {
+        const entt::entity entity = registry.create();
+        entities.push_back(entity);
+        if (i == 3) continue;
+        scene::TransformComponent transform(glm::vec3(static_cast<float>(i)));
+        transform.rotation = glm::vec3(angle(random), angle(random), angle(random));
+        if (i == 5) transform.rotation = glm::vec3(90.0f, -180.0f, 270.0f);
+        if (i == 6) transform.rotation = glm::vec3(1.0e5f, -36000.5f, 7200.25f);
+        registry.emplace<scene::TransformComponent>(entity, transform);
+    }
+    
+    scene::TransformBatch expected;
+    expected.gather(registry, entities.data(), entities.size(), SimdKernel::Scalar);
+    bool accurate = expected.getRotation(3) == glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    for (size_t i = 0; i < entities.size(); ++i) {
+        const auto* transform = registry.try_get<scene::TransformComponent>(entities[i]);
+        if (!transform) continue;
+        const glm::dvec3 radians = glm::radians(glm::dvec3(transform->rotation));
+        const glm::dquat reference = glm::angleAxis(radians.x, glm::dvec3(1, 0, 0)) *
+                                     glm::angleAxis(radians.y, glm::dvec3(0, 1, 0)) *
+                                     glm::angleAxis(radians.z, glm::dvec3(0, 0, 1));
+        const glm::dquat rotation(expected.getRotation(i));
+        accurate = accurate && std::abs(std::abs(glm::dot(rotation, reference)) - 1.0) < 1.0e-6;
+        accurate = accurate && expected.get(i).position == transform->position;
+    }
+    bool passed = expect(accurate, name, "rotations differ from glm's");
+    
+    for (SimdKernel kernel : Kernels) {
+        if (!scene::isTransformKernelSupported(kernel)) continue;
+        scene::TransformBatch batch;
+        batch.gather(registry, entities.data(), entities.size(), kernel);
+        bool identical = true;
+        for (int field = 0; field < scene::TransformBatch::FieldCount; ++field) {
+            const auto f = static_cast<scene::TransformBatch::Field>(field);
+            identical = identical && std::memcmp(batch.data(f), expected.data(f), batch.size() * sizeof(float)) == 0;
+        }
+        passed = expect(identical, name, core::getKernelName(kernel)) && passed;
+    }
+    return passed;
+}
+
+bool sameBatch(const scene::TransformBatch& a, const scene::TransformBatch& b) {
+    if (a.size() != b.size()) return false;
+    for (int field = 0; field < scene::TransformBatch::FieldCount; ++field) {
+        const auto f = static_cast<scene::TransformBatch::Field>(field);
+        if (std::memcmp(a.data(f), b.data(f), a.size() * sizeof(float)) != 0) return false;
+    }
+    return true;
+}
+
+// The scene's batch stays resident: moving a few parts reloads only their
+// blocks, while adding a part or a bulk write reloads everything. Either way
+// it matches a fresh gather of the storage.
+bool testResidentBatch() {
+    const char* name = "ResidentBatch";
+    scene::Scene scene;
+    auto& registry = scene.registry();
+    std::vector<entt::entity> parts;
+    for (int i = 0; i < 200; ++i) {
+        parts.push_back(scene.createEntity("Part"));
+        scene::Entity(parts.back(), &scene).setPosition(glm::vec3(static_cast<float>(i)));
+    }
+    const auto& storage = registry.storage<scene::TransformComponent>();
+    scene::TransformBatch expected;
+    auto matches = [&]() {
+        expected.gather(registry, storage.data(), storage.size());
+        return sameBatch(scene.updateTransformBatch(), expected);
+    };
+    
+    bool passed = expect(matches(), name, "first update differs from a gather");
+    passed = expect(scene.getTransformBatch().getReloadedCount() == 200, name, "first update was not a refill") &&
+             passed;
+    
+    scene.beginSimulationStep();
+    scene::Entity(parts[10], &scene).setRotation(glm::vec3(30.0f, 60.0f, 90.0f));
+    scene::Entity(parts[10], &scene).setPosition(glm::vec3(-5.0f));
+    registry.patch<scene::TransformComponent>(parts[150], [](scene::TransformComponent& transform) {
+        transform.scale = glm::vec3(2.0f);
+    });
+    scene.endSimulationStep();
+    passed = expect(matches(), name, "moved parts not reloaded") && passed;
+    passed = expect(scene.getTransformBatch().getReloadedCount() <= 2 * scene::TransformBatch::Padding, name,
+                    "reloaded more than the moved parts' blocks") && passed;
+    passed = expect(scene.getSteppedParts().size() == 2 && !scene.allPartsStepped(), name,
+                    "stepped parts not listed once each") && passed;
+    
+    matches();
+    passed = expect(scene.getTransformBatch().getReloadedCount() == 0, name, "idle update reloaded parts") && passed;
+    
+    registry.destroy(parts[0]);
+    passed = expect(matches(), name, "removal not picked up") && passed;
+    scene.each([](entt::entity, scene::TransformComponent& transform) { transform.position.y += 1.0f; });
+    scene.markAllTransformsChanged();
+    passed = expect(matches(), name, "bulk write not picked up") && passed;
+    passed = expect(scene.getTransformBatch().getReloadedCount() == 199, name, "bulk write was not a refill") &&
+             passed;
+    return passed;
+}
+
+}
+
+int runTransformBatchTests() {
+    return runTests({ testComposeMatchesComponents, testInterpolate, testCull, testGather, testResidentBatch });
+}
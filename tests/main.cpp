@@ -1,8 +1,33 @@
+#include "BvhTests.hpp"
+#include "ChangeTrackerTests.hpp"
+#include "CommandBufferTests.hpp"
+#include "DeterministicMathTests.hpp"
+#include "JobSystemTests.hpp"
+#include "PhysicsTests.hpp"
+#include "PrefabTests.hpp"
+#include "SpatialHashTests.hpp"
+#include "SceneFileTests.hpp"
+#include "SnapshotTests.hpp"
+#include "StreamingTests.hpp"
+#include "StringInternerTests.hpp"
+#include "TransformBatchTests.hpp"
+#include "core/Logger.hpp"
 #include <spdlog/spdlog.h>
 
 int main() {
+    roblox_clone::core::Logger::init();
+    roblox_clone::core::Logger::setLevel(spdlog::level::warn);
     spdlog::info("Running tests...");
     
+    const int failures = runCommandBufferTests() + runDeterministicMathTests() + runJobSystemTests() +
+                         runPhysicsTests() + runSnapshotTests() + runSceneFileTests() + runSpatialHashTests() +
+                         runBvhTests() + runStreamingTests() + runPrefabTests() + runStringInternerTests() +
+                         runTransformBatchTests() + runChangeTrackerTests();
+    if (failures > 0) {
+        spdlog::error("{} tests failed", failures);
+        return 1;
+    }
+    
     spdlog::info("All tests passed!");
     return 0;
 }